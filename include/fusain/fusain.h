@@ -25,6 +25,44 @@
 #define FUSAIN_MAX_PAYLOAD_SIZE 114
 #define FUSAIN_MIN_PACKET_SIZE 14 // START + LEN + ADDR(8) + TYPE + CRC(2) + END
 
+/* Set in LENGTH when ADDRESS is a 1-byte session alias instead of 8 bytes.
+ * Lengths never exceed 114, so the flagged byte never needs escaping. */
+#define FUSAIN_LENGTH_ALIAS_FLAG 0x80
+
+/* Reserved Addresses
+ *
+ * The top 256 addresses are never assigned to devices. One frame sent to
+ * FUSAIN_ADDRESS_BROADCAST reaches every appliance on the bus, and one
+ * sent to FUSAIN_ADDRESS_GROUP(n) reaches the members of group n (0-254).
+ */
+#define FUSAIN_ADDRESS_BROADCAST 0xFFFFFFFFFFFFFFFFULL
+#define FUSAIN_ADDRESS_GROUP_BASE 0xFFFFFFFFFFFFFF00ULL
+#define FUSAIN_ADDRESS_GROUP(group) (FUSAIN_ADDRESS_GROUP_BASE | (uint8_t)(group))
+#define FUSAIN_ADDRESS_IS_MULTICAST(address) ((address) >= FUSAIN_ADDRESS_GROUP_BASE)
+#define FUSAIN_MAX_GROUPS 255
+
+/* Worst-case stuffed frame length for a CBOR payload of cbor_len bytes:
+ * START + LEN + END, with every ADDR(8), PAYLOAD and CRC(2) byte escaped */
+#define FUSAIN_STUFFED_FRAME_SIZE(cbor_len) (3 + 2 * (8 + (cbor_len) + 2))
+#define FUSAIN_MAX_STUFFED_PACKET_SIZE FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_MAX_PAYLOAD_SIZE)
+
+/* COBS framing: [COBS(LENGTH + ADDRESS(8) + CBOR_PAYLOAD + CRC(2))][0x00]
+ * One code byte per started 254-byte block, plus the delimiter */
+#define FUSAIN_COBS_DELIMITER 0x00
+#define FUSAIN_COBS_FRAME_SIZE(cbor_len) \
+  ((11 + (cbor_len)) + (11 + (cbor_len)) / 254 + 2)
+#define FUSAIN_MAX_COBS_PACKET_SIZE FUSAIN_COBS_FRAME_SIZE(FUSAIN_MAX_PAYLOAD_SIZE)
+
+/* Raw framing for reliable transports: [LENGTH][ADDRESS(8)][CBOR_PAYLOAD][CRC(2)?] */
+#define FUSAIN_RAW_FRAME_SIZE(cbor_len, with_crc) (9 + (cbor_len) + ((with_crc) ? 2 : 0))
+#define FUSAIN_MAX_RAW_PACKET_SIZE FUSAIN_RAW_FRAME_SIZE(FUSAIN_MAX_PAYLOAD_SIZE, true)
+
+#define FUSAIN_CRC_BATCH_LANES 4 // Spans processed in lockstep by fusain_crc16_batch
+
+/* Scatter-gather encoding limits (fusain_encode_packet_iov) */
+#define FUSAIN_IOV_MAX_SEGMENTS (FUSAIN_MAX_PAYLOAD_SIZE + 2)
+#define FUSAIN_IOV_SIDE_BUFFER_SIZE FUSAIN_MAX_STUFFED_PACKET_SIZE
+
 /* Message Type Definitions */
 typedef enum {
   /* Configuration Commands (Controller → Appliance) 0x10-0x1F */
@@ -36,6 +74,7 @@ typedef enum {
   FUSAIN_MSG_DATA_UNSUBSCRIBE = 0x15,
   FUSAIN_MSG_TELEMETRY_CONFIG = 0x16,
   FUSAIN_MSG_TIMEOUT_CONFIG = 0x17,
+  FUSAIN_MSG_ALIAS_CONFIG = 0x18,
   FUSAIN_MSG_DISCOVERY_REQUEST = 0x1F,
 
   /* Control Commands (Controller → Appliance) 0x20-0x2F */
@@ -54,6 +93,7 @@ typedef enum {
   FUSAIN_MSG_GLOW_DATA = 0x33,
   FUSAIN_MSG_TEMP_DATA = 0x34,
   FUSAIN_MSG_DEVICE_ANNOUNCE = 0x35,
+  FUSAIN_MSG_TELEMETRY_BATCH = 0x36,
   FUSAIN_MSG_PING_RESPONSE = 0x3F,
 
   /* Error Messages (Bidirectional) 0xE0-0xEF */
@@ -61,6 +101,113 @@ typedef enum {
   FUSAIN_MSG_ERROR_STATE_REJECT = 0xE1,
 } fusain_msg_type_t;
 
+/* Message Families
+ *
+ * Zephyr builds compile the create helpers of a family only when its
+ * CONFIG_FUSAIN_MSG_* option is enabled, so the linker can drop the
+ * matching generated cbor_* code. Standalone builds include every family.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_MSG_CONFIG)
+#define FUSAIN_HAS_MSG_CONFIG 1 // 0x10-0x1F
+#else
+#define FUSAIN_HAS_MSG_CONFIG 0
+#endif
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_MSG_CONTROL)
+#define FUSAIN_HAS_MSG_CONTROL 1 // 0x20-0x2F
+#else
+#define FUSAIN_HAS_MSG_CONTROL 0
+#endif
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_MSG_TELEMETRY)
+#define FUSAIN_HAS_MSG_TELEMETRY 1 // 0x30-0x3F
+#else
+#define FUSAIN_HAS_MSG_TELEMETRY 0
+#endif
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_MSG_ERROR)
+#define FUSAIN_HAS_MSG_ERROR 1 // 0xE0-0xEF
+#else
+#define FUSAIN_HAS_MSG_ERROR 0
+#endif
+
+/* Fixed-Point Telemetry
+ *
+ * Integer-only TEMP_DATA encoding (centi-degrees under key 6) for
+ * appliances without an FPU. Zephyr builds include it with
+ * CONFIG_FUSAIN_FIXED_POINT_TELEMETRY; standalone builds always do.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_FIXED_POINT_TELEMETRY)
+#define FUSAIN_HAS_FIXED_POINT 1
+#else
+#define FUSAIN_HAS_FIXED_POINT 0
+#endif
+
+/* COBS Framing
+ *
+ * Alternative link framing with fixed worst-case overhead. Zephyr builds
+ * include it with CONFIG_FUSAIN_COBS_FRAMING; standalone builds always do.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_COBS_FRAMING)
+#define FUSAIN_HAS_COBS 1
+#else
+#define FUSAIN_HAS_COBS 0
+#endif
+
+/* Worst-Case CBOR Payload Sizes
+ *
+ * Largest [msg_type, payload] encoding each message type can produce:
+ * array/type header (2 bytes for types <= 0x17, else 3), 2 bytes of
+ * indefinite-length map framing, and every optional key present with its
+ * widest value (int32/uint32: 5 bytes, uint64/float64: 9 bytes, 8-bit
+ * ranged fields: 2 bytes). Size TX buffers with FUSAIN_FRAME_SIZE_*
+ * instead of FUSAIN_MAX_PACKET_SIZE * 2.
+ *
+ * Schema payloads come from generated/cbor_sizes.h, which
+ * scripts/cbor_sizes.py derives from the zcbor encoder during
+ * `task zcbor-generate`. The rest are encoded by hand in fusain.c.
+ */
+#include <fusain/generated/cbor_sizes.h>
+
+#define FUSAIN_CBOR_SIZE_ALIAS_CONFIG 8
+#define FUSAIN_CBOR_SIZE_DISCOVERY_REQUEST 4
+#define FUSAIN_CBOR_SIZE_PING_REQUEST 4
+#define FUSAIN_CBOR_SIZE_TELEMETRY_BATCH FUSAIN_MAX_PAYLOAD_SIZE // Filled by the builder
+
+/* Worst-Case Stuffed Frame Sizes (encode buffer size per message type) */
+#define FUSAIN_FRAME_SIZE_MOTOR_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_MOTOR_CONFIG)
+#define FUSAIN_FRAME_SIZE_PUMP_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_PUMP_CONFIG)
+#define FUSAIN_FRAME_SIZE_TEMP_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TEMP_CONFIG)
+#define FUSAIN_FRAME_SIZE_GLOW_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_GLOW_CONFIG)
+#define FUSAIN_FRAME_SIZE_DATA_SUBSCRIPTION \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_DATA_SUBSCRIPTION)
+#define FUSAIN_FRAME_SIZE_DATA_UNSUBSCRIBE \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_DATA_UNSUBSCRIBE)
+#define FUSAIN_FRAME_SIZE_TELEMETRY_CONFIG \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TELEMETRY_CONFIG)
+#define FUSAIN_FRAME_SIZE_TIMEOUT_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TIMEOUT_CONFIG)
+#define FUSAIN_FRAME_SIZE_ALIAS_CONFIG FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_ALIAS_CONFIG)
+#define FUSAIN_FRAME_SIZE_DISCOVERY_REQUEST \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_DISCOVERY_REQUEST)
+#define FUSAIN_FRAME_SIZE_STATE_COMMAND FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_STATE_COMMAND)
+#define FUSAIN_FRAME_SIZE_MOTOR_COMMAND FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_MOTOR_COMMAND)
+#define FUSAIN_FRAME_SIZE_PUMP_COMMAND FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_PUMP_COMMAND)
+#define FUSAIN_FRAME_SIZE_GLOW_COMMAND FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_GLOW_COMMAND)
+#define FUSAIN_FRAME_SIZE_TEMP_COMMAND FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TEMP_COMMAND)
+#define FUSAIN_FRAME_SIZE_SEND_TELEMETRY FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_SEND_TELEMETRY)
+#define FUSAIN_FRAME_SIZE_PING_REQUEST FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_PING_REQUEST)
+#define FUSAIN_FRAME_SIZE_STATE_DATA FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_STATE_DATA)
+#define FUSAIN_FRAME_SIZE_MOTOR_DATA FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_MOTOR_DATA)
+#define FUSAIN_FRAME_SIZE_PUMP_DATA FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_PUMP_DATA)
+#define FUSAIN_FRAME_SIZE_GLOW_DATA FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_GLOW_DATA)
+#define FUSAIN_FRAME_SIZE_TEMP_DATA FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TEMP_DATA)
+#define FUSAIN_FRAME_SIZE_DEVICE_ANNOUNCE \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_DEVICE_ANNOUNCE)
+#define FUSAIN_FRAME_SIZE_PING_RESPONSE FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_PING_RESPONSE)
+#define FUSAIN_FRAME_SIZE_TELEMETRY_BATCH \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_TELEMETRY_BATCH)
+#define FUSAIN_FRAME_SIZE_ERROR_INVALID_CMD \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_ERROR_INVALID_CMD)
+#define FUSAIN_FRAME_SIZE_ERROR_STATE_REJECT \
+  FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_CBOR_SIZE_ERROR_STATE_REJECT)
+
 /* Operating Modes */
 typedef enum {
   FUSAIN_MODE_IDLE = 0x00,
@@ -171,6 +318,106 @@ typedef enum {
   FUSAIN_PUMP_EVENT_CYCLE_END = 5,
 } fusain_pump_event_t;
 
+/* Telemetry Readings (used by fusain_create_*_data_fields and delta APIs) */
+typedef struct {
+  uint8_t motor;
+  uint32_t timestamp;
+  int32_t rpm;
+  int32_t target;
+  int32_t max_rpm; // Optional key 4
+  int32_t min_rpm; // Optional key 5
+  uint32_t pwm; // Optional key 6
+  uint32_t pwm_max; // Optional key 7
+} fusain_motor_data_t;
+
+typedef struct {
+  uint8_t thermometer;
+  uint32_t timestamp;
+  float reading;
+  bool rpm_control; // Optional key 3
+  int32_t watched_motor; // Optional key 4
+  float target_temp; // Optional key 5
+} fusain_temp_data_t;
+
+/* Optional field masks (bit n = CBOR key n) */
+#define FUSAIN_MOTOR_DATA_MAX_RPM (1u << 4)
+#define FUSAIN_MOTOR_DATA_MIN_RPM (1u << 5)
+#define FUSAIN_MOTOR_DATA_PWM (1u << 6)
+#define FUSAIN_MOTOR_DATA_PWM_MAX (1u << 7)
+#define FUSAIN_MOTOR_DATA_OPTIONAL 0xF0u
+
+#define FUSAIN_TEMP_DATA_RPM_CONTROL (1u << 3)
+#define FUSAIN_TEMP_DATA_WATCHED_MOTOR (1u << 4)
+#define FUSAIN_TEMP_DATA_TARGET_TEMP (1u << 5)
+#define FUSAIN_TEMP_DATA_OPTIONAL 0x38u
+
+/* TEMP_DATA key carrying the reading as a CBOR integer in 0.01 degrees,
+ * sent in place of the float reading at key 2 */
+#define FUSAIN_TEMP_DATA_KEY_CENTI 6
+
+/* Delta Telemetry Encoder State
+ *
+ * One instance per peripheral. Optional fields are sent only when they
+ * move beyond their deadband from the last value sent; every refresh_ms
+ * (by reading timestamp) all fields are sent again.
+ */
+typedef struct {
+  uint32_t rpm_deadband; // max_rpm/min_rpm change that triggers a send
+  uint32_t pwm_deadband; // pwm/pwm_max change that triggers a send
+  uint32_t refresh_ms; // Full refresh period (0 = always send everything)
+} fusain_motor_delta_config_t;
+
+typedef struct {
+  fusain_motor_delta_config_t config;
+  fusain_motor_data_t sent; // Last value sent for each optional field
+  uint32_t last_refresh; // Timestamp of the last full refresh
+  bool primed; // False until the first full refresh
+} fusain_motor_delta_t;
+
+typedef struct {
+  float target_deadband; // target_temp change that triggers a send
+  uint32_t refresh_ms; // Full refresh period (0 = always send everything)
+} fusain_temp_delta_config_t;
+
+typedef struct {
+  fusain_temp_delta_config_t config;
+  fusain_temp_data_t sent; // Last value sent for each optional field
+  uint32_t last_refresh; // Timestamp of the last full refresh
+  bool primed; // False until the first full refresh
+} fusain_temp_delta_t;
+
+/* Telemetry Batch (TELEMETRY_BATCH)
+ *
+ * Several readings in one frame. Each record names the *_DATA message it
+ * stands in for, the peripheral index, its offset from the batch base
+ * timestamp, and that message's values from key 2 upward in key order
+ * (trailing optional keys may be left out).
+ */
+#define FUSAIN_BATCH_MAX_VALUES 6
+#define FUSAIN_BATCH_MAX_RECORDS 16 // Smallest record is 6 bytes
+
+typedef struct {
+  bool is_float;
+  union {
+    int32_t i;
+    float f;
+  } as;
+} fusain_batch_value_t;
+
+typedef struct {
+  uint8_t kind; // FUSAIN_MSG_*_DATA this record stands in for
+  uint8_t index; // Peripheral index
+  uint16_t dt_ms; // Offset from the batch base timestamp
+  uint8_t value_count;
+  fusain_batch_value_t values[FUSAIN_BATCH_MAX_VALUES];
+} fusain_batch_record_t;
+
+typedef struct {
+  uint32_t base_timestamp;
+  uint8_t count;
+  fusain_batch_record_t records[FUSAIN_BATCH_MAX_RECORDS];
+} fusain_telemetry_batch_t;
+
 /* Packet Structure */
 typedef struct {
   uint8_t start; // FUSAIN_START_BYTE
@@ -182,6 +429,20 @@ typedef struct {
   uint8_t end; // FUSAIN_END_BYTE
 } fusain_packet_t;
 
+/* Incremental batch builder (appliance side) */
+typedef struct {
+  fusain_packet_t* packet;
+  uint32_t base_timestamp;
+  uint8_t count;
+  bool finished;
+} fusain_batch_builder_t;
+
+/* Read-only byte span (pointer + length) */
+typedef struct {
+  const uint8_t* data;
+  size_t length;
+} fusain_span_t;
+
 /* Decode Result */
 typedef enum {
   FUSAIN_DECODE_OK = 0,
@@ -190,8 +451,47 @@ typedef enum {
   FUSAIN_DECODE_INVALID_CRC = 3,
   FUSAIN_DECODE_INVALID_LENGTH = 4,
   FUSAIN_DECODE_BUFFER_OVERFLOW = 5,
+  FUSAIN_DECODE_UNKNOWN_ALIAS = 6, // Short-address frame without a matching session
+  FUSAIN_DECODE_NOT_ADDRESSED = 7, // Frame for another device, dropped (not an error)
 } fusain_decode_result_t;
 
+/* Address Alias Session
+ *
+ * On a point-to-point link the controller proposes a 1-byte alias for the
+ * appliance with ALIAS_CONFIG. The appliance switches to short-address
+ * frames once it accepts; the controller keeps sending full frames until
+ * the first short frame arrives, so appliances without alias support
+ * simply never answer in the short form.
+ */
+typedef enum {
+  FUSAIN_ALIAS_OFF = 0, // Full 8-byte addresses only
+  FUSAIN_ALIAS_PROPOSED = 1, // Short frames accepted, full frames sent
+  FUSAIN_ALIAS_ACTIVE = 2, // Short frames accepted and sent
+} fusain_alias_state_t;
+
+typedef struct {
+  uint64_t address; // Full address the alias stands for
+  uint8_t alias;
+  uint8_t state; // fusain_alias_state_t
+} fusain_alias_t;
+
+/* Address Filter
+ *
+ * Lets an appliance's decoder drop frames meant for other devices on a
+ * shared bus as soon as their address is complete, before the payload
+ * is stored or the CRC computed. Broadcast is always accepted.
+ */
+typedef struct {
+  uint64_t address; // This device's own address
+  uint32_t groups[8]; // Accepted group numbers, one bit each (bit 255 = broadcast)
+} fusain_address_filter_t;
+
+/* Link Framing (selected per decoder with fusain_decoder_set_framing) */
+typedef enum {
+  FUSAIN_FRAMING_STUFFED = 0, // START/END delimiters with ESC byte stuffing
+  FUSAIN_FRAMING_COBS = 1, // COBS-encoded frames terminated by 0x00
+} fusain_framing_t;
+
 /* Decoder State */
 typedef struct {
   uint8_t state; // Internal state machine state
@@ -199,8 +499,36 @@ typedef struct {
   size_t buffer_index; // Current position in buffer
   bool escape_next; // Escape sequence flag
   uint8_t addr_byte_count; // Number of address bytes received (0-8)
+  bool aliased; // Current frame carries a 1-byte alias address
+  fusain_alias_t* alias; // Session for short frames (NULL = full only)
+  uint8_t framing; // fusain_framing_t
+  const fusain_address_filter_t* filter; // Accepted addresses (NULL = all)
 } fusain_decoder_t;
 
+/* Zero-copy view of a validated frame (see fusain_extract_frame) */
+typedef struct {
+  uint64_t address; // Device address
+  uint8_t msg_type; // fusain_msg_type_t
+  const uint8_t* payload; // CBOR payload [msg_type, map], unstuffed in place
+  size_t length; // Payload length (0-114)
+} fusain_frame_view_t;
+
+/* Frame Extractor State */
+typedef struct {
+  uint8_t carry[FUSAIN_MAX_STUFFED_PACKET_SIZE]; // Stuffed bytes of a split frame
+  size_t carry_length; // Bytes held in carry (0 = no partial frame)
+} fusain_extractor_t;
+
+/* Frame Retargeting State (see fusain_retarget_init) */
+typedef struct {
+  const uint8_t* frame; // Template frame (referenced, not copied)
+  size_t tail_offset; // Start of the stuffed CBOR payload in frame
+  size_t tail_length; // Stuffed CBOR payload length
+  uint8_t length; // LENGTH byte
+  uint16_t tail_crc; // Zero-init CRC of the CBOR payload
+  uint16_t shift[16]; // CRC register map across the payload, per bit
+} fusain_retarget_t;
+
 /* Function Declarations */
 
 /**
@@ -212,6 +540,63 @@ typedef struct {
  */
 uint16_t fusain_crc16(const uint8_t* data, size_t length);
 
+/**
+ * Continue a CRC-16-CCITT over more bytes
+ *
+ * fusain_crc16_update(0xFFFF, data, length) equals fusain_crc16(data,
+ * length), so a CRC can be carried across data that arrives in pieces.
+ *
+ * @param crc CRC of the bytes so far (0xFFFF before the first byte)
+ * @param data Next bytes
+ * @param length Number of bytes
+ * @return CRC including data
+ */
+uint16_t fusain_crc16_update(uint16_t crc, const uint8_t* data, size_t length);
+
+/**
+ * Calculate CRC-16-CCITT over many independent spans
+ *
+ * Produces the same values as calling fusain_crc16() on each span, but
+ * interleaves FUSAIN_CRC_BATCH_LANES spans at a time through a table-driven
+ * kernel. Intended for bulk verification of captured or batched frames.
+ *
+ * @param spans Array of spans to checksum
+ * @param count Number of spans
+ * @param crcs Output array of count CRC values (crcs[i] covers spans[i])
+ */
+void fusain_crc16_batch(const fusain_span_t* spans, size_t count,
+    uint16_t* crcs);
+
+/**
+ * CRC-16-CCITT of a concatenation from the CRCs of its parts
+ *
+ * Returns fusain_crc16(A || B) given fusain_crc16(A), fusain_crc16(B) and
+ * the length of B, without touching the data. Cost grows with length_b.
+ *
+ * @param crc_a CRC of the first part
+ * @param crc_b CRC of the second part
+ * @param length_b Length of the second part in bytes
+ * @return CRC of both parts
+ */
+uint16_t fusain_crc16_combine(uint16_t crc_a, uint16_t crc_b, size_t length_b);
+
+/**
+ * Update a CRC-16-CCITT for bytes replaced in the middle of a message
+ *
+ * The CRC is linear in the data, so replacing length bytes changes it by
+ * the CRC of the XOR difference carried through the trailing bytes. The
+ * rest of the message is not needed.
+ *
+ * @param crc CRC of the original message
+ * @param old_bytes Replaced bytes
+ * @param new_bytes Replacement bytes
+ * @param length Number of bytes replaced
+ * @param trailing Number of message bytes after the replaced range
+ * @return CRC of the modified message
+ */
+uint16_t fusain_crc16_patch(uint16_t crc, const uint8_t* old_bytes,
+    const uint8_t* new_bytes, size_t length, size_t trailing);
+
 /**
  * Encode a packet into a byte buffer with byte stuffing
  *
@@ -223,6 +608,107 @@ uint16_t fusain_crc16(const uint8_t* data, size_t length);
 int fusain_encode_packet(const fusain_packet_t* packet, uint8_t* buffer,
     size_t buffer_size);
 
+/**
+ * Encode a packet, using the short-address form when the session allows
+ *
+ * The 8-byte address is replaced by the 1-byte alias (and LENGTH carries
+ * FUSAIN_LENGTH_ALIAS_FLAG) when alias is active and packet->address
+ * matches it; otherwise the output equals fusain_encode_packet().
+ *
+ * @param packet Packet structure to encode
+ * @param alias Alias session, or NULL
+ * @param buffer Output buffer for encoded bytes
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or negative error code as
+ *         fusain_encode_packet()
+ */
+int fusain_encode_packet_alias(const fusain_packet_t* packet,
+    const fusain_alias_t* alias, uint8_t* buffer, size_t buffer_size);
+
+/**
+ * Encode several packets back-to-back into one contiguous buffer
+ *
+ * Each packet becomes a complete stuffed frame (same bytes as
+ * fusain_encode_packet()). If the buffer runs out, encoding stops before
+ * the first frame that does not fit and the frames already written remain
+ * valid, so the caller can send them and retry the rest.
+ *
+ * @param packets Array of packets to encode
+ * @param count Number of packets
+ * @param buffer Output buffer for encoded frames
+ * @param buffer_size Size of output buffer
+ * @param frame_offsets Optional output array (count entries) receiving the
+ *                      start offset of each encoded frame, or NULL
+ * @param encoded_count Output: number of packets fully encoded
+ * @return Total bytes written for the encoded frames, -1 on invalid
+ *         arguments, or -2 if packets[*encoded_count] has an invalid length
+ */
+int fusain_encode_packets(const fusain_packet_t* packets, size_t count,
+    uint8_t* buffer, size_t buffer_size, size_t* frame_offsets,
+    size_t* encoded_count);
+
+/**
+ * Prepare an encoded frame as a template for re-addressed copies
+ *
+ * For sending the same command to many devices: encode it once, then
+ * produce each device's frame with fusain_retarget_frame(). The CRC
+ * contribution of the payload is computed here once.
+ *
+ * @param retarget Retargeting state
+ * @param frame Stuffed frame from fusain_encode_packet(); must stay
+ *              unchanged while retarget is used
+ * @param frame_length Length of frame
+ * @return 0 on success, -1 invalid arguments, -2 malformed or
+ *         short-address frame, -3 CRC mismatch
+ */
+int fusain_retarget_init(fusain_retarget_t* retarget, const uint8_t* frame,
+    size_t frame_length);
+
+/**
+ * Write a copy of the template frame addressed to another device
+ *
+ * Output is byte-identical to encoding the packet for address. Only the
+ * address and CRC are stuffed anew; the stuffed payload is copied, and
+ * the CRC is derived from the template's through linearity.
+ *
+ * @param retarget State from fusain_retarget_init()
+ * @param address Destination address
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or -1 if the buffer is too small
+ */
+int fusain_retarget_frame(const fusain_retarget_t* retarget, uint64_t address,
+    uint8_t* buffer, size_t buffer_size);
+
+/**
+ * Encode a packet as a scatter-gather list without copying the payload
+ *
+ * Fills iov with segments that, concatenated, equal the output of
+ * fusain_encode_packet(). Escape-free runs of the CBOR payload point
+ * directly into packet->payload; START, LENGTH, stuffed address bytes,
+ * escape pairs, CRC and END are written to side_buffer. The segments
+ * map one-to-one onto struct iovec for writev()/sendmsg().
+ *
+ * The segments reference packet and side_buffer, so both must stay
+ * unchanged until the data has been sent.
+ *
+ * Sizing: FUSAIN_IOV_MAX_SEGMENTS and FUSAIN_IOV_SIDE_BUFFER_SIZE always
+ * suffice. An escape-free frame needs only 3 segments and 13 side bytes.
+ *
+ * @param packet Packet structure to encode
+ * @param iov Output segment array
+ * @param iov_size Capacity of iov in segments
+ * @param side_buffer Scratch storage for framing and stuffed bytes
+ * @param side_buffer_size Size of side_buffer
+ * @param total_length Optional output: total encoded frame length, or NULL
+ * @return Number of segments used, or negative error code
+ *         (-1 invalid arguments, -2 invalid payload length,
+ *          -3 iov too small, -4 side_buffer too small)
+ */
+int fusain_encode_packet_iov(const fusain_packet_t* packet, fusain_span_t* iov,
+    size_t iov_size, uint8_t* side_buffer, size_t side_buffer_size,
+    size_t* total_length);
+
 /**
  * Decode received bytes into a packet structure
  *
@@ -241,179 +727,573 @@ fusain_decode_result_t fusain_decode_byte(uint8_t rx_byte,
 /**
  * Reset decoder state
  *
+ * Initializes the decoder: byte stuffing, no alias session and no
+ * address filter. Call before the first byte.
+ *
  * @param decoder Decoder state to reset
  */
 void fusain_reset_decoder(fusain_decoder_t* decoder);
 
 /**
- * Create a STATE_COMMAND packet
+ * Resync a decoder after a decode error
  *
- * @param packet Output packet
- * @param address Device address
- * @param mode Operating mode
- * @param argument Mode-specific argument (RPM for FAN, pump rate for HEAT)
+ * Discards any partial frame so the decoder picks up at the next one.
+ * The link configuration (alias session, framing, address filter) is
+ * kept.
+ *
+ * @param decoder Decoder state
  */
-void fusain_create_state_command(fusain_packet_t* packet, uint64_t address,
-    fusain_mode_t mode, int32_t argument);
+void fusain_decoder_resync(fusain_decoder_t* decoder);
 
 /**
- * Create a PUMP_COMMAND packet
+ * Encode a packet with raw framing for a reliable transport
  *
- * @param packet Output packet
- * @param address Device address
- * @param pump Pump index (0-9, typically 0)
- * @param rate_ms Pulse interval in milliseconds (0=stop, >=100=run)
+ * Writes [LENGTH][ADDRESS(8)][CBOR_PAYLOAD] and, if with_crc, the CRC
+ * big-endian, with no START/END bytes and no escaping. Only for links
+ * that already guarantee integrity, ordering and framing of the byte
+ * stream (TCP, WebSocket, local IPC); both ends must agree on with_crc.
+ *
+ * @param packet Packet structure to encode
+ * @param with_crc Append the CRC-16 (for end-to-end checking across bridges)
+ * @param buffer Output buffer, FUSAIN_MAX_RAW_PACKET_SIZE always suffices
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or negative error code
+ *         (-1 invalid arguments or buffer too small,
+ *          -2 invalid payload length)
  */
-void fusain_create_pump_command(fusain_packet_t* packet, uint64_t address,
-    uint8_t pump, int32_t rate_ms);
+int fusain_encode_packet_raw(const fusain_packet_t* packet, bool with_crc,
+    uint8_t* buffer, size_t buffer_size);
 
 /**
- * Create a MOTOR_COMMAND packet
+ * Decode the next raw-framed packet from a receive buffer
  *
- * @param packet Output packet
- * @param address Device address
- * @param motor Motor index (0-9, typically 0)
- * @param rpm Target RPM (0=stop, 800-3400=run)
+ * Call with data + *consumed until FUSAIN_DECODE_INCOMPLETE, then keep
+ * the unconsumed tail for the next read. A CRC or CBOR error consumes
+ * only the bad frame. A LENGTH above FUSAIN_MAX_PAYLOAD_SIZE consumes the
+ * whole buffer: the stream cannot be resynchronized, so close it.
+ *
+ * @param data Received bytes
+ * @param length Number of bytes in data
+ * @param with_crc Frames carry a CRC-16
+ * @param packet Output packet structure
+ * @param consumed Output: bytes of data used (0 when incomplete)
+ * @return FUSAIN_DECODE_OK, FUSAIN_DECODE_INCOMPLETE if data ends inside
+ *         a frame, or FUSAIN_DECODE_INVALID_LENGTH / _INVALID_CRC /
+ *         _INVALID_START (payload is not a CBOR [msg_type, ...])
  */
-void fusain_create_motor_command(fusain_packet_t* packet, uint64_t address,
-    uint8_t motor, int32_t rpm);
+fusain_decode_result_t fusain_decode_packet_raw(const uint8_t* data,
+    size_t length, bool with_crc, fusain_packet_t* packet, size_t* consumed);
 
+#if FUSAIN_HAS_COBS
 /**
- * Create a GLOW_COMMAND packet
+ * Select the framing a decoder expects
  *
- * @param packet Output packet
- * @param address Device address
- * @param glow Glow plug index (0-9, typically 0)
- * @param duration Burn duration in milliseconds (0-300000)
+ * Decoders start in FUSAIN_FRAMING_STUFFED after fusain_reset_decoder(),
+ * and fusain_decoder_resync() keeps the framing. Switching discards any
+ * partial frame; the alias session is kept.
+ *
+ * @param decoder Decoder state
+ * @param framing fusain_framing_t
  */
-void fusain_create_glow_command(fusain_packet_t* packet, uint64_t address, uint8_t glow,
-    int32_t duration);
+void fusain_decoder_set_framing(fusain_decoder_t* decoder, uint8_t framing);
 
 /**
- * Create a TEMP_COMMAND packet
+ * Encode a packet with COBS framing
  *
- * @param packet Output packet
- * @param address Device address
- * @param thermometer Temperature controller index (0-9, typically 0)
- * @param type Command type (fusain_temp_cmd_type_t)
- * @param motor_index Motor to control (used with WATCH_MOTOR)
- * @param target_temp Target temperature in Celsius (used with SET_TARGET_TEMP)
+ * The frame carries the same LENGTH, ADDRESS, CBOR payload and CRC as
+ * fusain_encode_packet(), COBS-encoded so it contains no 0x00 byte, then
+ * a 0x00 delimiter. Unlike byte stuffing, the overhead does not depend on
+ * the payload: every frame is exactly 2 bytes longer than its contents,
+ * at most FUSAIN_MAX_COBS_PACKET_SIZE in total.
+ *
+ * @param packet Packet structure to encode
+ * @param buffer Output buffer for the encoded frame
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or negative error code
+ *         (-1 invalid arguments or buffer too small,
+ *          -2 invalid payload length)
  */
-void fusain_create_temp_command(fusain_packet_t* packet, uint64_t address,
-    uint8_t thermometer, fusain_temp_cmd_type_t type, uint8_t motor_index,
-    float target_temp);
+int fusain_encode_packet_cobs(const fusain_packet_t* packet, uint8_t* buffer,
+    size_t buffer_size);
 
 /**
- * Create a PING_REQUEST packet
+ * Decode one complete COBS frame
  *
- * @param packet Output packet
+ * For receivers that already split the stream at 0x00 delimiters (e.g.
+ * with memchr over a DMA buffer). Whole runs between zeros are copied
+ * with memcpy instead of being examined byte by byte.
+ *
+ * @param frame Frame bytes, without the 0x00 delimiter
+ * @param length Number of bytes in frame
+ * @param packet Output packet structure
+ * @return FUSAIN_DECODE_OK, FUSAIN_DECODE_INVALID_START for a malformed
+ *         COBS or CBOR frame, or FUSAIN_DECODE_INVALID_LENGTH /
+ *         FUSAIN_DECODE_INVALID_CRC
  */
-void fusain_create_ping_request(fusain_packet_t* packet, uint64_t address);
+fusain_decode_result_t fusain_decode_cobs_frame(const uint8_t* frame,
+    size_t length, fusain_packet_t* packet);
+#endif /* FUSAIN_HAS_COBS */
 
 /**
- * Create a TELEMETRY_CONFIG packet
+ * Let a decoder accept short-address frames
  *
- * @param packet Output packet
- * @param address Device address
- * @param enabled Telemetry broadcast enabled (0=disabled, 1=enabled)
- * @param interval_ms Telemetry broadcast interval (0=polling, 100-5000 ms)
+ * Short frames whose alias matches are returned with the session's full
+ * address, and a proposed session becomes active on the first one. Short
+ * frames are rejected with FUSAIN_DECODE_UNKNOWN_ALIAS otherwise.
+ * fusain_decoder_resync() keeps the session; fusain_reset_decoder()
+ * detaches it.
+ *
+ * @param decoder Decoder state
+ * @param alias Alias session, or NULL to accept full addresses only
  */
-void fusain_create_telemetry_config(fusain_packet_t* packet, uint64_t address, bool enabled,
-    uint32_t interval_ms);
+void fusain_decoder_set_alias(fusain_decoder_t* decoder, fusain_alias_t* alias);
 
 /**
- * Create a TIMEOUT_CONFIG packet
+ * Initialize an address filter for a device
  *
- * @param packet Output packet
- * @param address Device address
- * @param enabled Timeout enabled (0=disabled, 1=enabled)
- * @param timeout_ms Timeout interval in milliseconds (5000-60000)
+ * Accepts the device's own address and broadcast, and no groups.
+ *
+ * @param filter Address filter
+ * @param address This device's address
  */
-void fusain_create_timeout_config(fusain_packet_t* packet, uint64_t address, bool enabled,
-    uint32_t timeout_ms);
+void fusain_filter_init(fusain_address_filter_t* filter, uint64_t address);
 
 /**
- * Create a SEND_TELEMETRY packet (polling mode)
+ * Accept frames sent to a group
  *
- * @param packet Output packet
- * @param address Device address
- * @param telemetry_type Type (0=STATE, 1=MOTOR, 2=TEMP, 3=PUMP, 4=GLOW)
- * @param index Peripheral index or 0xFFFFFFFF for all
+ * @param filter Address filter
+ * @param group Group number (0 to FUSAIN_MAX_GROUPS - 1; others ignored)
  */
-void fusain_create_send_telemetry(fusain_packet_t* packet, uint64_t address,
-    uint32_t telemetry_type, uint32_t index);
+void fusain_filter_join(fusain_address_filter_t* filter, uint8_t group);
 
 /**
- * Create a MOTOR_CONFIG packet
+ * Stop accepting frames sent to a group
  *
- * @param packet Output packet
- * @param config Motor configuration parameters
+ * @param filter Address filter
+ * @param group Group number (0 to FUSAIN_MAX_GROUPS - 1; others ignored)
  */
-void fusain_create_motor_config(fusain_packet_t* packet, uint64_t address,
-    const fusain_cmd_motor_config_t* config);
+void fusain_filter_leave(fusain_address_filter_t* filter, uint8_t group);
 
 /**
- * Create a PUMP_CONFIG packet
+ * Check whether a frame address is meant for the filtering device
  *
- * @param packet Output packet
- * @param config Pump configuration parameters
+ * @param filter Address filter
+ * @param address Frame address
+ * @return true for the own address, broadcast and joined groups
  */
-void fusain_create_pump_config(fusain_packet_t* packet, uint64_t address,
-    const fusain_cmd_pump_config_t* config);
+bool fusain_filter_accepts(const fusain_address_filter_t* filter,
+    uint64_t address);
 
 /**
- * Create a TEMP_CONFIG packet
+ * Make a decoder drop frames for other devices
  *
- * @param packet Output packet
- * @param config Temperature configuration parameters
+ * Frames whose full address the filter does not accept end with
+ * FUSAIN_DECODE_NOT_ADDRESSED once the address is received; the rest of
+ * the frame is skipped. Short-address frames are not filtered, since an
+ * alias always names the peer of a point-to-point session.
+ * fusain_decoder_resync() keeps the filter; fusain_reset_decoder()
+ * removes it.
+ *
+ * @param decoder Decoder state
+ * @param filter Address filter, or NULL to accept every address
  */
-void fusain_create_temp_config(fusain_packet_t* packet, uint64_t address,
-    const fusain_cmd_temp_config_t* config);
+void fusain_decoder_set_filter(fusain_decoder_t* decoder,
+    const fusain_address_filter_t* filter);
 
 /**
- * Create a GLOW_CONFIG packet
+ * Record a proposed alias (controller side)
  *
- * @param packet Output packet
- * @param config Glow plug configuration parameters
+ * Call after sending ALIAS_CONFIG. Short frames are accepted right away;
+ * sending them waits for the appliance's first short frame.
+ *
+ * @param session Alias session
+ * @param address Appliance address
+ * @param alias Proposed alias
  */
-void fusain_create_glow_config(fusain_packet_t* packet, uint64_t address,
-    const fusain_cmd_glow_config_t* config);
+void fusain_alias_propose(fusain_alias_t* session, uint64_t address,
+    uint8_t alias);
 
 /**
- * Create a DATA_SUBSCRIPTION packet
+ * Accept a received ALIAS_CONFIG (appliance side)
  *
- * @param packet Output packet
- * @param address Device address
- * @param appliance_address Address of appliance to subscribe to
+ * @param session Alias session, active on success
+ * @param packet Received ALIAS_CONFIG packet (its address is ours)
+ * @return 0 on success, -1 if the packet is not a valid ALIAS_CONFIG
  */
-void fusain_create_data_subscription(fusain_packet_t* packet, uint64_t address,
-    uint64_t appliance_address);
+int fusain_alias_accept(fusain_alias_t* session, const fusain_packet_t* packet);
 
 /**
- * Create a DATA_UNSUBSCRIBE packet
+ * Drop an alias session (e.g. on rediscovery or link timeout)
  *
- * @param packet Output packet
- * @param appliance_address Address of appliance to unsubscribe from
+ * @param session Alias session
  */
-void fusain_create_data_unsubscribe(fusain_packet_t* packet, uint64_t address,
-    uint64_t appliance_address);
+void fusain_alias_reset(fusain_alias_t* session);
 
 /**
- * Create a DISCOVERY_REQUEST packet
+ * Extract the next frame from a received chunk without copying it
  *
- * @param packet Output packet
+ * Scans data for a START..END frame and unstuffs it in place (the
+ * unstuffed frame is never longer than the stuffed one), validates
+ * length and CRC, and fills view with pointers into data. Call again
+ * with data + *consumed until the chunk is exhausted.
+ *
+ * A frame that is cut off at the end of the chunk is copied into the
+ * extractor's carry buffer and completed from the next chunk; in that
+ * case view->payload points into the carry buffer instead.
+ *
+ * The view is valid until data is modified or the extractor is called
+ * again. Bytes of a returned frame in data are overwritten.
+ *
+ * @param extractor Extractor state (initialize with fusain_reset_extractor)
+ * @param data Received bytes (modified in place)
+ * @param length Number of bytes in data
+ * @param view Output frame view, filled on FUSAIN_DECODE_OK
+ * @param consumed Output: number of bytes of data processed
+ * @return FUSAIN_DECODE_OK when view holds a frame, FUSAIN_DECODE_INCOMPLETE
+ *         when data is exhausted, or an error for a dropped frame
  */
-void fusain_create_discovery_request(fusain_packet_t* packet, uint64_t address);
+fusain_decode_result_t fusain_extract_frame(fusain_extractor_t* extractor,
+    uint8_t* data, size_t length, fusain_frame_view_t* view,
+    size_t* consumed);
 
 /**
- * Create a STATE_DATA packet
+ * Extract the next frame, accepting short-address frames of a session
  *
- * @param packet Output packet
- * @param address Device address
- * @param error Error flag (0=no error, 1=error)
- * @param code Error code (fusain_error_t)
- * @param state Current state
- * @param timestamp Timestamp in milliseconds since boot
+ * As fusain_extract_frame(), which rejects every short frame with
+ * FUSAIN_DECODE_INVALID_LENGTH. Here short frames whose alias matches are
+ * returned with the session's full address, and a proposed session
+ * becomes active on the first one; other short frames end with
+ * FUSAIN_DECODE_UNKNOWN_ALIAS.
+ *
+ * @param extractor Extractor state
+ * @param alias Alias session, or NULL to accept full addresses only
+ * @param data Received bytes (modified in place)
+ * @param length Number of bytes in data
+ * @param view Output frame view, filled on FUSAIN_DECODE_OK
+ * @param consumed Output: number of bytes of data processed
+ * @return As fusain_extract_frame()
+ */
+fusain_decode_result_t fusain_extract_frame_alias(fusain_extractor_t* extractor,
+    fusain_alias_t* alias, uint8_t* data, size_t length, fusain_frame_view_t* view,
+    size_t* consumed);
+
+/**
+ * Reset frame extractor state, discarding any partial frame
+ *
+ * @param extractor Extractor state to reset
+ */
+void fusain_reset_extractor(fusain_extractor_t* extractor);
+
+/**
+ * Read one unsigned integer field from a packet without a full decode
+ *
+ * Walks the top-level CBOR map of packet->payload (after the [msg_type]
+ * header), skipping other entries, and decodes only the value stored
+ * under the integer key. Far cheaper than a zcbor struct decode when a
+ * single field (e.g. an alarm threshold check) is needed.
+ *
+ * @param packet Decoded packet
+ * @param key Integer map key (CDDL key number)
+ * @param value Output value
+ * @return 0 on success, -1 invalid arguments or malformed CBOR,
+ *         -2 key not present, -3 value has a different type or range
+ */
+int fusain_peek_uint(const fusain_packet_t* packet, uint32_t key,
+    uint64_t* value);
+
+/**
+ * Read one signed integer field from a packet without a full decode
+ *
+ * Accepts both CBOR unsigned and negative integers.
+ *
+ * @param packet Decoded packet
+ * @param key Integer map key (CDDL key number)
+ * @param value Output value
+ * @return 0 on success, or a negative error code as fusain_peek_uint()
+ */
+int fusain_peek_int(const fusain_packet_t* packet, uint32_t key,
+    int64_t* value);
+
+/**
+ * Read one floating-point field from a packet without a full decode
+ *
+ * Accepts half, single and double precision CBOR floats.
+ *
+ * @param packet Decoded packet
+ * @param key Integer map key (CDDL key number)
+ * @param value Output value
+ * @return 0 on success, or a negative error code as fusain_peek_uint()
+ */
+int fusain_peek_float(const fusain_packet_t* packet, uint32_t key,
+    double* value);
+
+/**
+ * Read one boolean field from a packet without a full decode
+ *
+ * @param packet Decoded packet
+ * @param key Integer map key (CDDL key number)
+ * @param value Output value
+ * @return 0 on success, or a negative error code as fusain_peek_uint()
+ */
+int fusain_peek_bool(const fusain_packet_t* packet, uint32_t key, bool* value);
+
+/**
+ * Re-encode payload floats in their shortest exact form
+ *
+ * Rewrites every float64 in the payload as float16 or float32 when that
+ * width holds the same value bit for bit (RFC 8949 preferred
+ * serialization). NaNs are left as float64 so their payload bits survive.
+ * Decoders accept all three widths. The create helpers call this on
+ * their own when CONFIG_FUSAIN_SHORTEST_FLOAT is enabled.
+ *
+ * @param packet Packet whose payload is rewritten in place
+ * @return Number of bytes saved, or -1 if the payload is not valid CBOR
+ *         (the packet is left unchanged)
+ */
+int fusain_compact_floats(fusain_packet_t* packet);
+
+/**
+ * Decode a TEMP_DATA packet in either reading form
+ *
+ * Accepts the float reading (key 2, any float width) and the fixed-point
+ * reading (FUSAIN_TEMP_DATA_KEY_CENTI). Optional fields that are absent
+ * are zeroed; the return value says which were present.
+ *
+ * @param packet TEMP_DATA packet
+ * @param data Output reading
+ * @return Mask of FUSAIN_TEMP_DATA_* optional fields present, or -1
+ *         (malformed or not TEMP_DATA), -2 (required key absent),
+ *         -3 (wrong type or range)
+ */
+int fusain_decode_temp_data(const fusain_packet_t* packet,
+    fusain_temp_data_t* data);
+
+/**
+ * Decode a TELEMETRY_BATCH packet
+ *
+ * Integer values stay integers and floats of any width become float.
+ *
+ * @param packet TELEMETRY_BATCH packet
+ * @param batch Output records
+ * @return 0 on success, or -1 (malformed or not TELEMETRY_BATCH),
+ *         -2 (required key absent), -3 (wrong type or range, or more
+ *         than FUSAIN_BATCH_MAX_RECORDS records or
+ *         FUSAIN_BATCH_MAX_VALUES values)
+ */
+int fusain_decode_telemetry_batch(const fusain_packet_t* packet,
+    fusain_telemetry_batch_t* batch);
+
+#if FUSAIN_HAS_FIXED_POINT
+/**
+ * Read a TEMP_DATA reading as centi-degrees without floating point
+ *
+ * Takes the fixed-point key when present, otherwise converts the float
+ * at key 2 with integer arithmetic (rounded half away from zero).
+ *
+ * @param packet TEMP_DATA packet
+ * @param centi Output temperature in 0.01 degrees Celsius
+ * @return 0 on success, or a negative error code as fusain_peek_uint()
+ *         (-3 also for NaN, infinity or values outside int32)
+ */
+int fusain_read_temp_centi(const fusain_packet_t* packet, int32_t* centi);
+#endif /* FUSAIN_HAS_FIXED_POINT */
+
+/* Command helpers accept FUSAIN_ADDRESS_BROADCAST and FUSAIN_ADDRESS_GROUP(n)
+ * as address, so one frame commands a whole fleet or group. Appliances act
+ * on such commands but must not answer them (FUSAIN_ADDRESS_IS_MULTICAST),
+ * or every device would reply at once on a shared bus. */
+
+#if FUSAIN_HAS_MSG_CONTROL
+/**
+ * Create a STATE_COMMAND packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param mode Operating mode
+ * @param argument Mode-specific argument (RPM for FAN, pump rate for HEAT)
+ */
+void fusain_create_state_command(fusain_packet_t* packet, uint64_t address,
+    fusain_mode_t mode, int32_t argument);
+
+/**
+ * Create a PUMP_COMMAND packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param pump Pump index (0-9, typically 0)
+ * @param rate_ms Pulse interval in milliseconds (0=stop, >=100=run)
+ */
+void fusain_create_pump_command(fusain_packet_t* packet, uint64_t address,
+    uint8_t pump, int32_t rate_ms);
+
+/**
+ * Create a MOTOR_COMMAND packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param motor Motor index (0-9, typically 0)
+ * @param rpm Target RPM (0=stop, 800-3400=run)
+ */
+void fusain_create_motor_command(fusain_packet_t* packet, uint64_t address,
+    uint8_t motor, int32_t rpm);
+
+/**
+ * Create a GLOW_COMMAND packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param glow Glow plug index (0-9, typically 0)
+ * @param duration Burn duration in milliseconds (0-300000)
+ */
+void fusain_create_glow_command(fusain_packet_t* packet, uint64_t address, uint8_t glow,
+    int32_t duration);
+
+/**
+ * Create a TEMP_COMMAND packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param thermometer Temperature controller index (0-9, typically 0)
+ * @param type Command type (fusain_temp_cmd_type_t)
+ * @param motor_index Motor to control (used with WATCH_MOTOR)
+ * @param target_temp Target temperature in Celsius (used with SET_TARGET_TEMP)
+ */
+void fusain_create_temp_command(fusain_packet_t* packet, uint64_t address,
+    uint8_t thermometer, fusain_temp_cmd_type_t type, uint8_t motor_index,
+    float target_temp);
+
+/**
+ * Create a PING_REQUEST packet
+ *
+ * @param packet Output packet
+ */
+void fusain_create_ping_request(fusain_packet_t* packet, uint64_t address);
+#endif /* FUSAIN_HAS_MSG_CONTROL */
+
+#if FUSAIN_HAS_MSG_CONFIG
+/**
+ * Create a TELEMETRY_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param enabled Telemetry broadcast enabled (0=disabled, 1=enabled)
+ * @param interval_ms Telemetry broadcast interval (0=polling, 100-5000 ms)
+ */
+void fusain_create_telemetry_config(fusain_packet_t* packet, uint64_t address, bool enabled,
+    uint32_t interval_ms);
+
+/**
+ * Create a TIMEOUT_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param enabled Timeout enabled (0=disabled, 1=enabled)
+ * @param timeout_ms Timeout interval in milliseconds (5000-60000)
+ */
+void fusain_create_timeout_config(fusain_packet_t* packet, uint64_t address, bool enabled,
+    uint32_t timeout_ms);
+#endif /* FUSAIN_HAS_MSG_CONFIG */
+
+#if FUSAIN_HAS_MSG_CONTROL
+/**
+ * Create a SEND_TELEMETRY packet (polling mode)
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param telemetry_type Type (0=STATE, 1=MOTOR, 2=TEMP, 3=PUMP, 4=GLOW)
+ * @param index Peripheral index or 0xFFFFFFFF for all
+ */
+void fusain_create_send_telemetry(fusain_packet_t* packet, uint64_t address,
+    uint32_t telemetry_type, uint32_t index);
+#endif /* FUSAIN_HAS_MSG_CONTROL */
+
+#if FUSAIN_HAS_MSG_CONFIG
+/**
+ * Create a MOTOR_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param config Motor configuration parameters
+ */
+void fusain_create_motor_config(fusain_packet_t* packet, uint64_t address,
+    const fusain_cmd_motor_config_t* config);
+
+/**
+ * Create a PUMP_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param config Pump configuration parameters
+ */
+void fusain_create_pump_config(fusain_packet_t* packet, uint64_t address,
+    const fusain_cmd_pump_config_t* config);
+
+/**
+ * Create a TEMP_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param config Temperature configuration parameters
+ */
+void fusain_create_temp_config(fusain_packet_t* packet, uint64_t address,
+    const fusain_cmd_temp_config_t* config);
+
+/**
+ * Create a GLOW_CONFIG packet
+ *
+ * @param packet Output packet
+ * @param config Glow plug configuration parameters
+ */
+void fusain_create_glow_config(fusain_packet_t* packet, uint64_t address,
+    const fusain_cmd_glow_config_t* config);
+
+/**
+ * Create a DATA_SUBSCRIPTION packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param appliance_address Address of appliance to subscribe to
+ */
+void fusain_create_data_subscription(fusain_packet_t* packet, uint64_t address,
+    uint64_t appliance_address);
+
+/**
+ * Create a DATA_UNSUBSCRIBE packet
+ *
+ * @param packet Output packet
+ * @param appliance_address Address of appliance to unsubscribe from
+ */
+void fusain_create_data_unsubscribe(fusain_packet_t* packet, uint64_t address,
+    uint64_t appliance_address);
+
+/**
+ * Create a DISCOVERY_REQUEST packet
+ *
+ * @param packet Output packet
+ */
+void fusain_create_discovery_request(fusain_packet_t* packet, uint64_t address);
+
+/**
+ * Create ALIAS_CONFIG packet
+ *
+ * Proposes a 1-byte session alias for the appliance's address; follow
+ * with fusain_alias_propose().
+ *
+ * @param packet Output packet
+ * @param address Appliance address
+ * @param alias Proposed alias
+ */
+void fusain_create_alias_config(fusain_packet_t* packet, uint64_t address,
+    uint8_t alias);
+#endif /* FUSAIN_HAS_MSG_CONFIG */
+
+#if FUSAIN_HAS_MSG_TELEMETRY
+/**
+ * Create a STATE_DATA packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param error Error flag (0=no error, 1=error)
+ * @param code Error code (fusain_error_t)
+ * @param state Current state
+ * @param timestamp Timestamp in milliseconds since boot
  */
 void fusain_create_state_data(fusain_packet_t* packet, uint64_t address,
     uint32_t error, uint8_t code, fusain_state_t state, uint32_t timestamp);
@@ -492,29 +1372,1488 @@ void fusain_create_temp_data(fusain_packet_t* packet, uint64_t address,
     uint8_t thermometer, uint32_t timestamp, float reading);
 
 /**
- * Create an ERROR_INVALID_CMD packet
+ * Create a MOTOR_DATA packet including selected optional fields
  *
  * @param packet Output packet
  * @param address Device address
- * @param error_code Error code (fusain_invalid_cmd_error_t)
- * @param rejected_field CBOR key of field that failed validation (-1 to omit)
- * @param constraint Constraint violation type (-1 to omit, or fusain_constraint_t)
+ * @param data Motor reading
+ * @param fields Mask of FUSAIN_MOTOR_DATA_* optional fields to include
  */
-void fusain_create_error_invalid_cmd(fusain_packet_t* packet, uint64_t address,
-    fusain_invalid_cmd_error_t error_code, int32_t rejected_field,
-    int32_t constraint);
+void fusain_create_motor_data_fields(fusain_packet_t* packet, uint64_t address,
+    const fusain_motor_data_t* data, uint8_t fields);
 
 /**
- * Create an ERROR_STATE_REJECT packet
+ * Create a TEMP_DATA packet including selected optional fields
  *
  * @param packet Output packet
  * @param address Device address
- * @param state Current state that rejected the command
- * @param rejection_reason Why the state rejected the command (-1 to omit,
- *                         or fusain_rejection_reason_t)
+ * @param data Temperature reading
+ * @param fields Mask of FUSAIN_TEMP_DATA_* optional fields to include
  */
-void fusain_create_error_state_reject(fusain_packet_t* packet, uint64_t address,
-    fusain_state_t state, int32_t rejection_reason);
+void fusain_create_temp_data_fields(fusain_packet_t* packet, uint64_t address,
+    const fusain_temp_data_t* data, uint8_t fields);
+
+/**
+ * Initialize (or reset) a MOTOR_DATA delta encoder
+ *
+ * The next frame after initialization is a full refresh. Re-initialize
+ * to force a refresh, e.g. when a new subscriber appears.
+ *
+ * @param delta Encoder state
+ * @param config Deadbands and refresh period
+ */
+void fusain_init_motor_delta(fusain_motor_delta_t* delta,
+    const fusain_motor_delta_config_t* config);
+
+/**
+ * Create a MOTOR_DATA packet carrying only changed optional fields
+ *
+ * rpm and target are always sent. max_rpm/min_rpm and pwm/pwm_max are
+ * included when they differ from the last value sent by more than
+ * rpm_deadband/pwm_deadband, and all of them on a full refresh.
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param delta Encoder state for this motor
+ * @param data Current motor reading
+ * @return Mask of FUSAIN_MOTOR_DATA_* optional fields included
+ */
+uint8_t fusain_create_motor_data_delta(fusain_packet_t* packet,
+    uint64_t address, fusain_motor_delta_t* delta,
+    const fusain_motor_data_t* data);
+
+/**
+ * Initialize (or reset) a TEMP_DATA delta encoder
+ *
+ * @param delta Encoder state
+ * @param config Deadband and refresh period
+ */
+void fusain_init_temp_delta(fusain_temp_delta_t* delta,
+    const fusain_temp_delta_config_t* config);
+
+/**
+ * Create a TEMP_DATA packet carrying only changed optional fields
+ *
+ * reading is always sent. rpm_control and watched_motor are included on
+ * any change, target_temp when it moves by more than target_deadband,
+ * and all of them on a full refresh.
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param delta Encoder state for this thermometer
+ * @param data Current temperature reading
+ * @return Mask of FUSAIN_TEMP_DATA_* optional fields included
+ */
+uint8_t fusain_create_temp_data_delta(fusain_packet_t* packet,
+    uint64_t address, fusain_temp_delta_t* delta,
+    const fusain_temp_data_t* data);
+
+#if FUSAIN_HAS_FIXED_POINT
+/**
+ * Create a TEMP_DATA packet with a fixed-point reading
+ *
+ * Integer-only: the reading goes out as centi-degrees under
+ * FUSAIN_TEMP_DATA_KEY_CENTI instead of a float at key 2, so no
+ * soft-float code is linked. Controllers read either form with
+ * fusain_decode_temp_data().
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param thermometer Thermometer index
+ * @param timestamp Timestamp in milliseconds
+ * @param centi Temperature in 0.01 degrees Celsius
+ */
+void fusain_create_temp_data_centi(fusain_packet_t* packet, uint64_t address,
+    uint8_t thermometer, uint32_t timestamp, int32_t centi);
+#endif /* FUSAIN_HAS_FIXED_POINT */
+
+/**
+ * Start a TELEMETRY_BATCH packet
+ *
+ * @param builder Builder state
+ * @param packet Output packet, valid once fusain_batch_finish() returns
+ * @param address Device address
+ * @param base_timestamp Timestamp that record offsets are relative to
+ */
+void fusain_batch_begin(fusain_batch_builder_t* builder,
+    fusain_packet_t* packet, uint64_t address, uint32_t base_timestamp);
+
+/**
+ * Append a record to a batch
+ *
+ * On -1 the packet is unchanged: finish it, send it, and begin a new
+ * batch with the pending record.
+ *
+ * @param builder Builder state
+ * @param record Record to append
+ * @return 0 on success, -1 if the batch is full or finished,
+ *         -3 if the record has more than FUSAIN_BATCH_MAX_VALUES values
+ */
+int fusain_batch_add(fusain_batch_builder_t* builder,
+    const fusain_batch_record_t* record);
+
+/**
+ * Append a motor reading (rpm, target) to a batch
+ *
+ * @param builder Builder state
+ * @param data Motor reading; optional fields are not batched
+ * @return As fusain_batch_add(), plus -3 if the timestamp is more than
+ *         65535 ms after the batch base
+ */
+int fusain_batch_add_motor(fusain_batch_builder_t* builder,
+    const fusain_motor_data_t* data);
+
+/**
+ * Append a temperature reading to a batch
+ *
+ * @param builder Builder state
+ * @param data Temperature reading; optional fields are not batched
+ * @return As fusain_batch_add_motor()
+ */
+int fusain_batch_add_temp(fusain_batch_builder_t* builder,
+    const fusain_temp_data_t* data);
+
+/**
+ * Close a batch so the packet can be encoded
+ *
+ * @param builder Builder state
+ * @return Number of records in the batch
+ */
+int fusain_batch_finish(fusain_batch_builder_t* builder);
+
+/**
+ * Create a TELEMETRY_BATCH packet from a record array
+ *
+ * @param packet Output packet (length 0 on failure)
+ * @param address Device address
+ * @param batch Records to send
+ * @return 0 on success, or a negative error code as fusain_batch_add()
+ */
+int fusain_create_telemetry_batch(fusain_packet_t* packet, uint64_t address,
+    const fusain_telemetry_batch_t* batch);
+#endif /* FUSAIN_HAS_MSG_TELEMETRY */
+
+#if FUSAIN_HAS_MSG_ERROR
+/**
+ * Create an ERROR_INVALID_CMD packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param error_code Error code (fusain_invalid_cmd_error_t)
+ * @param rejected_field CBOR key of field that failed validation (-1 to omit)
+ * @param constraint Constraint violation type (-1 to omit, or fusain_constraint_t)
+ */
+void fusain_create_error_invalid_cmd(fusain_packet_t* packet, uint64_t address,
+    fusain_invalid_cmd_error_t error_code, int32_t rejected_field,
+    int32_t constraint);
+
+/**
+ * Create an ERROR_STATE_REJECT packet
+ *
+ * @param packet Output packet
+ * @param address Device address
+ * @param state Current state that rejected the command
+ * @param rejection_reason Why the state rejected the command (-1 to omit,
+ *                         or fusain_rejection_reason_t)
+ */
+void fusain_create_error_state_reject(fusain_packet_t* packet, uint64_t address,
+    fusain_state_t state, int32_t rejection_reason);
+#endif /* FUSAIN_HAS_MSG_ERROR */
+
+/* Controller Polling Scheduler
+ *
+ * Polls appliances with SEND_TELEMETRY when telemetry broadcasts are off.
+ * Picks the earliest-deadline target, learns each appliance's response
+ * latency, and on half-duplex buses overlaps requests with the idle gaps
+ * before responses without letting two transmissions collide. Standalone
+ * builds always include it; Zephyr builds need CONFIG_FUSAIN_POLL.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_POLL)
+
+#ifndef FUSAIN_POLL_MAX_TARGETS
+#define FUSAIN_POLL_MAX_TARGETS 64
+#endif
+/* Target counts and heap slots are uint8_t; slot 0xFF is FUSAIN_POLL_IN_FLIGHT */
+#if FUSAIN_POLL_MAX_TARGETS < 1 || FUSAIN_POLL_MAX_TARGETS > 255
+#error "FUSAIN_POLL_MAX_TARGETS must be between 1 and 255"
+#endif
+#define FUSAIN_POLL_MAX_IN_FLIGHT 8
+
+/* Polling Scheduler Configuration */
+typedef struct {
+  uint32_t baud_rate; // Bus bit rate (10 bits per byte on the wire)
+  uint8_t max_in_flight; // Outstanding requests (1 = wait for each response)
+  uint32_t guard_us; // Idle time kept between two transmissions
+  uint32_t initial_turnaround_us; // Assumed response delay before the first sample
+  uint32_t min_timeout_us; // Response timeout bounds (after the request ends)
+  uint32_t max_timeout_us;
+} fusain_poll_config_t;
+
+/* Per-Appliance Polling State */
+typedef struct {
+  uint64_t address;
+  uint64_t deadline_us; // Next poll due
+  uint32_t period_us; // Poll interval
+  uint32_t turnaround_us; // Smoothed request end to response start
+  uint32_t turnaround_var_us; // Smoothed turnaround deviation
+  uint32_t response_air_us; // Airtime of the last response
+  uint32_t polls;
+  uint32_t responses;
+  uint32_t timeouts;
+  uint8_t telemetry_type; // SEND_TELEMETRY type (0=STATE ... 4=GLOW)
+  uint8_t heap_slot; // Position in the ready heap (FUSAIN_POLL_IN_FLIGHT if polled)
+} fusain_poll_target_t;
+
+#define FUSAIN_POLL_IN_FLIGHT 0xFF
+
+/* Outstanding Poll */
+typedef struct {
+  uint8_t target; // Index into targets
+  uint64_t sent_us; // Request end
+  uint64_t rx_start_us; // Earliest expected response start
+  uint64_t rx_end_us; // Latest expected response end
+  uint64_t timeout_us;
+} fusain_poll_flight_t;
+
+/* Polling Scheduler State */
+typedef struct {
+  fusain_poll_config_t config;
+  fusain_poll_target_t targets[FUSAIN_POLL_MAX_TARGETS];
+  uint8_t target_count;
+  uint8_t heap[FUSAIN_POLL_MAX_TARGETS]; // Idle targets, min-heap on deadline
+  uint8_t heap_size;
+  fusain_poll_flight_t flights[FUSAIN_POLL_MAX_IN_FLIGHT];
+  uint8_t in_flight;
+  uint64_t tx_free_us; // End of our last transmission plus guard
+} fusain_poll_scheduler_t;
+
+/**
+ * Initialize a polling scheduler
+ *
+ * @param scheduler Scheduler state
+ * @param config Bus parameters (copied); max_in_flight is clamped to
+ *               1..FUSAIN_POLL_MAX_IN_FLIGHT
+ */
+void fusain_poll_init(fusain_poll_scheduler_t* scheduler,
+    const fusain_poll_config_t* config);
+
+/**
+ * Start polling an appliance
+ *
+ * @param scheduler Scheduler state
+ * @param address Appliance address
+ * @param telemetry_type SEND_TELEMETRY type to request
+ * @param period_us Poll interval
+ * @param now_us Current time; the first poll is due immediately
+ * @return Target index, -1 invalid arguments or address already polled,
+ *         -2 no room (FUSAIN_POLL_MAX_TARGETS)
+ */
+int fusain_poll_add(fusain_poll_scheduler_t* scheduler, uint64_t address,
+    uint8_t telemetry_type, uint32_t period_us, uint64_t now_us);
+
+/**
+ * Stop polling an appliance (an outstanding poll is forgotten)
+ *
+ * @param scheduler Scheduler state
+ * @param address Appliance address
+ * @return 0 on success, -1 if the address is not polled
+ */
+int fusain_poll_remove(fusain_poll_scheduler_t* scheduler, uint64_t address);
+
+/**
+ * Get the next poll to send, if the bus allows one now
+ *
+ * Expires overdue polls, then takes the target with the earliest deadline
+ * if it is due and its request and expected response fit between the
+ * transmissions already on the bus. The packet must be sent at now_us.
+ *
+ * @param scheduler Scheduler state
+ * @param now_us Current time
+ * @param packet Output SEND_TELEMETRY packet (scratch unless 1 is returned)
+ * @param wake_us Output: when to call again if no response arrives first
+ *                (UINT64_MAX when nothing is scheduled)
+ * @return 1 if packet should be sent now, 0 otherwise
+ */
+int fusain_poll_next(fusain_poll_scheduler_t* scheduler, uint64_t now_us,
+    fusain_packet_t* packet, uint64_t* wake_us);
+
+/**
+ * Report a received packet to the scheduler
+ *
+ * Completes the outstanding poll of the sender and updates its latency
+ * estimate. Call with the time the frame's last byte arrived.
+ *
+ * @param scheduler Scheduler state
+ * @param packet Received packet
+ * @param now_us Reception time
+ * @return 0 if it answered a poll, -1 if no poll was outstanding for it
+ */
+int fusain_poll_response(fusain_poll_scheduler_t* scheduler,
+    const fusain_packet_t* packet, uint64_t now_us);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_POLL */
+
+/* Request/Response Correlation
+ *
+ * Matches appliance responses to the controller requests that caused them,
+ * retries requests that go unanswered and reports the outcome through one
+ * callback. At most one request per (address, family) is outstanding:
+ *   PING       PING_REQUEST -> PING_RESPONSE
+ *   DISCOVERY  DISCOVERY_REQUEST -> DEVICE_ANNOUNCE
+ *   TELEMETRY  SEND_TELEMETRY -> any telemetry data
+ *   COMMAND    other config/control commands -> STATE_DATA, or an ERROR_*
+ *              rejection
+ * Entries live in a caller-provided array and are found through hash chains
+ * threaded through the same array, so tracking, matching and expiry are
+ * O(1) without allocation. Standalone builds always include it; Zephyr
+ * builds need CONFIG_FUSAIN_CORRELATE.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_CORRELATE)
+
+#define FUSAIN_CORRELATE_NONE UINT32_MAX
+
+/* Request Families */
+typedef enum {
+  FUSAIN_CORRELATE_COMMAND = 0,
+  FUSAIN_CORRELATE_TELEMETRY = 1,
+  FUSAIN_CORRELATE_PING = 2,
+  FUSAIN_CORRELATE_DISCOVERY = 3,
+} fusain_correlate_family_t;
+
+/* Callback Events */
+typedef enum {
+  FUSAIN_CORRELATE_RESPONSE = 0, // Answered; response is the reply
+  FUSAIN_CORRELATE_REJECTED = 1, // Answered with ERROR_*; response is the error
+  FUSAIN_CORRELATE_RETRY = 2, // Unanswered; send the request again now
+  FUSAIN_CORRELATE_TIMEOUT = 3, // Unanswered after every retry; entry released
+} fusain_correlate_event_t;
+
+/* Outstanding Request (one slot of the caller-provided table) */
+typedef struct {
+  uint64_t address;
+  uint64_t deadline_us; // When the current attempt times out
+  void* user; // Caller context passed back in callbacks
+  uint32_t bucket; // Head of the hash chain for this slot's bucket
+  uint32_t chain; // Next entry in the same hash chain (or free list)
+  uint32_t older; // Deadline list neighbours
+  uint32_t newer;
+  uint8_t msg_type; // Request message type
+  uint8_t family; // fusain_correlate_family_t
+  uint8_t retries_left;
+  uint8_t in_use;
+} fusain_correlation_t;
+
+/**
+ * Correlation callback
+ *
+ * For RESPONSE, REJECTED and TIMEOUT the entry has already been released
+ * and points to a copy, so the callback may track a new request for the
+ * same key. For RETRY the entry stays outstanding with a new deadline.
+ *
+ * @param event What happened
+ * @param entry The request (address, msg_type, user context)
+ * @param response Received packet, NULL for RETRY and TIMEOUT
+ */
+typedef void (*fusain_correlate_cb_t)(fusain_correlate_event_t event,
+    const fusain_correlation_t* entry, const fusain_packet_t* response);
+
+/* Correlator State */
+typedef struct {
+  fusain_correlation_t* slots;
+  uint32_t capacity;
+  uint32_t count;
+  uint32_t mask; // capacity - 1
+  uint32_t free_head;
+  uint32_t oldest; // Earliest deadline
+  uint32_t newest;
+  uint32_t timeout_us; // Per attempt
+  uint8_t retries; // Attempts after the first
+  fusain_correlate_cb_t callback;
+} fusain_correlator_t;
+
+/**
+ * Initialize a correlator over a caller-provided table
+ *
+ * Every attempt waits the same timeout, so deadlines expire in the order
+ * they were set and expiry is a walk from the oldest entry.
+ *
+ * @param correlator Correlator state
+ * @param slots Table storage (capacity entries)
+ * @param capacity Table size, a power of two
+ * @param timeout_us Wait per attempt (nonzero)
+ * @param retries Resends before an entry times out
+ * @param callback Outcome callback
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_correlator_init(fusain_correlator_t* correlator,
+    fusain_correlation_t* slots, uint32_t capacity, uint32_t timeout_us,
+    uint8_t retries, fusain_correlate_cb_t callback);
+
+/**
+ * Track a request that is being sent
+ *
+ * @param correlator Correlator state
+ * @param request Request packet (a command, SEND_TELEMETRY, PING_REQUEST or
+ *                DISCOVERY_REQUEST to a single device)
+ * @param user Context passed back in callbacks
+ * @param now_us Send time
+ * @return 0 on success, -1 not a trackable request (or multicast address),
+ *         -2 a request of the same family is outstanding for the address,
+ *         -3 table full
+ */
+int fusain_correlator_track(fusain_correlator_t* correlator,
+    const fusain_packet_t* request, void* user, uint64_t now_us);
+
+/**
+ * Match a received packet against outstanding requests
+ *
+ * Fires RESPONSE or REJECTED and releases the entry. STATE_DATA and errors
+ * complete an outstanding command before an outstanding SEND_TELEMETRY.
+ *
+ * @param correlator Correlator state
+ * @param packet Received packet
+ * @return 0 if it completed a request, -1 if it answered nothing
+ */
+int fusain_correlator_match(fusain_correlator_t* correlator,
+    const fusain_packet_t* packet);
+
+/**
+ * Stop tracking a request without a callback
+ *
+ * @param correlator Correlator state
+ * @param address Device address
+ * @param msg_type Request message type (selects the family)
+ * @return 0 on success, -1 if nothing was outstanding
+ */
+int fusain_correlator_cancel(fusain_correlator_t* correlator, uint64_t address,
+    uint8_t msg_type);
+
+/**
+ * Expire overdue requests
+ *
+ * Fires RETRY (and re-arms) or TIMEOUT for every entry whose deadline is at
+ * or before now_us.
+ *
+ * @param correlator Correlator state
+ * @param now_us Current time
+ * @return Next deadline, or UINT64_MAX when nothing is outstanding
+ */
+uint64_t fusain_correlator_poll(fusain_correlator_t* correlator, uint64_t now_us);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_CORRELATE */
+
+/* Hierarchical Timer Wheel
+ *
+ * Schedules heartbeats, TIMEOUT_CONFIG expiry and retry deadlines for many
+ * devices. Timers are embedded in the caller's per-device state and linked
+ * into one of FUSAIN_WHEEL_LEVELS levels of 2^FUSAIN_WHEEL_BITS slots, so
+ * start and cancel are O(1). The wheel only moves when the caller advances
+ * it with its own tick count (k_uptime_get(), CLOCK_MONOTONIC, ...).
+ * Standalone builds always include it; Zephyr builds need
+ * CONFIG_FUSAIN_TIMER_WHEEL.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_TIMER_WHEEL)
+
+#define FUSAIN_WHEEL_BITS 6
+#define FUSAIN_WHEEL_SLOTS (1U << FUSAIN_WHEEL_BITS)
+#define FUSAIN_WHEEL_LEVELS 4
+/* Longer delays are parked at the top level and re-placed as time passes */
+#define FUSAIN_WHEEL_RANGE (1UL << (FUSAIN_WHEEL_BITS * FUSAIN_WHEEL_LEVELS))
+
+typedef struct fusain_timer fusain_timer_t;
+
+/**
+ * Timer callback
+ *
+ * Runs from fusain_wheel_advance(). It may start or cancel any timer,
+ * including its own (a heartbeat restarts itself here).
+ *
+ * @param timer Expired timer (no longer pending)
+ * @param user Context given to fusain_timer_init()
+ */
+typedef void (*fusain_timer_cb_t)(fusain_timer_t* timer, void* user);
+
+/* Timer (embed in per-device state) */
+struct fusain_timer {
+  fusain_timer_t* next;
+  fusain_timer_t** pprev; // NULL when not pending
+  uint32_t expires; // Absolute tick
+  fusain_timer_cb_t callback;
+  void* user;
+};
+
+/* Timer Wheel State */
+typedef struct {
+  fusain_timer_t* slots[FUSAIN_WHEEL_LEVELS][FUSAIN_WHEEL_SLOTS];
+  uint32_t tick; // Last tick processed
+  uint32_t pending; // Timers started and not yet fired or cancelled
+  uint32_t rng; // Jitter state
+} fusain_wheel_t;
+
+/**
+ * Initialize a timer wheel
+ *
+ * @param wheel Wheel state
+ * @param now_tick Current tick (treated as already processed)
+ * @param seed Jitter seed (e.g. a device address or boot counter)
+ */
+void fusain_wheel_init(fusain_wheel_t* wheel, uint32_t now_tick, uint32_t seed);
+
+/**
+ * Initialize a timer before first use
+ *
+ * @param timer Timer
+ * @param callback Expiry callback
+ * @param user Context passed to the callback
+ */
+void fusain_timer_init(fusain_timer_t* timer, fusain_timer_cb_t callback,
+    void* user);
+
+/**
+ * Start (or restart) a timer
+ *
+ * The timer fires delay_ticks after the last processed tick, plus a
+ * uniform random 0..jitter_ticks. Heartbeats started together with some
+ * jitter spread out instead of pinging every appliance in the same tick.
+ * A delay of 0 fires on the next tick.
+ *
+ * @param wheel Wheel state
+ * @param timer Timer (pending timers are moved)
+ * @param delay_ticks Delay
+ * @param jitter_ticks Maximum random extra delay (0 for none)
+ */
+void fusain_timer_start(fusain_wheel_t* wheel, fusain_timer_t* timer,
+    uint32_t delay_ticks, uint32_t jitter_ticks);
+
+/**
+ * Cancel a timer
+ *
+ * @param wheel Wheel state
+ * @param timer Timer
+ * @return 0 if it was pending, -1 if it was not
+ */
+int fusain_timer_cancel(fusain_wheel_t* wheel, fusain_timer_t* timer);
+
+/**
+ * Check whether a timer is pending
+ *
+ * @param timer Timer
+ * @return true if started and not yet fired or cancelled
+ */
+bool fusain_timer_pending(const fusain_timer_t* timer);
+
+/**
+ * Advance the wheel and run expired timers
+ *
+ * Processes every tick up to and including now_tick. Call at least once
+ * per tick, or use fusain_wheel_next() to sleep until work is due.
+ *
+ * @param wheel Wheel state
+ * @param now_tick Current tick
+ * @return Number of timers fired
+ */
+uint32_t fusain_wheel_advance(fusain_wheel_t* wheel, uint32_t now_tick);
+
+/**
+ * Ticks until the wheel next needs advancing
+ *
+ * May be earlier than the next expiry when a higher level has to be
+ * re-sorted; advancing then fires nothing and this gives a later answer.
+ *
+ * @param wheel Wheel state
+ * @return Ticks after the last processed tick, UINT32_MAX if no timer is pending
+ */
+uint32_t fusain_wheel_next(const fusain_wheel_t* wheel);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_TIMER_WHEEL */
+
+/* Device Shadow
+ *
+ * Latest telemetry and capabilities per appliance, for readers that only
+ * want the current value ("last TEMP_DATA of heater X, thermometer 0").
+ * One thread (the decoder path) feeds received packets in; any number of
+ * threads read without locks. Each device is guarded by a seqlock in its
+ * latch form: the record is kept twice, the sequence tells readers which
+ * copy the writer is not touching, and a reader retries only if the
+ * sequence moved while it copied. Readers never wait for the writer, so a
+ * high-priority reader cannot spin on a preempted writer. Devices are
+ * found by open addressing in a caller-provided power-of-two table and
+ * are never removed, so lookups need no lock either. Standalone builds
+ * always include it; Zephyr builds need CONFIG_FUSAIN_SHADOW.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_SHADOW)
+
+#ifdef CONFIG_FUSAIN_SHADOW_MAX_PERIPHERALS
+#define FUSAIN_SHADOW_MAX_PERIPHERALS CONFIG_FUSAIN_SHADOW_MAX_PERIPHERALS
+#elif !defined(FUSAIN_SHADOW_MAX_PERIPHERALS)
+#define FUSAIN_SHADOW_MAX_PERIPHERALS 4 // Per kind (motors, pumps, glow plugs, thermometers)
+#endif
+
+/* Shadowed Readings */
+typedef struct {
+  bool error;
+  uint8_t code; // fusain_error_t
+  uint8_t state; // fusain_state_t
+  uint32_t timestamp;
+} fusain_state_data_t;
+
+typedef struct {
+  uint8_t pump;
+  uint32_t timestamp;
+  uint8_t event; // fusain_pump_event_t
+  int32_t rate; // Last rate reported (kept when an event omits it)
+} fusain_pump_data_t;
+
+typedef struct {
+  uint8_t glow;
+  uint32_t timestamp;
+  bool lit;
+} fusain_glow_data_t;
+
+typedef struct {
+  uint8_t motor_count;
+  uint8_t thermometer_count;
+  uint8_t pump_count;
+  uint8_t glow_count;
+} fusain_device_caps_t;
+
+/* Presence bits of fusain_shadow_record_t.present */
+#define FUSAIN_SHADOW_HAS_STATE (1u << 0)
+#define FUSAIN_SHADOW_HAS_CAPS (1u << 1)
+#define FUSAIN_SHADOW_RESTORED (1u << 7) // From a persistent image; cleared by the next update
+
+/* Shadowed State of One Device */
+typedef struct {
+  uint32_t updated_ms; // Writer's clock at the last update
+  uint8_t present; // FUSAIN_SHADOW_HAS_* bits
+  uint8_t motor_mask; // Bit n set once motor n has reported
+  uint8_t pump_mask;
+  uint8_t glow_mask;
+  uint8_t temp_mask;
+  fusain_device_caps_t caps;
+  fusain_state_data_t state;
+  fusain_motor_data_t motors[FUSAIN_SHADOW_MAX_PERIPHERALS];
+  fusain_pump_data_t pumps[FUSAIN_SHADOW_MAX_PERIPHERALS];
+  fusain_glow_data_t glows[FUSAIN_SHADOW_MAX_PERIPHERALS];
+  fusain_temp_data_t temps[FUSAIN_SHADOW_MAX_PERIPHERALS];
+} fusain_shadow_record_t;
+
+/* Table Entry */
+typedef struct {
+  uint32_t seq; // Readers use copies[seq & 1]; bumped twice per update
+  uint8_t in_use; // Set once the address is published
+  uint32_t sum[2]; // Checksum of each copy (persistent images only)
+  uint64_t address;
+  fusain_shadow_record_t copies[2];
+} fusain_shadow_device_t;
+
+/* Shadow State */
+typedef struct {
+  fusain_shadow_device_t* devices;
+  uint32_t mask; // capacity - 1
+  uint32_t count;
+  bool persistent; // Keep sum[] current (set by fusain_shadow_attach)
+} fusain_shadow_t;
+
+/* Persistent Image Header
+ *
+ * A persistent image is this header followed by the device table, in the
+ * host's native layout. entry_size changes with
+ * FUSAIN_SHADOW_MAX_PERIPHERALS and the compiler's struct layout, so an
+ * image written by a different build is reformatted rather than misread.
+ */
+#define FUSAIN_SHADOW_IMAGE_MAGIC 0x44485346u // "FSHD" in little-endian memory
+#define FUSAIN_SHADOW_IMAGE_VERSION 1
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t entry_size; // sizeof(fusain_shadow_device_t)
+  uint32_t capacity;
+  uint16_t reserved;
+  uint16_t crc; // fusain_crc16() of the fields above
+} fusain_shadow_image_t;
+
+/**
+ * Initialize a shadow over a caller-provided table
+ *
+ * @param shadow Shadow state
+ * @param devices Table storage (capacity entries)
+ * @param capacity Table size, a power of two; keep it above the device
+ *                 count so probes stay short
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_shadow_init(fusain_shadow_t* shadow, fusain_shadow_device_t* devices,
+    uint32_t capacity);
+
+/**
+ * Bytes needed for a persistent image of capacity devices
+ *
+ * @param capacity Table size, a power of two
+ * @return Image size in bytes
+ */
+size_t fusain_shadow_image_size(uint32_t capacity);
+
+/**
+ * Initialize a shadow over a persistent image
+ *
+ * The image is the live table: updates go straight into it, so a region
+ * that survives a restart (a memory-mapped file, retained RAM) keeps the
+ * last known state without a separate save step. On attach every device
+ * is checked against its checksums and falls back to the other copy when
+ * the current one is damaged; a device with neither copy intact keeps its
+ * address but loses its readings. Restored devices carry
+ * FUSAIN_SHADOW_RESTORED until their next update. An image with a
+ * missing or foreign header is formatted empty. Call before any reader
+ * starts.
+ *
+ * @param shadow Shadow state
+ * @param image Image storage, 8-byte aligned
+ * @param size Bytes available at image
+ * @param capacity Table size, a power of two; an image of another
+ *                 capacity is formatted
+ * @return Devices whose readings were restored (0 for a new image), -1
+ *         invalid arguments
+ */
+int fusain_shadow_attach(fusain_shadow_t* shadow, void* image, size_t size,
+    uint32_t capacity);
+
+/**
+ * List devices not heard from since they were restored (lock-free)
+ *
+ * Use it to revalidate a restored image in the background, e.g. by
+ * sending DISCOVERY_REQUEST or PING_REQUEST to each listed device.
+ *
+ * @param shadow Shadow state
+ * @param addresses Output addresses (may be NULL when max is 0)
+ * @param max Capacity of addresses
+ * @return Number of such devices (may exceed max; only max are written)
+ */
+uint32_t fusain_shadow_restored(const fusain_shadow_t* shadow, uint64_t* addresses,
+    uint32_t max);
+
+/**
+ * Apply a received packet (single writer)
+ *
+ * Handles STATE/MOTOR/PUMP/GLOW/TEMP_DATA, DEVICE_ANNOUNCE and the records
+ * of TELEMETRY_BATCH. Optional fields a packet leaves out keep their last
+ * value, matching delta-encoded telemetry.
+ *
+ * @param shadow Shadow state
+ * @param packet Decoded packet
+ * @param now_ms Writer's clock, stored as the update time
+ * @return 0 updated, 1 not a shadowed message type, -1 malformed payload
+ *         (including batch values that do not fit their field, e.g. a NaN
+ *         rpm), -2 table full, -3 peripheral index >=
+ *         FUSAIN_SHADOW_MAX_PERIPHERALS
+ */
+int fusain_shadow_update(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms);
+
+/**
+ * Read STATE_DATA (lock-free)
+ *
+ * The read functions may run on any thread, concurrently with
+ * fusain_shadow_update(), and always return a value that was written as a
+ * whole.
+ *
+ * @param shadow Shadow state
+ * @param address Device address
+ * @param data Output reading
+ * @return 0 on success, -1 unknown device, -2 not reported yet
+ */
+int fusain_shadow_read_state(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_state_data_t* data);
+
+/**
+ * Read DEVICE_ANNOUNCE capabilities (lock-free)
+ *
+ * @return As fusain_shadow_read_state()
+ */
+int fusain_shadow_read_caps(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_device_caps_t* caps);
+
+/**
+ * Read the last MOTOR_DATA of one motor (lock-free)
+ *
+ * @param shadow Shadow state
+ * @param address Device address
+ * @param index Motor index
+ * @param data Output reading
+ * @return As fusain_shadow_read_state()
+ */
+int fusain_shadow_read_motor(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_motor_data_t* data);
+
+/**
+ * Read the last PUMP_DATA of one pump (lock-free)
+ *
+ * @return As fusain_shadow_read_state()
+ */
+int fusain_shadow_read_pump(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_pump_data_t* data);
+
+/**
+ * Read the last GLOW_DATA of one glow plug (lock-free)
+ *
+ * @return As fusain_shadow_read_state()
+ */
+int fusain_shadow_read_glow(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_glow_data_t* data);
+
+/**
+ * Read the last TEMP_DATA of one thermometer (lock-free)
+ *
+ * @return As fusain_shadow_read_state()
+ */
+int fusain_shadow_read_temp(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_temp_data_t* data);
+
+/**
+ * Copy everything known about a device (lock-free)
+ *
+ * @param shadow Shadow state
+ * @param address Device address
+ * @param record Output record (consistent as of one update)
+ * @return 0 on success, -1 unknown device
+ */
+int fusain_shadow_snapshot(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_shadow_record_t* record);
+
+#ifndef CONFIG_FUSAIN
+/* Memory-Mapped Shadow File (standalone builds on POSIX hosts) */
+typedef struct {
+  void* image;
+  size_t size;
+  int fd;
+} fusain_shadow_file_t;
+
+/**
+ * Open (or create) a shadow file and attach a shadow to its mapping
+ *
+ * The file is sized to fusain_shadow_image_size(capacity) and mapped
+ * shared, so every update reaches the page cache at once and survives a
+ * crash of the process; fusain_shadow_sync() pushes it to storage.
+ *
+ * @param shadow Shadow state
+ * @param file Output file handle
+ * @param path File path
+ * @param capacity Table size, a power of two
+ * @return As fusain_shadow_attach(), or -2 on a file or mapping error;
+ *         on any error the file is left closed
+ */
+int fusain_shadow_open(fusain_shadow_t* shadow, fusain_shadow_file_t* file,
+    const char* path, uint32_t capacity);
+
+/**
+ * Write dirty pages of a shadow file to storage
+ *
+ * @param file File handle
+ * @param wait true to block until written, false to only schedule it
+ * @return 0 on success, -2 on error
+ */
+int fusain_shadow_sync(fusain_shadow_file_t* file, bool wait);
+
+/**
+ * Unmap and close a shadow file (stop readers first)
+ *
+ * @param file File handle
+ */
+void fusain_shadow_close(fusain_shadow_file_t* file);
+#endif /* !CONFIG_FUSAIN */
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_SHADOW */
+
+/* Routing Table
+ *
+ * Maps a packet's 64-bit address to an application route handle (an index
+ * into its connection, subscriber or shadow arrays) on the receive hot
+ * path. Open addressing over 64-byte buckets of four slots; each slot has
+ * a one-byte tag from the address hash, and a bucket's four tags are
+ * matched at once as one 32-bit word. One writer, any number of lock-free
+ * readers: new entries are published by a release store of their tag,
+ * route changes are single atomic stores, and removed slots are only
+ * reused after fusain_route_compact() republishes the table RCU-style.
+ * Standalone builds always include it; Zephyr builds need
+ * CONFIG_FUSAIN_ROUTE.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_ROUTE)
+
+#define FUSAIN_ROUTE_SLOTS 4 // Slots per bucket
+
+/* One Cache Line of Entries */
+typedef struct {
+  uint32_t tags; // Byte n: 0 empty, 0x01 removed, 0x80 | hash bits in use
+  uint32_t routes[FUSAIN_ROUTE_SLOTS];
+  uint64_t addresses[FUSAIN_ROUTE_SLOTS];
+} __attribute__((aligned(64))) fusain_route_bucket_t;
+
+/* Routing Table State */
+typedef struct {
+  fusain_route_bucket_t* buckets; // Published array (readers load it once per lookup)
+  fusain_route_bucket_t* spare; // Target of the next compaction, NULL while in grace
+  uint32_t mask; // bucket_count - 1
+  uint32_t count; // Live entries
+  uint32_t removed; // Removed slots not yet reclaimed
+} fusain_route_t;
+
+/**
+ * Initialize an empty routing table
+ *
+ * @param table Table state
+ * @param buckets Bucket storage (bucket_count entries)
+ * @param spare Second array of the same size for fusain_route_compact(),
+ *              or NULL if removed slots need never be reclaimed
+ * @param bucket_count Number of buckets, a power of two; the table holds
+ *                     up to 7/8 of bucket_count * FUSAIN_ROUTE_SLOTS, but
+ *                     probes stay short only below about half of that
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_route_init(fusain_route_t* table, fusain_route_bucket_t* buckets,
+    fusain_route_bucket_t* spare, uint32_t bucket_count);
+
+/**
+ * Add a route or change an existing one (single writer)
+ *
+ * @param table Table state
+ * @param address Device or multicast address
+ * @param route Route handle
+ * @return 0 changed, 1 added, -2 table full (compact or grow it)
+ */
+int fusain_route_set(fusain_route_t* table, uint64_t address, uint32_t route);
+
+/**
+ * Remove a route (single writer)
+ *
+ * Readers already holding the old route may still use it; the slot is
+ * reused for the same address at once, for others only after compaction.
+ *
+ * @param table Table state
+ * @param address Address to remove
+ * @return 0 removed, -1 not found
+ */
+int fusain_route_remove(fusain_route_t* table, uint64_t address);
+
+/**
+ * Look up the route of an address (lock-free)
+ *
+ * @param table Table state
+ * @param address Address, typically fusain_packet_t.address
+ * @param route Output route handle
+ * @return 0 found, -1 not found
+ */
+int fusain_route_lookup(const fusain_route_t* table, uint64_t address,
+    uint32_t* route);
+
+/**
+ * Rebuild without removed slots and publish the result (single writer)
+ *
+ * Live entries are copied into the spare array, which then replaces the
+ * published one with a release store. Readers that started before may
+ * still be probing the old array, so it is returned instead of reused:
+ * once every reader has passed a quiescent point (the application's grace
+ * period, e.g. each reader thread finishing its current packet), hand it
+ * back with fusain_route_recycle().
+ *
+ * @param table Table state
+ * @return The retired bucket array, or NULL if there is no spare (none
+ *         given, or the last retired array is not recycled yet)
+ */
+fusain_route_bucket_t* fusain_route_compact(fusain_route_t* table);
+
+/**
+ * Return a retired bucket array after its grace period
+ *
+ * @param table Table state
+ * @param buckets Array returned by fusain_route_compact()
+ */
+void fusain_route_recycle(fusain_route_t* table, fusain_route_bucket_t* buckets);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_ROUTE */
+
+/* Subscription Fan-out
+ *
+ * Serves DATA_SUBSCRIPTION/DATA_UNSUBSCRIBE: tracks which subscribers
+ * (dashboards, loggers, other connections) follow each appliance and
+ * forwards its telemetry to them. A forwarded packet is encoded once into
+ * a reference-counted frame that every subscriber's TX queue shares; the
+ * last queue to finish with it releases it. Subscriptions are intrusive
+ * nodes on both the appliance's and the subscriber's list, so releasing
+ * one by its handle is O(1) and dropping a subscriber touches only its
+ * own subscriptions.
+ * Subscribe, unsubscribe and publish run on one thread; frames may be
+ * released from any thread. Standalone builds always include it; Zephyr
+ * builds need CONFIG_FUSAIN_FANOUT.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_FANOUT)
+
+/* Shared Encoded Frame */
+typedef struct {
+  uint32_t refs; // Owners left; 0 when free
+  uint16_t length;
+  uint8_t data[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+} fusain_frame_t;
+
+/* Frame Pool */
+typedef struct {
+  fusain_frame_t* frames;
+  uint32_t count;
+  uint32_t cursor; // Where the next allocation starts looking
+} fusain_frame_pool_t;
+
+/**
+ * Initialize a pool over caller-provided frames
+ *
+ * @param pool Pool state
+ * @param frames Frame storage
+ * @param count Number of frames
+ */
+void fusain_frame_pool_init(fusain_frame_pool_t* pool, fusain_frame_t* frames,
+    uint32_t count);
+
+/**
+ * Take a free frame (single allocating thread)
+ *
+ * @param pool Pool state
+ * @return Frame holding one reference, or NULL if every frame is in use
+ */
+fusain_frame_t* fusain_frame_alloc(fusain_frame_pool_t* pool);
+
+/**
+ * Add a reference (any thread)
+ *
+ * @param frame Frame
+ */
+void fusain_frame_ref(fusain_frame_t* frame);
+
+/**
+ * Drop a reference (any thread); the last one returns the frame to its pool
+ *
+ * @param frame Frame
+ * @return true if this was the last reference
+ */
+bool fusain_frame_unref(fusain_frame_t* frame);
+
+struct fusain_subscription;
+
+/* Subscriber (embed one per connection) */
+typedef struct {
+  struct fusain_subscription* subscriptions;
+  void* user;
+} fusain_subscriber_t;
+
+/**
+ * Queue a frame to a subscriber
+ *
+ * On success the subscriber's TX queue owns one reference and calls
+ * fusain_frame_unref() once the frame is sent; on failure the reference
+ * is dropped by the fan-out.
+ *
+ * @param subscriber Destination
+ * @param frame Encoded frame (reference already added for the queue)
+ * @return 0 queued, nonzero to drop (e.g. queue full)
+ */
+typedef int (*fusain_fanout_send_t)(fusain_subscriber_t* subscriber,
+    fusain_frame_t* frame);
+
+/* Subscribed Appliance */
+typedef struct {
+  uint64_t address;
+  struct fusain_subscription* subscriptions;
+  uint8_t in_use;
+} fusain_fanout_topic_t;
+
+/* Subscription (pool entry) */
+typedef struct fusain_subscription {
+  struct fusain_subscription* topic_next;
+  struct fusain_subscription** topic_pprev;
+  struct fusain_subscription* subscriber_next;
+  struct fusain_subscription** subscriber_pprev;
+  fusain_fanout_topic_t* topic;
+  fusain_subscriber_t* subscriber;
+} fusain_subscription_t;
+
+/* Fan-out State */
+typedef struct {
+  fusain_frame_pool_t* pool;
+  fusain_fanout_topic_t* topics;
+  uint32_t topic_mask; // topic_capacity - 1
+  fusain_subscription_t* free_list;
+  fusain_fanout_send_t send;
+} fusain_fanout_t;
+
+/**
+ * Initialize a fan-out engine
+ *
+ * @param fanout Fan-out state
+ * @param pool Frames for published packets
+ * @param topics Appliance table storage; appliances stay in it once seen
+ * @param topic_capacity Appliance table size, a power of two
+ * @param subscriptions Subscription storage
+ * @param subscription_count Number of subscriptions
+ * @param send Delivery to a subscriber's TX queue
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_fanout_init(fusain_fanout_t* fanout, fusain_frame_pool_t* pool,
+    fusain_fanout_topic_t* topics, uint32_t topic_capacity,
+    fusain_subscription_t* subscriptions, uint32_t subscription_count,
+    fusain_fanout_send_t send);
+
+/**
+ * Subscribe to an appliance (no-op if already subscribed)
+ *
+ * @param fanout Fan-out state
+ * @param subscriber Subscriber
+ * @param appliance Appliance address
+ * @param handle Optional output: the subscription, for
+ *        fusain_fanout_release(); may be NULL
+ * @return 0 on success, -2 out of subscriptions or appliance slots
+ */
+int fusain_fanout_subscribe(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    uint64_t appliance, fusain_subscription_t** handle);
+
+/**
+ * Unsubscribe from an appliance
+ *
+ * Looks the subscription up in the subscriber's own list, so it costs
+ * one step per subscription that subscriber holds; the unlink is O(1).
+ *
+ * @param fanout Fan-out state
+ * @param subscriber Subscriber
+ * @param appliance Appliance address
+ * @return 0 on success, -1 not subscribed
+ */
+int fusain_fanout_unsubscribe(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    uint64_t appliance);
+
+/**
+ * Release a subscription by its handle in O(1)
+ *
+ * @param fanout Fan-out state
+ * @param subscription Handle from fusain_fanout_subscribe(), not used after
+ */
+void fusain_fanout_release(fusain_fanout_t* fanout, fusain_subscription_t* subscription);
+
+/**
+ * Remove every subscription of a subscriber (e.g. on disconnect)
+ *
+ * @param fanout Fan-out state
+ * @param subscriber Subscriber
+ * @return Number of subscriptions removed
+ */
+uint32_t fusain_fanout_drop(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber);
+
+/**
+ * Apply a DATA_SUBSCRIPTION or DATA_UNSUBSCRIBE received from a subscriber
+ *
+ * @param fanout Fan-out state
+ * @param subscriber Connection the packet came from
+ * @param packet Decoded packet
+ * @return As fusain_fanout_subscribe()/fusain_fanout_unsubscribe(), 1 if
+ *         another message type, -3 malformed payload
+ */
+int fusain_fanout_handle(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    const fusain_packet_t* packet);
+
+/**
+ * Forward a packet from an appliance to its subscribers
+ *
+ * Encodes the packet once (only if anyone is subscribed) and queues the
+ * same frame to every subscriber.
+ *
+ * @param fanout Fan-out state
+ * @param packet Packet; its address selects the subscribers
+ * @return Subscribers the frame was queued to, -1 encoding failed, -2 no
+ *         free frame
+ */
+int fusain_fanout_publish(fusain_fanout_t* fanout, const fusain_packet_t* packet);
+
+/**
+ * Forward an already encoded frame (e.g. the bytes as received)
+ *
+ * Takes over the caller's reference to frame.
+ *
+ * @param fanout Fan-out state
+ * @param appliance Appliance the frame came from
+ * @param frame Frame holding one reference
+ * @return Subscribers the frame was queued to
+ */
+int fusain_fanout_publish_frame(fusain_fanout_t* fanout, uint64_t appliance,
+    fusain_frame_t* frame);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_FANOUT */
+
+/* Cut-through Forwarding
+ *
+ * Bridges stuffed frames between links (UART segments, UART to TCP)
+ * without decoding them. Each frame is forwarded as soon as its address
+ * and message type have arrived, still stuffed, while its CRC is checked
+ * on the fly; the END byte is held back until the CRC is known, and a bad
+ * frame is cut off downstream with a START byte instead, which every
+ * decoder treats as the beginning of a new frame. Like a learning switch,
+ * the forwarder records on which link each appliance was heard (from its
+ * telemetry and error messages, which carry the sender's address) in a
+ * fusain_route_t, and sends configuration and control messages for a
+ * known appliance only there. Everything else (telemetry, errors,
+ * multicast, unknown appliances) goes to every other link. An egress link
+ * that is already carrying another link's frame is not interleaved: the
+ * frame is copied aside and sent there as soon as that link is free,
+ * catching up and then streaming if it is still arriving. Each ingress
+ * link holds one such frame; while it waits, later frames from the same
+ * link skip busy egress links and are counted in collisions. Aliased
+ * frames are link-local and are not forwarded. All links are fed from one
+ * thread. Standalone builds always include it; Zephyr builds need
+ * CONFIG_FUSAIN_FORWARD.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_FORWARD)
+
+#define FUSAIN_FORWARD_MAX_LINKS 8
+/* START, then LENGTH, address and message type, each byte possibly escaped */
+#define FUSAIN_FORWARD_HEAD_SIZE (1 + 2 * (1 + 8 + 3))
+
+/**
+ * Write bytes to an egress link
+ *
+ * @param user fusain_forwarder_t.user
+ * @param link Egress link
+ * @param data Stuffed bytes
+ * @param length Number of bytes
+ */
+typedef void (*fusain_forward_emit_t)(void* user, uint8_t link, const uint8_t* data,
+    size_t length);
+
+/* Frame in Progress on One Ingress Link */
+typedef struct {
+  uint8_t state;
+  bool escape_next;
+  uint8_t length; // CBOR payload length
+  uint8_t index; // Unstuffed bytes after START
+  uint16_t crc; // Running CRC over LENGTH, ADDRESS and payload
+  uint16_t frame_crc; // CRC carried by the frame
+  uint64_t address;
+  uint8_t type[3]; // First payload bytes: [type, ...] header
+  uint8_t msg_type;
+  uint8_t egress; // Links this frame is streaming to
+  uint8_t head_length;
+  uint8_t head[FUSAIN_FORWARD_HEAD_SIZE];
+  bool holding; // The frame in progress is being copied to held
+  uint8_t waiting; // Busy links still owed the held frame
+  uint8_t held_length;
+  uint8_t held[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+} fusain_forward_link_t;
+
+/* Forwarder State */
+typedef struct {
+  fusain_route_t* routes; // Learned appliance -> link
+  fusain_forward_emit_t emit;
+  void* user;
+  uint8_t link_count;
+  uint8_t busy; // Egress links carrying a frame
+  fusain_forward_link_t links[FUSAIN_FORWARD_MAX_LINKS];
+  uint32_t forwarded; // Frames completed downstream, or held for a busy link
+  uint32_t aborted; // Frames cut off downstream (bad CRC or framing)
+  uint32_t dropped; // Frames not forwarded anywhere
+  uint32_t deferred; // Egress links a frame was held back for until free
+  uint32_t collisions; // Egress links skipped: busy, and the hold buffer in use
+} fusain_forwarder_t;
+
+/**
+ * Initialize a forwarder
+ *
+ * @param fwd Forwarder state
+ * @param routes Initialized routing table for learned appliances; its
+ *               route handles are link numbers
+ * @param link_count Number of links (1 to FUSAIN_FORWARD_MAX_LINKS)
+ * @param emit Egress output
+ * @param user Passed to emit
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_forward_init(fusain_forwarder_t* fwd, fusain_route_t* routes,
+    uint8_t link_count, fusain_forward_emit_t emit, void* user);
+
+/**
+ * Feed bytes received on a link
+ *
+ * Bytes of a routed frame are passed to emit as they arrive, in runs as
+ * long as the input allows, so feeding whole receive buffers is cheaper
+ * than feeding single bytes.
+ *
+ * @param fwd Forwarder state
+ * @param link Ingress link
+ * @param data Received stuffed bytes
+ * @param length Number of bytes
+ * @return Frames completed (downstream, or held for a busy link), -1 invalid link
+ */
+int fusain_forward_feed(fusain_forwarder_t* fwd, uint8_t link, const uint8_t* data,
+    size_t length);
+
+/**
+ * Cut off the frame in progress on a link (e.g. the link went down)
+ *
+ * @param fwd Forwarder state
+ * @param link Ingress link
+ */
+void fusain_forward_abort(fusain_forwarder_t* fwd, uint8_t link);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_FORWARD */
+
+/* Priority TX Scheduling
+ *
+ * Queues encoded frames for one link in priority classes taken from the
+ * message type, so an emergency stop does not wait behind telemetry. The
+ * link driver pulls bytes as it has room for them (e.g. a UART FIFO's
+ * worth); the class to serve is chosen again at every frame boundary, so
+ * a new frame waits for at most the frame already being sent. The safety
+ * class is always served first; the others are served in strict priority
+ * order or by deficit round robin with per-class byte weights.
+ *
+ * Telemetry that only reports a latest value (STATE, MOTOR, GLOW and
+ * TEMP_DATA) is coalesced: a newer frame for the same appliance, message
+ * type and peripheral replaces the queued one in place instead of joining
+ * the queue, so a link that falls behind sends fresh values and its queue
+ * stays bounded by the number of distinct values. Telemetry can also be
+ * held to a byte rate by a token bucket, leaving the rest of the link to
+ * the other classes. Enqueue and pull run on one thread, or under the
+ * caller's lock. Standalone builds always include it; Zephyr builds need
+ * CONFIG_FUSAIN_TX_SCHED.
+ */
+#if !defined(CONFIG_FUSAIN) || defined(CONFIG_FUSAIN_TX_SCHED)
+
+/* Priority Classes (highest first) */
+typedef enum {
+  FUSAIN_TX_SAFETY = 0, // Emergency STATE_COMMAND, TIMEOUT_CONFIG, errors
+  FUSAIN_TX_CONTROL = 1, // 0x20-0x2F
+  FUSAIN_TX_CONFIG = 2, // 0x10-0x1F
+  FUSAIN_TX_TELEMETRY = 3, // 0x30-0x3F and anything else
+  FUSAIN_TX_CLASSES = 4,
+} fusain_tx_class_t;
+
+/* Byte rate of a UART at a baud rate with 8N1 framing (10 bits per byte) */
+#define FUSAIN_TX_UART_RATE(baud) ((uint32_t)(baud) / 10)
+
+/* Queued Frame (pool entry) */
+typedef struct fusain_tx_slot {
+  struct fusain_tx_slot* next;
+  uint64_t queued_us;
+  uint64_t address; // Coalescing key: address, msg_type and index
+  uint8_t msg_type;
+  uint8_t index;
+  bool latest; // Replaced by newer frames with the same key
+  uint16_t length;
+  uint8_t data[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+} fusain_tx_slot_t;
+
+/* Per-class Metrics */
+typedef struct {
+  uint32_t depth; // Frames queued now
+  uint32_t max_depth;
+  uint32_t sent; // Frames started
+  uint32_t dropped; // Refused (no slot) or evicted for a higher class
+  uint32_t coalesced; // Queued frames replaced by a newer value
+  uint64_t latency_total_us; // Enqueue to first byte pulled, summed over sent
+  uint32_t latency_max_us;
+} fusain_tx_stats_t;
+
+/* Scheduler State */
+typedef struct {
+  fusain_tx_slot_t* heads[FUSAIN_TX_CLASSES];
+  fusain_tx_slot_t* tails[FUSAIN_TX_CLASSES];
+  fusain_tx_slot_t* free_list;
+  fusain_tx_slot_t* current; // Frame being pulled, NULL at a frame boundary
+  uint16_t offset; // Bytes of current already pulled
+  uint8_t turn; // Weighted class being served
+  bool granted; // turn already received its quantum
+  uint16_t weights[FUSAIN_TX_CLASSES]; // Bytes per round; all 0 = strict
+  int32_t deficits[FUSAIN_TX_CLASSES];
+  uint32_t rate; // Telemetry bytes per second, 0 = unlimited
+  uint64_t burst; // Bucket size, in millionths of a byte
+  uint64_t tokens; // Bucket level, in millionths of a byte
+  uint64_t tokens_us; // When tokens was last brought up to date
+  fusain_tx_stats_t stats[FUSAIN_TX_CLASSES];
+} fusain_tx_scheduler_t;
+
+/**
+ * Initialize a scheduler
+ *
+ * @param sched Scheduler state
+ * @param slots Frame storage shared by all classes
+ * @param count Number of slots
+ * @param weights Bytes per round for CONTROL, CONFIG and TELEMETRY under
+ *                deficit round robin (each nonzero; the SAFETY entry is
+ *                ignored), or NULL for strict priority
+ * @return 0 on success, -1 invalid arguments
+ */
+int fusain_tx_init(fusain_tx_scheduler_t* sched, fusain_tx_slot_t* slots,
+    uint32_t count, const uint16_t weights[FUSAIN_TX_CLASSES]);
+
+/**
+ * Get the priority class of a packet
+ *
+ * @param packet Packet
+ * @return fusain_tx_class_t
+ */
+fusain_tx_class_t fusain_tx_class_of(const fusain_packet_t* packet);
+
+/**
+ * Encode a packet and queue it in its class
+ *
+ * Latest-value telemetry replaces a queued frame with the same key, which
+ * keeps its place in the queue. Otherwise, with every slot in use, a
+ * packet evicts the oldest queued frame of the lowest class below its
+ * own, if there is one.
+ *
+ * @param sched Scheduler state
+ * @param packet Packet to send
+ * @param now_us Current time (for latency metrics)
+ * @return Class queued in, -1 encoding failed, -2 no slot
+ */
+int fusain_tx_enqueue(fusain_tx_scheduler_t* sched, const fusain_packet_t* packet,
+    uint64_t now_us);
+
+/**
+ * Take the next bytes to transmit
+ *
+ * Finishes the frame in progress first; at each frame boundary the
+ * highest class due is chosen.
+ *
+ * @param sched Scheduler state
+ * @param buffer Output
+ * @param size Room in buffer; keep it small (a FIFO's worth) so that
+ *             pre-emption stays close to a frame boundary
+ * @param now_us Current time (for latency metrics)
+ * @return Bytes written, 0 if nothing can be sent now
+ */
+size_t fusain_tx_pull(fusain_tx_scheduler_t* sched, uint8_t* buffer, size_t size,
+    uint64_t now_us);
+
+/**
+ * Limit telemetry to a byte rate
+ *
+ * A token bucket of burst bytes fills at bytes_per_second; a telemetry
+ * frame is started only once the bucket holds all of its bytes. Other
+ * classes are never held back, but their bytes are not counted either.
+ *
+ * @param sched Scheduler state
+ * @param bytes_per_second Rate, e.g. a share of FUSAIN_TX_UART_RATE(baud);
+ *                         0 removes the limit
+ * @param burst Bucket size in bytes; raised to FUSAIN_MAX_STUFFED_PACKET_SIZE
+ *              if smaller, so that any frame can be sent
+ * @param now_us Current time; the bucket starts full
+ */
+void fusain_tx_set_rate(fusain_tx_scheduler_t* sched, uint32_t bytes_per_second,
+    uint32_t burst, uint64_t now_us);
+
+/**
+ * Get when fusain_tx_pull() will next have bytes to send
+ *
+ * @param sched Scheduler state
+ * @param now_us Current time
+ * @return now_us if bytes can be sent now, the time the rate limit allows
+ *         the next telemetry frame, or UINT64_MAX if nothing is queued
+ */
+uint64_t fusain_tx_wake(fusain_tx_scheduler_t* sched, uint64_t now_us);
+
+#endif /* !CONFIG_FUSAIN || CONFIG_FUSAIN_TX_SCHED */
 
 /* Net Buffer API (Zephyr only) */
 #ifdef CONFIG_FUSAIN_NET_BUF
@@ -0,0 +1,33 @@
+/*
+ * Generated by scripts/cbor_sizes.py from src/generated/cbor_encode.c
+ * Do not edit; run `task zcbor-generate` after changing the schema.
+ */
+
+#ifndef FUSAIN_CBOR_SIZES_H__
+#define FUSAIN_CBOR_SIZES_H__
+
+#define FUSAIN_CBOR_SIZE_MOTOR_CONFIG 61
+#define FUSAIN_CBOR_SIZE_PUMP_CONFIG 19
+#define FUSAIN_CBOR_SIZE_TEMP_CONFIG 37
+#define FUSAIN_CBOR_SIZE_GLOW_CONFIG 13
+#define FUSAIN_CBOR_SIZE_DATA_SUBSCRIPTION 14
+#define FUSAIN_CBOR_SIZE_DATA_UNSUBSCRIBE 14
+#define FUSAIN_CBOR_SIZE_TELEMETRY_CONFIG 12
+#define FUSAIN_CBOR_SIZE_TIMEOUT_CONFIG 12
+#define FUSAIN_CBOR_SIZE_STATE_COMMAND 14
+#define FUSAIN_CBOR_SIZE_MOTOR_COMMAND 14
+#define FUSAIN_CBOR_SIZE_PUMP_COMMAND 14
+#define FUSAIN_CBOR_SIZE_GLOW_COMMAND 14
+#define FUSAIN_CBOR_SIZE_TEMP_COMMAND 24
+#define FUSAIN_CBOR_SIZE_SEND_TELEMETRY 14
+#define FUSAIN_CBOR_SIZE_STATE_DATA 19
+#define FUSAIN_CBOR_SIZE_MOTOR_DATA 50
+#define FUSAIN_CBOR_SIZE_PUMP_DATA 23
+#define FUSAIN_CBOR_SIZE_GLOW_DATA 16
+#define FUSAIN_CBOR_SIZE_TEMP_DATA 42
+#define FUSAIN_CBOR_SIZE_DEVICE_ANNOUNCE 17
+#define FUSAIN_CBOR_SIZE_PING_RESPONSE 11
+#define FUSAIN_CBOR_SIZE_ERROR_INVALID_CMD 20
+#define FUSAIN_CBOR_SIZE_ERROR_STATE_REJECT 14
+
+#endif /* FUSAIN_CBOR_SIZES_H__ */
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Derive worst-case CBOR payload sizes from the zcbor-generated encoder.
+
+Walks each encode_<name>_payload() function in src/generated/cbor_encode.c,
+counting every map key and every optional key as present, and sizes each
+value at the widest end of its range check. The message type header comes
+from the fusain_msg_type_t values in include/fusain/fusain.h.
+
+Usage:
+  scripts/cbor_sizes.py           Write include/fusain/generated/cbor_sizes.h
+  scripts/cbor_sizes.py --check   Exit non-zero if that header is stale
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+ENCODER = ROOT / "src/generated/cbor_encode.c"
+PUBLIC_HEADER = ROOT / "include/fusain/fusain.h"
+OUTPUT = ROOT / "include/fusain/generated/cbor_sizes.h"
+
+# Messages that reuse another message's payload schema
+SHARED_PAYLOADS = {"DATA_UNSUBSCRIBE": "data_subscription"}
+
+LIMITS = {
+    "INT8_MIN": -(1 << 7), "INT8_MAX": (1 << 7) - 1, "UINT8_MAX": (1 << 8) - 1,
+    "INT16_MIN": -(1 << 15), "INT16_MAX": (1 << 15) - 1, "UINT16_MAX": (1 << 16) - 1,
+    "INT32_MIN": -(1 << 31), "INT32_MAX": (1 << 31) - 1, "UINT32_MAX": (1 << 32) - 1,
+}
+
+# Value encoders with a fixed width (head byte included)
+FIXED_WIDTH = {
+    "zcbor_bool_encode": 1,
+    "zcbor_nil_put": 1,
+    "zcbor_float16_encode": 3,
+    "zcbor_float32_encode": 5,
+    "zcbor_float64_encode": 9,
+    "zcbor_uint64_encode": 9,
+    "zcbor_int64_encode": 9,
+}
+
+# Integer encoders and their unchecked range
+INT_RANGE = {
+    "zcbor_uint32_encode": (0, LIMITS["UINT32_MAX"]),
+    "zcbor_int32_encode": (LIMITS["INT32_MIN"], LIMITS["INT32_MAX"]),
+}
+
+TOKEN = re.compile(
+    r"(?P<start>zcbor_(?:map|list)_start_encode)\(state"
+    r"|(?P<put>zcbor_uint32_put)\(state, \((?P<key>\d+)\)\)"
+    r"|(?P<int>zcbor_u?int32_encode)\(state, \(&\(\*input\)\.(?P<field>\w+)\)\)"
+    r"|(?P<fixed>zcbor_\w+_(?:encode|put))\(state"
+    r"|(?P<nested>encode_\w+)\(state"
+)
+
+
+def head_size(value):
+    """Bytes taken by a CBOR head carrying this argument."""
+    if value < 24:
+        return 1
+    if value <= 0xFF:
+        return 2
+    if value <= 0xFFFF:
+        return 3
+    if value <= 0xFFFFFFFF:
+        return 5
+    return 9
+
+
+def parse_bound(text):
+    return LIMITS[text] if text in LIMITS else int(text, 0)
+
+
+def load_functions(source):
+    """Map each static encoder name to its body."""
+    functions = {}
+    pattern = re.compile(r"^static bool (encode_\w+)\(\n.*?\n\{\n(.*?)\n\}\n",
+                         re.M | re.S)
+    for match in pattern.finditer(source):
+        functions[match.group(1)] = match.group(2)
+    return functions
+
+
+def value_size(body, encoder, field):
+    low, high = INT_RANGE[encoder]
+    upper = re.search(r"\.%s <= (-?\w+)\)" % field, body)
+    lower = re.search(r"\.%s >= (-?\w+)\)" % field, body)
+    if upper:
+        high = parse_bound(upper.group(1))
+    if lower:
+        low = parse_bound(lower.group(1))
+    widest = max(high, -1 - low) if low < 0 else high
+    return head_size(widest)
+
+
+def encoded_size(functions, name):
+    body = functions[name]
+    size = 0
+    for token in TOKEN.finditer(body):
+        if token.group("start"):
+            size += 2  # Indefinite-length head and break byte
+        elif token.group("put"):
+            size += head_size(int(token.group("key")))
+        elif token.group("int"):
+            size += value_size(body, token.group("int"), token.group("field"))
+        elif token.group("fixed"):
+            encoder = token.group("fixed")
+            if encoder.endswith("_end_encode") or encoder == "zcbor_list_map_end_force_encode":
+                continue
+            if encoder not in FIXED_WIDTH:
+                sys.exit("%s: unsupported encoder %s" % (name, encoder))
+            size += FIXED_WIDTH[encoder]
+        elif token.group("nested") != name:
+            size += encoded_size(functions, token.group("nested"))
+    return size
+
+
+def message_types(header):
+    return {m.group(1): int(m.group(2), 0)
+            for m in re.finditer(r"^\s+FUSAIN_MSG_(\w+) = (0x[0-9A-Fa-f]+),", header, re.M)}
+
+
+def render(sizes):
+    lines = [
+        "/*",
+        " * Generated by scripts/cbor_sizes.py from src/generated/cbor_encode.c",
+        " * Do not edit; run `task zcbor-generate` after changing the schema.",
+        " */",
+        "",
+        "#ifndef FUSAIN_CBOR_SIZES_H__",
+        "#define FUSAIN_CBOR_SIZES_H__",
+        "",
+    ]
+    lines += ["#define FUSAIN_CBOR_SIZE_%s %d" % item for item in sizes]
+    lines += ["", "#endif /* FUSAIN_CBOR_SIZES_H__ */", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="fail if the generated header is out of date")
+    args = parser.parse_args()
+
+    functions = load_functions(ENCODER.read_text())
+    types = message_types(PUBLIC_HEADER.read_text())
+
+    payloads = {}
+    for entry in re.findall(r"^int cbor_encode_(\w+)_payload\(", ENCODER.read_text(), re.M):
+        payloads[entry.upper()] = entry
+    payloads.update(SHARED_PAYLOADS)
+
+    sizes = []
+    for message, msg_type in types.items():
+        if message not in payloads:
+            continue
+        header = 2 if msg_type <= 0x17 else 3
+        body = encoded_size(functions, "encode_%s_payload" % payloads[message])
+        sizes.append((message, header + body))
+
+    text = render(sizes)
+    if args.check:
+        if not OUTPUT.exists() or OUTPUT.read_text() != text:
+            sys.exit("%s is stale; run scripts/cbor_sizes.py" % OUTPUT.relative_to(ROOT))
+        return
+    OUTPUT.write_text(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -17,6 +17,7 @@
 
 #ifdef CONFIG_FUSAIN
 #include <zephyr/sys/crc.h>
+#include <zephyr/toolchain.h>
 #endif
 
 /* CBOR encoding constants */
@@ -24,6 +25,44 @@
 #define CBOR_UINT8_PREFIX 0x18 /* uint8 value follows */
 #define CBOR_NIL 0xF6 /* nil/null value */
 
+/* Every per-message worst case must fit in a packet */
+#ifdef CONFIG_FUSAIN
+#define FUSAIN_STATIC_ASSERT(cond) BUILD_ASSERT(cond, #cond)
+#else
+#define FUSAIN_STATIC_ASSERT(cond) extern char fusain_static_assert[(cond) ? 1 : -1]
+#endif
+#define FUSAIN_ASSERT_FITS(msg) \
+  FUSAIN_STATIC_ASSERT(FUSAIN_CBOR_SIZE_##msg <= FUSAIN_MAX_PAYLOAD_SIZE)
+
+FUSAIN_ASSERT_FITS(MOTOR_CONFIG);
+FUSAIN_ASSERT_FITS(PUMP_CONFIG);
+FUSAIN_ASSERT_FITS(TEMP_CONFIG);
+FUSAIN_ASSERT_FITS(GLOW_CONFIG);
+FUSAIN_ASSERT_FITS(DATA_SUBSCRIPTION);
+FUSAIN_ASSERT_FITS(DATA_UNSUBSCRIBE);
+FUSAIN_ASSERT_FITS(TELEMETRY_CONFIG);
+FUSAIN_ASSERT_FITS(TIMEOUT_CONFIG);
+FUSAIN_ASSERT_FITS(ALIAS_CONFIG);
+FUSAIN_ASSERT_FITS(DISCOVERY_REQUEST);
+FUSAIN_ASSERT_FITS(STATE_COMMAND);
+FUSAIN_ASSERT_FITS(MOTOR_COMMAND);
+FUSAIN_ASSERT_FITS(PUMP_COMMAND);
+FUSAIN_ASSERT_FITS(GLOW_COMMAND);
+FUSAIN_ASSERT_FITS(TEMP_COMMAND);
+FUSAIN_ASSERT_FITS(SEND_TELEMETRY);
+FUSAIN_ASSERT_FITS(PING_REQUEST);
+FUSAIN_ASSERT_FITS(STATE_DATA);
+FUSAIN_ASSERT_FITS(MOTOR_DATA);
+FUSAIN_ASSERT_FITS(PUMP_DATA);
+FUSAIN_ASSERT_FITS(GLOW_DATA);
+FUSAIN_ASSERT_FITS(TEMP_DATA);
+FUSAIN_ASSERT_FITS(DEVICE_ANNOUNCE);
+FUSAIN_ASSERT_FITS(PING_RESPONSE);
+FUSAIN_ASSERT_FITS(TELEMETRY_BATCH);
+FUSAIN_ASSERT_FITS(ERROR_INVALID_CMD);
+FUSAIN_ASSERT_FITS(ERROR_STATE_REJECT);
+FUSAIN_STATIC_ASSERT(FUSAIN_STUFFED_FRAME_SIZE(FUSAIN_MAX_PAYLOAD_SIZE) <= 2 * FUSAIN_MAX_PACKET_SIZE);
+
 /* Decoder States
  * Note: TYPE state removed - msg_type is now embedded in CBOR payload
  */
@@ -34,6 +73,7 @@
 #define DECODER_STATE_CRC1 4
 #define DECODER_STATE_CRC2 5
 #define DECODER_STATE_END 6
+#define DECODER_STATE_COBS 7 /* Collecting a COBS frame up to its delimiter */
 
 /* CRC-16-CCITT Calculation */
 #ifdef CONFIG_FUSAIN
@@ -64,6 +104,152 @@ uint16_t fusain_crc16(const uint8_t* data, size_t length)
 }
 #endif
 
+/* Batched CRC-16-CCITT
+ *
+ * Table-driven (one lookup per byte) and interleaved across
+ * FUSAIN_CRC_BATCH_LANES independent spans. Each span's CRC is a serial
+ * dependency chain; running several chains in lockstep lets the CPU overlap
+ * their table loads instead of waiting on one chain at a time. Results are
+ * bit-identical to fusain_crc16() in both build modes.
+ */
+static const uint16_t crc16_table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+#define CRC16_STEP(crc, byte) \
+  ((uint16_t)(((crc) << 8) ^ crc16_table[(((crc) >> 8) ^ (byte)) & 0xFF]))
+
+static uint16_t crc16_table_update(uint16_t crc, const uint8_t* data,
+    size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    crc = CRC16_STEP(crc, data[i]);
+  }
+  return crc;
+}
+
+uint16_t fusain_crc16_update(uint16_t crc, const uint8_t* data, size_t length)
+{
+  return crc16_table_update(crc, data, length);
+}
+
+/* The loop body below is unrolled for exactly four lanes */
+FUSAIN_STATIC_ASSERT(FUSAIN_CRC_BATCH_LANES == 4);
+
+void fusain_crc16_batch(const fusain_span_t* spans, size_t count,
+    uint16_t* crcs)
+{
+  size_t i = 0;
+
+  for (; i + FUSAIN_CRC_BATCH_LANES <= count; i += FUSAIN_CRC_BATCH_LANES) {
+    const fusain_span_t* s = &spans[i];
+    uint16_t crc0 = 0xFFFF;
+    uint16_t crc1 = 0xFFFF;
+    uint16_t crc2 = 0xFFFF;
+    uint16_t crc3 = 0xFFFF;
+
+    /* Lockstep over the prefix shared by all four spans */
+    size_t common = s[0].length;
+    for (int lane = 1; lane < FUSAIN_CRC_BATCH_LANES; lane++) {
+      if (s[lane].length < common) {
+        common = s[lane].length;
+      }
+    }
+    for (size_t j = 0; j < common; j++) {
+      crc0 = CRC16_STEP(crc0, s[0].data[j]);
+      crc1 = CRC16_STEP(crc1, s[1].data[j]);
+      crc2 = CRC16_STEP(crc2, s[2].data[j]);
+      crc3 = CRC16_STEP(crc3, s[3].data[j]);
+    }
+
+    /* Finish the longer spans one at a time */
+    crcs[i] = crc16_table_update(crc0, s[0].data + common, s[0].length - common);
+    crcs[i + 1] = crc16_table_update(crc1, s[1].data + common, s[1].length - common);
+    crcs[i + 2] = crc16_table_update(crc2, s[2].data + common, s[2].length - common);
+    crcs[i + 3] = crc16_table_update(crc3, s[3].data + common, s[3].length - common);
+  }
+
+  for (; i < count; i++) {
+    crcs[i] = crc16_table_update(0xFFFF, spans[i].data, spans[i].length);
+  }
+}
+
+/* CRC Linearity
+ *
+ * With the data fixed at zero, each CRC step is a linear map of the
+ * register, and for equal-length messages the CRC is linear in the data.
+ * So a CRC can be carried across bytes it never saw, and changed bytes
+ * can be patched by the CRC of their difference.
+ */
+
+/* Run the register over zeros zero bytes */
+static uint16_t crc16_shift(uint16_t crc, size_t zeros)
+{
+  while (zeros-- > 0) {
+    crc = CRC16_STEP(crc, 0);
+  }
+  return crc;
+}
+
+/* Apply a shift precomputed per register bit (map[i] = shift of 1 << i) */
+static uint16_t crc16_shift_apply(const uint16_t map[16], uint16_t crc)
+{
+  uint16_t result = 0;
+  for (int i = 0; i < 16; i++) {
+    result ^= map[i] & (uint16_t)-((crc >> i) & 1);
+  }
+  return result;
+}
+
+uint16_t fusain_crc16_combine(uint16_t crc_a, uint16_t crc_b, size_t length_b)
+{
+  /* crc_b already carries the initial value across B; cancel it in crc_a */
+  return crc16_shift(crc_a ^ 0xFFFF, length_b) ^ crc_b;
+}
+
+uint16_t fusain_crc16_patch(uint16_t crc, const uint8_t* old_bytes,
+    const uint8_t* new_bytes, size_t length, size_t trailing)
+{
+  uint16_t delta = 0;
+  for (size_t i = 0; i < length; i++) {
+    delta = CRC16_STEP(delta, old_bytes[i] ^ new_bytes[i]);
+  }
+  return crc ^ crc16_shift(delta, trailing);
+}
+
+#if FUSAIN_HAS_MSG_CONFIG || FUSAIN_HAS_MSG_CONTROL || FUSAIN_HAS_MSG_TELEMETRY \
+    || FUSAIN_HAS_MSG_ERROR
 /* CBOR Message Wrapper Encoding
  *
  * Encodes the CBOR array header and msg_type prefix: [type, ...]
@@ -90,6 +276,9 @@ static int encode_cbor_message_header(uint8_t* buffer, size_t buffer_size,
   }
 }
 
+#endif
+
+#if FUSAIN_HAS_MSG_CONFIG || FUSAIN_HAS_MSG_CONTROL
 /* Encode nil payload for messages with no data (PING_REQUEST, DISCOVERY_REQUEST)
  * Returns number of bytes written (1)
  */
@@ -100,6 +289,7 @@ static int encode_cbor_nil(uint8_t* buffer, size_t buffer_size)
   buffer[0] = CBOR_NIL;
   return 1;
 }
+#endif /* FUSAIN_HAS_MSG_CONFIG || FUSAIN_HAS_MSG_CONTROL */
 
 /* Extract msg_type from CBOR payload [type, payload_map]
  * Returns 0 on success, -1 on error
@@ -162,10 +352,12 @@ static int stuff_byte(uint8_t byte, uint8_t* buffer, size_t buffer_size,
  * The packet->length field contains the CBOR byte count.
  * The packet->msg_type field is kept for routing but is also in the CBOR payload.
  */
-int fusain_encode_packet(const fusain_packet_t* packet, uint8_t* buffer,
-    size_t buffer_size)
+/* Encode one frame; a non-NULL alias selects the 1-byte address form */
+static int encode_frame(const fusain_packet_t* packet,
+    const fusain_alias_t* alias, uint8_t* buffer, size_t buffer_size)
 {
-  if (!packet || !buffer || buffer_size < FUSAIN_MIN_PACKET_SIZE) {
+  size_t addr_len = alias ? 1 : 8;
+  if (!packet || !buffer || buffer_size < FUSAIN_MIN_PACKET_SIZE - (8 - addr_len)) {
     return -1;
   }
 
@@ -180,22 +372,22 @@ int fusain_encode_packet(const fusain_packet_t* packet, uint8_t* buffer,
 
   // Calculate CRC over LENGTH + ADDRESS + CBOR_PAYLOAD
   uint8_t crc_data[FUSAIN_MAX_PAYLOAD_SIZE + 9]; // +1 length +8 address
-  crc_data[0] = packet->length;
-  // Add address bytes (little-endian)
-  for (int i = 0; i < 8; i++) {
-    crc_data[1 + i] = (packet->address >> (i * 8)) & 0xFF;
+  crc_data[0] = packet->length | (alias ? FUSAIN_LENGTH_ALIAS_FLAG : 0);
+  // Add address bytes (little-endian), or the alias alone
+  for (size_t i = 0; i < addr_len; i++) {
+    crc_data[1 + i] = alias ? alias->alias : (packet->address >> (i * 8)) & 0xFF;
   }
   // CBOR payload (includes msg_type in the encoded data)
-  memcpy(&crc_data[9], packet->payload, packet->length);
-  uint16_t crc = fusain_crc16(crc_data, packet->length + 9);
+  memcpy(&crc_data[1 + addr_len], packet->payload, packet->length);
+  uint16_t crc = fusain_crc16(crc_data, packet->length + 1 + addr_len);
 
-  // Write LENGTH byte directly (never needs escaping: 0-114 range, escape bytes are 125-127)
-  buffer[index++] = packet->length;
+  // Write LENGTH byte directly (never needs escaping: 0-114 range, escape bytes
+  // are 125-127, and the alias flag moves it to 128-242)
+  buffer[index++] = crc_data[0];
 
-  // Stuff ADDRESS bytes (little-endian)
-  for (int i = 0; i < 8; i++) {
-    uint8_t addr_byte = (packet->address >> (i * 8)) & 0xFF;
-    if (stuff_byte(addr_byte, buffer, buffer_size, &index) < 0) {
+  // Stuff ADDRESS bytes
+  for (size_t i = 0; i < addr_len; i++) {
+    if (stuff_byte(crc_data[1 + i], buffer, buffer_size, &index) < 0) {
       return -4;
     }
   }
@@ -226,132 +418,1702 @@ int fusain_encode_packet(const fusain_packet_t* packet, uint8_t* buffer,
   return (int)index;
 }
 
-/* Packet Decoding
+int fusain_encode_packet(const fusain_packet_t* packet, uint8_t* buffer,
+    size_t buffer_size)
+{
+  return encode_frame(packet, NULL, buffer, buffer_size);
+}
+
+int fusain_encode_packet_alias(const fusain_packet_t* packet,
+    const fusain_alias_t* alias, uint8_t* buffer, size_t buffer_size)
+{
+  bool use_alias = alias && packet && alias->state == FUSAIN_ALIAS_ACTIVE
+      && alias->address == packet->address;
+  return encode_frame(packet, use_alias ? alias : NULL, buffer, buffer_size);
+}
+
+/* Batched Packet Encoding
  *
- * Wire format: [START][LENGTH][ADDRESS(8)][CBOR_PAYLOAD][CRC(2)][END]
- * CBOR payload is [msg_type, payload_map] - msg_type extracted after CRC validation
+ * Frames are written back-to-back so a whole telemetry burst can go out in
+ * one UART/DMA transfer or one write() call. Encoding stops at the first
+ * frame that does not fit; everything before it is complete and usable.
  */
-fusain_decode_result_t fusain_decode_byte(uint8_t rx_byte,
-    fusain_packet_t* packet,
-    fusain_decoder_t* decoder)
+int fusain_encode_packets(const fusain_packet_t* packets, size_t count,
+    uint8_t* buffer, size_t buffer_size, size_t* frame_offsets,
+    size_t* encoded_count)
 {
-  /* Handle START byte - reset decoder */
-  if (rx_byte == FUSAIN_START_BYTE && !(decoder->escape_next)) {
-    decoder->state = DECODER_STATE_LENGTH;
-    decoder->buffer_index = 0;
-    decoder->escape_next = false;
-    decoder->addr_byte_count = 0;
-    packet->address = 0;
+  if (!packets || !buffer || !encoded_count) {
+    return -1;
+  }
+
+  size_t offset = 0;
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    int len = fusain_encode_packet(&packets[i], buffer + offset,
+        buffer_size - offset);
+    if (len == -2) {
+      *encoded_count = i;
+      return -2; // Invalid payload length in packets[i]
+    }
+    if (len < 0) {
+      break; // Out of space, report partial progress
+    }
+    if (frame_offsets) {
+      frame_offsets[i] = offset;
+    }
+    offset += (size_t)len;
+  }
+
+  *encoded_count = i;
+  return (int)offset;
+}
+
+/* Frame Retargeting
+ *
+ * A frame's CRC is shift(CRC(LENGTH + ADDRESS), payload length) XOR the
+ * zero-init CRC of the payload. Both the shift map and the payload term
+ * are fixed per template, so each copy costs a 9-byte CRC, 16 masked XORs
+ * and a memcpy of the already stuffed payload.
+ */
+static int unstuff_next(const uint8_t* frame, size_t end, size_t* index,
+    uint8_t* byte)
+{
+  if (*index >= end) {
+    return -1;
+  }
+  uint8_t b = frame[(*index)++];
+  if (b == FUSAIN_ESC_BYTE) {
+    if (*index >= end) {
+      return -1;
+    }
+    b = frame[(*index)++] ^ FUSAIN_ESC_XOR;
+  } else if (b == FUSAIN_START_BYTE || b == FUSAIN_END_BYTE) {
+    return -1;
+  }
+  *byte = b;
+  return 0;
+}
+
+int fusain_retarget_init(fusain_retarget_t* retarget, const uint8_t* frame,
+    size_t frame_length)
+{
+  if (!retarget || !frame) {
+    return -1;
+  }
+  if (frame_length < 13 || frame[0] != FUSAIN_START_BYTE
+      || frame[frame_length - 1] != FUSAIN_END_BYTE
+      || frame[1] > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -2; /* Also rejects short-address frames (flagged LENGTH) */
+  }
+
+  size_t end = frame_length - 1;
+  size_t index = 2;
+  uint8_t head[9];
+  uint8_t crc_bytes[2];
+  head[0] = frame[1];
+  for (int i = 0; i < 8; i++) {
+    if (unstuff_next(frame, end, &index, &head[1 + i]) < 0) {
+      return -2;
+    }
+  }
+
+  size_t tail_offset = index;
+  uint16_t tail_crc = 0;
+  for (size_t i = 0; i < frame[1]; i++) {
+    uint8_t byte;
+    if (unstuff_next(frame, end, &index, &byte) < 0) {
+      return -2;
+    }
+    tail_crc = CRC16_STEP(tail_crc, byte);
+  }
+  size_t tail_length = index - tail_offset;
+
+  if (unstuff_next(frame, end, &index, &crc_bytes[0]) < 0
+      || unstuff_next(frame, end, &index, &crc_bytes[1]) < 0 || index != end) {
+    return -2;
+  }
+
+  for (int i = 0; i < 16; i++) {
+    retarget->shift[i] = crc16_shift((uint16_t)(1u << i), frame[1]);
+  }
+  uint16_t crc = crc16_shift_apply(retarget->shift,
+                     crc16_table_update(0xFFFF, head, sizeof(head)))
+      ^ tail_crc;
+  if (crc != (((uint16_t)crc_bytes[0] << 8) | crc_bytes[1])) {
+    return -3;
+  }
+
+  retarget->frame = frame;
+  retarget->tail_offset = tail_offset;
+  retarget->tail_length = tail_length;
+  retarget->length = frame[1];
+  retarget->tail_crc = tail_crc;
+  return 0;
+}
+
+int fusain_retarget_frame(const fusain_retarget_t* retarget, uint64_t address,
+    uint8_t* buffer, size_t buffer_size)
+{
+  if (!retarget || !buffer || buffer_size < 2) {
+    return -1;
+  }
+
+  uint8_t head[9];
+  head[0] = retarget->length;
+  for (int i = 0; i < 8; i++) {
+    head[1 + i] = (address >> (i * 8)) & 0xFF;
+  }
+  uint16_t crc = crc16_shift_apply(retarget->shift,
+                     crc16_table_update(0xFFFF, head, sizeof(head)))
+      ^ retarget->tail_crc;
+
+  size_t index = 0;
+  buffer[index++] = FUSAIN_START_BYTE;
+  buffer[index++] = retarget->length;
+  for (int i = 0; i < 8; i++) {
+    if (stuff_byte(head[1 + i], buffer, buffer_size, &index) < 0) {
+      return -1;
+    }
+  }
+  if (buffer_size - index < retarget->tail_length) {
+    return -1;
+  }
+  memcpy(&buffer[index], &retarget->frame[retarget->tail_offset],
+      retarget->tail_length);
+  index += retarget->tail_length;
+  if (stuff_byte((crc >> 8) & 0xFF, buffer, buffer_size, &index) < 0
+      || stuff_byte(crc & 0xFF, buffer, buffer_size, &index) < 0
+      || index >= buffer_size) {
+    return -1;
+  }
+  buffer[index++] = FUSAIN_END_BYTE;
+  return (int)index;
+}
+
+/* Scatter-Gather Packet Encoding
+ *
+ * Unescaped payload runs are referenced in place; only framing, stuffed
+ * address/CRC bytes and escape pairs are written to the side buffer.
+ * Adjacent side-buffer writes are merged into a single segment.
+ */
+typedef struct {
+  fusain_span_t* iov;
+  size_t iov_size;
+  size_t iov_count;
+  uint8_t* side;
+  size_t side_size;
+  size_t side_used;
+  bool last_is_side;
+} iov_writer_t;
+
+static int iov_push(iov_writer_t* w, const uint8_t* data, size_t length,
+    bool is_side)
+{
+  if (is_side && w->last_is_side) {
+    w->iov[w->iov_count - 1].length += length; // Contiguous in side buffer
+    return 0;
+  }
+  if (w->iov_count >= w->iov_size) {
+    return -1;
+  }
+  w->iov[w->iov_count].data = data;
+  w->iov[w->iov_count].length = length;
+  w->iov_count++;
+  w->last_is_side = is_side;
+  return 0;
+}
+
+static int iov_side_stuff(iov_writer_t* w, uint8_t byte, bool escapable)
+{
+  uint8_t* out = w->side + w->side_used;
+  size_t n = (escapable
+                 && (byte == FUSAIN_START_BYTE || byte == FUSAIN_END_BYTE
+                     || byte == FUSAIN_ESC_BYTE))
+      ? 2
+      : 1;
+
+  if (w->side_used + n > w->side_size) {
+    return -4;
+  }
+  if (iov_push(w, out, n, true) < 0) {
+    return -3;
+  }
+  if (n == 2) {
+    out[0] = FUSAIN_ESC_BYTE;
+    out[1] = byte ^ FUSAIN_ESC_XOR;
+  } else {
+    out[0] = byte;
+  }
+  w->side_used += n;
+  return 0;
+}
+
+int fusain_encode_packet_iov(const fusain_packet_t* packet, fusain_span_t* iov,
+    size_t iov_size, uint8_t* side_buffer, size_t side_buffer_size,
+    size_t* total_length)
+{
+  if (!packet || !iov || !side_buffer) {
+    return -1;
+  }
+  if (packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -2;
+  }
+
+  iov_writer_t w = {
+    .iov = iov,
+    .iov_size = iov_size,
+    .side = side_buffer,
+    .side_size = side_buffer_size,
+  };
+  int ret;
+
+  // CRC over LENGTH + ADDRESS + CBOR_PAYLOAD without staging a copy
+  uint8_t header[9];
+  header[0] = packet->length;
+  for (int i = 0; i < 8; i++) {
+    header[1 + i] = (packet->address >> (i * 8)) & 0xFF;
+  }
+  uint16_t crc = crc16_table_update(0xFFFF, header, sizeof(header));
+  crc = crc16_table_update(crc, packet->payload, packet->length);
+
+  // START and LENGTH are never escaped, ADDRESS bytes may be
+  if ((ret = iov_side_stuff(&w, FUSAIN_START_BYTE, false)) < 0
+      || (ret = iov_side_stuff(&w, packet->length, false)) < 0) {
+    return ret;
+  }
+  for (int i = 1; i < 9; i++) {
+    if ((ret = iov_side_stuff(&w, header[i], true)) < 0) {
+      return ret;
+    }
+  }
+
+  // Payload: reference escape-free runs, stuff only the special bytes
+  size_t run_start = 0;
+  for (size_t i = 0; i < packet->length; i++) {
+    uint8_t byte = packet->payload[i];
+    if (byte != FUSAIN_START_BYTE && byte != FUSAIN_END_BYTE && byte != FUSAIN_ESC_BYTE) {
+      continue;
+    }
+    if (i > run_start
+        && iov_push(&w, &packet->payload[run_start], i - run_start, false) < 0) {
+      return -3;
+    }
+    if ((ret = iov_side_stuff(&w, byte, true)) < 0) {
+      return ret;
+    }
+    run_start = i + 1;
+  }
+  if (packet->length > run_start
+      && iov_push(&w, &packet->payload[run_start], packet->length - run_start,
+             false)
+          < 0) {
+    return -3;
+  }
+
+  // CRC (big-endian) and END
+  if ((ret = iov_side_stuff(&w, (crc >> 8) & 0xFF, true)) < 0
+      || (ret = iov_side_stuff(&w, crc & 0xFF, true)) < 0
+      || (ret = iov_side_stuff(&w, FUSAIN_END_BYTE, false)) < 0) {
+    return ret;
+  }
+
+  if (total_length) {
+    size_t total = 0;
+    for (size_t i = 0; i < w.iov_count; i++) {
+      total += w.iov[i].length;
+    }
+    *total_length = total;
+  }
+
+  return (int)w.iov_count;
+}
+
+/* Unstuffed Frames
+ *
+ * [LENGTH][ADDRESS][CBOR_PAYLOAD][CRC(2)] with no delimiters or escapes.
+ * The raw framing sends it as-is (CRC optional); COBS wraps it. Both
+ * build and check it in one piece rather than through the byte-wise
+ * state machine.
+ */
+static size_t put_raw_frame(const fusain_packet_t* packet, bool with_crc,
+    uint8_t* out)
+{
+  out[0] = packet->length;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (packet->address >> (i * 8)) & 0xFF;
+  }
+  memcpy(&out[9], packet->payload, packet->length);
+  size_t length = (size_t)packet->length + 9;
+  if (with_crc) {
+    uint16_t crc = crc16_table_update(0xFFFF, out, length);
+    out[length++] = (crc >> 8) & 0xFF;
+    out[length++] = crc & 0xFF;
+  }
+  return length;
+}
+
+/* Validate a complete frame and copy it into packet; alias and filter may
+ * be NULL */
+static fusain_decode_result_t check_raw_frame(const uint8_t* raw,
+    size_t raw_length, bool with_crc, fusain_packet_t* packet,
+    fusain_alias_t* alias, const fusain_address_filter_t* filter)
+{
+  bool aliased = (raw[0] & FUSAIN_LENGTH_ALIAS_FLAG) != 0;
+  size_t length = raw[0] & ~FUSAIN_LENGTH_ALIAS_FLAG;
+  size_t addr_len = aliased ? 1 : 8;
+  size_t crc_len = with_crc ? 2 : 0;
+  if (length > FUSAIN_MAX_PAYLOAD_SIZE
+      || raw_length != 1 + addr_len + length + crc_len
+      || (aliased && (!alias || alias->state == FUSAIN_ALIAS_OFF))) {
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+
+  uint64_t address = 0;
+  for (size_t i = 0; i < addr_len; i++) {
+    address |= ((uint64_t)raw[1 + i]) << (i * 8);
+  }
+  if (!aliased && filter && !fusain_filter_accepts(filter, address)) {
+    return FUSAIN_DECODE_NOT_ADDRESSED;
+  }
+
+  uint16_t crc = 0;
+  if (with_crc) {
+    crc = ((uint16_t)raw[raw_length - 2] << 8) | raw[raw_length - 1];
+    if (crc16_table_update(0xFFFF, raw, raw_length - 2) != crc) {
+      return FUSAIN_DECODE_INVALID_CRC;
+    }
+  }
+
+  if (aliased) {
+    if (address != alias->alias) {
+      return FUSAIN_DECODE_UNKNOWN_ALIAS;
+    }
+    address = alias->address;
+    alias->state = FUSAIN_ALIAS_ACTIVE;
+  }
+
+  size_t header_len = 0;
+  if (decode_cbor_message_header(&raw[1 + addr_len], length, &packet->msg_type,
+          &header_len)
+      != 0) {
+    return FUSAIN_DECODE_INVALID_START; /* Invalid CBOR format */
+  }
+
+  packet->address = address;
+  packet->length = (uint8_t)length;
+  memcpy(packet->payload, &raw[1 + addr_len], length);
+  packet->crc = crc;
+  return FUSAIN_DECODE_OK;
+}
+
+/* Raw Framing
+ *
+ * For transports that already deliver bytes intact and in order (TCP,
+ * WebSocket, local IPC): no delimiters, no escapes, CRC only if asked.
+ */
+int fusain_encode_packet_raw(const fusain_packet_t* packet, bool with_crc,
+    uint8_t* buffer, size_t buffer_size)
+{
+  if (!packet || !buffer) {
+    return -1;
+  }
+  if (packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -2;
+  }
+  if (buffer_size < (size_t)FUSAIN_RAW_FRAME_SIZE(packet->length, with_crc)) {
+    return -1;
+  }
+  return (int)put_raw_frame(packet, with_crc, buffer);
+}
+
+fusain_decode_result_t fusain_decode_packet_raw(const uint8_t* data,
+    size_t length, bool with_crc, fusain_packet_t* packet, size_t* consumed)
+{
+  *consumed = 0;
+  if (length == 0) {
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+  if (data[0] > FUSAIN_MAX_PAYLOAD_SIZE) {
+    *consumed = length; /* No way to find the next frame */
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+  size_t frame_length = FUSAIN_RAW_FRAME_SIZE(data[0], with_crc);
+  if (length < frame_length) {
     return FUSAIN_DECODE_INCOMPLETE;
   }
+  *consumed = frame_length;
+  return check_raw_frame(data, frame_length, with_crc, packet, NULL, NULL);
+}
+
+#if FUSAIN_HAS_COBS
+/* COBS Framing
+ *
+ * Consistent Overhead Byte Stuffing replaces every 0x00 with the distance
+ * to the next one, so 0x00 can delimit frames. Runs between zeros are
+ * located with memchr and moved with memcpy; no per-byte escape test.
+ */
+#define COBS_MAX_RUN 254 /* Data bytes behind a 0xFF code, no implied zero */
+
+static size_t cobs_encode(const uint8_t* in, size_t length, uint8_t* out)
+{
+  size_t i = 0;
+  size_t o = 0;
+  for (;;) {
+    size_t run = length - i < COBS_MAX_RUN ? length - i : COBS_MAX_RUN;
+    const uint8_t* zero = memchr(&in[i], 0, run);
+    size_t n = zero ? (size_t)(zero - &in[i]) : run;
+    out[o] = (uint8_t)(n + 1);
+    memcpy(&out[o + 1], &in[i], n);
+    o += n + 1;
+    i += n;
+    if (zero) {
+      i++; /* Zero is implied by the code; a trailing one ends in code 1 */
+    } else if (i == length) {
+      return o;
+    }
+  }
+}
+
+/* Returns the decoded length, -1 for a malformed frame, -2 if too long */
+static int cobs_decode(const uint8_t* in, size_t length, uint8_t* out,
+    size_t out_size)
+{
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    size_t code = in[i++];
+    if (code == 0 || code - 1 > length - i) {
+      return -1;
+    }
+    if (o + code - 1 > out_size) {
+      return -2;
+    }
+    memcpy(&out[o], &in[i], code - 1);
+    i += code - 1;
+    o += code - 1;
+    if (code <= COBS_MAX_RUN && i < length) {
+      if (o == out_size) {
+        return -2;
+      }
+      out[o++] = 0;
+    }
+  }
+  return (int)o;
+}
+
+static fusain_decode_result_t decode_cobs(const uint8_t* frame, size_t length,
+    fusain_packet_t* packet, fusain_alias_t* alias,
+    const fusain_address_filter_t* filter)
+{
+  uint8_t raw[FUSAIN_MAX_PAYLOAD_SIZE + 11];
+  int raw_length = cobs_decode(frame, length, raw, sizeof(raw));
+  if (raw_length == -1) {
+    return FUSAIN_DECODE_INVALID_START;
+  }
+  if (raw_length < 1) {
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+  return check_raw_frame(raw, (size_t)raw_length, true, packet, alias, filter);
+}
+
+int fusain_encode_packet_cobs(const fusain_packet_t* packet, uint8_t* buffer,
+    size_t buffer_size)
+{
+  if (!packet || !buffer) {
+    return -1;
+  }
+  if (packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -2;
+  }
+  if (buffer_size < (size_t)FUSAIN_COBS_FRAME_SIZE(packet->length)) {
+    return -1;
+  }
+
+  /* LENGTH + ADDRESS + CBOR_PAYLOAD + CRC, as in the stuffed framing */
+  uint8_t raw[FUSAIN_MAX_PAYLOAD_SIZE + 11];
+  size_t raw_length = put_raw_frame(packet, true, raw);
+
+  size_t index = cobs_encode(raw, raw_length, buffer);
+  buffer[index++] = FUSAIN_COBS_DELIMITER;
+  return (int)index;
+}
+
+fusain_decode_result_t fusain_decode_cobs_frame(const uint8_t* frame,
+    size_t length, fusain_packet_t* packet)
+{
+  return decode_cobs(frame, length, packet, NULL, NULL);
+}
+
+/* Byte-wise COBS reception: collect until the delimiter, then decode */
+static fusain_decode_result_t decode_cobs_byte(uint8_t rx_byte,
+    fusain_packet_t* packet, fusain_decoder_t* decoder)
+{
+  if (rx_byte != FUSAIN_COBS_DELIMITER) {
+    if (decoder->state != DECODER_STATE_COBS) {
+      return FUSAIN_DECODE_INCOMPLETE; /* Dropping the rest of a frame */
+    }
+    if (decoder->buffer_index >= sizeof(decoder->buffer)) {
+      decoder->state = DECODER_STATE_IDLE;
+      return FUSAIN_DECODE_BUFFER_OVERFLOW;
+    }
+    decoder->buffer[decoder->buffer_index++] = rx_byte;
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+
+  size_t length = decoder->buffer_index;
+  bool dropped = decoder->state != DECODER_STATE_COBS;
+  decoder->buffer_index = 0;
+  decoder->state = DECODER_STATE_COBS;
+  if (length == 0 || dropped) {
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+  return decode_cobs(decoder->buffer, length, packet, decoder->alias,
+      decoder->filter);
+}
+#endif /* FUSAIN_HAS_COBS */
+
+/* Packet Decoding
+ *
+ * Wire format: [START][LENGTH][ADDRESS(8)][CBOR_PAYLOAD][CRC(2)][END]
+ * CBOR payload is [msg_type, payload_map] - msg_type extracted after CRC validation
+ */
+fusain_decode_result_t fusain_decode_byte(uint8_t rx_byte,
+    fusain_packet_t* packet,
+    fusain_decoder_t* decoder)
+{
+#if FUSAIN_HAS_COBS
+  if (decoder->framing == FUSAIN_FRAMING_COBS) {
+    return decode_cobs_byte(rx_byte, packet, decoder);
+  }
+#endif
+
+  /* Handle START byte - reset decoder */
+  if (rx_byte == FUSAIN_START_BYTE && !(decoder->escape_next)) {
+    decoder->state = DECODER_STATE_LENGTH;
+    decoder->buffer_index = 0;
+    decoder->escape_next = false;
+    decoder->addr_byte_count = 0;
+    decoder->aliased = false;
+    packet->address = 0;
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+
+  /* Handle escape sequences */
+  if (rx_byte == FUSAIN_ESC_BYTE && !(decoder->escape_next)) {
+    decoder->escape_next = true;
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+
+  /* Unescape byte if needed */
+  uint8_t byte = rx_byte;
+  if (decoder->escape_next) {
+    byte ^= FUSAIN_ESC_XOR;
+    decoder->escape_next = false;
+  }
+
+  /* State machine */
+  switch (decoder->state) {
+  case DECODER_STATE_IDLE:
+    return FUSAIN_DECODE_INCOMPLETE;
+
+  case DECODER_STATE_LENGTH:
+    decoder->aliased = (byte & FUSAIN_LENGTH_ALIAS_FLAG) != 0;
+    if ((byte & ~FUSAIN_LENGTH_ALIAS_FLAG) > FUSAIN_MAX_PAYLOAD_SIZE
+        || (decoder->aliased
+            && (!decoder->alias || decoder->alias->state == FUSAIN_ALIAS_OFF))) {
+      decoder->state = DECODER_STATE_IDLE;
+      return FUSAIN_DECODE_INVALID_LENGTH;
+    }
+    packet->length = byte & ~FUSAIN_LENGTH_ALIAS_FLAG;
+    decoder->buffer[decoder->buffer_index++] = byte;
+    decoder->addr_byte_count = 0;
+    decoder->state = DECODER_STATE_ADDRESS;
+    return FUSAIN_DECODE_INCOMPLETE;
+
+  case DECODER_STATE_ADDRESS:
+    /* Accumulate address bytes (little-endian) */
+    packet->address |= ((uint64_t)byte) << (decoder->addr_byte_count * 8);
+    decoder->buffer[decoder->buffer_index++] = byte;
+    decoder->addr_byte_count++;
+    if (decoder->addr_byte_count >= (decoder->aliased ? 1 : 8)) {
+      /* Skip frames for other devices before storing or checking them */
+      if (!decoder->aliased && decoder->filter
+          && !fusain_filter_accepts(decoder->filter, packet->address)) {
+        decoder->state = DECODER_STATE_IDLE;
+        return FUSAIN_DECODE_NOT_ADDRESSED;
+      }
+      /* All address bytes received, move to CBOR payload */
+      if (packet->length == 0) {
+        decoder->state = DECODER_STATE_CRC1;
+      } else {
+        decoder->state = DECODER_STATE_PAYLOAD;
+      }
+    }
+    return FUSAIN_DECODE_INCOMPLETE;
+
+  case DECODER_STATE_PAYLOAD: {
+    /* Store CBOR payload bytes directly (after LENGTH and ADDRESS) */
+    size_t header = 1 + (size_t)decoder->addr_byte_count;
+    packet->payload[decoder->buffer_index - header] = byte;
+    decoder->buffer[decoder->buffer_index++] = byte;
+    if (decoder->buffer_index >= (size_t)(packet->length + header)) {
+      decoder->state = DECODER_STATE_CRC1;
+    }
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+
+  case DECODER_STATE_CRC1:
+    packet->crc = (uint16_t)byte << 8;
+    decoder->state = DECODER_STATE_CRC2;
+    return FUSAIN_DECODE_INCOMPLETE;
+
+  case DECODER_STATE_CRC2:
+    packet->crc |= byte;
+    decoder->state = DECODER_STATE_END;
+    return FUSAIN_DECODE_INCOMPLETE;
+
+  case DECODER_STATE_END: {
+    if (rx_byte != FUSAIN_END_BYTE) {
+      decoder->state = DECODER_STATE_IDLE;
+      return FUSAIN_DECODE_INVALID_START;
+    }
+
+    /* Validate CRC (LENGTH + ADDRESS + CBOR_PAYLOAD) */
+    uint16_t calculated_crc = fusain_crc16(decoder->buffer,
+        packet->length + 1 + (size_t)decoder->addr_byte_count);
+    if (calculated_crc != packet->crc) {
+      decoder->state = DECODER_STATE_IDLE;
+      return FUSAIN_DECODE_INVALID_CRC;
+    }
+
+    /* Expand a session alias back to the full address */
+    if (decoder->aliased) {
+      fusain_alias_t* alias = decoder->alias;
+      if (packet->address != alias->alias) {
+        decoder->state = DECODER_STATE_IDLE;
+        return FUSAIN_DECODE_UNKNOWN_ALIAS;
+      }
+      packet->address = alias->address;
+      alias->state = FUSAIN_ALIAS_ACTIVE; /* Peer proved it speaks aliases */
+    }
+
+    /* Extract msg_type from CBOR payload [type, payload_map] */
+    size_t header_len = 0;
+    if (decode_cbor_message_header(packet->payload, packet->length,
+            &packet->msg_type, &header_len)
+        != 0) {
+      decoder->state = DECODER_STATE_IDLE;
+      return FUSAIN_DECODE_INVALID_START; /* Invalid CBOR format */
+    }
+
+    /* Packet complete and valid */
+    decoder->state = DECODER_STATE_IDLE;
+    return FUSAIN_DECODE_OK;
+  }
+
+  default:
+    decoder->state = DECODER_STATE_IDLE;
+    return FUSAIN_DECODE_INVALID_START;
+  }
+}
+
+/* Reset Decoder */
+void fusain_reset_decoder(fusain_decoder_t* decoder)
+{
+  decoder->alias = NULL;
+  decoder->framing = FUSAIN_FRAMING_STUFFED;
+  decoder->filter = NULL;
+  fusain_decoder_resync(decoder);
+}
+
+/* Resync Decoder (link configuration is kept) */
+void fusain_decoder_resync(fusain_decoder_t* decoder)
+{
+  decoder->state = DECODER_STATE_IDLE;
+#if FUSAIN_HAS_COBS
+  if (decoder->framing == FUSAIN_FRAMING_COBS) {
+    decoder->state = DECODER_STATE_COBS; /* A cut-off frame then fails its CRC */
+  }
+#endif
+  decoder->buffer_index = 0;
+  decoder->escape_next = false;
+  decoder->addr_byte_count = 0;
+  decoder->aliased = false;
+}
+
+/* Address Filtering */
+void fusain_filter_init(fusain_address_filter_t* filter, uint64_t address)
+{
+  memset(filter->groups, 0, sizeof(filter->groups));
+  filter->address = address;
+  filter->groups[7] = 1u << 31; /* Broadcast, the last reserved address */
+}
+
+void fusain_filter_join(fusain_address_filter_t* filter, uint8_t group)
+{
+  if (group < FUSAIN_MAX_GROUPS) {
+    filter->groups[group >> 5] |= 1u << (group & 31);
+  }
+}
+
+void fusain_filter_leave(fusain_address_filter_t* filter, uint8_t group)
+{
+  if (group < FUSAIN_MAX_GROUPS) {
+    filter->groups[group >> 5] &= ~(1u << (group & 31));
+  }
+}
+
+bool fusain_filter_accepts(const fusain_address_filter_t* filter,
+    uint64_t address)
+{
+  if (address == filter->address) {
+    return true;
+  }
+  if (!FUSAIN_ADDRESS_IS_MULTICAST(address)) {
+    return false;
+  }
+  uint8_t group = address & 0xFF;
+  return (filter->groups[group >> 5] >> (group & 31)) & 1;
+}
+
+void fusain_decoder_set_filter(fusain_decoder_t* decoder,
+    const fusain_address_filter_t* filter)
+{
+  decoder->filter = filter;
+}
+
+#if FUSAIN_HAS_COBS
+/* Select Link Framing */
+void fusain_decoder_set_framing(fusain_decoder_t* decoder, uint8_t framing)
+{
+  decoder->framing = framing;
+  decoder->buffer_index = 0;
+  decoder->escape_next = false;
+  decoder->state = framing == FUSAIN_FRAMING_COBS ? DECODER_STATE_COBS
+                                                  : DECODER_STATE_IDLE;
+}
+#endif
+
+/* Address Alias Sessions */
+void fusain_decoder_set_alias(fusain_decoder_t* decoder, fusain_alias_t* alias)
+{
+  decoder->alias = alias;
+}
+
+void fusain_alias_propose(fusain_alias_t* session, uint64_t address,
+    uint8_t alias)
+{
+  session->address = address;
+  session->alias = alias;
+  session->state = FUSAIN_ALIAS_PROPOSED;
+}
+
+int fusain_alias_accept(fusain_alias_t* session, const fusain_packet_t* packet)
+{
+  uint64_t alias;
+  if (!packet || packet->msg_type != FUSAIN_MSG_ALIAS_CONFIG
+      || fusain_peek_uint(packet, 0, &alias) != 0 || alias > UINT8_MAX) {
+    return -1;
+  }
+  session->address = packet->address;
+  session->alias = (uint8_t)alias;
+  session->state = FUSAIN_ALIAS_ACTIVE;
+  return 0;
+}
+
+void fusain_alias_reset(fusain_alias_t* session)
+{
+  session->state = FUSAIN_ALIAS_OFF;
+}
+
+/* In-Place Frame Extraction
+ *
+ * Stuffed frame content never contains a raw START or END byte, so frame
+ * boundaries are found by scanning, and unstuffing can write each byte at
+ * or before the position it was read from.
+ */
+static fusain_decode_result_t extract_in_place(uint8_t* frame, size_t length,
+    fusain_alias_t* alias, fusain_frame_view_t* view)
+{
+  /* frame holds [LENGTH][ADDRESS(8 or 1)][CBOR_PAYLOAD][CRC(2)], still stuffed */
+  if (length == 0) {
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+  bool aliased = (frame[0] & FUSAIN_LENGTH_ALIAS_FLAG) != 0;
+  size_t payload_length = frame[0] & ~FUSAIN_LENGTH_ALIAS_FLAG;
+  if (payload_length > FUSAIN_MAX_PAYLOAD_SIZE
+      || (aliased && (!alias || alias->state == FUSAIN_ALIAS_OFF))) {
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+
+  size_t header = aliased ? 2 : 9; /* LENGTH + ADDRESS */
+  size_t out = 1;
+  bool escape_next = false;
+  for (size_t i = 1; i < length; i++) {
+    uint8_t byte = frame[i];
+    if (escape_next) {
+      byte ^= FUSAIN_ESC_XOR;
+      escape_next = false;
+    } else if (byte == FUSAIN_ESC_BYTE) {
+      escape_next = true;
+      continue;
+    }
+    frame[out++] = byte;
+  }
+  if (escape_next || out != payload_length + header + 2) {
+    return FUSAIN_DECODE_INVALID_LENGTH;
+  }
+
+  /* Validate CRC (LENGTH + ADDRESS + CBOR_PAYLOAD) */
+  uint16_t crc = ((uint16_t)frame[payload_length + header] << 8)
+      | frame[payload_length + header + 1];
+  if (crc16_table_update(0xFFFF, frame, payload_length + header) != crc) {
+    return FUSAIN_DECODE_INVALID_CRC;
+  }
+
+  /* Expand a session alias back to the full address, as the decoder does */
+  if (aliased) {
+    if (frame[1] != alias->alias) {
+      return FUSAIN_DECODE_UNKNOWN_ALIAS;
+    }
+    view->address = alias->address;
+  } else {
+    view->address = 0;
+    for (int i = 0; i < 8; i++) {
+      view->address |= ((uint64_t)frame[1 + i]) << (i * 8);
+    }
+  }
+
+  size_t header_len = 0;
+  if (decode_cbor_message_header(&frame[header], payload_length, &view->msg_type,
+          &header_len)
+      != 0) {
+    return FUSAIN_DECODE_INVALID_START; /* Invalid CBOR format */
+  }
+  if (aliased) {
+    alias->state = FUSAIN_ALIAS_ACTIVE; /* Peer proved it speaks aliases */
+  }
+
+  view->payload = &frame[header];
+  view->length = payload_length;
+  return FUSAIN_DECODE_OK;
+}
+
+fusain_decode_result_t fusain_extract_frame(fusain_extractor_t* extractor,
+    uint8_t* data, size_t length, fusain_frame_view_t* view,
+    size_t* consumed)
+{
+  return fusain_extract_frame_alias(extractor, NULL, data, length, view, consumed);
+}
+
+fusain_decode_result_t fusain_extract_frame_alias(fusain_extractor_t* extractor,
+    fusain_alias_t* alias, uint8_t* data, size_t length, fusain_frame_view_t* view,
+    size_t* consumed)
+{
+  size_t i = 0;
+
+  /* Complete a frame split across chunks in the carry buffer */
+  if (extractor->carry_length > 0) {
+    for (; i < length; i++) {
+      if (data[i] == FUSAIN_START_BYTE) {
+        extractor->carry_length = 0; /* Truncated frame, resync on new START */
+        break;
+      }
+      if (data[i] == FUSAIN_END_BYTE) {
+        size_t carried = extractor->carry_length - 1; /* Skip START */
+        extractor->carry_length = 0;
+        *consumed = i + 1;
+        return extract_in_place(&extractor->carry[1], carried, alias, view);
+      }
+      if (extractor->carry_length >= sizeof(extractor->carry)) {
+        extractor->carry_length = 0;
+        *consumed = i;
+        return FUSAIN_DECODE_BUFFER_OVERFLOW;
+      }
+      extractor->carry[extractor->carry_length++] = data[i];
+    }
+    if (i == length) {
+      *consumed = length;
+      return FUSAIN_DECODE_INCOMPLETE;
+    }
+  }
+
+  /* Skip to START */
+  while (i < length && data[i] != FUSAIN_START_BYTE) {
+    i++;
+  }
+  if (i == length) {
+    *consumed = length;
+    return FUSAIN_DECODE_INCOMPLETE;
+  }
+
+  /* Find END; a second START means the previous frame was truncated */
+  size_t start = i;
+  for (i = start + 1; i < length; i++) {
+    if (data[i] == FUSAIN_START_BYTE) {
+      start = i;
+    } else if (data[i] == FUSAIN_END_BYTE) {
+      *consumed = i + 1;
+      return extract_in_place(&data[start + 1], i - start - 1, alias, view);
+    }
+  }
+
+  /* Frame continues in the next chunk */
+  *consumed = length;
+  if (length - start > sizeof(extractor->carry)) {
+    return FUSAIN_DECODE_BUFFER_OVERFLOW;
+  }
+  memcpy(extractor->carry, &data[start], length - start);
+  extractor->carry_length = length - start;
+  return FUSAIN_DECODE_INCOMPLETE;
+}
+
+/* Reset Frame Extractor */
+void fusain_reset_extractor(fusain_extractor_t* extractor)
+{
+  extractor->carry_length = 0;
+}
+
+/* Single-Field Peek
+ *
+ * Minimal CBOR reader: walks the top-level payload map, skipping entries
+ * by their headers, and decodes only the value under the requested key.
+ */
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NINT 1
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_MAJOR_SIMPLE 7
+#define CBOR_INFO_INDEFINITE 31
+#define CBOR_BREAK 0xFF
+#define CBOR_MAX_SKIP_DEPTH 8
+
+typedef struct {
+  const uint8_t* p;
+  const uint8_t* end;
+} cbor_cursor_t;
+
+typedef struct {
+  uint8_t major;
+  uint8_t info;
+  uint64_t arg; /* Value, length or count; raw bits for floats */
+} cbor_head_t;
+
+static int cbor_read_head(cbor_cursor_t* c, cbor_head_t* head)
+{
+  if (c->p >= c->end) {
+    return -1;
+  }
+  uint8_t initial = *c->p++;
+  head->major = initial >> 5;
+  head->info = initial & 0x1F;
+  head->arg = head->info;
+  if (head->info < 24 || head->info == CBOR_INFO_INDEFINITE) {
+    return 0;
+  }
+  if (head->info > 27) {
+    return -1; /* Reserved additional information */
+  }
+
+  size_t n = (size_t)1 << (head->info - 24);
+  if ((size_t)(c->end - c->p) < n) {
+    return -1;
+  }
+  head->arg = 0;
+  for (size_t i = 0; i < n; i++) {
+    head->arg = (head->arg << 8) | *c->p++;
+  }
+  return 0;
+}
+
+static int cbor_skip(cbor_cursor_t* c, int depth)
+{
+  cbor_head_t head;
+  if (depth > CBOR_MAX_SKIP_DEPTH || cbor_read_head(c, &head) < 0) {
+    return -1;
+  }
+
+  bool indefinite = head.info == CBOR_INFO_INDEFINITE;
+  switch (head.major) {
+  case 2: /* Byte string */
+  case 3: /* Text string */
+    if (!indefinite) {
+      if (head.arg > (uint64_t)(c->end - c->p)) {
+        return -1;
+      }
+      c->p += head.arg;
+      return 0;
+    }
+    break; /* Chunks until break */
+  case 4: /* Array */
+  case 5: /* Map */
+    if (!indefinite) {
+      if (head.arg > (uint64_t)(c->end - c->p)) {
+        return -1; /* Every item needs at least one byte */
+      }
+      uint64_t items = head.major == 5 ? head.arg * 2 : head.arg;
+      for (uint64_t i = 0; i < items; i++) {
+        if (cbor_skip(c, depth + 1) < 0) {
+          return -1;
+        }
+      }
+      return 0;
+    }
+    break; /* Items until break */
+  case 6: /* Tag: skip the tagged item */
+    return indefinite ? -1 : cbor_skip(c, depth + 1);
+  default: /* Integers, simple values and floats: head only */
+    return indefinite ? -1 : 0;
+  }
+
+  while (c->p < c->end && *c->p != CBOR_BREAK) {
+    if (cbor_skip(c, depth + 1) < 0) {
+      return -1;
+    }
+  }
+  if (c->p >= c->end) {
+    return -1;
+  }
+  c->p++; /* Break */
+  return 0;
+}
+
+/* Position a cursor on the value stored under key and read its head;
+ * at (optional) is left just past that head */
+static int peek_find(const fusain_packet_t* packet, uint32_t key,
+    cbor_head_t* value, cbor_cursor_t* at)
+{
+  if (!packet || packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -1;
+  }
+
+  uint8_t msg_type;
+  size_t header_len = 0;
+  if (decode_cbor_message_header(packet->payload, packet->length, &msg_type,
+          &header_len)
+      != 0) {
+    return -1;
+  }
+
+  cbor_cursor_t c = { packet->payload + header_len,
+    packet->payload + packet->length };
+  cbor_head_t map;
+  if (cbor_read_head(&c, &map) < 0) {
+    return -1;
+  }
+  if (map.major == CBOR_MAJOR_SIMPLE && map.arg == 22) {
+    return -2; /* nil payload has no fields */
+  }
+  if (map.major != CBOR_MAJOR_MAP) {
+    return -1;
+  }
+
+  bool indefinite = map.info == CBOR_INFO_INDEFINITE;
+  for (uint64_t i = 0; indefinite || i < map.arg; i++) {
+    if (indefinite && c.p < c.end && *c.p == CBOR_BREAK) {
+      return -2;
+    }
+    cbor_cursor_t key_start = c;
+    cbor_head_t k;
+    if (cbor_read_head(&c, &k) < 0) {
+      return -1;
+    }
+    if (k.major == CBOR_MAJOR_UINT && k.info != CBOR_INFO_INDEFINITE
+        && k.arg == key) {
+      if (cbor_read_head(&c, value) < 0) {
+        return -1;
+      }
+      if (at) {
+        *at = c;
+      }
+      return 0;
+    }
+    c = key_start; /* Skip the whole key, whatever its type */
+    if (cbor_skip(&c, 0) < 0 || cbor_skip(&c, 0) < 0) {
+      return -1;
+    }
+  }
+  return -2;
+}
+
+/* IEEE 754 half precision to single precision */
+static float cbor_half_to_float(uint16_t half)
+{
+  uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+  uint32_t exp = (half >> 10) & 0x1F;
+  uint32_t mant = half & 0x3FF;
+  uint32_t bits;
+
+  if (exp == 0x1F) {
+    bits = sign | 0x7F800000 | (mant << 13); /* Infinity or NaN */
+  } else if (exp != 0) {
+    bits = sign | ((exp + 112) << 23) | (mant << 13);
+  } else if (mant == 0) {
+    bits = sign; /* Signed zero */
+  } else {
+    /* Subnormal half: normalize into a single precision exponent */
+    exp = 113;
+    while (!(mant & 0x400)) {
+      mant <<= 1;
+      exp--;
+    }
+    bits = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+  }
+
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+int fusain_peek_uint(const fusain_packet_t* packet, uint32_t key,
+    uint64_t* value)
+{
+  cbor_head_t head;
+  int ret = value ? peek_find(packet, key, &head, NULL) : -1;
+  if (ret < 0) {
+    return ret;
+  }
+  if (head.major != CBOR_MAJOR_UINT || head.info == CBOR_INFO_INDEFINITE) {
+    return -3;
+  }
+  *value = head.arg;
+  return 0;
+}
+
+int fusain_peek_int(const fusain_packet_t* packet, uint32_t key,
+    int64_t* value)
+{
+  cbor_head_t head;
+  int ret = value ? peek_find(packet, key, &head, NULL) : -1;
+  if (ret < 0) {
+    return ret;
+  }
+  if ((head.major != CBOR_MAJOR_UINT && head.major != CBOR_MAJOR_NINT)
+      || head.info == CBOR_INFO_INDEFINITE || head.arg > INT64_MAX) {
+    return -3;
+  }
+  /* Negative integers encode -1 - n */
+  *value = head.major == CBOR_MAJOR_UINT ? (int64_t)head.arg
+                                         : -1 - (int64_t)head.arg;
+  return 0;
+}
+
+int fusain_peek_float(const fusain_packet_t* packet, uint32_t key,
+    double* value)
+{
+  cbor_head_t head;
+  int ret = value ? peek_find(packet, key, &head, NULL) : -1;
+  if (ret < 0) {
+    return ret;
+  }
+  if (head.major != CBOR_MAJOR_SIMPLE) {
+    return -3;
+  }
+
+  if (head.info == 25) {
+    *value = cbor_half_to_float((uint16_t)head.arg);
+  } else if (head.info == 26) {
+    uint32_t bits = (uint32_t)head.arg;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    *value = f;
+  } else if (head.info == 27) {
+    memcpy(value, &head.arg, sizeof(*value));
+  } else {
+    return -3;
+  }
+  return 0;
+}
+
+int fusain_peek_bool(const fusain_packet_t* packet, uint32_t key, bool* value)
+{
+  cbor_head_t head;
+  int ret = value ? peek_find(packet, key, &head, NULL) : -1;
+  if (ret < 0) {
+    return ret;
+  }
+  if (head.major != CBOR_MAJOR_SIMPLE || (head.info != 20 && head.info != 21)) {
+    return -3;
+  }
+  *value = head.info == 21;
+  return 0;
+}
+
+/* Shortest Float Encoding
+ *
+ * Walks the payload head by head (container heads are copied as-is, so
+ * no recursion is needed) and narrows each float64 that survives the
+ * round trip. Output is built in a scratch buffer and only copied back
+ * once the whole payload has parsed.
+ */
+static bool float_to_half_exact(float f, uint16_t* half)
+{
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+  int32_t exp = (int32_t)((bits >> 23) & 0xFF) - 127;
+  uint32_t mant = bits & 0x7FFFFF;
+  uint16_t candidate;
+
+  if ((bits & 0x7FFFFFFF) == 0) {
+    candidate = sign; /* Signed zero */
+  } else if (exp == 128) {
+    candidate = sign | 0x7C00; /* Infinity (NaN is filtered by the caller) */
+  } else if (exp >= -14 && exp <= 15) {
+    candidate = (uint16_t)(sign | ((exp + 15) << 10) | (mant >> 13));
+  } else if (exp >= -24 && exp < -14) {
+    /* Half subnormal: value = m * 2^-24 */
+    candidate = (uint16_t)(sign | ((0x800000 | mant) >> (-exp - 1)));
+  } else {
+    return false;
+  }
+
+  /* Reject any candidate that dropped mantissa bits */
+  float back = cbor_half_to_float(candidate);
+  if (memcmp(&back, &f, sizeof(f)) != 0) {
+    return false;
+  }
+  *half = candidate;
+  return true;
+}
+
+static size_t compact_float(uint64_t bits, uint8_t* out)
+{
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  float f = (float)d;
+
+  if (d != d || (double)f != d) {
+    out[0] = 0xFB;
+    for (int i = 0; i < 8; i++) {
+      out[1 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+    return 9;
+  }
+
+  uint16_t half;
+  if (float_to_half_exact(f, &half)) {
+    out[0] = 0xF9;
+    out[1] = (uint8_t)(half >> 8);
+    out[2] = (uint8_t)half;
+    return 3;
+  }
+
+  uint32_t single;
+  memcpy(&single, &f, sizeof(single));
+  out[0] = 0xFA;
+  for (int i = 0; i < 4; i++) {
+    out[1 + i] = (uint8_t)(single >> (24 - 8 * i));
+  }
+  return 5;
+}
+
+int fusain_compact_floats(fusain_packet_t* packet)
+{
+  if (!packet || packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -1;
+  }
+
+  uint8_t out[FUSAIN_MAX_PAYLOAD_SIZE];
+  size_t w = 0;
+  cbor_cursor_t c = { packet->payload, packet->payload + packet->length };
+
+  while (c.p < c.end) {
+    const uint8_t* start = c.p;
+    cbor_head_t head;
+    if (cbor_read_head(&c, &head) < 0) {
+      return -1;
+    }
+
+    if (head.major == CBOR_MAJOR_SIMPLE && head.info == 27) {
+      w += compact_float(head.arg, out + w);
+      continue;
+    }
+
+    /* Definite strings carry their body inline */
+    size_t body = 0;
+    if ((head.major == 2 || head.major == 3)
+        && head.info != CBOR_INFO_INDEFINITE) {
+      if (head.arg > (uint64_t)(c.end - c.p)) {
+        return -1;
+      }
+      body = (size_t)head.arg;
+    }
+    size_t n = (size_t)(c.p - start) + body;
+    memcpy(out + w, start, n);
+    c.p += body;
+    w += n;
+  }
+
+  int saved = (int)(packet->length - w);
+  memcpy(packet->payload, out, w);
+  packet->length = (uint8_t)w;
+  return saved;
+}
+
+/* TEMP_DATA Decoding
+ *
+ * Built on the peek reader so the fixed-point and float reading forms
+ * share one path; the generated decoder requires the float at key 2.
+ */
+#if FUSAIN_HAS_FIXED_POINT
+/* Scale a CBOR float head by 100 using integer arithmetic only */
+static int float_head_to_centi(const cbor_head_t* head, int32_t* centi)
+{
+  unsigned mant_bits;
+  unsigned exp_bits;
+  switch (head->major == CBOR_MAJOR_SIMPLE ? head->info : 0) {
+  case 25:
+    mant_bits = 10;
+    exp_bits = 5;
+    break;
+  case 26:
+    mant_bits = 23;
+    exp_bits = 8;
+    break;
+  case 27:
+    mant_bits = 52;
+    exp_bits = 11;
+    break;
+  default:
+    return -3;
+  }
+
+  uint64_t bits = head->arg;
+  bool negative = (bits >> (mant_bits + exp_bits)) & 1;
+  uint32_t exp_max = (1u << exp_bits) - 1;
+  uint32_t exp = (uint32_t)(bits >> mant_bits) & exp_max;
+  uint64_t mant = bits & ((UINT64_C(1) << mant_bits) - 1);
+  if (exp == exp_max) {
+    return -3; /* Infinity or NaN */
+  }
+
+  /* value = mant * 2^shift */
+  int32_t bias = (int32_t)(exp_max >> 1);
+  int32_t shift;
+  if (exp == 0) {
+    shift = 1 - bias - (int32_t)mant_bits; /* Subnormal */
+  } else {
+    mant |= UINT64_C(1) << mant_bits;
+    shift = (int32_t)exp - bias - (int32_t)mant_bits;
+  }
+
+  uint64_t scaled = mant * 100; /* mant < 2^53, so this stays below 2^60 */
+  uint64_t magnitude;
+  if (shift >= 0) {
+    if (shift > 32 || scaled > ((UINT64_C(1) << 32) >> shift)) {
+      return -3;
+    }
+    magnitude = scaled << shift;
+  } else if (shift < -62) {
+    magnitude = 0;
+  } else {
+    unsigned s = (unsigned)-shift;
+    magnitude = (scaled + (UINT64_C(1) << (s - 1))) >> s; /* Round half away */
+  }
+
+  if (magnitude > (negative ? UINT64_C(0x80000000) : (uint64_t)INT32_MAX)) {
+    return -3;
+  }
+  *centi = (int32_t)(negative ? -(int64_t)magnitude : (int64_t)magnitude);
+  return 0;
+}
+
+int fusain_read_temp_centi(const fusain_packet_t* packet, int32_t* centi)
+{
+  int64_t value;
+  int ret = centi ? fusain_peek_int(packet, FUSAIN_TEMP_DATA_KEY_CENTI, &value)
+                  : -1;
+  if (ret == 0) {
+    if (value < INT32_MIN || value > INT32_MAX) {
+      return -3;
+    }
+    *centi = (int32_t)value;
+    return 0;
+  }
+  if (ret != -2) {
+    return ret;
+  }
+
+  cbor_head_t head;
+  ret = peek_find(packet, 2, &head, NULL);
+  if (ret < 0) {
+    return ret;
+  }
+  return float_head_to_centi(&head, centi);
+}
+#endif /* FUSAIN_HAS_FIXED_POINT */
+
+/* Fold an optional field lookup into the present mask; -2 is not an error */
+static int temp_data_optional(int ret, int field, int* fields)
+{
+  if (ret == 0) {
+    *fields |= field;
+  }
+  return ret == -2 ? 0 : ret;
+}
 
-  /* Handle escape sequences */
-  if (rx_byte == FUSAIN_ESC_BYTE && !(decoder->escape_next)) {
-    decoder->escape_next = true;
-    return FUSAIN_DECODE_INCOMPLETE;
+int fusain_decode_temp_data(const fusain_packet_t* packet,
+    fusain_temp_data_t* data)
+{
+  if (!packet || !data || packet->msg_type != FUSAIN_MSG_TEMP_DATA) {
+    return -1;
   }
+  memset(data, 0, sizeof(*data));
 
-  /* Unescape byte if needed */
-  uint8_t byte = rx_byte;
-  if (decoder->escape_next) {
-    byte ^= FUSAIN_ESC_XOR;
-    decoder->escape_next = false;
+  int64_t index;
+  uint64_t timestamp;
+  int ret = fusain_peek_int(packet, 0, &index);
+  if (ret == 0 && (index < 0 || index > INT8_MAX)) {
+    ret = -3;
+  }
+  if (ret == 0) {
+    ret = fusain_peek_uint(packet, 1, &timestamp);
+  }
+  if (ret == 0 && timestamp > UINT32_MAX) {
+    ret = -3;
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  data->thermometer = (uint8_t)index;
+  data->timestamp = (uint32_t)timestamp;
+
+  int64_t centi;
+  double reading;
+  ret = fusain_peek_int(packet, FUSAIN_TEMP_DATA_KEY_CENTI, &centi);
+  if (ret == 0) {
+    data->reading = (float)centi / 100.0f;
+  } else if (ret == -2) {
+    ret = fusain_peek_float(packet, 2, &reading);
+    data->reading = (float)reading;
+  }
+  if (ret < 0) {
+    return ret;
   }
 
-  /* State machine */
-  switch (decoder->state) {
-  case DECODER_STATE_IDLE:
-    return FUSAIN_DECODE_INCOMPLETE;
+  int fields = 0;
+  int64_t motor = 0;
+  double target = 0.0;
+  ret = temp_data_optional(fusain_peek_bool(packet, 3, &data->rpm_control),
+      FUSAIN_TEMP_DATA_RPM_CONTROL, &fields);
+  if (ret == 0) {
+    ret = temp_data_optional(fusain_peek_int(packet, 4, &motor),
+        FUSAIN_TEMP_DATA_WATCHED_MOTOR, &fields);
+  }
+  if (ret == 0 && (motor < INT32_MIN || motor > INT32_MAX)) {
+    ret = -3;
+  }
+  if (ret == 0) {
+    ret = temp_data_optional(fusain_peek_float(packet, 5, &target),
+        FUSAIN_TEMP_DATA_TARGET_TEMP, &fields);
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  data->watched_motor = (int32_t)motor;
+  data->target_temp = (float)target;
+  return fields;
+}
 
-  case DECODER_STATE_LENGTH:
-    if (byte > FUSAIN_MAX_PAYLOAD_SIZE) {
-      decoder->state = DECODER_STATE_IDLE;
-      return FUSAIN_DECODE_INVALID_LENGTH;
-    }
-    packet->length = byte;
-    decoder->buffer[decoder->buffer_index++] = byte;
-    decoder->addr_byte_count = 0;
-    decoder->state = DECODER_STATE_ADDRESS;
-    return FUSAIN_DECODE_INCOMPLETE;
+/* TELEMETRY_BATCH Decoding */
 
-  case DECODER_STATE_ADDRESS:
-    /* Accumulate address bytes (little-endian) */
-    packet->address |= ((uint64_t)byte) << (decoder->addr_byte_count * 8);
-    decoder->buffer[decoder->buffer_index++] = byte;
-    decoder->addr_byte_count++;
-    if (decoder->addr_byte_count >= 8) {
-      /* All 8 address bytes received, move to CBOR payload */
-      if (packet->length == 0) {
-        decoder->state = DECODER_STATE_CRC1;
-      } else {
-        decoder->state = DECODER_STATE_PAYLOAD;
-      }
+/* Step through a definite or indefinite container: 1 while items remain,
+ * 0 at its end (break consumed), -1 if the payload runs out */
+static int cbor_container_next(cbor_cursor_t* c, const cbor_head_t* head,
+    uint64_t* seen)
+{
+  if (head->info == CBOR_INFO_INDEFINITE) {
+    if (c->p >= c->end) {
+      return -1;
     }
-    return FUSAIN_DECODE_INCOMPLETE;
-
-  case DECODER_STATE_PAYLOAD:
-    /* Store CBOR payload bytes directly */
-    packet->payload[decoder->buffer_index - 9] = byte; /* -1 length -8 addr */
-    decoder->buffer[decoder->buffer_index++] = byte;
-    if (decoder->buffer_index >= (size_t)(packet->length + 9)) {
-      decoder->state = DECODER_STATE_CRC1;
+    if (*c->p == CBOR_BREAK) {
+      c->p++;
+      return 0;
     }
-    return FUSAIN_DECODE_INCOMPLETE;
+    return 1;
+  }
+  return (*seen)++ < head->arg ? 1 : 0;
+}
 
-  case DECODER_STATE_CRC1:
-    packet->crc = (uint16_t)byte << 8;
-    decoder->state = DECODER_STATE_CRC2;
-    return FUSAIN_DECODE_INCOMPLETE;
+static int cbor_read_uint(cbor_cursor_t* c, uint64_t max, uint64_t* value)
+{
+  cbor_head_t head;
+  if (cbor_read_head(c, &head) < 0) {
+    return -1;
+  }
+  if (head.major != CBOR_MAJOR_UINT || head.info == CBOR_INFO_INDEFINITE
+      || head.arg > max) {
+    return -3;
+  }
+  *value = head.arg;
+  return 0;
+}
 
-  case DECODER_STATE_CRC2:
-    packet->crc |= byte;
-    decoder->state = DECODER_STATE_END;
-    return FUSAIN_DECODE_INCOMPLETE;
+static int batch_read_value(cbor_cursor_t* c, fusain_batch_value_t* value)
+{
+  cbor_head_t head;
+  if (cbor_read_head(c, &head) < 0) {
+    return -1;
+  }
+  value->is_float = head.major == CBOR_MAJOR_SIMPLE;
 
-  case DECODER_STATE_END: {
-    if (rx_byte != FUSAIN_END_BYTE) {
-      decoder->state = DECODER_STATE_IDLE;
-      return FUSAIN_DECODE_INVALID_START;
+  if (head.major == CBOR_MAJOR_UINT || head.major == CBOR_MAJOR_NINT) {
+    if (head.info == CBOR_INFO_INDEFINITE
+        || head.arg > (head.major == CBOR_MAJOR_UINT ? INT32_MAX : -(INT32_MIN + 1))) {
+      return -3;
     }
+    value->as.i = head.major == CBOR_MAJOR_UINT ? (int32_t)head.arg
+                                                : -1 - (int32_t)head.arg;
+  } else if (value->is_float && head.info == 25) {
+    value->as.f = cbor_half_to_float((uint16_t)head.arg);
+  } else if (value->is_float && head.info == 26) {
+    uint32_t bits = (uint32_t)head.arg;
+    memcpy(&value->as.f, &bits, sizeof(value->as.f));
+  } else if (value->is_float && head.info == 27) {
+    double d;
+    memcpy(&d, &head.arg, sizeof(d));
+    value->as.f = (float)d;
+  } else {
+    return -3;
+  }
+  return 0;
+}
 
-    /* Validate CRC (LENGTH + ADDRESS + CBOR_PAYLOAD) */
-    uint16_t calculated_crc = fusain_crc16(decoder->buffer, packet->length + 9);
-    if (calculated_crc != packet->crc) {
-      decoder->state = DECODER_STATE_IDLE;
-      return FUSAIN_DECODE_INVALID_CRC;
-    }
+static int batch_read_record(cbor_cursor_t* c, fusain_batch_record_t* record)
+{
+  cbor_head_t head;
+  if (cbor_read_head(c, &head) < 0) {
+    return -1;
+  }
+  if (head.major != CBOR_MAJOR_ARRAY || head.arg != 4) {
+    return -3;
+  }
 
-    /* Extract msg_type from CBOR payload [type, payload_map] */
-    size_t header_len = 0;
-    if (decode_cbor_message_header(packet->payload, packet->length,
-            &packet->msg_type, &header_len)
-        != 0) {
-      decoder->state = DECODER_STATE_IDLE;
-      return FUSAIN_DECODE_INVALID_START; /* Invalid CBOR format */
+  uint64_t kind;
+  uint64_t index;
+  uint64_t dt;
+  int ret = cbor_read_uint(c, UINT8_MAX, &kind);
+  if (ret == 0) {
+    ret = cbor_read_uint(c, UINT8_MAX, &index);
+  }
+  if (ret == 0) {
+    ret = cbor_read_uint(c, UINT16_MAX, &dt);
+  }
+  if (ret == 0 && cbor_read_head(c, &head) < 0) {
+    ret = -1;
+  }
+  if (ret == 0 && head.major != CBOR_MAJOR_ARRAY) {
+    ret = -3;
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  record->kind = (uint8_t)kind;
+  record->index = (uint8_t)index;
+  record->dt_ms = (uint16_t)dt;
+  record->value_count = 0;
+
+  uint64_t seen = 0;
+  while ((ret = cbor_container_next(c, &head, &seen)) > 0) {
+    if (record->value_count >= FUSAIN_BATCH_MAX_VALUES) {
+      return -3;
+    }
+    ret = batch_read_value(c, &record->values[record->value_count++]);
+    if (ret < 0) {
+      return ret;
     }
+  }
+  return ret;
+}
 
-    /* Packet complete and valid */
-    decoder->state = DECODER_STATE_IDLE;
-    return FUSAIN_DECODE_OK;
+int fusain_decode_telemetry_batch(const fusain_packet_t* packet,
+    fusain_telemetry_batch_t* batch)
+{
+  if (!packet || !batch || packet->msg_type != FUSAIN_MSG_TELEMETRY_BATCH) {
+    return -1;
   }
+  batch->count = 0;
 
-  default:
-    decoder->state = DECODER_STATE_IDLE;
-    return FUSAIN_DECODE_INVALID_START;
+  uint64_t base;
+  int ret = fusain_peek_uint(packet, 0, &base);
+  if (ret == 0 && base > UINT32_MAX) {
+    ret = -3;
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  batch->base_timestamp = (uint32_t)base;
+
+  cbor_cursor_t c;
+  cbor_head_t records;
+  ret = peek_find(packet, 1, &records, &c);
+  if (ret < 0) {
+    return ret;
+  }
+  if (records.major != CBOR_MAJOR_ARRAY) {
+    return -3;
+  }
+
+  uint64_t seen = 0;
+  while ((ret = cbor_container_next(&c, &records, &seen)) > 0) {
+    if (batch->count >= FUSAIN_BATCH_MAX_RECORDS) {
+      return -3;
+    }
+    ret = batch_read_record(&c, &batch->records[batch->count++]);
+    if (ret < 0) {
+      return ret;
+    }
   }
+  return ret;
 }
 
-/* Reset Decoder */
-void fusain_reset_decoder(fusain_decoder_t* decoder)
+/* Create helpers narrow their floats only in shortest-float mode */
+#ifdef CONFIG_FUSAIN_SHORTEST_FLOAT
+#define FINISH_FLOAT_PAYLOAD(packet) ((void)fusain_compact_floats(packet))
+#else
+#define FINISH_FLOAT_PAYLOAD(packet) ((void)0)
+#endif
+
+#if FUSAIN_HAS_MSG_CONFIG || FUSAIN_HAS_MSG_TELEMETRY
+/* Hand-Written CBOR Encoding
+ *
+ * Used where the generated encoder does not fit: ALIAS_CONFIG, the
+ * integer-only fixed-point path and the incremental batch builder.
+ */
+
+/* Append a CBOR head with a 32-bit argument in its shortest form */
+static size_t cbor_put_head(uint8_t* out, uint8_t major, uint32_t arg)
 {
-  decoder->state = DECODER_STATE_IDLE;
-  decoder->buffer_index = 0;
-  decoder->escape_next = false;
-  decoder->addr_byte_count = 0;
+  major <<= 5;
+  if (arg < 24) {
+    out[0] = (uint8_t)(major | arg);
+    return 1;
+  }
+  if (arg <= 0xFF) {
+    out[0] = major | 24;
+    out[1] = (uint8_t)arg;
+    return 2;
+  }
+  if (arg <= 0xFFFF) {
+    out[0] = major | 25;
+    out[1] = (uint8_t)(arg >> 8);
+    out[2] = (uint8_t)arg;
+    return 3;
+  }
+  out[0] = major | 26;
+  out[1] = (uint8_t)(arg >> 24);
+  out[2] = (uint8_t)(arg >> 16);
+  out[3] = (uint8_t)(arg >> 8);
+  out[4] = (uint8_t)arg;
+  return 5;
 }
+#endif /* FUSAIN_HAS_MSG_CONFIG || FUSAIN_HAS_MSG_TELEMETRY */
 
 /* Helper Functions to Create Packets */
 
+#if FUSAIN_HAS_MSG_CONTROL
 void fusain_create_state_command(fusain_packet_t* packet, uint64_t address,
     fusain_mode_t mode, int32_t argument)
 {
@@ -517,6 +2279,7 @@ void fusain_create_temp_command(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
 
   packet->length = (uint8_t)(offset + payload_len);
+  FINISH_FLOAT_PAYLOAD(packet);
 }
 
 void fusain_create_ping_request(fusain_packet_t* packet, uint64_t address)
@@ -542,7 +2305,9 @@ void fusain_create_ping_request(fusain_packet_t* packet, uint64_t address)
 
   packet->length = (uint8_t)(offset + (size_t)nil_len);
 }
+#endif /* FUSAIN_HAS_MSG_CONTROL */
 
+#if FUSAIN_HAS_MSG_CONFIG
 void fusain_create_telemetry_config(fusain_packet_t* packet, uint64_t address, bool enabled,
     uint32_t interval_ms)
 {
@@ -604,7 +2369,9 @@ void fusain_create_timeout_config(fusain_packet_t* packet, uint64_t address, boo
 
   packet->length = (uint8_t)(offset + payload_len);
 }
+#endif /* FUSAIN_HAS_MSG_CONFIG */
 
+#if FUSAIN_HAS_MSG_CONTROL
 void fusain_create_send_telemetry(fusain_packet_t* packet, uint64_t address,
     uint32_t telemetry_type, uint32_t index)
 {
@@ -636,7 +2403,9 @@ void fusain_create_send_telemetry(fusain_packet_t* packet, uint64_t address,
 
   packet->length = (uint8_t)(offset + payload_len);
 }
+#endif /* FUSAIN_HAS_MSG_CONTROL */
 
+#if FUSAIN_HAS_MSG_TELEMETRY
 void fusain_create_state_data(fusain_packet_t* packet, uint64_t address,
     uint32_t error, uint8_t code, fusain_state_t state, uint32_t timestamp)
 {
@@ -699,9 +2468,11 @@ void fusain_create_ping_response(fusain_packet_t* packet, uint64_t address,
 
   packet->length = (uint8_t)(offset + payload_len);
 }
+#endif /* FUSAIN_HAS_MSG_TELEMETRY */
 
 /* v3.0 Configuration Command Functions (CBOR) */
 
+#if FUSAIN_HAS_MSG_CONFIG
 void fusain_create_motor_config(fusain_packet_t* packet, uint64_t address,
     const fusain_cmd_motor_config_t* config)
 {
@@ -748,6 +2519,7 @@ void fusain_create_motor_config(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
 
   packet->length = (uint8_t)(offset + payload_len);
+  FINISH_FLOAT_PAYLOAD(packet);
 }
 
 void fusain_create_pump_config(fusain_packet_t* packet, uint64_t address,
@@ -820,6 +2592,7 @@ void fusain_create_temp_config(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
 
   packet->length = (uint8_t)(offset + payload_len);
+  FINISH_FLOAT_PAYLOAD(packet);
 }
 
 void fusain_create_glow_config(fusain_packet_t* packet, uint64_t address,
@@ -940,6 +2713,25 @@ void fusain_create_discovery_request(fusain_packet_t* packet, uint64_t address)
   packet->length = (uint8_t)(offset + (size_t)nil_len);
 }
 
+void fusain_create_alias_config(fusain_packet_t* packet, uint64_t address,
+    uint8_t alias)
+{
+  packet->address = address;
+  packet->msg_type = FUSAIN_MSG_ALIAS_CONFIG;
+
+  /* {0: alias} */
+  uint8_t* p = packet->payload;
+  size_t n = (size_t)encode_cbor_message_header(p, FUSAIN_MAX_PAYLOAD_SIZE,
+      FUSAIN_MSG_ALIAS_CONFIG);
+  p[n++] = 0xBF;
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, 0);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, alias);
+  p[n++] = CBOR_BREAK;
+  packet->length = (uint8_t)n;
+}
+#endif /* FUSAIN_HAS_MSG_CONFIG */
+
+#if FUSAIN_HAS_MSG_TELEMETRY
 void fusain_create_device_announce(fusain_packet_t* packet, uint64_t address,
     uint8_t motor_count, uint8_t thermometer_count, uint8_t pump_count,
     uint8_t glow_count)
@@ -976,6 +2768,18 @@ void fusain_create_device_announce(fusain_packet_t* packet, uint64_t address,
 
 void fusain_create_motor_data(fusain_packet_t* packet, uint64_t address,
     uint8_t motor, uint32_t timestamp, int32_t rpm, int32_t target)
+{
+  fusain_motor_data_t data = {
+    .motor = motor,
+    .timestamp = timestamp,
+    .rpm = rpm,
+    .target = target,
+  };
+  fusain_create_motor_data_fields(packet, address, &data, 0);
+}
+
+void fusain_create_motor_data_fields(fusain_packet_t* packet, uint64_t address,
+    const fusain_motor_data_t* data, uint8_t fields)
 {
   packet->address = address;
   packet->msg_type = FUSAIN_MSG_MOTOR_DATA;
@@ -989,15 +2793,22 @@ void fusain_create_motor_data(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
   offset = (size_t)header_len;
 
+  /* CDDL key mapping: 0=motor, 1=timestamp, 2=rpm, 3=target,
+   *                   4=max-rpm, 5=min-rpm, 6=pwm, 7=pwm-max
+   */
   struct motor_data_payload cbor_payload = {
-    .motor_data_payload_motor_index_m = (int32_t)motor,
-    .motor_data_payload_timestamp_m = timestamp,
-    .motor_data_payload_uint2int = rpm,
-    .motor_data_payload_uint3int = target,
-    .motor_data_payload_uint4int_present = false,
-    .motor_data_payload_uint5int_present = false,
-    .motor_data_payload_uint6uint_present = false,
-    .motor_data_payload_uint7uint_present = false,
+    .motor_data_payload_motor_index_m = (int32_t)data->motor,
+    .motor_data_payload_timestamp_m = data->timestamp,
+    .motor_data_payload_uint2int = data->rpm,
+    .motor_data_payload_uint3int = data->target,
+    .motor_data_payload_uint4int = { .motor_data_payload_uint4int = data->max_rpm },
+    .motor_data_payload_uint4int_present = (fields & FUSAIN_MOTOR_DATA_MAX_RPM) != 0,
+    .motor_data_payload_uint5int = { .motor_data_payload_uint5int = data->min_rpm },
+    .motor_data_payload_uint5int_present = (fields & FUSAIN_MOTOR_DATA_MIN_RPM) != 0,
+    .motor_data_payload_uint6uint = { .motor_data_payload_uint6uint = data->pwm },
+    .motor_data_payload_uint6uint_present = (fields & FUSAIN_MOTOR_DATA_PWM) != 0,
+    .motor_data_payload_uint7uint = { .motor_data_payload_uint7uint = data->pwm_max },
+    .motor_data_payload_uint7uint_present = (fields & FUSAIN_MOTOR_DATA_PWM_MAX) != 0,
   };
   size_t payload_len = 0;
   int ret = cbor_encode_motor_data_payload(
@@ -1079,6 +2890,17 @@ void fusain_create_glow_data(fusain_packet_t* packet, uint64_t address,
 
 void fusain_create_temp_data(fusain_packet_t* packet, uint64_t address,
     uint8_t thermometer, uint32_t timestamp, float reading)
+{
+  fusain_temp_data_t data = {
+    .thermometer = thermometer,
+    .timestamp = timestamp,
+    .reading = reading,
+  };
+  fusain_create_temp_data_fields(packet, address, &data, 0);
+}
+
+void fusain_create_temp_data_fields(fusain_packet_t* packet, uint64_t address,
+    const fusain_temp_data_t* data, uint8_t fields)
 {
   packet->address = address;
   packet->msg_type = FUSAIN_MSG_TEMP_DATA;
@@ -1092,13 +2914,19 @@ void fusain_create_temp_data(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
   offset = (size_t)header_len;
 
+  /* CDDL key mapping: 0=thermometer, 1=timestamp, 2=reading,
+   *                   3=rpm-control, 4=watched-motor, 5=target-temp
+   */
   struct temp_data_payload cbor_payload = {
-    .temp_data_payload_thermometer_index_m = (int32_t)thermometer,
-    .temp_data_payload_timestamp_m = timestamp,
-    .temp_data_payload_uint2float = reading,
-    .temp_data_payload_uint3bool_present = false,
-    .temp_data_payload_uint4int_present = false,
-    .temp_data_payload_uint5float_present = false,
+    .temp_data_payload_thermometer_index_m = (int32_t)data->thermometer,
+    .temp_data_payload_timestamp_m = data->timestamp,
+    .temp_data_payload_uint2float = data->reading,
+    .temp_data_payload_uint3bool = { .temp_data_payload_uint3bool = data->rpm_control },
+    .temp_data_payload_uint3bool_present = (fields & FUSAIN_TEMP_DATA_RPM_CONTROL) != 0,
+    .temp_data_payload_uint4int = { .temp_data_payload_uint4int = data->watched_motor },
+    .temp_data_payload_uint4int_present = (fields & FUSAIN_TEMP_DATA_WATCHED_MOTOR) != 0,
+    .temp_data_payload_uint5float = { .temp_data_payload_uint5float = data->target_temp },
+    .temp_data_payload_uint5float_present = (fields & FUSAIN_TEMP_DATA_TARGET_TEMP) != 0,
   };
   size_t payload_len = 0;
   int ret = cbor_encode_temp_data_payload(
@@ -1110,8 +2938,324 @@ void fusain_create_temp_data(fusain_packet_t* packet, uint64_t address,
   } /* LCOV_EXCL_STOP */
 
   packet->length = (uint8_t)(offset + payload_len);
+  FINISH_FLOAT_PAYLOAD(packet);
+}
+
+/* Delta Telemetry Encoding
+ *
+ * Deadbands compare against the last value actually sent, so slow drift
+ * still triggers a send once it accumulates past the deadband.
+ */
+static bool delta_int_exceeds(int32_t value, int32_t sent, uint32_t deadband)
+{
+  int64_t diff = (int64_t)value - (int64_t)sent;
+  return (uint64_t)(diff < 0 ? -diff : diff) > deadband;
+}
+
+static bool delta_uint_exceeds(uint32_t value, uint32_t sent, uint32_t deadband)
+{
+  return (value > sent ? value - sent : sent - value) > deadband;
+}
+
+static bool delta_refresh_due(bool* primed, uint32_t* last_refresh,
+    uint32_t refresh_ms, uint32_t timestamp)
+{
+  if (*primed && refresh_ms != 0
+      && (uint32_t)(timestamp - *last_refresh) < refresh_ms) {
+    return false;
+  }
+  *primed = true;
+  *last_refresh = timestamp;
+  return true;
+}
+
+void fusain_init_motor_delta(fusain_motor_delta_t* delta,
+    const fusain_motor_delta_config_t* config)
+{
+  memset(delta, 0, sizeof(*delta));
+  delta->config = *config;
+}
+
+uint8_t fusain_create_motor_data_delta(fusain_packet_t* packet,
+    uint64_t address, fusain_motor_delta_t* delta,
+    const fusain_motor_data_t* data)
+{
+  const fusain_motor_delta_config_t* cfg = &delta->config;
+  fusain_motor_data_t* sent = &delta->sent;
+  uint8_t fields = 0;
+
+  if (delta_refresh_due(&delta->primed, &delta->last_refresh, cfg->refresh_ms,
+          data->timestamp)) {
+    fields = FUSAIN_MOTOR_DATA_OPTIONAL;
+  } else {
+    if (delta_int_exceeds(data->max_rpm, sent->max_rpm, cfg->rpm_deadband)) {
+      fields |= FUSAIN_MOTOR_DATA_MAX_RPM;
+    }
+    if (delta_int_exceeds(data->min_rpm, sent->min_rpm, cfg->rpm_deadband)) {
+      fields |= FUSAIN_MOTOR_DATA_MIN_RPM;
+    }
+    if (delta_uint_exceeds(data->pwm, sent->pwm, cfg->pwm_deadband)) {
+      fields |= FUSAIN_MOTOR_DATA_PWM;
+    }
+    if (delta_uint_exceeds(data->pwm_max, sent->pwm_max, cfg->pwm_deadband)) {
+      fields |= FUSAIN_MOTOR_DATA_PWM_MAX;
+    }
+  }
+
+  if (fields & FUSAIN_MOTOR_DATA_MAX_RPM) {
+    sent->max_rpm = data->max_rpm;
+  }
+  if (fields & FUSAIN_MOTOR_DATA_MIN_RPM) {
+    sent->min_rpm = data->min_rpm;
+  }
+  if (fields & FUSAIN_MOTOR_DATA_PWM) {
+    sent->pwm = data->pwm;
+  }
+  if (fields & FUSAIN_MOTOR_DATA_PWM_MAX) {
+    sent->pwm_max = data->pwm_max;
+  }
+
+  fusain_create_motor_data_fields(packet, address, data, fields);
+  return fields;
+}
+
+void fusain_init_temp_delta(fusain_temp_delta_t* delta,
+    const fusain_temp_delta_config_t* config)
+{
+  memset(delta, 0, sizeof(*delta));
+  delta->config = *config;
+}
+
+uint8_t fusain_create_temp_data_delta(fusain_packet_t* packet,
+    uint64_t address, fusain_temp_delta_t* delta,
+    const fusain_temp_data_t* data)
+{
+  const fusain_temp_delta_config_t* cfg = &delta->config;
+  fusain_temp_data_t* sent = &delta->sent;
+  uint8_t fields = 0;
+
+  if (delta_refresh_due(&delta->primed, &delta->last_refresh, cfg->refresh_ms,
+          data->timestamp)) {
+    fields = FUSAIN_TEMP_DATA_OPTIONAL;
+  } else {
+    if (data->rpm_control != sent->rpm_control) {
+      fields |= FUSAIN_TEMP_DATA_RPM_CONTROL;
+    }
+    if (data->watched_motor != sent->watched_motor) {
+      fields |= FUSAIN_TEMP_DATA_WATCHED_MOTOR;
+    }
+    float diff = data->target_temp - sent->target_temp;
+    /* Negated test so a NaN on either side forces a send */
+    if (!(diff <= cfg->target_deadband && -diff <= cfg->target_deadband)) {
+      fields |= FUSAIN_TEMP_DATA_TARGET_TEMP;
+    }
+  }
+
+  if (fields & FUSAIN_TEMP_DATA_RPM_CONTROL) {
+    sent->rpm_control = data->rpm_control;
+  }
+  if (fields & FUSAIN_TEMP_DATA_WATCHED_MOTOR) {
+    sent->watched_motor = data->watched_motor;
+  }
+  if (fields & FUSAIN_TEMP_DATA_TARGET_TEMP) {
+    sent->target_temp = data->target_temp;
+  }
+
+  fusain_create_temp_data_fields(packet, address, data, fields);
+  return fields;
+}
+
+static size_t cbor_put_int(uint8_t* out, int32_t value)
+{
+  /* Negative integers encode -1 - n */
+  return value < 0 ? cbor_put_head(out, CBOR_MAJOR_NINT, (uint32_t)(-1 - value))
+                   : cbor_put_head(out, CBOR_MAJOR_UINT, (uint32_t)value);
+}
+
+#if FUSAIN_HAS_FIXED_POINT
+void fusain_create_temp_data_centi(fusain_packet_t* packet, uint64_t address,
+    uint8_t thermometer, uint32_t timestamp, int32_t centi)
+{
+  packet->address = address;
+  packet->msg_type = FUSAIN_MSG_TEMP_DATA;
+
+  /* Hand-encoded to stay clear of the float path in the generated code:
+   * {0: thermometer, 1: timestamp, 6: centi} as an indefinite map like zcbor
+   */
+  uint8_t* p = packet->payload;
+  size_t n = (size_t)encode_cbor_message_header(p, FUSAIN_MAX_PAYLOAD_SIZE,
+      FUSAIN_MSG_TEMP_DATA);
+  p[n++] = 0xBF;
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, 0);
+  n += cbor_put_int(p + n, thermometer);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, 1);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, timestamp);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, FUSAIN_TEMP_DATA_KEY_CENTI);
+  n += cbor_put_int(p + n, centi);
+  p[n++] = CBOR_BREAK;
+
+  packet->length = (uint8_t)n;
+}
+#endif /* FUSAIN_HAS_FIXED_POINT */
+
+/* Telemetry Batch Builder
+ *
+ * The records array is indefinite so records can be appended in place;
+ * two bytes stay reserved for the array and map breaks written by
+ * fusain_batch_finish().
+ */
+#define BATCH_TRAILER_SIZE 2
+#define BATCH_RECORD_MAX_SIZE (1 + 2 + 2 + 3 + 1 + FUSAIN_BATCH_MAX_VALUES * 5)
+
+static size_t batch_put_record(uint8_t* out, const fusain_batch_record_t* record)
+{
+  size_t n = cbor_put_head(out, CBOR_MAJOR_ARRAY, 4);
+  n += cbor_put_head(out + n, CBOR_MAJOR_UINT, record->kind);
+  n += cbor_put_head(out + n, CBOR_MAJOR_UINT, record->index);
+  n += cbor_put_head(out + n, CBOR_MAJOR_UINT, record->dt_ms);
+  n += cbor_put_head(out + n, CBOR_MAJOR_ARRAY, record->value_count);
+
+  for (uint8_t i = 0; i < record->value_count; i++) {
+    const fusain_batch_value_t* value = &record->values[i];
+    if (!value->is_float) {
+      n += cbor_put_int(out + n, value->as.i);
+      continue;
+    }
+    uint16_t half;
+    if (float_to_half_exact(value->as.f, &half)) {
+      out[n++] = 0xF9;
+      out[n++] = (uint8_t)(half >> 8);
+      out[n++] = (uint8_t)half;
+    } else {
+      uint32_t bits;
+      memcpy(&bits, &value->as.f, sizeof(bits));
+      out[n++] = 0xFA;
+      for (int b = 0; b < 4; b++) {
+        out[n++] = (uint8_t)(bits >> (24 - 8 * b));
+      }
+    }
+  }
+  return n;
+}
+
+void fusain_batch_begin(fusain_batch_builder_t* builder,
+    fusain_packet_t* packet, uint64_t address, uint32_t base_timestamp)
+{
+  builder->packet = packet;
+  builder->base_timestamp = base_timestamp;
+  builder->count = 0;
+  builder->finished = false;
+
+  packet->address = address;
+  packet->msg_type = FUSAIN_MSG_TELEMETRY_BATCH;
+
+  /* {0: base_timestamp, 1: [_ records...]} */
+  uint8_t* p = packet->payload;
+  size_t n = (size_t)encode_cbor_message_header(p, FUSAIN_MAX_PAYLOAD_SIZE,
+      FUSAIN_MSG_TELEMETRY_BATCH);
+  p[n++] = 0xBF;
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, 0);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, base_timestamp);
+  n += cbor_put_head(p + n, CBOR_MAJOR_UINT, 1);
+  p[n++] = 0x9F;
+  packet->length = (uint8_t)n;
+}
+
+int fusain_batch_add(fusain_batch_builder_t* builder,
+    const fusain_batch_record_t* record)
+{
+  if (record->value_count > FUSAIN_BATCH_MAX_VALUES) {
+    return -3;
+  }
+  if (builder->finished || builder->count >= FUSAIN_BATCH_MAX_RECORDS) {
+    return -1;
+  }
+
+  uint8_t encoded[BATCH_RECORD_MAX_SIZE];
+  size_t n = batch_put_record(encoded, record);
+  fusain_packet_t* packet = builder->packet;
+  if (packet->length + n + BATCH_TRAILER_SIZE > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -1;
+  }
+
+  memcpy(packet->payload + packet->length, encoded, n);
+  packet->length = (uint8_t)(packet->length + n);
+  builder->count++;
+  return 0;
+}
+
+/* Offset of a reading from the batch base, or -1 if it does not fit */
+static int32_t batch_dt(const fusain_batch_builder_t* builder,
+    uint32_t timestamp)
+{
+  uint32_t dt = timestamp - builder->base_timestamp;
+  return dt <= UINT16_MAX ? (int32_t)dt : -1;
+}
+
+int fusain_batch_add_motor(fusain_batch_builder_t* builder,
+    const fusain_motor_data_t* data)
+{
+  int32_t dt = batch_dt(builder, data->timestamp);
+  if (dt < 0) {
+    return -3;
+  }
+  fusain_batch_record_t record = {
+    .kind = FUSAIN_MSG_MOTOR_DATA,
+    .index = data->motor,
+    .dt_ms = (uint16_t)dt,
+    .value_count = 2,
+    .values = { { .as.i = data->rpm }, { .as.i = data->target } },
+  };
+  return fusain_batch_add(builder, &record);
+}
+
+int fusain_batch_add_temp(fusain_batch_builder_t* builder,
+    const fusain_temp_data_t* data)
+{
+  int32_t dt = batch_dt(builder, data->timestamp);
+  if (dt < 0) {
+    return -3;
+  }
+  fusain_batch_record_t record = {
+    .kind = FUSAIN_MSG_TEMP_DATA,
+    .index = data->thermometer,
+    .dt_ms = (uint16_t)dt,
+    .value_count = 1,
+    .values = { { .is_float = true, .as.f = data->reading } },
+  };
+  return fusain_batch_add(builder, &record);
+}
+
+int fusain_batch_finish(fusain_batch_builder_t* builder)
+{
+  fusain_packet_t* packet = builder->packet;
+  if (!builder->finished) {
+    packet->payload[packet->length++] = CBOR_BREAK; /* Records */
+    packet->payload[packet->length++] = CBOR_BREAK; /* Map */
+    builder->finished = true;
+  }
+  return builder->count;
+}
+
+int fusain_create_telemetry_batch(fusain_packet_t* packet, uint64_t address,
+    const fusain_telemetry_batch_t* batch)
+{
+  fusain_batch_builder_t builder;
+  fusain_batch_begin(&builder, packet, address, batch->base_timestamp);
+
+  for (uint8_t i = 0; i < batch->count; i++) {
+    int ret = fusain_batch_add(&builder, &batch->records[i]);
+    if (ret < 0) {
+      packet->length = 0;
+      return ret;
+    }
+  }
+  fusain_batch_finish(&builder);
+  return 0;
 }
+#endif /* FUSAIN_HAS_MSG_TELEMETRY */
 
+#if FUSAIN_HAS_MSG_ERROR
 void fusain_create_error_invalid_cmd(fusain_packet_t* packet, uint64_t address,
     fusain_invalid_cmd_error_t error_code, int32_t rejected_field,
     int32_t constraint)
@@ -1190,3 +3334,4 @@ void fusain_create_error_state_reject(fusain_packet_t* packet, uint64_t address,
 
   packet->length = (uint8_t)(offset + payload_len);
 }
+#endif /* FUSAIN_HAS_MSG_ERROR */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Request/Response Correlation
+ *
+ * The caller's slot array holds three intrusive structures at once: hash
+ * chains (each slot is also the head of one bucket), the free list (reusing
+ * the chain link) and a doubly linked deadline list. Because every attempt
+ * uses the same timeout, appending on send and on retry keeps the deadline
+ * list sorted, so expiry only ever looks at the oldest entry.
+ */
+
+#include <stddef.h>
+
+#include <fusain/fusain.h>
+
+#include "fusain_internal.h"
+
+static uint32_t bucket_of(const fusain_correlator_t* correlator,
+    uint64_t address, uint8_t family)
+{
+  uint64_t mix = fusain_address_hash(address ^ ((uint64_t)family << 56));
+  return (uint32_t)(mix >> 32) & correlator->mask;
+}
+
+static int request_family(uint8_t msg_type)
+{
+  switch (msg_type) {
+  case FUSAIN_MSG_PING_REQUEST:
+    return FUSAIN_CORRELATE_PING;
+  case FUSAIN_MSG_DISCOVERY_REQUEST:
+    return FUSAIN_CORRELATE_DISCOVERY;
+  case FUSAIN_MSG_SEND_TELEMETRY:
+    return FUSAIN_CORRELATE_TELEMETRY;
+  default:
+    if (msg_type >= 0x10 && msg_type <= 0x2F) {
+      return FUSAIN_CORRELATE_COMMAND;
+    }
+    return -1;
+  }
+}
+
+static uint32_t find(const fusain_correlator_t* correlator, uint64_t address,
+    uint8_t family)
+{
+  uint32_t i = correlator->slots[bucket_of(correlator, address, family)].bucket;
+
+  while (i != FUSAIN_CORRELATE_NONE) {
+    const fusain_correlation_t* entry = &correlator->slots[i];
+    if (entry->address == address && entry->family == family) {
+      return i;
+    }
+    i = entry->chain;
+  }
+  return FUSAIN_CORRELATE_NONE;
+}
+
+static void list_append(fusain_correlator_t* correlator, uint32_t i)
+{
+  fusain_correlation_t* entry = &correlator->slots[i];
+
+  entry->older = correlator->newest;
+  entry->newer = FUSAIN_CORRELATE_NONE;
+  if (correlator->newest != FUSAIN_CORRELATE_NONE) {
+    correlator->slots[correlator->newest].newer = i;
+  } else {
+    correlator->oldest = i;
+  }
+  correlator->newest = i;
+}
+
+static void list_unlink(fusain_correlator_t* correlator, uint32_t i)
+{
+  fusain_correlation_t* entry = &correlator->slots[i];
+
+  if (entry->older != FUSAIN_CORRELATE_NONE) {
+    correlator->slots[entry->older].newer = entry->newer;
+  } else {
+    correlator->oldest = entry->newer;
+  }
+  if (entry->newer != FUSAIN_CORRELATE_NONE) {
+    correlator->slots[entry->newer].older = entry->older;
+  } else {
+    correlator->newest = entry->older;
+  }
+}
+
+static void release(fusain_correlator_t* correlator, uint32_t i)
+{
+  fusain_correlation_t* entry = &correlator->slots[i];
+  uint32_t* link = &correlator->slots[bucket_of(correlator, entry->address, entry->family)].bucket;
+
+  while (*link != i) {
+    link = &correlator->slots[*link].chain;
+  }
+  *link = entry->chain;
+
+  list_unlink(correlator, i);
+  entry->in_use = 0;
+  entry->chain = correlator->free_head;
+  correlator->free_head = i;
+  correlator->count--;
+}
+
+static void complete(fusain_correlator_t* correlator, uint32_t i,
+    fusain_correlate_event_t event, const fusain_packet_t* response)
+{
+  /* Release first so the callback may track a new request for the key */
+  fusain_correlation_t entry = correlator->slots[i];
+
+  release(correlator, i);
+  correlator->callback(event, &entry, response);
+}
+
+int fusain_correlator_init(fusain_correlator_t* correlator,
+    fusain_correlation_t* slots, uint32_t capacity, uint32_t timeout_us,
+    uint8_t retries, fusain_correlate_cb_t callback)
+{
+  if (correlator == NULL || slots == NULL || callback == NULL || timeout_us == 0
+      || capacity == 0 || capacity == FUSAIN_CORRELATE_NONE
+      || (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+
+  correlator->slots = slots;
+  correlator->capacity = capacity;
+  correlator->mask = capacity - 1;
+  correlator->count = 0;
+  correlator->free_head = 0;
+  correlator->oldest = FUSAIN_CORRELATE_NONE;
+  correlator->newest = FUSAIN_CORRELATE_NONE;
+  correlator->timeout_us = timeout_us;
+  correlator->retries = retries;
+  correlator->callback = callback;
+
+  for (uint32_t i = 0; i < capacity; i++) {
+    slots[i].bucket = FUSAIN_CORRELATE_NONE;
+    slots[i].chain = i + 1 < capacity ? i + 1 : FUSAIN_CORRELATE_NONE;
+    slots[i].in_use = 0;
+  }
+
+  return 0;
+}
+
+int fusain_correlator_track(fusain_correlator_t* correlator,
+    const fusain_packet_t* request, void* user, uint64_t now_us)
+{
+  int family = request_family(request->msg_type);
+  if (family < 0 || FUSAIN_ADDRESS_IS_MULTICAST(request->address)) {
+    return -1;
+  }
+  if (find(correlator, request->address, (uint8_t)family) != FUSAIN_CORRELATE_NONE) {
+    return -2;
+  }
+  if (correlator->free_head == FUSAIN_CORRELATE_NONE) {
+    return -3;
+  }
+
+  uint32_t i = correlator->free_head;
+  fusain_correlation_t* entry = &correlator->slots[i];
+  correlator->free_head = entry->chain;
+
+  entry->address = request->address;
+  entry->deadline_us = now_us + correlator->timeout_us;
+  entry->user = user;
+  entry->msg_type = request->msg_type;
+  entry->family = (uint8_t)family;
+  entry->retries_left = correlator->retries;
+  entry->in_use = 1;
+
+  uint32_t* head = &correlator->slots[bucket_of(correlator, entry->address, entry->family)].bucket;
+  entry->chain = *head;
+  *head = i;
+
+  list_append(correlator, i);
+  correlator->count++;
+
+  return 0;
+}
+
+int fusain_correlator_match(fusain_correlator_t* correlator,
+    const fusain_packet_t* packet)
+{
+  fusain_correlate_event_t event = FUSAIN_CORRELATE_RESPONSE;
+  uint8_t first;
+  int second = -1;
+
+  switch (packet->msg_type) {
+  case FUSAIN_MSG_PING_RESPONSE:
+    first = FUSAIN_CORRELATE_PING;
+    break;
+  case FUSAIN_MSG_DEVICE_ANNOUNCE:
+    first = FUSAIN_CORRELATE_DISCOVERY;
+    break;
+  case FUSAIN_MSG_STATE_DATA:
+    first = FUSAIN_CORRELATE_COMMAND;
+    second = FUSAIN_CORRELATE_TELEMETRY;
+    break;
+  case FUSAIN_MSG_ERROR_INVALID_CMD:
+  case FUSAIN_MSG_ERROR_STATE_REJECT:
+    event = FUSAIN_CORRELATE_REJECTED;
+    first = FUSAIN_CORRELATE_COMMAND;
+    second = FUSAIN_CORRELATE_TELEMETRY;
+    break;
+  case FUSAIN_MSG_MOTOR_DATA:
+  case FUSAIN_MSG_PUMP_DATA:
+  case FUSAIN_MSG_GLOW_DATA:
+  case FUSAIN_MSG_TEMP_DATA:
+  case FUSAIN_MSG_TELEMETRY_BATCH:
+    first = FUSAIN_CORRELATE_TELEMETRY;
+    break;
+  default:
+    return -1;
+  }
+
+  uint32_t i = find(correlator, packet->address, first);
+  if (i == FUSAIN_CORRELATE_NONE && second >= 0) {
+    i = find(correlator, packet->address, (uint8_t)second);
+  }
+  if (i == FUSAIN_CORRELATE_NONE) {
+    return -1;
+  }
+
+  complete(correlator, i, event, packet);
+  return 0;
+}
+
+int fusain_correlator_cancel(fusain_correlator_t* correlator, uint64_t address,
+    uint8_t msg_type)
+{
+  int family = request_family(msg_type);
+  if (family < 0) {
+    return -1;
+  }
+
+  uint32_t i = find(correlator, address, (uint8_t)family);
+  if (i == FUSAIN_CORRELATE_NONE) {
+    return -1;
+  }
+
+  release(correlator, i);
+  return 0;
+}
+
+uint64_t fusain_correlator_poll(fusain_correlator_t* correlator, uint64_t now_us)
+{
+  while (correlator->oldest != FUSAIN_CORRELATE_NONE
+      && correlator->slots[correlator->oldest].deadline_us <= now_us) {
+    uint32_t i = correlator->oldest;
+    fusain_correlation_t* entry = &correlator->slots[i];
+
+    if (entry->retries_left == 0) {
+      complete(correlator, i, FUSAIN_CORRELATE_TIMEOUT, NULL);
+      continue;
+    }
+
+    /* Re-arm at the tail; now_us + timeout is never earlier than the rest */
+    entry->retries_left--;
+    entry->deadline_us = now_us + correlator->timeout_us;
+    list_unlink(correlator, i);
+    list_append(correlator, i);
+    correlator->callback(FUSAIN_CORRELATE_RETRY, entry, NULL);
+  }
+
+  if (correlator->oldest == FUSAIN_CORRELATE_NONE) {
+    return UINT64_MAX;
+  }
+  return correlator->slots[correlator->oldest].deadline_us;
+}
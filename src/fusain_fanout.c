@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Subscription Fan-out
+ *
+ * A frame is free when its reference count is zero. Only the allocating
+ * thread ever raises a count from zero, so allocation is a scan for a zero
+ * count with no compare-and-swap; other threads only drop references.
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "fusain_internal.h"
+
+void fusain_frame_pool_init(fusain_frame_pool_t* pool, fusain_frame_t* frames,
+    uint32_t count)
+{
+  memset(frames, 0, (size_t)count * sizeof(*frames));
+  pool->frames = frames;
+  pool->count = count;
+  pool->cursor = 0;
+}
+
+fusain_frame_t* fusain_frame_alloc(fusain_frame_pool_t* pool)
+{
+  for (uint32_t n = 0; n < pool->count; n++) {
+    fusain_frame_t* frame = &pool->frames[pool->cursor];
+    pool->cursor = pool->cursor + 1 < pool->count ? pool->cursor + 1 : 0;
+    /* Acquire pairs with the last fusain_frame_unref() of the previous use */
+    if (LOAD_ACQUIRE(&frame->refs) == 0) {
+      STORE_RELAXED(&frame->refs, 1);
+      frame->length = 0;
+      return frame;
+    }
+  }
+  return NULL;
+}
+
+void fusain_frame_ref(fusain_frame_t* frame)
+{
+  __atomic_add_fetch(&frame->refs, 1, __ATOMIC_RELAXED);
+}
+
+bool fusain_frame_unref(fusain_frame_t* frame)
+{
+  return __atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+/* Appliance table (open addressing, entries never removed) */
+
+static uint32_t topic_home(const fusain_fanout_t* fanout, uint64_t address)
+{
+  return (uint32_t)(fusain_address_hash(address) >> 32) & fanout->topic_mask;
+}
+
+static fusain_fanout_topic_t* topic_find(const fusain_fanout_t* fanout, uint64_t address,
+    bool create)
+{
+  uint32_t i = topic_home(fanout, address);
+
+  for (uint32_t probe = 0; probe <= fanout->topic_mask; probe++) {
+    fusain_fanout_topic_t* topic = &fanout->topics[i];
+    if (!topic->in_use) {
+      if (!create) {
+        return NULL;
+      }
+      topic->in_use = 1;
+      topic->address = address;
+      topic->subscriptions = NULL;
+      return topic;
+    }
+    if (topic->address == address) {
+      return topic;
+    }
+    i = (i + 1) & fanout->topic_mask;
+  }
+  return NULL;
+}
+
+/* Subscriptions (intrusive on both lists, so unlinking is O(1)) */
+
+static fusain_subscription_t* subscription_find(const fusain_subscriber_t* subscriber,
+    uint64_t appliance)
+{
+  for (fusain_subscription_t* sub = subscriber->subscriptions; sub != NULL;
+      sub = sub->subscriber_next) {
+    if (sub->topic->address == appliance) {
+      return sub;
+    }
+  }
+  return NULL;
+}
+
+static void subscription_release(fusain_fanout_t* fanout, fusain_subscription_t* sub)
+{
+  *sub->topic_pprev = sub->topic_next;
+  if (sub->topic_next != NULL) {
+    sub->topic_next->topic_pprev = sub->topic_pprev;
+  }
+  *sub->subscriber_pprev = sub->subscriber_next;
+  if (sub->subscriber_next != NULL) {
+    sub->subscriber_next->subscriber_pprev = sub->subscriber_pprev;
+  }
+  sub->topic_next = fanout->free_list;
+  fanout->free_list = sub;
+}
+
+int fusain_fanout_init(fusain_fanout_t* fanout, fusain_frame_pool_t* pool,
+    fusain_fanout_topic_t* topics, uint32_t topic_capacity,
+    fusain_subscription_t* subscriptions, uint32_t subscription_count,
+    fusain_fanout_send_t send)
+{
+  if (fanout == NULL || pool == NULL || topics == NULL || subscriptions == NULL
+      || send == NULL || topic_capacity == 0 || (topic_capacity & (topic_capacity - 1)) != 0) {
+    return -1;
+  }
+
+  memset(topics, 0, (size_t)topic_capacity * sizeof(*topics));
+  fanout->pool = pool;
+  fanout->topics = topics;
+  fanout->topic_mask = topic_capacity - 1;
+  fanout->send = send;
+  fanout->free_list = NULL;
+  for (uint32_t i = subscription_count; i-- > 0;) {
+    subscriptions[i].topic_next = fanout->free_list;
+    fanout->free_list = &subscriptions[i];
+  }
+  return 0;
+}
+
+int fusain_fanout_subscribe(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    uint64_t appliance, fusain_subscription_t** handle)
+{
+  fusain_subscription_t* existing = subscription_find(subscriber, appliance);
+  if (existing != NULL) {
+    if (handle != NULL) {
+      *handle = existing;
+    }
+    return 0;
+  }
+  if (fanout->free_list == NULL) {
+    return -2;
+  }
+  fusain_fanout_topic_t* topic = topic_find(fanout, appliance, true);
+  if (topic == NULL) {
+    return -2;
+  }
+
+  fusain_subscription_t* sub = fanout->free_list;
+  fanout->free_list = sub->topic_next;
+  sub->topic = topic;
+  sub->subscriber = subscriber;
+
+  sub->topic_next = topic->subscriptions;
+  sub->topic_pprev = &topic->subscriptions;
+  if (topic->subscriptions != NULL) {
+    topic->subscriptions->topic_pprev = &sub->topic_next;
+  }
+  topic->subscriptions = sub;
+
+  sub->subscriber_next = subscriber->subscriptions;
+  sub->subscriber_pprev = &subscriber->subscriptions;
+  if (subscriber->subscriptions != NULL) {
+    subscriber->subscriptions->subscriber_pprev = &sub->subscriber_next;
+  }
+  subscriber->subscriptions = sub;
+  if (handle != NULL) {
+    *handle = sub;
+  }
+  return 0;
+}
+
+int fusain_fanout_unsubscribe(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    uint64_t appliance)
+{
+  fusain_subscription_t* sub = subscription_find(subscriber, appliance);
+  if (sub == NULL) {
+    return -1;
+  }
+  subscription_release(fanout, sub);
+  return 0;
+}
+
+void fusain_fanout_release(fusain_fanout_t* fanout, fusain_subscription_t* subscription)
+{
+  subscription_release(fanout, subscription);
+}
+
+uint32_t fusain_fanout_drop(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber)
+{
+  uint32_t dropped = 0;
+
+  while (subscriber->subscriptions != NULL) {
+    subscription_release(fanout, subscriber->subscriptions);
+    dropped++;
+  }
+  return dropped;
+}
+
+int fusain_fanout_handle(fusain_fanout_t* fanout, fusain_subscriber_t* subscriber,
+    const fusain_packet_t* packet)
+{
+  uint64_t appliance;
+
+  if (packet->msg_type != FUSAIN_MSG_DATA_SUBSCRIPTION
+      && packet->msg_type != FUSAIN_MSG_DATA_UNSUBSCRIBE) {
+    return 1;
+  }
+  if (fusain_peek_uint(packet, 0, &appliance) < 0) {
+    return -3;
+  }
+  if (packet->msg_type == FUSAIN_MSG_DATA_SUBSCRIPTION) {
+    return fusain_fanout_subscribe(fanout, subscriber, appliance, NULL);
+  }
+  return fusain_fanout_unsubscribe(fanout, subscriber, appliance);
+}
+
+int fusain_fanout_publish_frame(fusain_fanout_t* fanout, uint64_t appliance,
+    fusain_frame_t* frame)
+{
+  const fusain_fanout_topic_t* topic = topic_find(fanout, appliance, false);
+  int queued = 0;
+
+  if (topic != NULL) {
+    for (fusain_subscription_t* sub = topic->subscriptions; sub != NULL;
+        sub = sub->topic_next) {
+      fusain_frame_ref(frame);
+      if (fanout->send(sub->subscriber, frame) == 0) {
+        queued++;
+      } else {
+        fusain_frame_unref(frame);
+      }
+    }
+  }
+  fusain_frame_unref(frame);
+  return queued;
+}
+
+int fusain_fanout_publish(fusain_fanout_t* fanout, const fusain_packet_t* packet)
+{
+  const fusain_fanout_topic_t* topic = topic_find(fanout, packet->address, false);
+  if (topic == NULL || topic->subscriptions == NULL) {
+    return 0;
+  }
+
+  fusain_frame_t* frame = fusain_frame_alloc(fanout->pool);
+  if (frame == NULL) {
+    return -2;
+  }
+  int length = fusain_encode_packet(packet, frame->data, sizeof(frame->data));
+  if (length < 0) {
+    fusain_frame_unref(frame);
+    return -1;
+  }
+  frame->length = (uint16_t)length;
+  return fusain_fanout_publish_frame(fanout, packet->address, frame);
+}
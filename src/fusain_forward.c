@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Cut-through Forwarding
+ *
+ * Raw bytes are passed downstream untouched; each link only unstuffs a
+ * copy of them to follow the frame (length, address, message type, CRC).
+ * Bytes of a routed frame are not copied: they are handed to the egress
+ * links as runs of the caller's input buffer. Only a frame that has to
+ * wait for a busy egress link is copied, into its ingress link's held
+ * buffer, and goes out from there once the link is free.
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#define STATE_IDLE 0
+#define STATE_HEAD 1 /* Held until the address and message type are known */
+#define STATE_BODY 2 /* Routed: rest of the payload and the CRC */
+#define STATE_END 3 /* Waiting for END to confirm the CRC */
+
+#define HEADER_SIZE 9 /* LENGTH + ADDRESS */
+#define CBOR_ARRAY_2 0x82
+#define CBOR_UINT8_PREFIX 0x18
+
+static void emit_links(const fusain_forwarder_t* fwd, uint8_t egress, const uint8_t* data,
+    size_t length)
+{
+  if (length == 0) {
+    return;
+  }
+  for (uint8_t link = 0; link < fwd->link_count; link++) {
+    if (egress & (1u << link)) {
+      fwd->emit(fwd->user, link, data, length);
+    }
+  }
+}
+
+/* Send held frames to the links they wait for that are free again */
+static void frames_flush(fusain_forwarder_t* fwd)
+{
+  for (uint8_t i = 0; i < fwd->link_count; i++) {
+    fusain_forward_link_t* link = &fwd->links[i];
+    uint8_t owed = link->waiting & (uint8_t)~fwd->busy;
+    if (owed == 0) {
+      continue;
+    }
+    emit_links(fwd, owed, link->held, link->held_length);
+    link->waiting &= (uint8_t)~owed;
+    if (link->holding) {
+      /* Still arriving: caught up, the rest streams like the other links */
+      link->egress |= owed;
+      fwd->busy |= owed;
+      link->holding = link->waiting != 0;
+    }
+  }
+}
+
+/* End a frame downstream with END, or cut it off with START */
+static void frame_close(fusain_forwarder_t* fwd, fusain_forward_link_t* link, uint8_t byte)
+{
+  uint8_t freed = link->egress;
+
+  emit_links(fwd, freed, &byte, 1);
+  fwd->busy &= (uint8_t)~freed;
+  link->egress = 0;
+  link->state = STATE_IDLE;
+  if (freed != 0) {
+    frames_flush(fwd);
+  }
+}
+
+static void frame_fail(fusain_forwarder_t* fwd, fusain_forward_link_t* link)
+{
+  if (link->state == STATE_HEAD) {
+    fwd->dropped++;
+  } else if (link->egress != 0) {
+    fwd->aborted++;
+  } else if (link->holding) {
+    fwd->dropped++; /* Held for every link: nothing went out */
+  }
+  if (link->holding) {
+    link->holding = false;
+    link->waiting = 0;
+  }
+  frame_close(fwd, link, FUSAIN_START_BYTE);
+}
+
+/* Message type from the payload's [type, ...] header: 1 known, 0 need more, -1 invalid */
+static int frame_type(fusain_forward_link_t* link, uint8_t received)
+{
+  if (link->type[0] != CBOR_ARRAY_2) {
+    return -1;
+  }
+  if (received < 2) {
+    return 0;
+  }
+  if (link->type[1] <= 0x17) {
+    link->msg_type = link->type[1];
+    return 1;
+  }
+  if (link->type[1] != CBOR_UINT8_PREFIX) {
+    return -1;
+  }
+  if (received < 3) {
+    return 0;
+  }
+  link->msg_type = link->type[2];
+  return 1;
+}
+
+/* Telemetry and errors carry the address of the appliance that sent them */
+static bool from_appliance(uint8_t msg_type)
+{
+  return (msg_type >= FUSAIN_MSG_STATE_DATA && msg_type <= FUSAIN_MSG_PING_RESPONSE)
+      || msg_type == FUSAIN_MSG_ERROR_INVALID_CMD || msg_type == FUSAIN_MSG_ERROR_STATE_REJECT;
+}
+
+/* Configuration and control carry the address of the appliance they are for */
+static bool to_appliance(uint8_t msg_type)
+{
+  return msg_type >= FUSAIN_MSG_MOTOR_CONFIG && msg_type <= FUSAIN_MSG_PING_REQUEST;
+}
+
+static uint8_t frame_route(fusain_forwarder_t* fwd, uint8_t ingress,
+    fusain_forward_link_t* link)
+{
+  uint8_t targets = (uint8_t)(((1u << fwd->link_count) - 1) & ~(1u << ingress));
+  uint32_t route;
+
+  if (to_appliance(link->msg_type) && !FUSAIN_ADDRESS_IS_MULTICAST(link->address)
+      && fusain_route_lookup(fwd->routes, link->address, &route) == 0) {
+    /* Known appliance: only its link, nowhere if it is where the frame came from */
+    targets = (route < fwd->link_count && route != ingress) ? (uint8_t)(1u << route) : 0;
+  }
+
+  uint8_t blocked = targets & fwd->busy;
+  if (blocked != 0 && link->waiting == 0) {
+    /* Hold the frame for the busy links, starting with the bytes so far */
+    memcpy(link->held, link->head, link->head_length);
+    link->held_length = link->head_length;
+    link->waiting = blocked;
+    link->holding = true;
+    fwd->deferred += (uint32_t)__builtin_popcount(blocked);
+  } else {
+    fwd->collisions += (uint32_t)__builtin_popcount(blocked);
+  }
+  return targets & (uint8_t)~fwd->busy;
+}
+
+/* Follow one unstuffed byte; returns false if the frame is invalid */
+static bool frame_byte(fusain_forwarder_t* fwd, uint8_t ingress, fusain_forward_link_t* link,
+    uint8_t byte)
+{
+  uint8_t index = link->index++;
+
+  if (index == 0) {
+    if (byte > FUSAIN_MAX_PAYLOAD_SIZE) {
+      return false; /* Also rejects aliased frames (FUSAIN_LENGTH_ALIAS_FLAG) */
+    }
+    link->length = byte;
+  } else if (index < HEADER_SIZE) {
+    link->address |= (uint64_t)byte << (8 * (index - 1));
+  } else if (index < HEADER_SIZE + link->length) {
+    uint8_t offset = index - HEADER_SIZE;
+    if (offset < sizeof(link->type)) {
+      link->type[offset] = byte;
+    }
+    if (link->state == STATE_HEAD) {
+      int known = frame_type(link, offset + 1);
+      if (known < 0) {
+        return false;
+      }
+      if (known > 0) {
+        link->egress = frame_route(fwd, ingress, link);
+        if (link->egress == 0 && !link->holding) {
+          fwd->dropped++;
+        }
+        fwd->busy |= link->egress;
+        emit_links(fwd, link->egress, link->head, link->head_length);
+        link->state = STATE_BODY;
+      }
+    }
+  } else if (index == HEADER_SIZE + link->length) {
+    if (link->state == STATE_HEAD) {
+      return false; /* Payload too short to carry a message type */
+    }
+    link->frame_crc = (uint16_t)byte << 8;
+    return true;
+  } else {
+    link->frame_crc |= byte;
+    link->state = STATE_END;
+    return true;
+  }
+
+  link->crc = fusain_crc16_update(link->crc, &byte, 1);
+  return true;
+}
+
+int fusain_forward_init(fusain_forwarder_t* fwd, fusain_route_t* routes,
+    uint8_t link_count, fusain_forward_emit_t emit, void* user)
+{
+  if (fwd == NULL || routes == NULL || emit == NULL || link_count == 0
+      || link_count > FUSAIN_FORWARD_MAX_LINKS) {
+    return -1;
+  }
+
+  memset(fwd, 0, sizeof(*fwd));
+  fwd->routes = routes;
+  fwd->emit = emit;
+  fwd->user = user;
+  fwd->link_count = link_count;
+  return 0;
+}
+
+int fusain_forward_feed(fusain_forwarder_t* fwd, uint8_t ingress, const uint8_t* data,
+    size_t length)
+{
+  if (ingress >= fwd->link_count) {
+    return -1;
+  }
+
+  fusain_forward_link_t* link = &fwd->links[ingress];
+  size_t from = 0; /* First routed byte of data not yet passed downstream */
+  int completed = 0;
+
+  for (size_t i = 0; i < length; i++) {
+    uint8_t rx = data[i];
+
+    if (link->holding && rx != FUSAIN_START_BYTE) {
+      link->held[link->held_length++] = rx;
+    }
+
+    if (rx == FUSAIN_START_BYTE) {
+      if (link->state != STATE_IDLE) {
+        frame_fail(fwd, link); /* Sender restarted: cut off its last frame too */
+      }
+      link->state = STATE_HEAD;
+      link->escape_next = false;
+      link->index = 0;
+      link->crc = 0xFFFF;
+      link->address = 0;
+      link->head[0] = rx;
+      link->head_length = 1;
+    } else if (link->state == STATE_END) {
+      emit_links(fwd, link->egress, &data[from], i - from);
+      if (rx == FUSAIN_END_BYTE && !link->escape_next && link->crc == link->frame_crc) {
+        if (from_appliance(link->msg_type) && !FUSAIN_ADDRESS_IS_MULTICAST(link->address)) {
+          fusain_route_set(fwd->routes, link->address, ingress);
+        }
+        if (link->egress != 0 || link->holding) {
+          fwd->forwarded++;
+          completed++;
+        }
+        link->holding = false; /* Complete: waits in held for its links */
+        frame_close(fwd, link, FUSAIN_END_BYTE);
+      } else {
+        frame_fail(fwd, link);
+      }
+    } else if (link->state != STATE_IDLE) {
+      if (link->state == STATE_HEAD) {
+        link->head[link->head_length++] = rx;
+      }
+      if (rx == FUSAIN_END_BYTE) {
+        frame_fail(fwd, link); /* END before the CRC */
+      } else if (rx == FUSAIN_ESC_BYTE && !link->escape_next) {
+        link->escape_next = true;
+      } else {
+        uint8_t byte = link->escape_next ? rx ^ FUSAIN_ESC_XOR : rx;
+        link->escape_next = false;
+        bool head = link->state == STATE_HEAD;
+        if (!frame_byte(fwd, ingress, link, byte)) {
+          frame_fail(fwd, link);
+        } else if (head && link->state == STATE_BODY) {
+          from = i + 1; /* This byte went out with the head */
+        }
+      }
+    }
+
+    if (link->state != STATE_BODY && link->state != STATE_END) {
+      from = i + 1;
+    }
+  }
+
+  if (link->state == STATE_BODY || link->state == STATE_END) {
+    emit_links(fwd, link->egress, &data[from], length - from);
+  }
+  return completed;
+}
+
+void fusain_forward_abort(fusain_forwarder_t* fwd, uint8_t ingress)
+{
+  if (ingress < fwd->link_count && fwd->links[ingress].state != STATE_IDLE) {
+    frame_fail(fwd, &fwd->links[ingress]);
+  }
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Internal Helpers (not installed)
+ *
+ * Shared by the library's modules only. Atomics use the GCC/Clang
+ * __atomic builtins, which both the Zephyr toolchains and host compilers
+ * provide.
+ */
+
+#ifndef FUSAIN_INTERNAL_H_
+#define FUSAIN_INTERNAL_H_
+
+#include <stdint.h>
+
+#define LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define STORE_RELAXED(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+
+/* Fibonacci hashing: the high bits of the product are well mixed */
+static inline uint64_t fusain_address_hash(uint64_t address)
+{
+  return address * 0x9E3779B97F4A7C15ULL;
+}
+
+#endif /* FUSAIN_INTERNAL_H_ */
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Controller Polling Scheduler
+ *
+ * Earliest-deadline-first SEND_TELEMETRY polling. Idle targets sit in a
+ * binary min-heap keyed on their next deadline. Each target keeps a
+ * smoothed response turnaround and deviation (RFC 6298 style), which give
+ * both its timeout and the window its response is expected to occupy on
+ * the bus. A new request is only sent if neither it nor its predicted
+ * response overlaps a window that is already reserved.
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+/* START + LEN + ADDR(8) + CRC(2) + END around the payload (escapes ignored) */
+#define POLL_FRAME_OVERHEAD 13
+
+static uint32_t poll_airtime_us(const fusain_poll_scheduler_t* scheduler,
+    size_t bytes)
+{
+  if (scheduler->config.baud_rate == 0) {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)bytes * 10U * 1000000U) / scheduler->config.baud_rate);
+}
+
+/* Ready heap */
+
+static void heap_place(fusain_poll_scheduler_t* scheduler, uint8_t slot,
+    uint8_t target)
+{
+  scheduler->heap[slot] = target;
+  scheduler->targets[target].heap_slot = slot;
+}
+
+static bool heap_less(const fusain_poll_scheduler_t* scheduler, uint8_t a,
+    uint8_t b)
+{
+  return scheduler->targets[scheduler->heap[a]].deadline_us
+      < scheduler->targets[scheduler->heap[b]].deadline_us;
+}
+
+static void heap_swap(fusain_poll_scheduler_t* scheduler, uint8_t a, uint8_t b)
+{
+  uint8_t target_a = scheduler->heap[a];
+  heap_place(scheduler, a, scheduler->heap[b]);
+  heap_place(scheduler, b, target_a);
+}
+
+static void heap_sift_up(fusain_poll_scheduler_t* scheduler, uint8_t slot)
+{
+  while (slot > 0) {
+    uint8_t parent = (uint8_t)((slot - 1) / 2);
+    if (!heap_less(scheduler, slot, parent)) {
+      break;
+    }
+    heap_swap(scheduler, slot, parent);
+    slot = parent;
+  }
+}
+
+static void heap_sift_down(fusain_poll_scheduler_t* scheduler, uint8_t slot)
+{
+  for (;;) {
+    size_t left = (size_t)slot * 2 + 1;
+    size_t right = left + 1;
+    uint8_t smallest = slot;
+
+    if (left < scheduler->heap_size && heap_less(scheduler, (uint8_t)left, smallest)) {
+      smallest = (uint8_t)left;
+    }
+    if (right < scheduler->heap_size && heap_less(scheduler, (uint8_t)right, smallest)) {
+      smallest = (uint8_t)right;
+    }
+    if (smallest == slot) {
+      break;
+    }
+    heap_swap(scheduler, slot, smallest);
+    slot = smallest;
+  }
+}
+
+static void heap_push(fusain_poll_scheduler_t* scheduler, uint8_t target)
+{
+  uint8_t slot = scheduler->heap_size++;
+  heap_place(scheduler, slot, target);
+  heap_sift_up(scheduler, slot);
+}
+
+static void heap_remove(fusain_poll_scheduler_t* scheduler, uint8_t slot)
+{
+  uint8_t target = scheduler->heap[slot];
+  uint8_t last = --scheduler->heap_size;
+
+  if (slot != last) {
+    heap_place(scheduler, slot, scheduler->heap[last]);
+    heap_sift_down(scheduler, slot);
+    heap_sift_up(scheduler, slot);
+  }
+  scheduler->targets[target].heap_slot = FUSAIN_POLL_IN_FLIGHT;
+}
+
+/* Outstanding polls */
+
+static void flight_finish(fusain_poll_scheduler_t* scheduler, uint8_t flight)
+{
+  uint8_t target = scheduler->flights[flight].target;
+
+  scheduler->flights[flight] = scheduler->flights[--scheduler->in_flight];
+  heap_push(scheduler, target);
+}
+
+static int find_target(const fusain_poll_scheduler_t* scheduler,
+    uint64_t address)
+{
+  for (uint8_t i = 0; i < scheduler->target_count; i++) {
+    if (scheduler->targets[i].address == address) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static uint64_t poll_timeout_us(const fusain_poll_scheduler_t* scheduler,
+    const fusain_poll_target_t* target)
+{
+  uint64_t timeout = (uint64_t)target->turnaround_us + target->response_air_us
+      + 4ULL * target->turnaround_var_us;
+
+  if (timeout < scheduler->config.min_timeout_us) {
+    timeout = scheduler->config.min_timeout_us;
+  }
+  if (timeout > scheduler->config.max_timeout_us) {
+    timeout = scheduler->config.max_timeout_us;
+  }
+  return timeout;
+}
+
+static bool overlaps(uint64_t start_a, uint64_t end_a, uint64_t start_b,
+    uint64_t end_b, uint32_t guard)
+{
+  return start_a < end_b + guard && start_b < end_a + guard;
+}
+
+void fusain_poll_init(fusain_poll_scheduler_t* scheduler,
+    const fusain_poll_config_t* config)
+{
+  memset(scheduler, 0, sizeof(*scheduler));
+  scheduler->config = *config;
+
+  if (scheduler->config.max_in_flight == 0) {
+    scheduler->config.max_in_flight = 1;
+  }
+  if (scheduler->config.max_in_flight > FUSAIN_POLL_MAX_IN_FLIGHT) {
+    scheduler->config.max_in_flight = FUSAIN_POLL_MAX_IN_FLIGHT;
+  }
+  if (scheduler->config.max_timeout_us < scheduler->config.min_timeout_us) {
+    scheduler->config.max_timeout_us = scheduler->config.min_timeout_us;
+  }
+}
+
+int fusain_poll_add(fusain_poll_scheduler_t* scheduler, uint64_t address,
+    uint8_t telemetry_type, uint32_t period_us, uint64_t now_us)
+{
+  if (period_us == 0 || FUSAIN_ADDRESS_IS_MULTICAST(address)
+      || find_target(scheduler, address) >= 0) {
+    return -1;
+  }
+  if (scheduler->target_count >= FUSAIN_POLL_MAX_TARGETS) {
+    return -2;
+  }
+
+  uint8_t index = scheduler->target_count++;
+  fusain_poll_target_t* target = &scheduler->targets[index];
+
+  memset(target, 0, sizeof(*target));
+  target->address = address;
+  target->deadline_us = now_us;
+  target->period_us = period_us;
+  target->turnaround_us = scheduler->config.initial_turnaround_us;
+  target->turnaround_var_us = scheduler->config.initial_turnaround_us / 2;
+  /* Reserve a full-size response until the first one is measured */
+  target->response_air_us = poll_airtime_us(scheduler, FUSAIN_MAX_PACKET_SIZE);
+  target->telemetry_type = telemetry_type;
+  heap_push(scheduler, index);
+
+  return index;
+}
+
+int fusain_poll_remove(fusain_poll_scheduler_t* scheduler, uint64_t address)
+{
+  int found = find_target(scheduler, address);
+  if (found < 0) {
+    return -1;
+  }
+
+  uint8_t index = (uint8_t)found;
+  if (scheduler->targets[index].heap_slot != FUSAIN_POLL_IN_FLIGHT) {
+    heap_remove(scheduler, scheduler->targets[index].heap_slot);
+  } else {
+    for (uint8_t i = 0; i < scheduler->in_flight; i++) {
+      if (scheduler->flights[i].target == index) {
+        scheduler->flights[i] = scheduler->flights[--scheduler->in_flight];
+        break;
+      }
+    }
+  }
+
+  /* Move the last target into the hole and repoint its references */
+  uint8_t last = --scheduler->target_count;
+  if (index != last) {
+    scheduler->targets[index] = scheduler->targets[last];
+    if (scheduler->targets[index].heap_slot != FUSAIN_POLL_IN_FLIGHT) {
+      scheduler->heap[scheduler->targets[index].heap_slot] = index;
+    } else {
+      for (uint8_t i = 0; i < scheduler->in_flight; i++) {
+        if (scheduler->flights[i].target == last) {
+          scheduler->flights[i].target = index;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int fusain_poll_next(fusain_poll_scheduler_t* scheduler, uint64_t now_us,
+    fusain_packet_t* packet, uint64_t* wake_us)
+{
+  const uint32_t guard = scheduler->config.guard_us;
+  uint64_t wake = UINT64_MAX;
+
+  /* Expire polls that outlived their timeout and widen the next window */
+  for (uint8_t i = 0; i < scheduler->in_flight;) {
+    if (scheduler->flights[i].timeout_us <= now_us) {
+      fusain_poll_target_t* target = &scheduler->targets[scheduler->flights[i].target];
+      uint64_t var = (uint64_t)target->turnaround_var_us * 2 + 1;
+      target->turnaround_var_us = var > scheduler->config.max_timeout_us
+          ? scheduler->config.max_timeout_us
+          : (uint32_t)var;
+      target->timeouts++;
+      flight_finish(scheduler, i);
+    } else {
+      i++;
+    }
+  }
+
+  int sent = 0;
+  if (scheduler->heap_size > 0 && scheduler->in_flight < scheduler->config.max_in_flight) {
+    uint8_t index = scheduler->heap[0];
+    fusain_poll_target_t* target = &scheduler->targets[index];
+
+    if (target->deadline_us > now_us || scheduler->tx_free_us > now_us) {
+      uint64_t ready = target->deadline_us > scheduler->tx_free_us
+          ? target->deadline_us
+          : scheduler->tx_free_us;
+      wake = ready;
+    } else {
+      fusain_create_send_telemetry(packet, target->address, target->telemetry_type,
+          0xFFFFFFFF);
+
+      uint64_t tx_end = now_us + poll_airtime_us(scheduler, packet->length + POLL_FRAME_OVERHEAD);
+      uint64_t spread = 2ULL * target->turnaround_var_us;
+      uint64_t rx_start = tx_end
+          + (target->turnaround_us > spread ? target->turnaround_us - spread : 0);
+      uint64_t rx_end = tx_end + target->turnaround_us + spread + target->response_air_us;
+      uint64_t blocked_until = 0;
+
+      for (uint8_t i = 0; i < scheduler->in_flight; i++) {
+        const fusain_poll_flight_t* flight = &scheduler->flights[i];
+        if (overlaps(now_us, tx_end, flight->rx_start_us, flight->rx_end_us, guard)
+            || overlaps(rx_start, rx_end, flight->rx_start_us, flight->rx_end_us, guard)) {
+          if (flight->rx_end_us + guard > blocked_until) {
+            blocked_until = flight->rx_end_us + guard;
+          }
+        }
+      }
+
+      if (blocked_until > 0) {
+        wake = blocked_until;
+      } else {
+        fusain_poll_flight_t* flight = &scheduler->flights[scheduler->in_flight++];
+        heap_remove(scheduler, 0);
+
+        flight->target = index;
+        flight->sent_us = tx_end;
+        flight->rx_start_us = rx_start;
+        flight->rx_end_us = rx_end;
+        flight->timeout_us = tx_end + poll_timeout_us(scheduler, target);
+
+        /* Keep the period, but never owe a burst after falling behind */
+        target->deadline_us += target->period_us;
+        if (target->deadline_us < now_us) {
+          target->deadline_us = now_us;
+        }
+        target->polls++;
+        scheduler->tx_free_us = tx_end + guard;
+        sent = 1;
+
+        if (scheduler->heap_size > 0 && scheduler->in_flight < scheduler->config.max_in_flight) {
+          uint64_t next = scheduler->targets[scheduler->heap[0]].deadline_us;
+          wake = next > scheduler->tx_free_us ? next : scheduler->tx_free_us;
+        }
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < scheduler->in_flight; i++) {
+    if (scheduler->flights[i].timeout_us < wake) {
+      wake = scheduler->flights[i].timeout_us;
+    }
+  }
+
+  if (wake_us != NULL) {
+    *wake_us = wake;
+  }
+  return sent;
+}
+
+int fusain_poll_response(fusain_poll_scheduler_t* scheduler,
+    const fusain_packet_t* packet, uint64_t now_us)
+{
+  for (uint8_t i = 0; i < scheduler->in_flight; i++) {
+    fusain_poll_flight_t* flight = &scheduler->flights[i];
+    fusain_poll_target_t* target = &scheduler->targets[flight->target];
+
+    if (target->address != packet->address) {
+      continue;
+    }
+
+    uint32_t air = poll_airtime_us(scheduler, packet->length + POLL_FRAME_OVERHEAD);
+    uint64_t elapsed = now_us > flight->sent_us ? now_us - flight->sent_us : 0;
+    int64_t sample = elapsed > air ? (int64_t)(elapsed - air) : 0;
+    if (sample > (int64_t)scheduler->config.max_timeout_us) {
+      sample = scheduler->config.max_timeout_us;
+    }
+
+    if (target->responses == 0) {
+      target->turnaround_us = (uint32_t)sample;
+      target->turnaround_var_us = (uint32_t)(sample / 2);
+    } else {
+      int64_t error = sample - (int64_t)target->turnaround_us;
+      int64_t magnitude = error < 0 ? -error : error;
+      target->turnaround_us = (uint32_t)((int64_t)target->turnaround_us + error / 8);
+      target->turnaround_var_us = (uint32_t)((int64_t)target->turnaround_var_us
+          + (magnitude - (int64_t)target->turnaround_var_us) / 4);
+    }
+    target->response_air_us = air;
+    target->responses++;
+
+    /* The response held the bus until now */
+    if (now_us + scheduler->config.guard_us > scheduler->tx_free_us) {
+      scheduler->tx_free_us = now_us + scheduler->config.guard_us;
+    }
+
+    flight_finish(scheduler, i);
+    return 0;
+  }
+
+  return -1;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Routing Table
+ *
+ * Buckets are probed linearly. A lookup stops at the first bucket with an
+ * empty slot, so an insert always takes the first empty slot on its path.
+ * Tags are matched SWAR-style: the four tag bytes of a bucket are XORed
+ * with the wanted tag and checked for zero bytes in one 32-bit operation.
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "fusain_internal.h"
+
+#define TAG_EMPTY 0x00u
+#define TAG_REMOVED 0x01u
+#define TAG_IN_USE 0x80u
+#define BYTES_LOW 0x01010101u
+#define BYTES_HIGH 0x80808080u
+
+static uint32_t hash_tag(uint64_t hash)
+{
+  return TAG_IN_USE | (uint32_t)(hash >> 57);
+}
+
+static uint32_t hash_bucket(const fusain_route_t* table, uint64_t hash)
+{
+  return (uint32_t)(hash >> 20) & table->mask;
+}
+
+/* High bit set in every byte of tags equal to tag (rare false positives above a match) */
+static uint32_t tags_match(uint32_t tags, uint32_t tag)
+{
+  uint32_t x = tags ^ (tag * BYTES_LOW);
+  return (x - BYTES_LOW) & ~x & BYTES_HIGH;
+}
+
+/* High bit set in every empty byte: bit 7 and bit 0 both clear */
+static uint32_t tags_empty(uint32_t tags)
+{
+  return ~(tags | (tags << 7)) & BYTES_HIGH;
+}
+
+static uint32_t tag_at(uint32_t tags, uint32_t slot)
+{
+  return (tags >> (8 * slot)) & 0xFFu;
+}
+
+/* Slot of the lowest flagged byte */
+static uint32_t first_slot(uint32_t flags)
+{
+  return (uint32_t)__builtin_ctz(flags) / 8;
+}
+
+static int bucket_find(const fusain_route_bucket_t* bucket, uint32_t tags, uint32_t tag,
+    uint64_t address)
+{
+  for (uint32_t match = tags_match(tags, tag); match != 0; match &= match - 1) {
+    uint32_t slot = first_slot(match);
+    if (tag_at(tags, slot) == tag && bucket->addresses[slot] == address) {
+      return (int)slot;
+    }
+  }
+  return -1;
+}
+
+static void bucket_publish(fusain_route_bucket_t* bucket, uint32_t slot, uint32_t tag)
+{
+  uint32_t tags = bucket->tags & ~(0xFFu << (8 * slot));
+  STORE_RELEASE(&bucket->tags, tags | (tag << (8 * slot)));
+}
+
+int fusain_route_init(fusain_route_t* table, fusain_route_bucket_t* buckets,
+    fusain_route_bucket_t* spare, uint32_t bucket_count)
+{
+  if (table == NULL || buckets == NULL || bucket_count == 0
+      || (bucket_count & (bucket_count - 1)) != 0) {
+    return -1;
+  }
+
+  memset(buckets, 0, (size_t)bucket_count * sizeof(*buckets));
+  table->buckets = buckets;
+  table->spare = spare;
+  table->mask = bucket_count - 1;
+  table->count = 0;
+  table->removed = 0;
+  return 0;
+}
+
+int fusain_route_set(fusain_route_t* table, uint64_t address, uint32_t route)
+{
+  uint64_t hash = fusain_address_hash(address);
+  uint32_t tag = hash_tag(hash);
+  uint32_t i = hash_bucket(table, hash);
+  fusain_route_bucket_t* reuse = NULL;
+  uint32_t reuse_slot = 0;
+
+  for (uint32_t probe = 0; probe <= table->mask; probe++) {
+    fusain_route_bucket_t* bucket = &table->buckets[i];
+    uint32_t tags = bucket->tags;
+
+    int slot = bucket_find(bucket, tags, tag, address);
+    if (slot >= 0) {
+      STORE_RELAXED(&bucket->routes[slot], route);
+      return 0;
+    }
+
+    /* A removed slot of this same address is safe to bring back at once */
+    if (reuse == NULL) {
+      slot = bucket_find(bucket, tags, TAG_REMOVED, address);
+      if (slot >= 0) {
+        reuse = bucket;
+        reuse_slot = (uint32_t)slot;
+      }
+    }
+
+    uint32_t empty = tags_empty(tags);
+    if (empty != 0) {
+      if (reuse != NULL) {
+        STORE_RELAXED(&reuse->routes[reuse_slot], route);
+        bucket_publish(reuse, reuse_slot, tag);
+        table->removed--;
+        table->count++;
+        return 1;
+      }
+      uint32_t capacity = (table->mask + 1) * FUSAIN_ROUTE_SLOTS;
+      if (table->count + table->removed >= capacity - capacity / 8) {
+        return -2;
+      }
+      uint32_t free_slot = first_slot(empty);
+      bucket->addresses[free_slot] = address;
+      STORE_RELAXED(&bucket->routes[free_slot], route);
+      bucket_publish(bucket, free_slot, tag);
+      table->count++;
+      return 1;
+    }
+    i = (i + 1) & table->mask;
+  }
+  return -2; /* LCOV_EXCL_LINE - the 7/8 fill limit always leaves an empty slot */
+}
+
+int fusain_route_remove(fusain_route_t* table, uint64_t address)
+{
+  uint64_t hash = fusain_address_hash(address);
+  uint32_t tag = hash_tag(hash);
+  uint32_t i = hash_bucket(table, hash);
+
+  for (uint32_t probe = 0; probe <= table->mask; probe++) {
+    fusain_route_bucket_t* bucket = &table->buckets[i];
+    uint32_t tags = bucket->tags;
+
+    int slot = bucket_find(bucket, tags, tag, address);
+    if (slot >= 0) {
+      bucket_publish(bucket, (uint32_t)slot, TAG_REMOVED);
+      table->count--;
+      table->removed++;
+      return 0;
+    }
+    if (tags_empty(tags) != 0) {
+      return -1;
+    }
+    i = (i + 1) & table->mask;
+  }
+  return -1; /* LCOV_EXCL_LINE - the 7/8 fill limit always leaves an empty slot */
+}
+
+int fusain_route_lookup(const fusain_route_t* table, uint64_t address,
+    uint32_t* route)
+{
+  const fusain_route_bucket_t* buckets = LOAD_ACQUIRE(&table->buckets);
+  uint64_t hash = fusain_address_hash(address);
+  uint32_t tag = hash_tag(hash);
+  uint32_t i = hash_bucket(table, hash);
+
+  for (uint32_t probe = 0; probe <= table->mask; probe++) {
+    const fusain_route_bucket_t* bucket = &buckets[i];
+    uint32_t tags = LOAD_ACQUIRE(&bucket->tags);
+
+    int slot = bucket_find(bucket, tags, tag, address);
+    if (slot >= 0) {
+      *route = LOAD_RELAXED(&bucket->routes[slot]);
+      return 0;
+    }
+    if (tags_empty(tags) != 0) {
+      return -1;
+    }
+    i = (i + 1) & table->mask;
+  }
+  return -1; /* LCOV_EXCL_LINE - the 7/8 fill limit always leaves an empty slot */
+}
+
+fusain_route_bucket_t* fusain_route_compact(fusain_route_t* table)
+{
+  fusain_route_bucket_t* old = table->buckets;
+  fusain_route_bucket_t* target = table->spare;
+  if (target == NULL) {
+    return NULL;
+  }
+
+  /* Not yet visible to readers, so no ordering is needed while filling it */
+  memset(target, 0, (size_t)(table->mask + 1) * sizeof(*target));
+  for (uint32_t b = 0; b <= table->mask; b++) {
+    uint32_t tags = old[b].tags;
+    for (uint32_t slot = 0; slot < FUSAIN_ROUTE_SLOTS; slot++) {
+      if ((tag_at(tags, slot) & TAG_IN_USE) == 0) {
+        continue;
+      }
+      uint64_t address = old[b].addresses[slot];
+      uint64_t hash = fusain_address_hash(address);
+      uint32_t i = hash_bucket(table, hash);
+      uint32_t empty;
+      while ((empty = tags_empty(target[i].tags)) == 0) {
+        i = (i + 1) & table->mask;
+      }
+      uint32_t free_slot = first_slot(empty);
+      target[i].addresses[free_slot] = address;
+      target[i].routes[free_slot] = old[b].routes[slot];
+      target[i].tags |= hash_tag(hash) << (8 * free_slot);
+    }
+  }
+
+  STORE_RELEASE(&table->buckets, target);
+  table->spare = NULL;
+  table->removed = 0;
+  return old;
+}
+
+void fusain_route_recycle(fusain_route_t* table, fusain_route_bucket_t* buckets)
+{
+  table->spare = buckets;
+}
@@ -0,0 +1,778 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Device Shadow
+ *
+ * Packets are decoded into locals first. To apply one, the writer bumps
+ * the sequence so readers move to copies[1], updates copies[0], bumps it
+ * again so readers move back, and brings copies[1] up to date. Readers
+ * copy just the value they asked for from the copy the sequence names.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "fusain_internal.h"
+
+static uint32_t shadow_home(const fusain_shadow_t* shadow, uint64_t address)
+{
+  return (uint32_t)(fusain_address_hash(address) >> 32) & shadow->mask;
+}
+
+static fusain_shadow_device_t* shadow_find(const fusain_shadow_t* shadow,
+    uint64_t address)
+{
+  uint32_t i = shadow_home(shadow, address);
+
+  for (uint32_t probe = 0; probe <= shadow->mask; probe++) {
+    fusain_shadow_device_t* device = &shadow->devices[i];
+    if (!LOAD_ACQUIRE(&device->in_use)) {
+      return NULL;
+    }
+    if (device->address == address) {
+      return device;
+    }
+    i = (i + 1) & shadow->mask;
+  }
+  return NULL;
+}
+
+/*
+ * Image checksum: sum of the record's 32-bit words weighted by 2i + 1.
+ * Odd weights catch any single changed word and swapped words, and an
+ * update adjusts the stored sum by each word's difference from the old
+ * copy, so writers never recompute it from scratch.
+ */
+/* The record holds uint32_t fields, so its size is a whole number of words */
+#define RECORD_WORDS (sizeof(fusain_shadow_record_t) / sizeof(uint32_t))
+
+static uint32_t record_word(const fusain_shadow_record_t* record, size_t i)
+{
+  uint32_t word;
+  memcpy(&word, (const uint8_t*)record + i * sizeof(word), sizeof(word));
+  return word;
+}
+
+static uint32_t record_sum(const fusain_shadow_record_t* record)
+{
+  uint32_t sum = 0;
+  for (size_t i = 0; i < RECORD_WORDS; i++) {
+    sum += (uint32_t)(2 * i + 1) * record_word(record, i);
+  }
+  return sum;
+}
+
+static uint32_t record_sum_update(uint32_t sum, const fusain_shadow_record_t* before,
+    const fusain_shadow_record_t* after)
+{
+  for (size_t i = 0; i < RECORD_WORDS; i++) {
+    uint32_t old_word = record_word(before, i);
+    uint32_t new_word = record_word(after, i);
+    sum += (uint32_t)(2 * i + 1) * (new_word - old_word);
+  }
+  return sum;
+}
+
+static fusain_shadow_device_t* shadow_insert(fusain_shadow_t* shadow,
+    uint64_t address)
+{
+  uint32_t i = shadow_home(shadow, address);
+
+  for (uint32_t probe = 0; probe <= shadow->mask; probe++) {
+    fusain_shadow_device_t* device = &shadow->devices[i];
+    if (!device->in_use) {
+      /* Publish the address only after it is written */
+      device->address = address;
+      if (shadow->persistent) {
+        /* Base for the first record_sum_update() */
+        device->sum[1] = record_sum(&device->copies[1]);
+      }
+      STORE_RELEASE(&device->in_use, 1);
+      shadow->count++;
+      return device;
+    }
+    if (device->address == address) {
+      return device;
+    }
+    i = (i + 1) & shadow->mask;
+  }
+  return NULL;
+}
+
+/* Returns the copy to update; readers are on the other one */
+static fusain_shadow_record_t* write_begin(fusain_shadow_device_t* device)
+{
+  STORE_RELAXED(&device->seq, LOAD_RELAXED(&device->seq) + 1);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  device->copies[0].present &= (uint8_t)~FUSAIN_SHADOW_RESTORED;
+  return &device->copies[0];
+}
+
+/*
+ * Each copy's checksum is written before the sequence points readers at
+ * it, so copies[seq & 1] and sum[seq & 1] agree whenever the process
+ * stops.
+ */
+static void write_end(const fusain_shadow_t* shadow, fusain_shadow_device_t* device,
+    uint32_t now_ms)
+{
+  device->copies[0].updated_ms = now_ms;
+  if (shadow->persistent) {
+    /* copies[1] still holds the record as it was before this update */
+    device->sum[0] = record_sum_update(device->sum[1], &device->copies[1], &device->copies[0]);
+  }
+  STORE_RELEASE(&device->seq, LOAD_RELAXED(&device->seq) + 1);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(&device->copies[1], &device->copies[0], sizeof(device->copies[1]));
+  device->sum[1] = device->sum[0];
+}
+
+/* Copy size bytes at offset, plus one presence byte, from a stable copy */
+static uint8_t read_stable(const fusain_shadow_device_t* device,
+    size_t mask_offset, size_t offset, size_t size, void* out)
+{
+  uint8_t present;
+
+  for (;;) {
+    uint32_t seq = LOAD_ACQUIRE(&device->seq);
+    const uint8_t* base = (const uint8_t*)&device->copies[seq & 1];
+    present = base[mask_offset];
+    memcpy(out, base + offset, size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (LOAD_RELAXED(&device->seq) == seq) {
+      return present;
+    }
+  }
+}
+
+static int shadow_read(const fusain_shadow_t* shadow, uint64_t address,
+    size_t mask_offset, uint8_t bit, size_t offset, size_t size, void* out)
+{
+  const fusain_shadow_device_t* device = shadow_find(shadow, address);
+  if (device == NULL) {
+    return -1;
+  }
+  return (read_stable(device, mask_offset, offset, size, out) & bit) ? 0 : -2;
+}
+
+/* Packet decoding (into locals, before the record is touched) */
+
+static int peek_index(const fusain_packet_t* packet, uint8_t* index)
+{
+  int64_t value;
+  if (fusain_peek_int(packet, 0, &value) < 0 || value < 0 || value > UINT8_MAX) {
+    return -1;
+  }
+  *index = (uint8_t)value;
+  return *index < FUSAIN_SHADOW_MAX_PERIPHERALS ? 0 : -3;
+}
+
+static int peek_u32(const fusain_packet_t* packet, uint32_t key, uint32_t* out)
+{
+  uint64_t value;
+  if (fusain_peek_uint(packet, key, &value) < 0 || value > UINT32_MAX) {
+    return -1;
+  }
+  *out = (uint32_t)value;
+  return 0;
+}
+
+/* Returns 1 if present, 0 if absent, -1 if malformed */
+static int peek_optional_i32(const fusain_packet_t* packet, uint32_t key, int32_t* out)
+{
+  int64_t value;
+  int ret = fusain_peek_int(packet, key, &value);
+  if (ret == -2) {
+    return 0;
+  }
+  if (ret < 0 || value < INT32_MIN || value > INT32_MAX) {
+    return -1;
+  }
+  *out = (int32_t)value;
+  return 1;
+}
+
+static int peek_optional_u32(const fusain_packet_t* packet, uint32_t key, uint32_t* out)
+{
+  uint64_t value;
+  int ret = fusain_peek_uint(packet, key, &value);
+  if (ret == -2) {
+    return 0;
+  }
+  if (ret < 0 || value > UINT32_MAX) {
+    return -1;
+  }
+  *out = (uint32_t)value;
+  return 1;
+}
+
+static int update_state(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_state_data_t data;
+  uint32_t code;
+  uint32_t state;
+
+  if (fusain_peek_bool(packet, 0, &data.error) < 0 || peek_u32(packet, 1, &code) < 0
+      || peek_u32(packet, 2, &state) < 0 || peek_u32(packet, 3, &data.timestamp) < 0
+      || code > UINT8_MAX || state > UINT8_MAX) {
+    return -1;
+  }
+  data.code = (uint8_t)code;
+  data.state = (uint8_t)state;
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  rec->state = data;
+  rec->present |= FUSAIN_SHADOW_HAS_STATE;
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+static int update_caps(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  uint32_t counts[4];
+
+  for (uint32_t key = 0; key < 4; key++) {
+    if (peek_u32(packet, key, &counts[key]) < 0 || counts[key] > UINT8_MAX) {
+      return -1;
+    }
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  rec->caps.motor_count = (uint8_t)counts[0];
+  rec->caps.thermometer_count = (uint8_t)counts[1];
+  rec->caps.pump_count = (uint8_t)counts[2];
+  rec->caps.glow_count = (uint8_t)counts[3];
+  rec->present |= FUSAIN_SHADOW_HAS_CAPS;
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+static int update_motor(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_motor_data_t data = { 0 };
+  int has[4];
+  int ret = peek_index(packet, &data.motor);
+  if (ret < 0) {
+    return ret;
+  }
+  int64_t rpm;
+  int64_t target;
+  if (peek_u32(packet, 1, &data.timestamp) < 0 || fusain_peek_int(packet, 2, &rpm) < 0
+      || fusain_peek_int(packet, 3, &target) < 0 || rpm < INT32_MIN || rpm > INT32_MAX
+      || target < INT32_MIN || target > INT32_MAX) {
+    return -1;
+  }
+  data.rpm = (int32_t)rpm;
+  data.target = (int32_t)target;
+  has[0] = peek_optional_i32(packet, 4, &data.max_rpm);
+  has[1] = peek_optional_i32(packet, 5, &data.min_rpm);
+  has[2] = peek_optional_u32(packet, 6, &data.pwm);
+  has[3] = peek_optional_u32(packet, 7, &data.pwm_max);
+  if (has[0] < 0 || has[1] < 0 || has[2] < 0 || has[3] < 0) {
+    return -1;
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  fusain_motor_data_t* slot = &rec->motors[data.motor];
+  slot->motor = data.motor;
+  slot->timestamp = data.timestamp;
+  slot->rpm = data.rpm;
+  slot->target = data.target;
+  if (has[0]) {
+    slot->max_rpm = data.max_rpm;
+  }
+  if (has[1]) {
+    slot->min_rpm = data.min_rpm;
+  }
+  if (has[2]) {
+    slot->pwm = data.pwm;
+  }
+  if (has[3]) {
+    slot->pwm_max = data.pwm_max;
+  }
+  rec->motor_mask |= (uint8_t)(1u << data.motor);
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+static int update_pump(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_pump_data_t data = { 0 };
+  uint32_t event;
+  int ret = peek_index(packet, &data.pump);
+  if (ret < 0) {
+    return ret;
+  }
+  if (peek_u32(packet, 1, &data.timestamp) < 0 || peek_u32(packet, 2, &event) < 0
+      || event > UINT8_MAX) {
+    return -1;
+  }
+  data.event = (uint8_t)event;
+  int has_rate = peek_optional_i32(packet, 3, &data.rate);
+  if (has_rate < 0) {
+    return -1;
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  fusain_pump_data_t* slot = &rec->pumps[data.pump];
+  slot->pump = data.pump;
+  slot->timestamp = data.timestamp;
+  slot->event = data.event;
+  if (has_rate) {
+    slot->rate = data.rate;
+  }
+  rec->pump_mask |= (uint8_t)(1u << data.pump);
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+static int update_glow(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_glow_data_t data;
+  int ret = peek_index(packet, &data.glow);
+  if (ret < 0) {
+    return ret;
+  }
+  if (peek_u32(packet, 1, &data.timestamp) < 0 || fusain_peek_bool(packet, 2, &data.lit) < 0) {
+    return -1;
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  rec->glows[data.glow] = data;
+  rec->glow_mask |= (uint8_t)(1u << data.glow);
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+static int update_temp(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_temp_data_t data;
+  int fields = fusain_decode_temp_data(packet, &data);
+  if (fields < 0) {
+    return -1;
+  }
+  if (data.thermometer >= FUSAIN_SHADOW_MAX_PERIPHERALS) {
+    return -3;
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  fusain_temp_data_t* slot = &rec->temps[data.thermometer];
+  slot->thermometer = data.thermometer;
+  slot->timestamp = data.timestamp;
+  slot->reading = data.reading;
+  if (fields & FUSAIN_TEMP_DATA_RPM_CONTROL) {
+    slot->rpm_control = data.rpm_control;
+  }
+  if (fields & FUSAIN_TEMP_DATA_WATCHED_MOTOR) {
+    slot->watched_motor = data.watched_motor;
+  }
+  if (fields & FUSAIN_TEMP_DATA_TARGET_TEMP) {
+    slot->target_temp = data.target_temp;
+  }
+  rec->temp_mask |= (uint8_t)(1u << data.thermometer);
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+/* Batch records (values start at the message's key 2) */
+
+static int32_t batch_int(const fusain_batch_value_t* value)
+{
+  return value->is_float ? (int32_t)value->as.f : value->as.i;
+}
+
+static float batch_float(const fusain_batch_value_t* value)
+{
+  return value->is_float ? value->as.f : (float)value->as.i;
+}
+
+/* Whether value j of a record fits the field it is stored in */
+static bool batch_value_fits(uint8_t kind, uint8_t j, const fusain_batch_value_t* value)
+{
+  int64_t min = INT32_MIN;
+  int64_t max = INT32_MAX;
+
+  if (kind == FUSAIN_MSG_TEMP_DATA && (j == 0 || j == 3)) {
+    return true; /* reading and target_temp stay floats */
+  }
+  if (kind == FUSAIN_MSG_MOTOR_DATA && j >= 4) {
+    min = 0; /* pwm, pwm_max */
+  } else if (kind == FUSAIN_MSG_PUMP_DATA && j == 0) {
+    min = 0; /* event */
+    max = UINT8_MAX;
+  }
+  if (value->is_float) {
+    /* Truncation must land in range; NaN fails both comparisons */
+    double f = value->as.f;
+    return f > (double)min - 1.0 && f < (double)max + 1.0;
+  }
+  return value->as.i >= min && value->as.i <= max;
+}
+
+static int batch_check(const fusain_batch_record_t* record)
+{
+  uint8_t needed;
+
+  switch (record->kind) {
+  case FUSAIN_MSG_MOTOR_DATA:
+    needed = 2;
+    break;
+  case FUSAIN_MSG_PUMP_DATA:
+  case FUSAIN_MSG_GLOW_DATA:
+  case FUSAIN_MSG_TEMP_DATA:
+    needed = 1;
+    break;
+  default:
+    return 1; /* Not shadowed */
+  }
+  if (record->value_count < needed) {
+    return -1;
+  }
+  for (uint8_t j = 0; j < record->value_count; j++) {
+    if (!batch_value_fits(record->kind, j, &record->values[j])) {
+      return -1;
+    }
+  }
+  return record->index < FUSAIN_SHADOW_MAX_PERIPHERALS ? 0 : -3;
+}
+
+static void batch_apply(fusain_shadow_record_t* rec,
+    const fusain_batch_record_t* record, uint32_t timestamp)
+{
+  const fusain_batch_value_t* v = record->values;
+  uint8_t n = record->value_count;
+  uint8_t bit = (uint8_t)(1u << record->index);
+
+  switch (record->kind) {
+  case FUSAIN_MSG_MOTOR_DATA: {
+    fusain_motor_data_t* slot = &rec->motors[record->index];
+    slot->motor = record->index;
+    slot->timestamp = timestamp;
+    slot->rpm = batch_int(&v[0]);
+    slot->target = batch_int(&v[1]);
+    if (n > 2) {
+      slot->max_rpm = batch_int(&v[2]);
+    }
+    if (n > 3) {
+      slot->min_rpm = batch_int(&v[3]);
+    }
+    if (n > 4) {
+      slot->pwm = (uint32_t)batch_int(&v[4]);
+    }
+    if (n > 5) {
+      slot->pwm_max = (uint32_t)batch_int(&v[5]);
+    }
+    rec->motor_mask |= bit;
+    break;
+  }
+  case FUSAIN_MSG_PUMP_DATA: {
+    fusain_pump_data_t* slot = &rec->pumps[record->index];
+    slot->pump = record->index;
+    slot->timestamp = timestamp;
+    slot->event = (uint8_t)batch_int(&v[0]);
+    if (n > 1) {
+      slot->rate = batch_int(&v[1]);
+    }
+    rec->pump_mask |= bit;
+    break;
+  }
+  case FUSAIN_MSG_GLOW_DATA: {
+    fusain_glow_data_t* slot = &rec->glows[record->index];
+    slot->glow = record->index;
+    slot->timestamp = timestamp;
+    slot->lit = batch_int(&v[0]) != 0;
+    rec->glow_mask |= bit;
+    break;
+  }
+  default: { /* FUSAIN_MSG_TEMP_DATA, the only other kind batch_check() passes */
+    fusain_temp_data_t* slot = &rec->temps[record->index];
+    slot->thermometer = record->index;
+    slot->timestamp = timestamp;
+    slot->reading = batch_float(&v[0]);
+    if (n > 1) {
+      slot->rpm_control = batch_int(&v[1]) != 0;
+    }
+    if (n > 2) {
+      slot->watched_motor = batch_int(&v[2]);
+    }
+    if (n > 3) {
+      slot->target_temp = batch_float(&v[3]);
+    }
+    rec->temp_mask |= bit;
+    break;
+  }
+  }
+}
+
+static int update_batch(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  fusain_telemetry_batch_t batch;
+  if (fusain_decode_telemetry_batch(packet, &batch) < 0) {
+    return -1;
+  }
+
+  /* Validate everything first so a batch is applied whole or not at all */
+  for (uint8_t i = 0; i < batch.count; i++) {
+    int ret = batch_check(&batch.records[i]);
+    if (ret < 0) {
+      return ret;
+    }
+  }
+
+  fusain_shadow_device_t* device = shadow_insert(shadow, packet->address);
+  if (device == NULL) {
+    return -2;
+  }
+  fusain_shadow_record_t* rec = write_begin(device);
+  for (uint8_t i = 0; i < batch.count; i++) {
+    const fusain_batch_record_t* record = &batch.records[i];
+    if (batch_check(record) == 0) {
+      batch_apply(rec, record, batch.base_timestamp + record->dt_ms);
+    }
+  }
+  write_end(shadow, device, now_ms);
+  return 0;
+}
+
+int fusain_shadow_init(fusain_shadow_t* shadow, fusain_shadow_device_t* devices,
+    uint32_t capacity)
+{
+  if (shadow == NULL || devices == NULL || capacity == 0
+      || (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+
+  memset(devices, 0, (size_t)capacity * sizeof(*devices));
+  shadow->devices = devices;
+  shadow->mask = capacity - 1;
+  shadow->count = 0;
+  shadow->persistent = false;
+  return 0;
+}
+
+size_t fusain_shadow_image_size(uint32_t capacity)
+{
+  return sizeof(fusain_shadow_image_t) + (size_t)capacity * sizeof(fusain_shadow_device_t);
+}
+
+static uint16_t image_header_crc(const fusain_shadow_image_t* header)
+{
+  return fusain_crc16((const uint8_t*)header, offsetof(fusain_shadow_image_t, crc));
+}
+
+/* Keep the newest intact copy of a restored device, or clear its readings */
+static int restore_device(fusain_shadow_device_t* device)
+{
+  uint32_t current = device->seq & 1;
+  int restored = 1;
+
+  if (record_sum(&device->copies[current]) == device->sum[current]) {
+    if (current != 0) {
+      memcpy(&device->copies[0], &device->copies[1], sizeof(device->copies[0]));
+    }
+  } else if (record_sum(&device->copies[current ^ 1]) == device->sum[current ^ 1]) {
+    if (current == 0) {
+      memcpy(&device->copies[0], &device->copies[1], sizeof(device->copies[0]));
+    }
+  } else {
+    memset(&device->copies[0], 0, sizeof(device->copies[0]));
+    restored = 0;
+  }
+
+  device->seq = 0;
+  device->in_use = 1;
+  device->copies[0].present |= FUSAIN_SHADOW_RESTORED;
+  device->sum[0] = record_sum(&device->copies[0]);
+  memcpy(&device->copies[1], &device->copies[0], sizeof(device->copies[1]));
+  device->sum[1] = device->sum[0];
+  return restored;
+}
+
+int fusain_shadow_attach(fusain_shadow_t* shadow, void* image, size_t size,
+    uint32_t capacity)
+{
+  if (shadow == NULL || image == NULL || ((uintptr_t)image & 7) != 0
+      || capacity == 0 || (capacity & (capacity - 1)) != 0
+      || size < fusain_shadow_image_size(capacity)) {
+    return -1;
+  }
+
+  fusain_shadow_image_t* header = image;
+  fusain_shadow_device_t* devices = (fusain_shadow_device_t*)(header + 1);
+  if (header->magic != FUSAIN_SHADOW_IMAGE_MAGIC
+      || header->version != FUSAIN_SHADOW_IMAGE_VERSION
+      || header->entry_size != sizeof(fusain_shadow_device_t)
+      || header->capacity != capacity || header->crc != image_header_crc(header)) {
+    fusain_shadow_init(shadow, devices, capacity);
+    shadow->persistent = true;
+    memset(header, 0, sizeof(*header));
+    header->magic = FUSAIN_SHADOW_IMAGE_MAGIC;
+    header->version = FUSAIN_SHADOW_IMAGE_VERSION;
+    header->entry_size = sizeof(fusain_shadow_device_t);
+    header->capacity = capacity;
+    header->crc = image_header_crc(header);
+    return 0;
+  }
+
+  int restored = 0;
+  shadow->devices = devices;
+  shadow->mask = capacity - 1;
+  shadow->count = 0;
+  shadow->persistent = true;
+  for (uint32_t i = 0; i < capacity; i++) {
+    if (devices[i].in_use) {
+      restored += restore_device(&devices[i]);
+      shadow->count++;
+    }
+  }
+  return restored;
+}
+
+uint32_t fusain_shadow_restored(const fusain_shadow_t* shadow, uint64_t* addresses,
+    uint32_t max)
+{
+  uint32_t found = 0;
+
+  for (uint32_t i = 0; i <= shadow->mask; i++) {
+    const fusain_shadow_device_t* device = &shadow->devices[i];
+    uint8_t present;
+    if (!LOAD_ACQUIRE(&device->in_use)) {
+      continue;
+    }
+    read_stable(device, offsetof(fusain_shadow_record_t, present),
+        offsetof(fusain_shadow_record_t, present), sizeof(present), &present);
+    if (present & FUSAIN_SHADOW_RESTORED) {
+      if (found < max) {
+        addresses[found] = device->address;
+      }
+      found++;
+    }
+  }
+  return found;
+}
+
+int fusain_shadow_update(fusain_shadow_t* shadow, const fusain_packet_t* packet,
+    uint32_t now_ms)
+{
+  switch (packet->msg_type) {
+  case FUSAIN_MSG_STATE_DATA:
+    return update_state(shadow, packet, now_ms);
+  case FUSAIN_MSG_MOTOR_DATA:
+    return update_motor(shadow, packet, now_ms);
+  case FUSAIN_MSG_PUMP_DATA:
+    return update_pump(shadow, packet, now_ms);
+  case FUSAIN_MSG_GLOW_DATA:
+    return update_glow(shadow, packet, now_ms);
+  case FUSAIN_MSG_TEMP_DATA:
+    return update_temp(shadow, packet, now_ms);
+  case FUSAIN_MSG_DEVICE_ANNOUNCE:
+    return update_caps(shadow, packet, now_ms);
+  case FUSAIN_MSG_TELEMETRY_BATCH:
+    return update_batch(shadow, packet, now_ms);
+  default:
+    return 1;
+  }
+}
+
+int fusain_shadow_read_state(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_state_data_t* data)
+{
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, present),
+      FUSAIN_SHADOW_HAS_STATE, offsetof(fusain_shadow_record_t, state), sizeof(*data), data);
+}
+
+int fusain_shadow_read_caps(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_device_caps_t* caps)
+{
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, present),
+      FUSAIN_SHADOW_HAS_CAPS, offsetof(fusain_shadow_record_t, caps), sizeof(*caps), caps);
+}
+
+int fusain_shadow_read_motor(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_motor_data_t* data)
+{
+  if (index >= FUSAIN_SHADOW_MAX_PERIPHERALS) {
+    return shadow_find(shadow, address) != NULL ? -2 : -1;
+  }
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, motor_mask),
+      (uint8_t)(1u << index),
+      offsetof(fusain_shadow_record_t, motors) + index * sizeof(*data), sizeof(*data), data);
+}
+
+int fusain_shadow_read_pump(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_pump_data_t* data)
+{
+  if (index >= FUSAIN_SHADOW_MAX_PERIPHERALS) {
+    return shadow_find(shadow, address) != NULL ? -2 : -1;
+  }
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, pump_mask),
+      (uint8_t)(1u << index),
+      offsetof(fusain_shadow_record_t, pumps) + index * sizeof(*data), sizeof(*data), data);
+}
+
+int fusain_shadow_read_glow(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_glow_data_t* data)
+{
+  if (index >= FUSAIN_SHADOW_MAX_PERIPHERALS) {
+    return shadow_find(shadow, address) != NULL ? -2 : -1;
+  }
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, glow_mask),
+      (uint8_t)(1u << index),
+      offsetof(fusain_shadow_record_t, glows) + index * sizeof(*data), sizeof(*data), data);
+}
+
+int fusain_shadow_read_temp(const fusain_shadow_t* shadow, uint64_t address,
+    uint8_t index, fusain_temp_data_t* data)
+{
+  if (index >= FUSAIN_SHADOW_MAX_PERIPHERALS) {
+    return shadow_find(shadow, address) != NULL ? -2 : -1;
+  }
+  return shadow_read(shadow, address, offsetof(fusain_shadow_record_t, temp_mask),
+      (uint8_t)(1u << index),
+      offsetof(fusain_shadow_record_t, temps) + index * sizeof(*data), sizeof(*data), data);
+}
+
+int fusain_shadow_snapshot(const fusain_shadow_t* shadow, uint64_t address,
+    fusain_shadow_record_t* record)
+{
+  const fusain_shadow_device_t* device = shadow_find(shadow, address);
+  if (device == NULL) {
+    return -1;
+  }
+  read_stable(device, offsetof(fusain_shadow_record_t, present), 0, sizeof(*record), record);
+  return 0;
+}
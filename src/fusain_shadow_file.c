@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Memory-Mapped Shadow File
+ *
+ * Standalone builds on POSIX hosts only. The mapping is the shadow's live
+ * table (see fusain_shadow_attach()), so there is no save step: the kernel
+ * writes dirty pages back on its own schedule or on fusain_shadow_sync().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fusain/fusain.h>
+
+int fusain_shadow_open(fusain_shadow_t* shadow, fusain_shadow_file_t* file,
+    const char* path, uint32_t capacity)
+{
+  if (shadow == NULL || file == NULL || path == NULL || capacity == 0
+      || (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+
+  size_t size = fusain_shadow_image_size(capacity);
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return -2;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || ((size_t)st.st_size != size && ftruncate(fd, (off_t)size) < 0)) {
+    close(fd);
+    return -2;
+  }
+
+  void* image = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (image == MAP_FAILED) {
+    close(fd);
+    return -2;
+  }
+
+  int restored = fusain_shadow_attach(shadow, image, size, capacity);
+  if (restored < 0) { /* LCOV_EXCL_START - arguments checked above, mapping is page-aligned */
+    munmap(image, size);
+    close(fd);
+    return restored;
+  } /* LCOV_EXCL_STOP */
+
+  file->image = image;
+  file->size = size;
+  file->fd = fd;
+  return restored;
+}
+
+int fusain_shadow_sync(fusain_shadow_file_t* file, bool wait)
+{
+  return msync(file->image, file->size, wait ? MS_SYNC : MS_ASYNC) < 0 ? -2 : 0;
+}
+
+void fusain_shadow_close(fusain_shadow_file_t* file)
+{
+  munmap(file->image, file->size);
+  close(file->fd);
+  file->image = NULL;
+  file->size = 0;
+  file->fd = -1;
+}
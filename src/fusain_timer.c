@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Hierarchical Timer Wheel
+ *
+ * Level 0 holds timers due within the next 64 ticks, one slot per tick.
+ * Each higher level covers 64 times the span of the one below. Whenever
+ * level 0 wraps, the next slot of level 1 is emptied and its timers are
+ * re-placed (mostly into level 0), and likewise up the levels. A timer is
+ * therefore moved at most once per level before it fires.
+ */
+
+#include <stddef.h>
+
+#include <fusain/fusain.h>
+
+#define WHEEL_MASK (FUSAIN_WHEEL_SLOTS - 1)
+
+/* Delays are compared as signed tick differences */
+#define WHEEL_MAX_DELAY 0x7FFFFFFFUL
+
+static void slot_insert(fusain_timer_t** head, fusain_timer_t* timer)
+{
+  timer->next = *head;
+  if (*head != NULL) {
+    (*head)->pprev = &timer->next;
+  }
+  *head = timer;
+  timer->pprev = head;
+}
+
+static void slot_unlink(fusain_timer_t* timer)
+{
+  *timer->pprev = timer->next;
+  if (timer->next != NULL) {
+    timer->next->pprev = timer->pprev;
+  }
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+static void wheel_place(fusain_wheel_t* wheel, fusain_timer_t* timer)
+{
+  uint32_t next = wheel->tick + 1;
+  uint32_t expires = timer->expires;
+  uint32_t delta = expires - next;
+
+  if ((int32_t)delta < 0) {
+    /* Already due: run on the next tick */
+    slot_insert(&wheel->slots[0][next & WHEEL_MASK], timer);
+    return;
+  }
+  if (delta >= FUSAIN_WHEEL_RANGE) {
+    /* Park in the farthest slot; it is re-placed when that slot cascades */
+    expires = next + (uint32_t)(FUSAIN_WHEEL_RANGE - 1);
+    delta = (uint32_t)(FUSAIN_WHEEL_RANGE - 1);
+  }
+
+  uint8_t level = 0;
+  while (delta >= (1UL << (FUSAIN_WHEEL_BITS * (level + 1)))) {
+    level++;
+  }
+  slot_insert(&wheel->slots[level][(expires >> (FUSAIN_WHEEL_BITS * level)) & WHEEL_MASK], timer);
+}
+
+/* Re-place the timers of one higher-level slot; returns the slot index */
+static uint32_t wheel_cascade(fusain_wheel_t* wheel, uint8_t level)
+{
+  uint32_t index = ((wheel->tick + 1) >> (FUSAIN_WHEEL_BITS * level)) & WHEEL_MASK;
+  fusain_timer_t* list = wheel->slots[level][index];
+
+  wheel->slots[level][index] = NULL;
+  while (list != NULL) {
+    fusain_timer_t* timer = list;
+    list = timer->next;
+    wheel_place(wheel, timer);
+  }
+
+  return index;
+}
+
+void fusain_wheel_init(fusain_wheel_t* wheel, uint32_t now_tick, uint32_t seed)
+{
+  for (uint8_t level = 0; level < FUSAIN_WHEEL_LEVELS; level++) {
+    for (uint32_t i = 0; i < FUSAIN_WHEEL_SLOTS; i++) {
+      wheel->slots[level][i] = NULL;
+    }
+  }
+  wheel->tick = now_tick;
+  wheel->pending = 0;
+  wheel->rng = seed != 0 ? seed : 0x2545F491U;
+}
+
+void fusain_timer_init(fusain_timer_t* timer, fusain_timer_cb_t callback,
+    void* user)
+{
+  timer->next = NULL;
+  timer->pprev = NULL;
+  timer->expires = 0;
+  timer->callback = callback;
+  timer->user = user;
+}
+
+void fusain_timer_start(fusain_wheel_t* wheel, fusain_timer_t* timer,
+    uint32_t delay_ticks, uint32_t jitter_ticks)
+{
+  uint64_t delay = delay_ticks;
+
+  if (jitter_ticks > 0) {
+    /* xorshift32 */
+    wheel->rng ^= wheel->rng << 13;
+    wheel->rng ^= wheel->rng >> 17;
+    wheel->rng ^= wheel->rng << 5;
+    delay += wheel->rng % ((uint64_t)jitter_ticks + 1);
+  }
+  if (delay > WHEEL_MAX_DELAY) {
+    delay = WHEEL_MAX_DELAY;
+  }
+
+  if (timer->pprev != NULL) {
+    slot_unlink(timer);
+  } else {
+    wheel->pending++;
+  }
+  timer->expires = wheel->tick + (uint32_t)delay;
+  wheel_place(wheel, timer);
+}
+
+int fusain_timer_cancel(fusain_wheel_t* wheel, fusain_timer_t* timer)
+{
+  if (timer->pprev == NULL) {
+    return -1;
+  }
+
+  slot_unlink(timer);
+  wheel->pending--;
+  return 0;
+}
+
+bool fusain_timer_pending(const fusain_timer_t* timer)
+{
+  return timer->pprev != NULL;
+}
+
+uint32_t fusain_wheel_advance(fusain_wheel_t* wheel, uint32_t now_tick)
+{
+  uint32_t fired = 0;
+
+  while ((int32_t)(now_tick - wheel->tick) > 0) {
+    if (wheel->pending == 0) {
+      /* Nothing to run or re-place: skip straight ahead */
+      wheel->tick = now_tick;
+      break;
+    }
+
+    uint32_t index = (wheel->tick + 1) & WHEEL_MASK;
+    if (index == 0) {
+      for (uint8_t level = 1; level < FUSAIN_WHEEL_LEVELS; level++) {
+        if (wheel_cascade(wheel, level) != 0) {
+          break;
+        }
+      }
+    }
+
+    /* Detach the slot first so callbacks can restart timers safely */
+    fusain_timer_t* list = wheel->slots[0][index];
+    wheel->slots[0][index] = NULL;
+    wheel->tick++;
+    if (list != NULL) {
+      list->pprev = &list;
+    }
+
+    while (list != NULL) {
+      fusain_timer_t* timer = list;
+      slot_unlink(timer);
+      wheel->pending--;
+      fired++;
+      timer->callback(timer, timer->user);
+    }
+  }
+
+  return fired;
+}
+
+uint32_t fusain_wheel_next(const fusain_wheel_t* wheel)
+{
+  if (wheel->pending == 0) {
+    return UINT32_MAX;
+  }
+
+  /* Level 0 up to the next wrap, where the higher levels cascade */
+  uint32_t next = wheel->tick + 1;
+  uint32_t until_wrap = FUSAIN_WHEEL_SLOTS - (next & WHEEL_MASK);
+  for (uint32_t i = 0; i < until_wrap; i++) {
+    if (wheel->slots[0][(next + i) & WHEEL_MASK] != NULL) {
+      return i + 1;
+    }
+  }
+  return until_wrap;
+}
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Serial Protocol - Priority TX Scheduling
+ *
+ * Each class is a FIFO of slots linked through next. The frame being
+ * pulled is taken off its queue, so queued frames are never partly sent
+ * and any of them may be evicted or overwritten by a newer value.
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#define WEIGHTED_FIRST FUSAIN_TX_CONTROL
+#define TOKENS_PER_BYTE 1000000ULL /* Bytes/s times microseconds */
+
+fusain_tx_class_t fusain_tx_class_of(const fusain_packet_t* packet)
+{
+  uint8_t type = packet->msg_type;
+  uint64_t mode;
+
+  if ((type & 0xF0) == 0xE0 || type == FUSAIN_MSG_TIMEOUT_CONFIG) {
+    return FUSAIN_TX_SAFETY;
+  }
+  if (type == FUSAIN_MSG_STATE_COMMAND && fusain_peek_uint(packet, 0, &mode) == 0
+      && mode == FUSAIN_MODE_EMERGENCY) {
+    return FUSAIN_TX_SAFETY;
+  }
+  if ((type & 0xF0) == 0x20) {
+    return FUSAIN_TX_CONTROL;
+  }
+  if ((type & 0xF0) == 0x10) {
+    return FUSAIN_TX_CONFIG;
+  }
+  return FUSAIN_TX_TELEMETRY;
+}
+
+/* Key of telemetry that only reports a latest value (not PUMP_DATA events) */
+static bool latest_key(const fusain_packet_t* packet, uint8_t* index)
+{
+  uint64_t value;
+
+  switch (packet->msg_type) {
+  case FUSAIN_MSG_STATE_DATA:
+    *index = 0;
+    return true;
+  case FUSAIN_MSG_MOTOR_DATA:
+  case FUSAIN_MSG_GLOW_DATA:
+  case FUSAIN_MSG_TEMP_DATA:
+    if (fusain_peek_uint(packet, 0, &value) < 0 || value > UINT8_MAX) {
+      return false;
+    }
+    *index = (uint8_t)value;
+    return true;
+  default:
+    return false;
+  }
+}
+
+static fusain_tx_slot_t* latest_find(const fusain_tx_scheduler_t* sched,
+    const fusain_packet_t* packet, uint8_t index)
+{
+  for (fusain_tx_slot_t* slot = sched->heads[FUSAIN_TX_TELEMETRY]; slot != NULL;
+      slot = slot->next) {
+    if (slot->latest && slot->address == packet->address && slot->msg_type == packet->msg_type
+        && slot->index == index) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+static void tokens_refill(fusain_tx_scheduler_t* sched, uint64_t now_us)
+{
+  if (sched->rate == 0 || now_us <= sched->tokens_us) {
+    return;
+  }
+  uint64_t elapsed = now_us - sched->tokens_us;
+  uint64_t room = sched->burst - sched->tokens;
+  sched->tokens_us = now_us;
+  if (elapsed > room / sched->rate) {
+    sched->tokens = sched->burst;
+  } else {
+    sched->tokens += elapsed * sched->rate;
+  }
+}
+
+/* Queued and, for rate-limited telemetry, covered by the bucket */
+static bool class_ready(const fusain_tx_scheduler_t* sched, uint8_t cls)
+{
+  const fusain_tx_slot_t* head = sched->heads[cls];
+  if (head == NULL) {
+    return false;
+  }
+  return cls != FUSAIN_TX_TELEMETRY || sched->rate == 0
+      || sched->tokens >= head->length * TOKENS_PER_BYTE;
+}
+
+static fusain_tx_slot_t* queue_pop(fusain_tx_scheduler_t* sched, uint8_t cls)
+{
+  fusain_tx_slot_t* slot = sched->heads[cls];
+  sched->heads[cls] = slot->next;
+  if (slot->next == NULL) {
+    sched->tails[cls] = NULL;
+  }
+  sched->stats[cls].depth--;
+  return slot;
+}
+
+static void queue_push(fusain_tx_scheduler_t* sched, uint8_t cls, fusain_tx_slot_t* slot)
+{
+  slot->next = NULL;
+  if (sched->tails[cls] != NULL) {
+    sched->tails[cls]->next = slot;
+  } else {
+    sched->heads[cls] = slot;
+  }
+  sched->tails[cls] = slot;
+
+  fusain_tx_stats_t* stats = &sched->stats[cls];
+  stats->depth++;
+  if (stats->depth > stats->max_depth) {
+    stats->max_depth = stats->depth;
+  }
+}
+
+/* A free slot, or the oldest frame of the lowest class below cls */
+static fusain_tx_slot_t* slot_take(fusain_tx_scheduler_t* sched, uint8_t cls)
+{
+  fusain_tx_slot_t* slot = sched->free_list;
+  if (slot != NULL) {
+    sched->free_list = slot->next;
+    return slot;
+  }
+  for (uint8_t lower = FUSAIN_TX_CLASSES - 1; lower > cls; lower--) {
+    if (sched->heads[lower] != NULL) {
+      sched->stats[lower].dropped++;
+      return queue_pop(sched, lower);
+    }
+  }
+  return NULL;
+}
+
+static bool tx_ready(const fusain_tx_scheduler_t* sched)
+{
+  for (uint8_t cls = 0; cls < FUSAIN_TX_CLASSES; cls++) {
+    if (class_ready(sched, cls)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Class to serve at a frame boundary (some class is ready) */
+static uint8_t class_next(fusain_tx_scheduler_t* sched)
+{
+  if (class_ready(sched, FUSAIN_TX_SAFETY) || sched->weights[WEIGHTED_FIRST] == 0) {
+    uint8_t cls = 0;
+    while (!class_ready(sched, cls)) {
+      cls++;
+    }
+    return cls;
+  }
+
+  /* Deficit round robin: each visit adds the class's weight in bytes */
+  for (;;) {
+    uint8_t cls = sched->turn;
+    const fusain_tx_slot_t* head = class_ready(sched, cls) ? sched->heads[cls] : NULL;
+    if (head != NULL && !sched->granted) {
+      sched->deficits[cls] += sched->weights[cls];
+      sched->granted = true;
+    }
+    if (head != NULL && sched->deficits[cls] >= head->length) {
+      sched->deficits[cls] -= head->length;
+      return cls;
+    }
+    if (sched->heads[cls] == NULL) {
+      sched->deficits[cls] = 0; /* An idle class saves up no credit */
+    }
+    sched->turn = cls + 1 < FUSAIN_TX_CLASSES ? cls + 1 : WEIGHTED_FIRST;
+    sched->granted = false;
+  }
+}
+
+int fusain_tx_init(fusain_tx_scheduler_t* sched, fusain_tx_slot_t* slots,
+    uint32_t count, const uint16_t weights[FUSAIN_TX_CLASSES])
+{
+  if (sched == NULL || slots == NULL) {
+    return -1;
+  }
+  memset(sched, 0, sizeof(*sched));
+  if (weights != NULL) {
+    for (uint8_t cls = WEIGHTED_FIRST; cls < FUSAIN_TX_CLASSES; cls++) {
+      if (weights[cls] == 0) {
+        return -1;
+      }
+      sched->weights[cls] = weights[cls];
+    }
+  }
+
+  sched->turn = WEIGHTED_FIRST;
+  for (uint32_t i = count; i-- > 0;) {
+    slots[i].next = sched->free_list;
+    sched->free_list = &slots[i];
+  }
+  return 0;
+}
+
+int fusain_tx_enqueue(fusain_tx_scheduler_t* sched, const fusain_packet_t* packet,
+    uint64_t now_us)
+{
+  /* Checked first so that a bad packet never evicts anything */
+  if (packet->length > FUSAIN_MAX_PAYLOAD_SIZE) {
+    return -1;
+  }
+
+  fusain_tx_class_t cls = fusain_tx_class_of(packet);
+  uint8_t index = 0;
+  bool latest = cls == FUSAIN_TX_TELEMETRY && latest_key(packet, &index);
+  if (latest) {
+    fusain_tx_slot_t* queued = latest_find(sched, packet, index);
+    if (queued != NULL) {
+      queued->length = (uint16_t)fusain_encode_packet(packet, queued->data,
+          sizeof(queued->data));
+      sched->stats[cls].coalesced++;
+      return (int)cls;
+    }
+  }
+
+  fusain_tx_slot_t* slot = slot_take(sched, (uint8_t)cls);
+  if (slot == NULL) {
+    sched->stats[cls].dropped++;
+    return -2;
+  }
+
+  /* Cannot fail: the payload length is valid and the slot holds any frame */
+  slot->length = (uint16_t)fusain_encode_packet(packet, slot->data, sizeof(slot->data));
+  slot->queued_us = now_us;
+  slot->address = packet->address;
+  slot->msg_type = packet->msg_type;
+  slot->index = index;
+  slot->latest = latest;
+  queue_push(sched, (uint8_t)cls, slot);
+  return (int)cls;
+}
+
+size_t fusain_tx_pull(fusain_tx_scheduler_t* sched, uint8_t* buffer, size_t size,
+    uint64_t now_us)
+{
+  size_t written = 0;
+
+  tokens_refill(sched, now_us);
+  while (written < size) {
+    if (sched->current == NULL) {
+      if (!tx_ready(sched)) {
+        break;
+      }
+      uint8_t cls = class_next(sched);
+      sched->current = queue_pop(sched, cls);
+      sched->offset = 0;
+      if (cls == FUSAIN_TX_TELEMETRY && sched->rate != 0) {
+        sched->tokens -= sched->current->length * TOKENS_PER_BYTE;
+      }
+
+      fusain_tx_stats_t* stats = &sched->stats[cls];
+      uint64_t waited = now_us - sched->current->queued_us;
+      uint32_t latency = waited > UINT32_MAX ? UINT32_MAX : (uint32_t)waited;
+      stats->sent++;
+      stats->latency_total_us += latency;
+      if (latency > stats->latency_max_us) {
+        stats->latency_max_us = latency;
+      }
+    }
+
+    fusain_tx_slot_t* slot = sched->current;
+    size_t chunk = slot->length - sched->offset;
+    if (chunk > size - written) {
+      chunk = size - written;
+    }
+    memcpy(&buffer[written], &slot->data[sched->offset], chunk);
+    written += chunk;
+    sched->offset += (uint16_t)chunk;
+    if (sched->offset == slot->length) {
+      slot->next = sched->free_list;
+      sched->free_list = slot;
+      sched->current = NULL;
+    }
+  }
+  return written;
+}
+
+void fusain_tx_set_rate(fusain_tx_scheduler_t* sched, uint32_t bytes_per_second,
+    uint32_t burst, uint64_t now_us)
+{
+  if (burst < FUSAIN_MAX_STUFFED_PACKET_SIZE) {
+    burst = FUSAIN_MAX_STUFFED_PACKET_SIZE;
+  }
+  sched->rate = bytes_per_second;
+  sched->burst = burst * TOKENS_PER_BYTE;
+  sched->tokens = sched->burst;
+  sched->tokens_us = now_us;
+}
+
+uint64_t fusain_tx_wake(fusain_tx_scheduler_t* sched, uint64_t now_us)
+{
+  tokens_refill(sched, now_us);
+  if (sched->current != NULL || tx_ready(sched)) {
+    return now_us;
+  }
+
+  const fusain_tx_slot_t* head = sched->heads[FUSAIN_TX_TELEMETRY];
+  if (head == NULL) {
+    return UINT64_MAX;
+  }
+  /* Only telemetry is queued, waiting for tokens */
+  uint64_t missing = head->length * TOKENS_PER_BYTE - sched->tokens;
+  return now_us + (missing + sched->rate - 1) / sched->rate;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark Harness
+ *
+ * Minimal registration and timing helpers for host-side benchmarks.
+ * Benchmarks register themselves via constructor attributes (same approach
+ * as the standalone ztest compatibility layer) and run sequentially.
+ */
+
+#ifndef FUSAIN_BENCH_H_
+#define FUSAIN_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*bench_func_t)(void);
+
+struct bench_entry {
+  const char* name;
+  bench_func_t func;
+};
+
+/* Maximum number of benchmarks */
+#define BENCH_MAX 64
+
+extern struct bench_entry __bench_registry[];
+extern int __bench_count;
+
+/* Helper to set entry fields (avoids macro parameter name collision) */
+static inline void __bench_set_entry(
+    struct bench_entry* entry, const char* n, bench_func_t f)
+{
+  entry->name = n;
+  entry->func = f;
+}
+
+/* Register a benchmark function */
+#define BENCH(name)                                                           \
+  static void bench_##name(void);                                            \
+  __attribute__((constructor)) static void __register_bench_##name(void)     \
+  {                                                                           \
+    if (__bench_count < BENCH_MAX) {                                          \
+      __bench_set_entry(&__bench_registry[__bench_count], #name, bench_##name); \
+      __bench_count++;                                                        \
+    }                                                                         \
+  }                                                                           \
+  static void bench_##name(void)
+
+/* Scale a base iteration count by FUSAIN_BENCH_SCALE */
+#define BENCH_ITERATIONS(base) ((size_t)(base) * (size_t)FUSAIN_BENCH_SCALE)
+
+/* Monotonic time in nanoseconds */
+uint64_t bench_now_ns(void);
+
+/**
+ * Print one result line
+ *
+ * @param label Case label
+ * @param elapsed_ns Elapsed wall time
+ * @param ops Operations performed (frames, CRCs, lookups, ...)
+ * @param bytes Bytes processed (0 to omit throughput)
+ */
+void bench_report(const char* label, uint64_t elapsed_ns, size_t ops,
+    size_t bytes);
+
+/* Sink to keep results observable so the optimizer cannot drop work */
+extern volatile uint32_t bench_sink;
+
+#endif /* FUSAIN_BENCH_H_ */
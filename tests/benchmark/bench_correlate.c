@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - correlation cost as the in-flight table grows
+ */
+
+#include <stdio.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define CORRELATE_MAX_SLOTS 65536
+
+static fusain_correlation_t correlate_slots[CORRELATE_MAX_SLOTS];
+
+static void correlate_count(fusain_correlate_event_t event,
+    const fusain_correlation_t* entry, const fusain_packet_t* response)
+{
+  (void)entry;
+  (void)response;
+  bench_sink += (uint32_t)event + 1;
+}
+
+static uint64_t correlate_address(uint32_t i)
+{
+  return 0x0100000000000000ULL + (uint64_t)i * 0x10001ULL;
+}
+
+BENCH(correlate)
+{
+  static const uint32_t sizes[] = { 256, 4096, CORRELATE_MAX_SLOTS };
+  fusain_correlator_t correlator;
+  fusain_packet_t request;
+  fusain_packet_t response;
+  char label[64];
+
+  fusain_create_ping_request(&request, 0);
+  fusain_create_ping_response(&response, 0, 0);
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    uint32_t size = sizes[s];
+    size_t rounds = BENCH_ITERATIONS(4000000) / size;
+    uint64_t now = 0;
+
+    fusain_correlator_init(&correlator, correlate_slots, size, 1000, 1, correlate_count);
+
+    /* Keep the table full: each step answers one request and sends it again */
+    for (uint32_t i = 0; i < size; i++) {
+      request.address = correlate_address(i);
+      fusain_correlator_track(&correlator, &request, NULL, now);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < rounds; r++) {
+      for (uint32_t i = 0; i < size; i++) {
+        response.address = correlate_address(i);
+        fusain_correlator_match(&correlator, &response);
+        request.address = response.address;
+        fusain_correlator_track(&correlator, &request, NULL, now);
+      }
+    }
+    uint64_t match_ns = bench_now_ns() - start;
+
+    /* Expire the whole table twice (retry, then timeout) */
+    start = bench_now_ns();
+    fusain_correlator_poll(&correlator, now + 1000);
+    fusain_correlator_poll(&correlator, now + 2000);
+    uint64_t expire_ns = bench_now_ns() - start;
+
+    snprintf(label, sizeof(label), "match + track (%u in flight)", size);
+    bench_report(label, match_ns, rounds * size, 0);
+    snprintf(label, sizeof(label), "expire (%u in flight)", size);
+    bench_report(label, expire_ns, (size_t)size * 2, 0);
+  }
+}
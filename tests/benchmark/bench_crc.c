@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - CRC-16-CCITT single vs batched
+ */
+
+#include <stdio.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define CRC_SPAN_COUNT 1024
+#define CRC_SPAN_LENGTH 123 /* LENGTH + ADDRESS(8) + max CBOR payload */
+
+static uint8_t crc_data[CRC_SPAN_COUNT][CRC_SPAN_LENGTH];
+static fusain_span_t crc_spans[CRC_SPAN_COUNT];
+static uint16_t crc_out[CRC_SPAN_COUNT];
+
+static void crc_setup(size_t length)
+{
+  uint32_t x = 0x12345678;
+  for (size_t s = 0; s < CRC_SPAN_COUNT; s++) {
+    for (size_t i = 0; i < CRC_SPAN_LENGTH; i++) {
+      x = x * 1103515245 + 12345;
+      crc_data[s][i] = (uint8_t)(x >> 16);
+    }
+    crc_spans[s].data = crc_data[s];
+    crc_spans[s].length = length;
+  }
+}
+
+static void crc_run(size_t length)
+{
+  char label[64];
+  size_t rounds = BENCH_ITERATIONS(200);
+  size_t ops = rounds * CRC_SPAN_COUNT;
+  size_t bytes = ops * length;
+
+  crc_setup(length);
+
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t s = 0; s < CRC_SPAN_COUNT; s++) {
+      crc_out[s] = fusain_crc16(crc_spans[s].data, crc_spans[s].length);
+    }
+    bench_sink += crc_out[r % CRC_SPAN_COUNT];
+  }
+  uint64_t single_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    fusain_crc16_batch(crc_spans, CRC_SPAN_COUNT, crc_out);
+    bench_sink += crc_out[r % CRC_SPAN_COUNT];
+  }
+  uint64_t batch_ns = bench_now_ns() - start;
+
+  snprintf(label, sizeof(label), "fusain_crc16 (%zu B)", length);
+  bench_report(label, single_ns, ops, bytes);
+  snprintf(label, sizeof(label), "fusain_crc16_batch (%zu B)", length);
+  bench_report(label, batch_ns, ops, bytes);
+}
+
+BENCH(crc16)
+{
+  crc_run(14);
+  crc_run(64);
+  crc_run(CRC_SPAN_LENGTH);
+}
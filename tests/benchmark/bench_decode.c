@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - byte-wise decoder vs in-place frame extraction
+ */
+
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define DECODE_FRAME_COUNT 64
+
+static uint8_t decode_stream[DECODE_FRAME_COUNT * FUSAIN_MAX_STUFFED_PACKET_SIZE];
+static uint8_t decode_chunk[sizeof(decode_stream)];
+static size_t decode_stream_len;
+
+static void decode_setup(void)
+{
+  decode_stream_len = 0;
+  for (int i = 0; i < DECODE_FRAME_COUNT; i++) {
+    fusain_packet_t packet;
+    fusain_create_motor_data(&packet, 0x1234 + i, 0, 1000 + i, 2500, 2600);
+    int len = fusain_encode_packet(&packet, &decode_stream[decode_stream_len],
+        sizeof(decode_stream) - decode_stream_len);
+    if (len > 0) {
+      decode_stream_len += (size_t)len;
+    }
+  }
+}
+
+BENCH(decode)
+{
+  decode_setup();
+
+  size_t rounds = BENCH_ITERATIONS(2000);
+  size_t ops = rounds * DECODE_FRAME_COUNT;
+  size_t bytes = rounds * decode_stream_len;
+
+  fusain_decoder_t decoder;
+  fusain_packet_t packet;
+  fusain_reset_decoder(&decoder);
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < decode_stream_len; i++) {
+      if (fusain_decode_byte(decode_stream[i], &packet, &decoder)
+          == FUSAIN_DECODE_OK) {
+        bench_sink += packet.msg_type;
+      }
+    }
+  }
+  uint64_t byte_ns = bench_now_ns() - start;
+
+  /* Extraction unstuffs in place, so each round works on a fresh copy */
+  fusain_extractor_t extractor;
+  fusain_frame_view_t view;
+  fusain_reset_extractor(&extractor);
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    memcpy(decode_chunk, decode_stream, decode_stream_len);
+    size_t offset = 0;
+    while (offset < decode_stream_len) {
+      size_t consumed = 0;
+      if (fusain_extract_frame(&extractor, &decode_chunk[offset],
+              decode_stream_len - offset, &view, &consumed)
+          == FUSAIN_DECODE_OK) {
+        bench_sink += view.msg_type;
+      }
+      offset += consumed;
+    }
+  }
+  uint64_t extract_ns = bench_now_ns() - start;
+
+  bench_report("fusain_decode_byte (per frame)", byte_ns, ops, bytes);
+  bench_report("fusain_extract_frame (per frame)", extract_ns, ops, bytes);
+}
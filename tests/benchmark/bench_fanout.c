@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - per-address encoding vs frame retargeting, and
+ * per-subscriber encoding vs one shared frame for DATA_SUBSCRIPTION
+ */
+
+#include <stdio.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define FANOUT_DEVICES 500
+
+static uint8_t fanout_out[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+static uint64_t fanout_address(size_t i)
+{
+  return 0x0100000000000000ULL + i * 0x10001ULL;
+}
+
+static void fanout_run(const char* name, const fusain_packet_t* command)
+{
+  char label[64];
+  size_t rounds = BENCH_ITERATIONS(200);
+  size_t ops = rounds * FANOUT_DEVICES;
+
+  /* Baseline: rebuild and encode the packet for every device */
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < FANOUT_DEVICES; i++) {
+      fusain_packet_t packet;
+      if (command->msg_type == FUSAIN_MSG_STATE_COMMAND) {
+        fusain_create_state_command(&packet, fanout_address(i), FUSAIN_MODE_HEAT, 3);
+      } else {
+        fusain_create_telemetry_config(&packet, fanout_address(i), true, 250);
+      }
+      bench_sink += (uint32_t)fusain_encode_packet(&packet, fanout_out, sizeof(fanout_out));
+    }
+  }
+  uint64_t create_ns = bench_now_ns() - start;
+
+  /* Encode only (packet already built, address patched in the struct) */
+  fusain_packet_t packet = *command;
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < FANOUT_DEVICES; i++) {
+      packet.address = fanout_address(i);
+      bench_sink += (uint32_t)fusain_encode_packet(&packet, fanout_out, sizeof(fanout_out));
+    }
+  }
+  uint64_t encode_ns = bench_now_ns() - start;
+
+  /* Retarget one encoded template */
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  int frame_len = fusain_encode_packet(command, frame, sizeof(frame));
+  fusain_retarget_t retarget;
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    fusain_retarget_init(&retarget, frame, (size_t)frame_len);
+    for (size_t i = 0; i < FANOUT_DEVICES; i++) {
+      bench_sink += (uint32_t)fusain_retarget_frame(&retarget, fanout_address(i),
+          fanout_out, sizeof(fanout_out));
+    }
+  }
+  uint64_t retarget_ns = bench_now_ns() - start;
+
+  snprintf(label, sizeof(label), "create + encode (%s)", name);
+  bench_report(label, create_ns, ops, 0);
+  snprintf(label, sizeof(label), "encode (%s)", name);
+  bench_report(label, encode_ns, ops, 0);
+  snprintf(label, sizeof(label), "retarget (%s)", name);
+  bench_report(label, retarget_ns, ops, 0);
+}
+
+BENCH(fanout)
+{
+  fusain_packet_t command;
+  fusain_create_state_command(&command, 0, FUSAIN_MODE_HEAT, 3);
+  fanout_run("STATE_COMMAND", &command);
+  fusain_create_telemetry_config(&command, 0, true, 250);
+  fanout_run("TELEMETRY_CONFIG", &command);
+}
+
+#define SUBSCRIBERS 300
+
+static fusain_subscriber_t subscribers[SUBSCRIBERS];
+static fusain_subscription_t subscriptions[SUBSCRIBERS];
+static fusain_fanout_topic_t topics[16];
+static fusain_frame_t frames[4];
+
+/* A TX queue that sends at once */
+static int subscriber_send(fusain_subscriber_t* subscriber, fusain_frame_t* frame)
+{
+  (void)subscriber;
+  bench_sink += frame->length;
+  fusain_frame_unref(frame);
+  return 0;
+}
+
+BENCH(subscription)
+{
+  fusain_frame_pool_t pool;
+  fusain_fanout_t fanout;
+  fusain_packet_t packet;
+  size_t rounds = BENCH_ITERATIONS(2000);
+  size_t ops = rounds * SUBSCRIBERS;
+
+  fusain_frame_pool_init(&pool, frames, 4);
+  fusain_fanout_init(&fanout, &pool, topics, 16, subscriptions, SUBSCRIBERS, subscriber_send);
+  for (size_t i = 0; i < SUBSCRIBERS; i++) {
+    fusain_fanout_subscribe(&fanout, &subscribers[i], fanout_address(0), NULL);
+  }
+  fusain_create_temp_data(&packet, fanout_address(0), 0, 1000, 21.5f);
+
+  /* Baseline: every subscriber's queue gets its own encoding */
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < SUBSCRIBERS; i++) {
+      bench_sink += (uint32_t)fusain_encode_packet(&packet, fanout_out, sizeof(fanout_out));
+    }
+  }
+  uint64_t encode_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    bench_sink += (uint32_t)fusain_fanout_publish(&fanout, &packet);
+  }
+  uint64_t shared_ns = bench_now_ns() - start;
+
+  /* A dashboard leaving and coming back, with 300 on the same appliance */
+  size_t churn = BENCH_ITERATIONS(100000);
+  start = bench_now_ns();
+  for (size_t i = 0; i < churn; i++) {
+    fusain_subscriber_t* subscriber = &subscribers[i % SUBSCRIBERS];
+    fusain_fanout_drop(&fanout, subscriber);
+    fusain_fanout_subscribe(&fanout, subscriber, fanout_address(0), NULL);
+  }
+  uint64_t churn_ns = bench_now_ns() - start;
+
+  printf("  TEMP_DATA to %d subscribers of one appliance\n", SUBSCRIBERS);
+  bench_report("encode per subscriber", encode_ns, ops, 0);
+  bench_report("encode once, shared frame", shared_ns, ops, 0);
+  bench_report("drop + resubscribe", churn_ns, churn, 0);
+}
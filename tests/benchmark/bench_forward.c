@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - store-and-forward vs cut-through bridging
+ *
+ * A bridge between two UART segments receives telemetry in 64-byte DMA
+ * chunks. Store-and-forward decodes each frame and re-encodes it before
+ * writing anything; cut-through passes the stuffed bytes on as they come.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define FORWARD_FRAMES 64
+#define FORWARD_CHUNK 64
+
+static uint8_t forward_stream[FORWARD_FRAMES * FUSAIN_MAX_STUFFED_PACKET_SIZE];
+static uint8_t forward_out[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+static size_t forward_first_out; /* Input bytes consumed when output began */
+static size_t forward_fed;
+
+static void forward_emit(void* user, uint8_t link, const uint8_t* data, size_t length)
+{
+  (void)user;
+  (void)link;
+  if (forward_first_out == 0) {
+    forward_first_out = forward_fed;
+  }
+  bench_sink += data[length - 1];
+}
+
+static size_t forward_build(void)
+{
+  fusain_packet_t packet;
+  size_t length = 0;
+
+  for (size_t i = 0; i < FORWARD_FRAMES; i++) {
+    uint64_t address = 0x0100000000000000ULL + i * 0x10001ULL;
+    switch (i % 3) {
+    case 0:
+      fusain_create_temp_data(&packet, address, 0, 1000 + (uint32_t)i, 21.5f);
+      break;
+    case 1:
+      fusain_create_state_data(&packet, address, 0, FUSAIN_ERROR_NONE, FUSAIN_STATE_HEATING,
+          1000 + (uint32_t)i);
+      break;
+    default:
+      fusain_create_motor_data(&packet, address, 0, 1000 + (uint32_t)i, 3200, 3300);
+      break;
+    }
+    length += (size_t)fusain_encode_packet(&packet, &forward_stream[length],
+        sizeof(forward_stream) - length);
+  }
+  return length;
+}
+
+BENCH(forward)
+{
+  static fusain_route_bucket_t buckets[64];
+  fusain_route_t routes;
+  fusain_forwarder_t fwd;
+  fusain_decoder_t decoder;
+  fusain_packet_t packet;
+  size_t length = forward_build();
+  size_t rounds = BENCH_ITERATIONS(2000);
+  size_t ops = rounds * FORWARD_FRAMES;
+
+  /* Baseline: unstuff, check, then re-stuff the whole frame */
+  fusain_reset_decoder(&decoder);
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < length; i++) {
+      if (fusain_decode_byte(forward_stream[i], &packet, &decoder) == FUSAIN_DECODE_OK) {
+        int n = fusain_encode_packet(&packet, forward_out, sizeof(forward_out));
+        bench_sink += forward_out[n - 1];
+      }
+    }
+  }
+  uint64_t store_ns = bench_now_ns() - start;
+
+  fusain_route_init(&routes, buckets, NULL, 64);
+  fusain_forward_init(&fwd, &routes, 2, forward_emit, NULL);
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t at = 0; at < length; at += FORWARD_CHUNK) {
+      size_t n = length - at < FORWARD_CHUNK ? length - at : FORWARD_CHUNK;
+      bench_sink += (uint32_t)fusain_forward_feed(&fwd, 0, &forward_stream[at], n);
+    }
+  }
+  uint64_t cut_ns = bench_now_ns() - start;
+
+  /* Latency: input bytes received before the first output byte, one frame */
+  size_t frame_length = (size_t)fusain_encode_packet(&packet, forward_out, sizeof(forward_out));
+  forward_first_out = 0;
+  for (forward_fed = 1; forward_fed <= frame_length; forward_fed++) {
+    fusain_forward_feed(&fwd, 0, &forward_out[forward_fed - 1], 1);
+  }
+
+  printf("  %d telemetry frames, %zu bytes, fed in %d-byte chunks\n", FORWARD_FRAMES, length,
+      FORWARD_CHUNK);
+  bench_report("store-and-forward (decode + encode)", store_ns, ops, rounds * length);
+  bench_report("cut-through", cut_ns, ops, rounds * length);
+  printf("  first byte out after %zu of %zu bytes (store-and-forward: after all %zu)\n",
+      forward_first_out, frame_length, frame_length);
+}
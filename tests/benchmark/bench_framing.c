@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - byte stuffing vs COBS vs raw framing
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define FRAMING_FRAME_COUNT 64
+
+static fusain_packet_t framing_packets[FRAMING_FRAME_COUNT];
+static uint8_t stuffed_stream[FRAMING_FRAME_COUNT * FUSAIN_MAX_STUFFED_PACKET_SIZE];
+static uint8_t cobs_stream[FRAMING_FRAME_COUNT * FUSAIN_MAX_COBS_PACKET_SIZE];
+static uint8_t raw_stream[FRAMING_FRAME_COUNT * FUSAIN_MAX_RAW_PACKET_SIZE];
+static size_t stuffed_len;
+static size_t cobs_len;
+static size_t raw_len;
+
+/* Typical telemetry, or payloads where every other byte must be escaped */
+static void framing_setup(bool escape_heavy)
+{
+  for (int i = 0; i < FRAMING_FRAME_COUNT; i++) {
+    fusain_packet_t* packet = &framing_packets[i];
+    fusain_create_motor_data(packet, 0x1234 + i, 0, 1000 + i, 2500, 2600);
+    if (escape_heavy) {
+      packet->length = FUSAIN_MAX_PAYLOAD_SIZE;
+      for (int j = 3; j < FUSAIN_MAX_PAYLOAD_SIZE; j++) {
+        packet->payload[j] = (j & 1) ? FUSAIN_START_BYTE : (uint8_t)j;
+      }
+    }
+  }
+}
+
+enum { FRAMING_STUFFED, FRAMING_COBS, FRAMING_RAW };
+
+static size_t encode_stream(int framing, uint8_t* out, size_t size)
+{
+  size_t len = 0;
+  for (int i = 0; i < FRAMING_FRAME_COUNT; i++) {
+    const fusain_packet_t* packet = &framing_packets[i];
+    int n = framing == FRAMING_COBS ? fusain_encode_packet_cobs(packet, &out[len], size - len)
+        : framing == FRAMING_RAW    ? fusain_encode_packet_raw(packet, false, &out[len], size - len)
+                                    : fusain_encode_packet(packet, &out[len], size - len);
+    if (n > 0) {
+      len += (size_t)n;
+    }
+  }
+  return len;
+}
+
+static void framing_run(const char* name, bool escape_heavy)
+{
+  char label[64];
+  size_t rounds = BENCH_ITERATIONS(2000);
+  size_t ops = rounds * FRAMING_FRAME_COUNT;
+
+  framing_setup(escape_heavy);
+  stuffed_len = encode_stream(FRAMING_STUFFED, stuffed_stream, sizeof(stuffed_stream));
+  cobs_len = encode_stream(FRAMING_COBS, cobs_stream, sizeof(cobs_stream));
+  raw_len = encode_stream(FRAMING_RAW, raw_stream, sizeof(raw_stream));
+  printf("  %s: %zu B/frame stuffed, %zu B/frame COBS, %zu B/frame raw\n", name,
+      stuffed_len / FRAMING_FRAME_COUNT, cobs_len / FRAMING_FRAME_COUNT,
+      raw_len / FRAMING_FRAME_COUNT);
+
+  /* Encoding */
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    bench_sink += (uint32_t)encode_stream(FRAMING_STUFFED, stuffed_stream, sizeof(stuffed_stream));
+  }
+  uint64_t stuffed_enc_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    bench_sink += (uint32_t)encode_stream(FRAMING_COBS, cobs_stream, sizeof(cobs_stream));
+  }
+  uint64_t cobs_enc_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    bench_sink += (uint32_t)encode_stream(FRAMING_RAW, raw_stream, sizeof(raw_stream));
+  }
+  uint64_t raw_enc_ns = bench_now_ns() - start;
+
+  /* Byte-wise decoding in each framing */
+  fusain_decoder_t decoder;
+  fusain_packet_t packet;
+  fusain_reset_decoder(&decoder);
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < stuffed_len; i++) {
+      if (fusain_decode_byte(stuffed_stream[i], &packet, &decoder) == FUSAIN_DECODE_OK) {
+        bench_sink += packet.msg_type;
+      }
+    }
+  }
+  uint64_t stuffed_dec_ns = bench_now_ns() - start;
+
+  fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_COBS);
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < cobs_len; i++) {
+      if (fusain_decode_byte(cobs_stream[i], &packet, &decoder) == FUSAIN_DECODE_OK) {
+        bench_sink += packet.msg_type;
+      }
+    }
+  }
+  uint64_t cobs_dec_ns = bench_now_ns() - start;
+
+  /* Bulk COBS decoding, splitting the stream at delimiters with memchr */
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    const uint8_t* p = cobs_stream;
+    const uint8_t* end = cobs_stream + cobs_len;
+    while (p < end) {
+      const uint8_t* zero = memchr(p, FUSAIN_COBS_DELIMITER, (size_t)(end - p));
+      if (fusain_decode_cobs_frame(p, (size_t)(zero - p), &packet) == FUSAIN_DECODE_OK) {
+        bench_sink += packet.msg_type;
+      }
+      p = zero + 1;
+    }
+  }
+  uint64_t cobs_bulk_ns = bench_now_ns() - start;
+
+  /* Raw framing, no CRC (reliable transport) */
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    size_t offset = 0;
+    size_t consumed = 0;
+    while (fusain_decode_packet_raw(&raw_stream[offset], raw_len - offset, false,
+               &packet, &consumed)
+        == FUSAIN_DECODE_OK) {
+      bench_sink += packet.msg_type;
+      offset += consumed;
+    }
+  }
+  uint64_t raw_dec_ns = bench_now_ns() - start;
+
+  snprintf(label, sizeof(label), "encode stuffed (%s)", name);
+  bench_report(label, stuffed_enc_ns, ops, rounds * stuffed_len);
+  snprintf(label, sizeof(label), "encode COBS (%s)", name);
+  bench_report(label, cobs_enc_ns, ops, rounds * cobs_len);
+  snprintf(label, sizeof(label), "encode raw (%s)", name);
+  bench_report(label, raw_enc_ns, ops, rounds * raw_len);
+  snprintf(label, sizeof(label), "decode_byte stuffed (%s)", name);
+  bench_report(label, stuffed_dec_ns, ops, rounds * stuffed_len);
+  snprintf(label, sizeof(label), "decode_byte COBS (%s)", name);
+  bench_report(label, cobs_dec_ns, ops, rounds * cobs_len);
+  snprintf(label, sizeof(label), "decode_cobs_frame (%s)", name);
+  bench_report(label, cobs_bulk_ns, ops, rounds * cobs_len);
+  snprintf(label, sizeof(label), "decode_packet_raw (%s)", name);
+  bench_report(label, raw_dec_ns, ops, rounds * raw_len);
+}
+
+BENCH(framing)
+{
+  framing_run("telemetry", false);
+  framing_run("escape-heavy", true);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - full zcbor decode vs single-field peek
+ */
+
+#include <fusain/fusain.h>
+#include <fusain/generated/cbor_decode.h>
+
+#include "bench.h"
+
+BENCH(peek)
+{
+  size_t ops = BENCH_ITERATIONS(1000000);
+  fusain_packet_t packet;
+  fusain_create_motor_data(&packet, 0x1234, 0, 123456, 2500, 2600);
+
+  /* Full decode of the payload map after the 3-byte [msg_type] header */
+  uint64_t start = bench_now_ns();
+  for (size_t n = 0; n < ops; n++) {
+    struct motor_data_payload decoded;
+    size_t consumed = 0;
+    if (cbor_decode_motor_data_payload(packet.payload + 3, packet.length - 3,
+            &decoded, &consumed)
+        == 0) {
+      bench_sink += (uint64_t)decoded.motor_data_payload_uint2int;
+    }
+  }
+  uint64_t decode_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t n = 0; n < ops; n++) {
+    int64_t rpm;
+    if (fusain_peek_int(&packet, 2, &rpm) == 0) {
+      bench_sink += (uint64_t)rpm;
+    }
+  }
+  uint64_t peek_ns = bench_now_ns() - start;
+
+  bench_report("cbor_decode_motor_data_payload", decode_ns, ops, 0);
+  bench_report("fusain_peek_int (rpm)", peek_ns, ops, 0);
+}
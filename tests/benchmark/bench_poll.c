@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - polling throughput on a simulated half-duplex bus
+ *
+ * Appliances answer SEND_TELEMETRY after their own turnaround plus jitter.
+ * Time is virtual; any two transmissions that overlap are both lost. The
+ * naive controller sends one request and waits for the answer (or a fixed
+ * timeout). The scheduler runs with one request in flight and pipelined.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define SIM_BAUD 115200
+#define SIM_APPLIANCES 16
+#define SIM_DURATION_US 60000000ULL
+#define SIM_NAIVE_TIMEOUT_US 20000
+#define SIM_MAX_PENDING 16
+#define SIM_MAX_REQUESTS 16
+
+typedef struct {
+  uint64_t address;
+  uint32_t turnaround_us;
+  uint32_t jitter_us;
+} sim_appliance_t;
+
+typedef struct {
+  uint64_t start;
+  uint64_t end;
+  uint64_t address;
+  bool lost;
+} sim_tx_t;
+
+static sim_appliance_t sim_appliances[SIM_APPLIANCES];
+static uint32_t sim_rng;
+
+static uint32_t sim_random(void)
+{
+  sim_rng = sim_rng * 1103515245U + 12345U;
+  return sim_rng >> 8;
+}
+
+static uint32_t sim_airtime_us(size_t bytes)
+{
+  return (uint32_t)((uint64_t)bytes * 10U * 1000000U / SIM_BAUD);
+}
+
+static void sim_setup(void)
+{
+  sim_rng = 1;
+  for (size_t i = 0; i < SIM_APPLIANCES; i++) {
+    sim_appliances[i].address = 0x0100000000000000ULL + i;
+    /* Main-loop latencies between 1 and 16 ms */
+    sim_appliances[i].turnaround_us = 1000 + (uint32_t)i * 1000;
+    sim_appliances[i].jitter_us = 300;
+  }
+}
+
+static size_t sim_find(uint64_t address)
+{
+  for (size_t i = 0; i < SIM_APPLIANCES; i++) {
+    if (sim_appliances[i].address == address) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+static size_t sim_frame_bytes(const fusain_packet_t* packet)
+{
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  return (size_t)fusain_encode_packet(packet, frame, sizeof(frame));
+}
+
+static void sim_telemetry(fusain_packet_t* packet, uint64_t address, uint64_t now)
+{
+  fusain_create_state_data(packet, address, 0, 0, FUSAIN_STATE_HEATING,
+      (uint32_t)(now / 1000));
+}
+
+static uint64_t sim_naive(void)
+{
+  fusain_packet_t request;
+  fusain_packet_t response;
+  uint64_t now = 0;
+  uint64_t answered = 0;
+
+  sim_setup();
+  for (size_t i = 0; now < SIM_DURATION_US; i = (i + 1) % SIM_APPLIANCES) {
+    const sim_appliance_t* appliance = &sim_appliances[i];
+    fusain_create_send_telemetry(&request, appliance->address, 0, 0xFFFFFFFF);
+    now += sim_airtime_us(sim_frame_bytes(&request));
+
+    uint64_t start = now + appliance->turnaround_us + sim_random() % appliance->jitter_us;
+    sim_telemetry(&response, appliance->address, start);
+    uint64_t end = start + sim_airtime_us(sim_frame_bytes(&response));
+    if (end - now <= SIM_NAIVE_TIMEOUT_US) {
+      now = end + 100;
+      answered++;
+    } else {
+      now += SIM_NAIVE_TIMEOUT_US;
+    }
+  }
+  return answered;
+}
+
+static uint64_t sim_scheduled(uint8_t max_in_flight, uint64_t* collisions,
+    uint64_t* decisions)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_poll_config_t config = {
+    .baud_rate = SIM_BAUD,
+    .max_in_flight = max_in_flight,
+    .guard_us = 100,
+    .initial_turnaround_us = 5000,
+    .min_timeout_us = 2000,
+    .max_timeout_us = SIM_NAIVE_TIMEOUT_US,
+  };
+  sim_tx_t pending[SIM_MAX_PENDING];
+  sim_tx_t requests[SIM_MAX_REQUESTS];
+  size_t pending_count = 0;
+  size_t request_head = 0;
+  fusain_packet_t request;
+  fusain_packet_t response;
+  uint64_t now = 0;
+  uint64_t answered = 0;
+
+  sim_setup();
+  memset(requests, 0, sizeof(requests));
+  *collisions = 0;
+  *decisions = 0;
+  fusain_poll_init(&scheduler, &config);
+  for (size_t i = 0; i < SIM_APPLIANCES; i++) {
+    /* Period 1 us: poll every appliance as often as the bus allows */
+    fusain_poll_add(&scheduler, sim_appliances[i].address, 0, 1, 0);
+  }
+
+  while (now < SIM_DURATION_US) {
+    uint64_t wake;
+    (*decisions)++;
+    if (fusain_poll_next(&scheduler, now, &request, &wake)) {
+      sim_tx_t* tx = &requests[request_head++ % SIM_MAX_REQUESTS];
+      tx->start = now;
+      tx->end = now + sim_airtime_us(sim_frame_bytes(&request));
+      tx->address = request.address;
+      tx->lost = false;
+      for (size_t i = 0; i < pending_count; i++) {
+        if (tx->start < pending[i].end && pending[i].start < tx->end) {
+          tx->lost = pending[i].lost = true;
+        }
+      }
+
+      /* The addressed appliance answers only an intact request */
+      if (!tx->lost && pending_count < SIM_MAX_PENDING) {
+        const sim_appliance_t* appliance = &sim_appliances[sim_find(tx->address)];
+        sim_tx_t* rx = &pending[pending_count++];
+        rx->start = tx->end + appliance->turnaround_us + sim_random() % appliance->jitter_us;
+        sim_telemetry(&response, tx->address, rx->start);
+        rx->end = rx->start + sim_airtime_us(sim_frame_bytes(&response));
+        rx->address = tx->address;
+        rx->lost = false;
+        for (size_t i = 0; i + 1 < pending_count; i++) {
+          if (rx->start < pending[i].end && pending[i].start < rx->end) {
+            rx->lost = pending[i].lost = true;
+          }
+        }
+      }
+      continue;
+    }
+
+    /* Advance to the earlier of the scheduler wake and the next response */
+    size_t next = SIM_MAX_PENDING;
+    for (size_t i = 0; i < pending_count; i++) {
+      if (pending[i].end <= wake && (next == SIM_MAX_PENDING || pending[i].end < pending[next].end)) {
+        next = i;
+      }
+    }
+    if (next == SIM_MAX_PENDING) {
+      now = wake;
+      continue;
+    }
+
+    sim_tx_t rx = pending[next];
+    pending[next] = pending[--pending_count];
+    now = rx.end > now ? rx.end : now;
+    if (rx.lost) {
+      (*collisions)++;
+      continue;
+    }
+    sim_telemetry(&response, rx.address, rx.start);
+    if (fusain_poll_response(&scheduler, &response, now) == 0) {
+      answered++;
+    }
+  }
+  return answered;
+}
+
+BENCH(poll)
+{
+  double seconds = (double)SIM_DURATION_US / 1e6;
+  uint64_t collisions;
+  uint64_t decisions;
+
+  printf("  %d appliances, %d baud, 1-16 ms turnaround, %.0f s simulated\n",
+      SIM_APPLIANCES, SIM_BAUD, seconds);
+
+  uint64_t naive = sim_naive();
+  printf("  %-40s %10.1f polls/s\n", "send, wait, timeout", (double)naive / seconds);
+
+  for (uint8_t depth = 1; depth <= 4; depth *= 2) {
+    char label[64];
+    uint64_t start = bench_now_ns();
+    uint64_t answered = sim_scheduled(depth, &collisions, &decisions);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    snprintf(label, sizeof(label), "EDF scheduler, %u in flight", depth);
+    printf("  %-40s %10.1f polls/s %6llu collisions\n", label, (double)answered / seconds,
+        (unsigned long long)collisions);
+    snprintf(label, sizeof(label), "simulation step, %u in flight", depth);
+    bench_report(label, elapsed, (size_t)decisions, 0);
+  }
+}
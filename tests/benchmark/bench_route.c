@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - routing table vs a generic chained hash map
+ *
+ * 100k device addresses, looked up in random order as a gateway would for
+ * each received packet. The baseline is the usual general-purpose map:
+ * one heap node per entry, chained from a prime-sized bucket array.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define ROUTE_ADDRESSES 100000
+#define ROUTE_BUCKETS 65536 /* 262144 slots, 38% full */
+#define CHAIN_BUCKETS 100003
+
+typedef struct chain_node {
+  struct chain_node* next;
+  uint64_t key;
+  uint32_t value;
+} chain_node_t;
+
+static fusain_route_bucket_t route_buckets[ROUTE_BUCKETS];
+static chain_node_t* chain_heads[CHAIN_BUCKETS];
+static uint64_t route_addresses[ROUTE_ADDRESSES];
+static uint32_t route_order[ROUTE_ADDRESSES];
+
+static void chain_insert(uint64_t key, uint32_t value)
+{
+  chain_node_t* node = malloc(sizeof(*node));
+  if (node == NULL) {
+    return;
+  }
+  size_t b = (size_t)(key % CHAIN_BUCKETS);
+  node->key = key;
+  node->value = value;
+  node->next = chain_heads[b];
+  chain_heads[b] = node;
+}
+
+static int chain_lookup(uint64_t key, uint32_t* value)
+{
+  for (const chain_node_t* node = chain_heads[key % CHAIN_BUCKETS]; node; node = node->next) {
+    if (node->key == key) {
+      *value = node->value;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static void chain_free(void)
+{
+  for (size_t b = 0; b < CHAIN_BUCKETS; b++) {
+    while (chain_heads[b] != NULL) {
+      chain_node_t* next = chain_heads[b]->next;
+      free(chain_heads[b]);
+      chain_heads[b] = next;
+    }
+  }
+}
+
+BENCH(route)
+{
+  fusain_route_t table;
+  uint64_t state = 0x243F6A8885A308D3ULL;
+  uint32_t route;
+
+  fusain_route_init(&table, route_buckets, NULL, ROUTE_BUCKETS);
+  for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    route_addresses[i] = state;
+    route_order[i] = i;
+    fusain_route_set(&table, state, i);
+    chain_insert(state, i);
+  }
+  for (uint32_t i = ROUTE_ADDRESSES - 1; i > 0; i--) {
+    uint32_t j = (uint32_t)(route_addresses[i] % (i + 1));
+    uint32_t t = route_order[i];
+    route_order[i] = route_order[j];
+    route_order[j] = t;
+  }
+
+  size_t rounds = BENCH_ITERATIONS(20);
+  size_t ops = rounds * ROUTE_ADDRESSES;
+
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+      fusain_route_lookup(&table, route_addresses[route_order[i]], &route);
+      bench_sink += route;
+    }
+  }
+  uint64_t hit_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+      bench_sink += (uint32_t)fusain_route_lookup(&table, ~route_addresses[i], &route);
+    }
+  }
+  uint64_t miss_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+      fusain_route_set(&table, route_addresses[route_order[i]], (uint32_t)r);
+    }
+  }
+  uint64_t set_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+      chain_lookup(route_addresses[route_order[i]], &route);
+      bench_sink += route;
+    }
+  }
+  uint64_t chain_hit_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < ROUTE_ADDRESSES; i++) {
+      bench_sink += (uint32_t)chain_lookup(~route_addresses[i], &route);
+    }
+  }
+  uint64_t chain_miss_ns = bench_now_ns() - start;
+  chain_free();
+
+  printf("  %d addresses, %d buckets of %d slots\n", ROUTE_ADDRESSES, ROUTE_BUCKETS,
+      FUSAIN_ROUTE_SLOTS);
+  bench_report("lookup hit (route table)", hit_ns, ops, 0);
+  bench_report("lookup miss (route table)", miss_ns, ops, 0);
+  bench_report("change route (route table)", set_ns, ops, 0);
+  bench_report("lookup hit (chained map)", chain_hit_ns, ops, 0);
+  bench_report("lookup miss (chained map)", chain_miss_ns, ops, 0);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - device shadow, one writer and N readers
+ *
+ * The writer feeds MOTOR_DATA for 256 devices with rpm == target; readers
+ * pick devices at random and count reads where the two differ (torn). The
+ * baseline guards the same calls with a pthread rwlock. A second part
+ * measures what a persistent image costs: checksummed updates, and the
+ * attach that replaces rediscovery after a restart.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define SHADOW_DEVICES 256
+#define SHADOW_VALUES 4
+#define SHADOW_RUN_NS (200000000ull * FUSAIN_BENCH_SCALE)
+#define SHADOW_MAX_READERS 4
+
+static fusain_shadow_device_t shadow_table[512];
+static fusain_shadow_t shadow;
+static fusain_packet_t shadow_packets[SHADOW_DEVICES * SHADOW_VALUES];
+static pthread_rwlock_t shadow_lock = PTHREAD_RWLOCK_INITIALIZER;
+static int shadow_locked;
+static int shadow_stop;
+
+typedef struct {
+  uint32_t seed;
+  uint64_t reads;
+  uint64_t torn;
+} shadow_reader_t;
+
+static void* shadow_writer(void* arg)
+{
+  uint64_t* updates = arg;
+  size_t i = 0;
+
+  while (!__atomic_load_n(&shadow_stop, __ATOMIC_RELAXED)) {
+    const fusain_packet_t* packet = &shadow_packets[i];
+    i = (i + SHADOW_DEVICES + 1) % (SHADOW_DEVICES * SHADOW_VALUES);
+    if (shadow_locked) {
+      pthread_rwlock_wrlock(&shadow_lock);
+    }
+    fusain_shadow_update(&shadow, packet, (uint32_t)i);
+    if (shadow_locked) {
+      pthread_rwlock_unlock(&shadow_lock);
+    }
+    (*updates)++;
+  }
+  return NULL;
+}
+
+static void* shadow_reader(void* arg)
+{
+  shadow_reader_t* reader = arg;
+  fusain_motor_data_t motor;
+
+  while (!__atomic_load_n(&shadow_stop, __ATOMIC_RELAXED)) {
+    reader->seed = reader->seed * 1664525u + 1013904223u;
+    uint64_t address = 0x100 + (reader->seed >> 8) % SHADOW_DEVICES;
+    if (shadow_locked) {
+      pthread_rwlock_rdlock(&shadow_lock);
+    }
+    fusain_shadow_read_motor(&shadow, address, 0, &motor);
+    if (shadow_locked) {
+      pthread_rwlock_unlock(&shadow_lock);
+    }
+    reader->torn += motor.rpm != motor.target;
+    reader->reads++;
+  }
+  return NULL;
+}
+
+static void shadow_run(int locked, int readers)
+{
+  pthread_t writer_thread;
+  pthread_t reader_threads[SHADOW_MAX_READERS];
+  shadow_reader_t reader_state[SHADOW_MAX_READERS] = { 0 };
+  uint64_t updates = 0;
+
+  shadow_locked = locked;
+  __atomic_store_n(&shadow_stop, 0, __ATOMIC_RELAXED);
+  uint64_t start = bench_now_ns();
+  pthread_create(&writer_thread, NULL, shadow_writer, &updates);
+  for (int r = 0; r < readers; r++) {
+    reader_state[r].seed = (uint32_t)r + 1;
+    pthread_create(&reader_threads[r], NULL, shadow_reader, &reader_state[r]);
+  }
+  while (bench_now_ns() - start < SHADOW_RUN_NS) {
+    sched_yield();
+  }
+  __atomic_store_n(&shadow_stop, 1, __ATOMIC_RELAXED);
+  pthread_join(writer_thread, NULL);
+  uint64_t reads = 0;
+  uint64_t torn = 0;
+  for (int r = 0; r < readers; r++) {
+    pthread_join(reader_threads[r], NULL);
+    reads += reader_state[r].reads;
+    torn += reader_state[r].torn;
+  }
+  uint64_t elapsed_ns = bench_now_ns() - start;
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s, %d reader%s: reads", locked ? "rwlock" : "seqlock",
+      readers, readers > 1 ? "s" : "");
+  bench_report(label, elapsed_ns, (size_t)reads, 0);
+  snprintf(label, sizeof(label), "%s, %d reader%s: updates", locked ? "rwlock" : "seqlock",
+      readers, readers > 1 ? "s" : "");
+  bench_report(label, elapsed_ns, (size_t)updates, 0);
+  if (torn != 0) {
+    printf("  %s: %llu torn reads\n", locked ? "rwlock" : "seqlock", (unsigned long long)torn);
+  }
+}
+
+#define PERSIST_CAPACITY 4096
+#define PERSIST_DEVICES 2048
+
+static void shadow_persist(void)
+{
+  size_t size = fusain_shadow_image_size(PERSIST_CAPACITY);
+  void* image = malloc(size);
+  fusain_shadow_t persisted;
+  fusain_packet_t packet;
+
+  if (image == NULL) {
+    return;
+  }
+  fusain_shadow_attach(&persisted, image, size, PERSIST_CAPACITY);
+  fusain_shadow_init(&shadow, shadow_table, 512);
+
+  size_t updates = BENCH_ITERATIONS(1000000);
+  fusain_create_motor_data(&packet, 0x100, 0, 1, 1500, 1500);
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < updates; i++) {
+    bench_sink += (uint32_t)fusain_shadow_update(&shadow, &packet, (uint32_t)i);
+  }
+  uint64_t plain_ns = bench_now_ns() - start;
+  start = bench_now_ns();
+  for (size_t i = 0; i < updates; i++) {
+    bench_sink += (uint32_t)fusain_shadow_update(&persisted, &packet, (uint32_t)i);
+  }
+  uint64_t checked_ns = bench_now_ns() - start;
+
+  for (uint64_t d = 0; d < PERSIST_DEVICES; d++) {
+    fusain_create_motor_data(&packet, 0x1000 + d, 0, 1, 1500, 1500);
+    fusain_shadow_update(&persisted, &packet, 0);
+  }
+  size_t attaches = BENCH_ITERATIONS(20);
+  start = bench_now_ns();
+  for (size_t i = 0; i < attaches; i++) {
+    bench_sink += (uint32_t)fusain_shadow_attach(&persisted, image, size, PERSIST_CAPACITY);
+  }
+  uint64_t attach_ns = bench_now_ns() - start;
+
+  printf("  persistent image: %d-entry table, %zu bytes\n", PERSIST_CAPACITY, size);
+  bench_report("update (in-memory)", plain_ns, updates, 0);
+  bench_report("update (checksummed image)", checked_ns, updates, 0);
+  bench_report("attach, 2048 devices restored", attach_ns, attaches, size);
+  free(image);
+}
+
+BENCH(shadow)
+{
+  fusain_shadow_init(&shadow, shadow_table, 512);
+  for (size_t v = 0; v < SHADOW_VALUES; v++) {
+    for (size_t d = 0; d < SHADOW_DEVICES; d++) {
+      int32_t rpm = (int32_t)(1000 + v * 1111);
+      fusain_create_motor_data(&shadow_packets[v * SHADOW_DEVICES + d], 0x100 + d, 0,
+          (uint32_t)v, rpm, rpm);
+      fusain_shadow_update(&shadow, &shadow_packets[v * SHADOW_DEVICES + d], 0);
+    }
+  }
+
+  printf("  %d devices, MOTOR_DATA updates, random motor reads\n", SHADOW_DEVICES);
+  for (int readers = 1; readers <= SHADOW_MAX_READERS; readers *= 2) {
+    shadow_run(0, readers);
+    shadow_run(1, readers);
+  }
+  shadow_persist();
+}
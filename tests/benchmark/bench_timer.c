@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - timer wheel vs per-device deadline scan
+ *
+ * Every device has a 1 s heartbeat (plus jitter) and a 5-60 s communication
+ * timeout that is pushed back on every heartbeat, at 1 ms per tick.
+ */
+
+#include <stdio.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define TIMER_DEVICES 10000
+#define TIMER_TICKS 60000
+
+typedef struct {
+  fusain_timer_t heartbeat;
+  fusain_timer_t timeout;
+  uint32_t timeout_ticks;
+} timer_device_t;
+
+static fusain_wheel_t timer_wheel;
+static timer_device_t timer_devices[TIMER_DEVICES];
+
+/* Naive baseline: deadlines checked one by one every tick */
+static uint32_t scan_heartbeat[TIMER_DEVICES];
+static uint32_t scan_timeout[TIMER_DEVICES];
+
+static void on_heartbeat(fusain_timer_t* timer, void* user)
+{
+  timer_device_t* device = user;
+
+  /* PING_REQUEST goes out; assume the answer arrives and re-arm both */
+  fusain_timer_start(&timer_wheel, timer, 1000, 100);
+  fusain_timer_start(&timer_wheel, &device->timeout, device->timeout_ticks, 0);
+  bench_sink++;
+}
+
+static void on_timeout(fusain_timer_t* timer, void* user)
+{
+  (void)timer;
+  (void)user;
+  bench_sink += 1000;
+}
+
+BENCH(timer)
+{
+  size_t rounds = BENCH_ITERATIONS(1);
+
+  fusain_wheel_init(&timer_wheel, 0, 1);
+  for (size_t i = 0; i < TIMER_DEVICES; i++) {
+    timer_device_t* device = &timer_devices[i];
+    device->timeout_ticks = 5000 + (uint32_t)(i * 55000 / TIMER_DEVICES);
+    fusain_timer_init(&device->heartbeat, on_heartbeat, device);
+    fusain_timer_init(&device->timeout, on_timeout, device);
+    fusain_timer_start(&timer_wheel, &device->heartbeat, 0, 1000);
+    fusain_timer_start(&timer_wheel, &device->timeout, device->timeout_ticks, 0);
+    scan_heartbeat[i] = (uint32_t)(i * 1000 / TIMER_DEVICES);
+    scan_timeout[i] = device->timeout_ticks;
+  }
+
+  /* Start + cancel of a pending timer (the response path) */
+  size_t restarts = BENCH_ITERATIONS(2000000);
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < restarts; i++) {
+    timer_device_t* device = &timer_devices[i % TIMER_DEVICES];
+    fusain_timer_start(&timer_wheel, &device->timeout, device->timeout_ticks, 0);
+  }
+  uint64_t restart_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  uint32_t tick = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t t = 0; t < TIMER_TICKS; t++) {
+      bench_sink += fusain_wheel_advance(&timer_wheel, ++tick);
+    }
+  }
+  uint64_t wheel_ns = bench_now_ns() - start;
+
+  start = bench_now_ns();
+  tick = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    for (uint32_t t = 0; t < TIMER_TICKS; t++) {
+      tick++;
+      for (size_t i = 0; i < TIMER_DEVICES; i++) {
+        if (scan_heartbeat[i] == tick) {
+          scan_heartbeat[i] = tick + 1000 + (tick ^ (uint32_t)i) % 101;
+          scan_timeout[i] = tick + timer_devices[i].timeout_ticks;
+          bench_sink++;
+        } else if (scan_timeout[i] == tick) {
+          bench_sink += 1000;
+        }
+      }
+    }
+  }
+  uint64_t scan_ns = bench_now_ns() - start;
+
+  printf("  %d devices, 1 s heartbeat, 5-60 s timeout, 1 ms ticks\n", TIMER_DEVICES);
+  bench_report("restart timeout (wheel)", restart_ns, restarts, 0);
+  bench_report("tick (wheel)", wheel_ns, rounds * TIMER_TICKS, 0);
+  bench_report("tick (scan every device)", scan_ns, rounds * TIMER_TICKS, 0);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark - emergency stop latency behind telemetry, FIFO vs
+ * priority TX scheduler; telemetry freshness on a slow link, appending
+ * FIFO vs coalescing
+ *
+ * A 115200 baud link (about 87 us per byte) is refilled 16 bytes at a
+ * time from a backlog of about 20 telemetry frames. Emergency stops are
+ * queued at pseudo-random moments. With one FIFO an emergency stop waits
+ * for every byte queued ahead of it; the scheduler sends it after the
+ * frame in progress.
+ *
+ * On a 9600 baud link, 8 thermometers report at 10 Hz each, about 2.5
+ * times what the link carries. An appending FIFO of 64 frames fills up
+ * and delivers readings that are seconds old; coalescing keeps one frame
+ * per thermometer queued, and the reading in it is the newest.
+ */
+
+#include <stdio.h>
+
+#include <fusain/fusain.h>
+
+#include "bench.h"
+
+#define TX_BYTE_US 87
+#define TX_FIFO 16
+#define TX_BACKLOG 20
+
+#define SLOW_BYTE_US 1042 /* 9600 baud */
+#define SLOW_SENSORS 8
+#define SLOW_PERIOD_US 100000
+#define SLOW_FIFO 64
+
+static fusain_tx_slot_t tx_slots[64];
+
+/* Bytes a FIFO would send before a frame queued now */
+static size_t tx_fifo_ahead(const fusain_tx_scheduler_t* sched)
+{
+  size_t bytes = sched->current != NULL ? sched->current->length - sched->offset : 0;
+  for (int cls = 0; cls < FUSAIN_TX_CLASSES; cls++) {
+    for (const fusain_tx_slot_t* slot = sched->heads[cls]; slot != NULL; slot = slot->next) {
+      bytes += slot->length;
+    }
+  }
+  return bytes;
+}
+
+BENCH(tx)
+{
+  fusain_tx_scheduler_t sched;
+  fusain_packet_t telemetry;
+  fusain_packet_t estop;
+  uint8_t fifo[TX_FIFO];
+  uint32_t seed = 12345;
+  uint64_t now_us = 0;
+  uint64_t fifo_total_us = 0;
+  uint64_t fifo_max_us = 0;
+  size_t stops = BENCH_ITERATIONS(2000);
+
+  fusain_tx_init(&sched, tx_slots, 64, NULL);
+  fusain_create_state_command(&estop, 0x0102030405060708ULL, FUSAIN_MODE_EMERGENCY, 0);
+
+  uint64_t cpu_ns = 0;
+  size_t pulled = 0;
+  for (size_t n = 0; n < stops; n++) {
+    /* Run the link for a while, keeping the telemetry backlog up */
+    seed = seed * 1103515245u + 12345u;
+    for (uint32_t refill = 0; refill < 4 + (seed >> 27); refill++) {
+      /* One frame per thermometer, so that none of them is coalesced */
+      for (uint8_t i = 0; sched.stats[FUSAIN_TX_TELEMETRY].depth < TX_BACKLOG; i++) {
+        fusain_create_temp_data(&telemetry, 0x0102030405060708ULL, i, 1000, 21.5f);
+        fusain_tx_enqueue(&sched, &telemetry, now_us);
+      }
+      uint64_t start = bench_now_ns();
+      size_t bytes = fusain_tx_pull(&sched, fifo, sizeof(fifo), now_us);
+      cpu_ns += bench_now_ns() - start;
+      pulled += bytes;
+      bench_sink += fifo[0];
+      now_us += bytes * TX_BYTE_US;
+    }
+
+    uint64_t fifo_us = tx_fifo_ahead(&sched) * TX_BYTE_US;
+    fifo_total_us += fifo_us;
+    if (fifo_us > fifo_max_us) {
+      fifo_max_us = fifo_us;
+    }
+    fusain_tx_enqueue(&sched, &estop, now_us);
+  }
+  /* Let the last emergency stop out */
+  while (sched.stats[FUSAIN_TX_SAFETY].depth > 0) {
+    now_us += fusain_tx_pull(&sched, fifo, sizeof(fifo), now_us) * TX_BYTE_US;
+  }
+
+  const fusain_tx_stats_t* safety = &sched.stats[FUSAIN_TX_SAFETY];
+  printf("  emergency stop behind %d TEMP_DATA frames at 115200 baud\n", TX_BACKLOG);
+  printf("  %-40s %10.1f ms avg %8.1f ms max\n", "one FIFO", fifo_total_us / 1000.0 / stops,
+      fifo_max_us / 1000.0);
+  printf("  %-40s %10.1f ms avg %8.1f ms max\n", "priority scheduler",
+      safety->latency_total_us / 1000.0 / safety->sent, safety->latency_max_us / 1000.0);
+  bench_report("pull (16-byte refill)", cpu_ns, pulled / TX_FIFO, pulled);
+}
+
+/* Appending FIFO model: publish times of the queued frames */
+typedef struct {
+  uint64_t published_us[SLOW_FIFO];
+  uint16_t length[SLOW_FIFO];
+  uint32_t head;
+  uint32_t depth;
+  uint32_t max_depth;
+  uint32_t dropped;
+} slow_fifo_t;
+
+static void slow_age(uint64_t age_us, uint64_t* total_us, uint64_t* max_us)
+{
+  *total_us += age_us;
+  if (age_us > *max_us) {
+    *max_us = age_us;
+  }
+}
+
+BENCH(tx_coalesce)
+{
+  static slow_fifo_t fifo;
+  fusain_tx_scheduler_t sched;
+  fusain_decoder_t decoder;
+  fusain_packet_t packet;
+  fusain_packet_t received;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t chunk[TX_FIFO];
+  uint64_t next_us[SLOW_SENSORS];
+  uint64_t end_us = BENCH_ITERATIONS(10) * 1000000ULL;
+
+  fusain_tx_init(&sched, tx_slots, SLOW_FIFO, NULL);
+  fusain_reset_decoder(&decoder);
+  fifo.head = fifo.depth = fifo.max_depth = fifo.dropped = 0;
+  for (int i = 0; i < SLOW_SENSORS; i++) {
+    next_us[i] = (uint64_t)i * SLOW_PERIOD_US / SLOW_SENSORS;
+  }
+
+  /* Both queues see the same readings; each link sends whole bytes in its own time */
+  uint64_t now_us = 0;
+  uint64_t fifo_us = 0;
+  uint64_t cpu_ns = 0;
+  size_t enqueued = 0;
+  uint64_t fifo_total_us = 0, fifo_max_us = 0, fifo_sent = 0;
+  uint64_t sched_total_us = 0, sched_max_us = 0, sched_sent = 0;
+  while (now_us < end_us) {
+    uint64_t due_us = UINT64_MAX;
+    for (uint8_t i = 0; i < SLOW_SENSORS; i++) {
+      if (next_us[i] <= now_us) {
+        fusain_create_temp_data(&packet, 0x0102030405060708ULL, i,
+            (uint32_t)(next_us[i] / 1000), 21.5f);
+        uint64_t start = bench_now_ns();
+        fusain_tx_enqueue(&sched, &packet, next_us[i]);
+        cpu_ns += bench_now_ns() - start;
+        enqueued++;
+
+        if (fifo.depth < SLOW_FIFO) {
+          uint32_t tail = (fifo.head + fifo.depth) % SLOW_FIFO;
+          fifo.published_us[tail] = next_us[i];
+          fifo.length[tail] = (uint16_t)fusain_encode_packet(&packet, frame, sizeof(frame));
+          fifo.depth++;
+          if (fifo.depth > fifo.max_depth) {
+            fifo.max_depth = fifo.depth;
+          }
+        } else {
+          fifo.dropped++;
+        }
+        next_us[i] += SLOW_PERIOD_US;
+      }
+      if (next_us[i] < due_us) {
+        due_us = next_us[i];
+      }
+    }
+
+    /* The FIFO link catches up to now, one whole frame at a time */
+    while (fifo.depth > 0 && fifo_us <= now_us) {
+      fifo_us = (fifo_us > fifo.published_us[fifo.head] ? fifo_us
+                                                        : fifo.published_us[fifo.head])
+          + fifo.length[fifo.head] * SLOW_BYTE_US;
+      slow_age(fifo_us - fifo.published_us[fifo.head], &fifo_total_us, &fifo_max_us);
+      fifo_sent++;
+      fifo.head = (fifo.head + 1) % SLOW_FIFO;
+      fifo.depth--;
+    }
+
+    size_t bytes = fusain_tx_pull(&sched, chunk, sizeof(chunk), now_us);
+    for (size_t i = 0; i < bytes; i++) {
+      if (fusain_decode_byte(chunk[i], &received, &decoder) == FUSAIN_DECODE_OK) {
+        uint64_t published_ms;
+        fusain_peek_uint(&received, 1, &published_ms);
+        slow_age(now_us + (i + 1) * SLOW_BYTE_US - published_ms * 1000, &sched_total_us,
+            &sched_max_us);
+        sched_sent++;
+      }
+    }
+    now_us = bytes > 0 ? now_us + bytes * SLOW_BYTE_US : due_us;
+  }
+
+  const fusain_tx_stats_t* telemetry = &sched.stats[FUSAIN_TX_TELEMETRY];
+  printf("  %d thermometers at 10 Hz on a 9600 baud link, %llu s\n", SLOW_SENSORS,
+      (unsigned long long)(end_us / 1000000));
+  printf("  %-28s %6u max depth %7.1f ms avg %7.1f ms max age %6u dropped\n",
+      "appending FIFO", fifo.max_depth, fifo_total_us / 1000.0 / fifo_sent,
+      fifo_max_us / 1000.0, fifo.dropped);
+  printf("  %-28s %6u max depth %7.1f ms avg %7.1f ms max age %6u coalesced\n",
+      "coalescing scheduler", telemetry->max_depth, sched_total_us / 1000.0 / sched_sent,
+      sched_max_us / 1000.0, telemetry->coalesced);
+  bench_report("enqueue (coalescing)", cpu_ns, enqueued, 0);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Benchmark Runner
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "bench.h"
+
+struct bench_entry __bench_registry[BENCH_MAX];
+int __bench_count = 0;
+volatile uint32_t bench_sink = 0;
+
+uint64_t bench_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void bench_report(const char* label, uint64_t elapsed_ns, size_t ops,
+    size_t bytes)
+{
+  double seconds = (double)elapsed_ns / 1e9;
+  double ns_per_op = ops ? (double)elapsed_ns / (double)ops : 0.0;
+  double mops = seconds > 0.0 ? (double)ops / seconds / 1e6 : 0.0;
+
+  if (bytes > 0) {
+    double mib_s = seconds > 0.0 ? (double)bytes / seconds / (1024.0 * 1024.0) : 0.0;
+    printf("  %-40s %10.1f ns/op %10.2f Mop/s %10.1f MiB/s\n", label, ns_per_op,
+        mops, mib_s);
+  } else {
+    printf("  %-40s %10.1f ns/op %10.2f Mop/s\n", label, ns_per_op, mops);
+  }
+}
+
+int main(void)
+{
+  printf("Fusain Protocol Library - Benchmarks\n");
+  printf("====================================\n");
+
+  for (int i = 0; i < __bench_count; i++) {
+    printf("\n%s\n", __bench_registry[i].name);
+    __bench_registry[i].func();
+  }
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Request/Response Correlation Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+#define CORRELATE_MAX_EVENTS 2048
+
+static struct {
+  fusain_correlate_event_t event;
+  uint64_t address;
+  uint8_t msg_type;
+  uint8_t response_type;
+  void* user;
+} events[CORRELATE_MAX_EVENTS];
+static int event_count;
+
+static void record(fusain_correlate_event_t event,
+    const fusain_correlation_t* entry, const fusain_packet_t* response)
+{
+  if (event_count < CORRELATE_MAX_EVENTS) {
+    events[event_count].event = event;
+    events[event_count].address = entry->address;
+    events[event_count].msg_type = entry->msg_type;
+    events[event_count].response_type = response != NULL ? response->msg_type : 0;
+    events[event_count].user = entry->user;
+  }
+  event_count++;
+}
+
+static void correlate_setup(fusain_correlator_t* correlator,
+    fusain_correlation_t* slots, uint32_t capacity)
+{
+  event_count = 0;
+  zassert_equal(fusain_correlator_init(correlator, slots, capacity, 1000, 2, record), 0,
+      "Init");
+}
+
+/* Test argument validation */
+ZTEST(fusain_correlate, test_correlate_init)
+{
+  fusain_correlator_t correlator;
+  fusain_correlation_t slots[8];
+
+  zassert_equal(fusain_correlator_init(&correlator, slots, 6, 1000, 0, record), -1,
+      "Not a power of two");
+  zassert_equal(fusain_correlator_init(&correlator, slots, 0, 1000, 0, record), -1,
+      "Empty");
+  zassert_equal(fusain_correlator_init(&correlator, slots, 8, 0, 0, record), -1,
+      "Zero timeout");
+  zassert_equal(fusain_correlator_init(&correlator, slots, 8, 1000, 0, NULL), -1,
+      "No callback");
+  zassert_equal(fusain_correlator_init(&correlator, NULL, 8, 1000, 0, record), -1,
+      "No storage");
+  zassert_equal(fusain_correlator_init(&correlator, slots, 1, 1000, 0, record), 0,
+      "Single slot");
+  zassert_equal(fusain_correlator_poll(&correlator, 0), UINT64_MAX, "Nothing outstanding");
+}
+
+/* Test each request family against its responses */
+ZTEST(fusain_correlate, test_correlate_families)
+{
+  fusain_correlator_t correlator;
+  fusain_correlation_t slots[16];
+  fusain_packet_t packet;
+  int context;
+
+  correlate_setup(&correlator, slots, 16);
+
+  fusain_create_ping_request(&packet, 0x10);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, &context, 0), 0, "Ping");
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), -2, "Ping busy");
+  fusain_create_discovery_request(&packet, 0x10);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), 0, "Discovery");
+  fusain_create_send_telemetry(&packet, 0x10, 0, 0xFFFFFFFF);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), 0, "Telemetry");
+  fusain_create_state_command(&packet, 0x10, FUSAIN_MODE_HEAT, 0);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), 0, "Command");
+  fusain_create_state_command(&packet, 0x20, FUSAIN_MODE_HEAT, 0);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), 0, "Other device");
+  zassert_equal(correlator.count, 5, "Five outstanding");
+
+  /* Not requests, or not answerable */
+  fusain_create_ping_response(&packet, 0x10, 0);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), -1, "Response");
+  fusain_create_state_command(&packet, FUSAIN_ADDRESS_BROADCAST, FUSAIN_MODE_IDLE, 0);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), -1, "Broadcast");
+
+  /* PING_RESPONSE completes only the ping */
+  fusain_create_ping_response(&packet, 0x10, 500);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Ping matched");
+  zassert_equal(fusain_correlator_match(&correlator, &packet), -1, "Ping done");
+  zassert_equal(events[0].event, FUSAIN_CORRELATE_RESPONSE, "Response event");
+  zassert_equal(events[0].msg_type, FUSAIN_MSG_PING_REQUEST, "Ping request");
+  zassert_equal(events[0].user, &context, "User context");
+
+  /* STATE_DATA acknowledges the command before the telemetry poll */
+  fusain_create_state_data(&packet, 0x10, 0, 0, FUSAIN_STATE_HEATING, 0);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Ack");
+  zassert_equal(events[1].msg_type, FUSAIN_MSG_STATE_COMMAND, "Command first");
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Telemetry");
+  zassert_equal(events[2].msg_type, FUSAIN_MSG_SEND_TELEMETRY, "Then telemetry");
+
+  /* Other telemetry only answers SEND_TELEMETRY */
+  fusain_create_motor_data(&packet, 0x10, 0, 0, 1000, 1000);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), -1, "No poll outstanding");
+
+  fusain_create_device_announce(&packet, 0x10, 1, 1, 1, 1);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Announce");
+  zassert_equal(events[3].msg_type, FUSAIN_MSG_DISCOVERY_REQUEST, "Discovery");
+
+  /* Errors reject the outstanding command */
+  fusain_create_error_state_reject(&packet, 0x20, FUSAIN_STATE_IDLE, FUSAIN_REJECTION_UNSPECIFIED);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Rejected");
+  zassert_equal(events[4].event, FUSAIN_CORRELATE_REJECTED, "Rejected event");
+  zassert_equal(events[4].response_type, FUSAIN_MSG_ERROR_STATE_REJECT, "Error passed");
+  zassert_equal(correlator.count, 0, "All complete");
+  zassert_equal(event_count, 5, "One event each");
+
+  /* Errors fall back to an outstanding SEND_TELEMETRY */
+  fusain_create_send_telemetry(&packet, 0x30, 9, 0xFFFFFFFF);
+  fusain_correlator_track(&correlator, &packet, NULL, 0);
+  fusain_create_error_invalid_cmd(&packet, 0x30, FUSAIN_INVALID_CMD_INVALID_PARAM, 0, -1);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Invalid poll");
+  zassert_equal(events[5].msg_type, FUSAIN_MSG_SEND_TELEMETRY, "Poll rejected");
+  zassert_equal(fusain_correlator_match(&correlator, &packet), -1, "Nothing left");
+  fusain_create_ping_request(&packet, 0x30);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), -1, "Requests never match");
+}
+
+/* Test deadline-driven retries and timeouts */
+ZTEST(fusain_correlate, test_correlate_retries)
+{
+  fusain_correlator_t correlator;
+  fusain_correlation_t slots[4];
+  fusain_packet_t packet;
+
+  correlate_setup(&correlator, slots, 4);
+  fusain_create_ping_request(&packet, 0xA);
+  fusain_correlator_track(&correlator, &packet, NULL, 0);
+  fusain_create_ping_request(&packet, 0xB);
+  fusain_correlator_track(&correlator, &packet, NULL, 500);
+
+  zassert_equal(fusain_correlator_poll(&correlator, 999), 1000, "First deadline");
+  zassert_equal(event_count, 0, "Nothing due");
+
+  /* A is resent and moves behind B */
+  zassert_equal(fusain_correlator_poll(&correlator, 1000), 1500, "B next");
+  zassert_equal(event_count, 1, "One retry");
+  zassert_equal(events[0].event, FUSAIN_CORRELATE_RETRY, "Retry");
+  zassert_equal(events[0].address, 0xA, "A resent");
+
+  /* B answers; A runs out of retries */
+  fusain_create_ping_response(&packet, 0xB, 0);
+  zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "B answered");
+  zassert_equal(fusain_correlator_poll(&correlator, 2000), 3000, "A re-armed again");
+  zassert_equal(fusain_correlator_poll(&correlator, 3000), UINT64_MAX, "All done");
+  zassert_equal(event_count, 4, "Retry, response, retry, timeout");
+  zassert_equal(events[2].event, FUSAIN_CORRELATE_RETRY, "Second retry");
+  zassert_equal(events[3].event, FUSAIN_CORRELATE_TIMEOUT, "Timeout");
+  zassert_equal(events[3].address, 0xA, "A timed out");
+  zassert_equal(correlator.count, 0, "Released");
+
+  /* Cancel drops an entry without a callback */
+  fusain_create_temp_command(&packet, 0xC, 0, FUSAIN_TEMP_CMD_WATCH_MOTOR, 0, 0);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 3000), 0, "Tracked");
+  zassert_equal(fusain_correlator_cancel(&correlator, 0xC, FUSAIN_MSG_PING_REQUEST), -1,
+      "Other family");
+  zassert_equal(fusain_correlator_cancel(&correlator, 0xC, FUSAIN_MSG_STATE_DATA), -1,
+      "Not a request");
+  zassert_equal(fusain_correlator_cancel(&correlator, 0xC, FUSAIN_MSG_MOTOR_COMMAND), 0,
+      "Same family");
+  zassert_equal(fusain_correlator_poll(&correlator, 10000), UINT64_MAX, "Nothing due");
+  zassert_equal(event_count, 4, "No callback");
+}
+
+/* Test a full table with colliding hash chains */
+ZTEST(fusain_correlate, test_correlate_capacity)
+{
+  static fusain_correlation_t slots[4096];
+  fusain_correlator_t correlator;
+  fusain_packet_t packet;
+
+  correlate_setup(&correlator, slots, 4096);
+  for (uint32_t i = 0; i < 4096; i++) {
+    fusain_create_ping_request(&packet, 0x0100000000000000ULL + i);
+    zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, i), 0, "Track %u", i);
+  }
+  fusain_create_ping_request(&packet, 0x0200000000000000ULL);
+  zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 0), -3, "Full");
+
+  /* Complete every other one, out of order */
+  for (uint32_t i = 0; i < 4096; i += 2) {
+    fusain_create_ping_response(&packet, 0x0100000000000000ULL + (i ^ 0x0AAA), 0);
+    zassert_equal(fusain_correlator_match(&correlator, &packet), 0, "Match %u", i);
+  }
+  zassert_equal(correlator.count, 2048, "Half left");
+
+  /* Freed slots are reused */
+  for (uint32_t i = 0; i < 2048; i++) {
+    fusain_create_ping_request(&packet, 0x0300000000000000ULL + i);
+    zassert_equal(fusain_correlator_track(&correlator, &packet, NULL, 5000), 0, "Reuse %u", i);
+  }
+  zassert_equal(correlator.count, 4096, "Full again");
+
+  /* The rest expire in deadline order */
+  event_count = 0;
+  zassert_equal(fusain_correlator_poll(&correlator, 5095), 6000, "Originals retried");
+  zassert_equal(event_count, 2048, "Retries");
+  zassert_equal(events[0].address, 0x0100000000000000ULL + 1, "Oldest first");
+  zassert_equal(events[2047].address, 0x0100000000000000ULL + 4095, "Newest last");
+}
+
+ZTEST_SUITE(fusain_correlate, NULL, NULL, NULL, NULL, NULL);
@@ -75,5 +75,95 @@ ZTEST(fusain_crc, test_crc_byte_order)
   zassert_not_equal(crc1, crc2, "Byte order should affect CRC");
 }
 
+/* Test batch CRC matches single-span CRC for mixed lengths */
+ZTEST(fusain_crc, test_crc_batch_matches_single)
+{
+  uint8_t data[FUSAIN_MAX_PACKET_SIZE];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(i * 37 + 11);
+  }
+
+  /* 7 spans: one full lane group plus a 3-span tail, including empty spans */
+  const size_t lengths[] = { 123, 0, 9, 64, 1, 123, 17 };
+  fusain_span_t spans[7];
+  uint16_t crcs[7];
+  for (size_t i = 0; i < 7; i++) {
+    spans[i].data = &data[i];
+    spans[i].length = lengths[i];
+  }
+
+  fusain_crc16_batch(spans, 7, crcs);
+
+  for (size_t i = 0; i < 7; i++) {
+    zassert_equal(crcs[i], fusain_crc16(spans[i].data, spans[i].length),
+        "Batch CRC should match single CRC (span %zu)", i);
+  }
+}
+
+/* Test batch CRC with no spans leaves output untouched */
+ZTEST(fusain_crc, test_crc_batch_empty)
+{
+  uint16_t crc = 0x1234;
+  fusain_crc16_batch(NULL, 0, &crc);
+  zassert_equal(crc, 0x1234, "Empty batch should not write output");
+}
+
+/* Test carrying a CRC across data fed in pieces */
+ZTEST(fusain_crc, test_crc_update)
+{
+  uint8_t data[FUSAIN_MAX_PACKET_SIZE];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(i * 37 + 11);
+  }
+
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < sizeof(data); i++) {
+    crc = fusain_crc16_update(crc, &data[i], 1);
+  }
+  zassert_equal(crc, fusain_crc16(data, sizeof(data)), "Byte at a time should match");
+  zassert_equal(fusain_crc16_update(fusain_crc16(data, 9), &data[9], sizeof(data) - 9),
+      fusain_crc16(data, sizeof(data)), "Continued CRC should match");
+}
+
+/* Test CRC of a concatenation from the CRCs of its parts */
+ZTEST(fusain_crc, test_crc_combine)
+{
+  uint8_t data[FUSAIN_MAX_PACKET_SIZE];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(i * 73 + 5);
+  }
+
+  const size_t splits[] = { 0, 1, 9, 64, 127, 128 };
+  for (size_t i = 0; i < sizeof(splits) / sizeof(splits[0]); i++) {
+    size_t a = splits[i];
+    uint16_t crc = fusain_crc16_combine(fusain_crc16(data, a),
+        fusain_crc16(&data[a], sizeof(data) - a), sizeof(data) - a);
+    zassert_equal(crc, fusain_crc16(data, sizeof(data)),
+        "Combined CRC should match (split at %zu)", a);
+  }
+}
+
+/* Test patching a CRC for replaced bytes */
+ZTEST(fusain_crc, test_crc_patch)
+{
+  uint8_t data[40];
+  uint8_t patched[40];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(i * 29 + 3);
+  }
+  memcpy(patched, data, sizeof(data));
+  const uint8_t replacement[8] = { 0x7E, 0x00, 0xFF, 0x12, 0x34, 0x7D, 0x7F, 0x01 };
+  memcpy(&patched[1], replacement, sizeof(replacement));
+
+  uint16_t crc = fusain_crc16_patch(fusain_crc16(data, sizeof(data)), &data[1],
+      replacement, sizeof(replacement), sizeof(data) - 9);
+  zassert_equal(crc, fusain_crc16(patched, sizeof(patched)),
+      "Patched CRC should match recomputed CRC");
+
+  /* Nothing replaced, nothing changes */
+  zassert_equal(fusain_crc16_patch(0xBEEF, data, data, 8, 3), 0xBEEF,
+      "Identical bytes should not change the CRC");
+}
+
 /* Test suite setup */
 ZTEST_SUITE(fusain_crc, NULL, NULL, NULL, NULL, NULL);
@@ -142,6 +142,29 @@ ZTEST(fusain_decoding, test_decoder_reset)
   zassert_false(decoder.escape_next, "Escape flag should be reset");
 }
 
+/* Test reset fully initializes a decoder holding garbage */
+ZTEST(fusain_decoding, test_decoder_reset_uninitialized)
+{
+  fusain_decoder_t decoder;
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+  memset(&decoder, 0xAA, sizeof(decoder));
+  fusain_reset_decoder(&decoder);
+
+  fusain_create_ping_request(&tx, 0x5678);
+  int len = fusain_encode_packet(&tx, frame, sizeof(frame));
+  zassert_true(len > 0, "Encode failed");
+
+  fusain_decode_result_t result = FUSAIN_DECODE_INCOMPLETE;
+  for (int i = 0; i < len; i++) {
+    result = fusain_decode_byte(frame[i], &rx, &decoder);
+  }
+  zassert_equal(result, FUSAIN_DECODE_OK, "Frame should decode");
+  zassert_equal(rx.address, 0x5678, "Address should match");
+}
+
 /* Test decoding with large CBOR payload (motor_config has many fields) */
 ZTEST(fusain_decoding, test_roundtrip_max_payload)
 {
@@ -575,4 +598,719 @@ ZTEST(fusain_decoding, test_decode_truncated_uint8_type)
 }
 
 /* Test suite setup */
+/* Test in-place frame extraction of several frames in one chunk */
+ZTEST(fusain_decoding, test_extract_frames_in_place)
+{
+  fusain_packet_t tx[3];
+  fusain_create_motor_command(&tx[0], 0x1234, 0, 3000);
+  fusain_create_device_announce(&tx[1], 0x7E7D7F01, 1, 1, 1, 1);
+  fusain_create_ping_request(&tx[2], 0x5678);
+
+  /* Leading garbage, then three frames back-to-back */
+  uint8_t chunk[FUSAIN_MAX_PACKET_SIZE * 6] = { 0x00, 0x7F, 0x42 };
+  size_t chunk_len = 3;
+  for (int p = 0; p < 3; p++) {
+    int len = fusain_encode_packet(&tx[p], &chunk[chunk_len],
+        sizeof(chunk) - chunk_len);
+    zassert_true(len > 0, "Encoding should succeed");
+    chunk_len += (size_t)len;
+  }
+
+  fusain_extractor_t extractor;
+  fusain_reset_extractor(&extractor);
+
+  size_t offset = 0;
+  for (int p = 0; p < 3; p++) {
+    fusain_frame_view_t view;
+    size_t consumed = 0;
+    fusain_decode_result_t result = fusain_extract_frame(&extractor,
+        &chunk[offset], chunk_len - offset, &view, &consumed);
+
+    zassert_equal(result, FUSAIN_DECODE_OK, "Frame %d should extract", p);
+    zassert_true(view.payload > &chunk[offset]
+            && view.payload < &chunk[offset + consumed],
+        "Frame %d payload should point into the chunk", p);
+    zassert_equal(view.address, tx[p].address, "Address should match");
+    zassert_equal(view.msg_type, tx[p].msg_type, "Type should match");
+    zassert_equal(view.length, tx[p].length, "Length should match");
+    zassert_mem_equal(view.payload, tx[p].payload, tx[p].length,
+        "Payload should match");
+    offset += consumed;
+  }
+
+  fusain_frame_view_t view;
+  size_t consumed = 0;
+  zassert_equal(fusain_extract_frame(&extractor, &chunk[offset],
+                    chunk_len - offset, &view, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Exhausted chunk should be incomplete");
+  zassert_equal(consumed, chunk_len - offset, "All bytes should be consumed");
+}
+
+/* Test frames split across chunks at every position use the carry buffer */
+ZTEST(fusain_decoding, test_extract_frame_split)
+{
+  fusain_packet_t tx;
+  fusain_create_device_announce(&tx, 0x7E7D7F01, 1, 1, 1, 1);
+
+  uint8_t encoded[FUSAIN_MAX_PACKET_SIZE * 2];
+  int encoded_len = fusain_encode_packet(&tx, encoded, sizeof(encoded));
+  zassert_true(encoded_len > 0, "Encoding should succeed");
+
+  for (int split = 1; split < encoded_len; split++) {
+    uint8_t chunk[FUSAIN_MAX_PACKET_SIZE * 2];
+    memcpy(chunk, encoded, encoded_len);
+
+    fusain_extractor_t extractor;
+    fusain_reset_extractor(&extractor);
+    fusain_frame_view_t view;
+    size_t consumed = 0;
+
+    zassert_equal(fusain_extract_frame(&extractor, chunk, split, &view,
+                      &consumed),
+        FUSAIN_DECODE_INCOMPLETE, "Split %d: first part incomplete", split);
+    zassert_equal(consumed, (size_t)split, "First part fully consumed");
+
+    zassert_equal(fusain_extract_frame(&extractor, &chunk[split],
+                      encoded_len - split, &view, &consumed),
+        FUSAIN_DECODE_OK, "Split %d: frame should complete", split);
+    zassert_equal(consumed, (size_t)(encoded_len - split),
+        "Second part fully consumed");
+    zassert_true(view.payload > extractor.carry
+            && view.payload < extractor.carry + sizeof(extractor.carry),
+        "Split frame payload should point into the carry buffer");
+    zassert_equal(view.address, tx.address, "Address should match");
+    zassert_mem_equal(view.payload, tx.payload, tx.length,
+        "Payload should match");
+  }
+}
+
+/* Test extraction error handling and resynchronization */
+ZTEST(fusain_decoding, test_extract_frame_errors)
+{
+  fusain_extractor_t extractor;
+  fusain_reset_extractor(&extractor);
+  fusain_frame_view_t view;
+  size_t consumed;
+
+  fusain_packet_t tx;
+  fusain_create_ping_request(&tx, 0x1234);
+  uint8_t good[FUSAIN_MAX_PACKET_SIZE * 2];
+  int good_len = fusain_encode_packet(&tx, good, sizeof(good));
+  zassert_true(good_len > 0, "Encoding should succeed");
+
+  /* Corrupted CRC, then a good frame */
+  uint8_t chunk[FUSAIN_MAX_STUFFED_PACKET_SIZE * 2];
+  memcpy(chunk, good, good_len);
+  chunk[good_len - 2] ^= 0x01;
+  memcpy(&chunk[good_len], good, good_len);
+  zassert_equal(fusain_extract_frame(&extractor, chunk, good_len * 2, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_CRC, "Bad CRC should be rejected");
+  zassert_equal(consumed, (size_t)good_len, "Bad frame should be consumed");
+  zassert_equal(fusain_extract_frame(&extractor, &chunk[good_len], good_len,
+                    &view, &consumed),
+      FUSAIN_DECODE_OK, "Next frame should extract");
+
+  /* Empty frame and invalid length byte */
+  uint8_t empty[] = { FUSAIN_START_BYTE, FUSAIN_END_BYTE };
+  zassert_equal(fusain_extract_frame(&extractor, empty, sizeof(empty), &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Empty frame should be rejected");
+  uint8_t too_long[] = { FUSAIN_START_BYTE, FUSAIN_MAX_PAYLOAD_SIZE + 1,
+    FUSAIN_END_BYTE };
+  zassert_equal(fusain_extract_frame(&extractor, too_long, sizeof(too_long),
+                    &view, &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Oversized length should be rejected");
+
+  /* Frame shorter than its length byte, and a dangling escape */
+  memcpy(chunk, good, good_len);
+  chunk[good_len - 2] = FUSAIN_END_BYTE;
+  zassert_equal(fusain_extract_frame(&extractor, chunk, good_len, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Short frame should be rejected");
+  memcpy(chunk, good, good_len);
+  chunk[good_len - 2] = FUSAIN_ESC_BYTE;
+  zassert_equal(fusain_extract_frame(&extractor, chunk, good_len, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Dangling escape should be rejected");
+
+  /* Valid CRC but invalid CBOR header */
+  fusain_packet_t bad_cbor = { .length = 3, .address = 1 };
+  memcpy(bad_cbor.payload, "\x83\x30\xF6", 3);
+  int bad_len = fusain_encode_packet(&bad_cbor, chunk, sizeof(chunk));
+  zassert_equal(fusain_extract_frame(&extractor, chunk, bad_len, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_START, "Invalid CBOR header should be rejected");
+
+  /* Truncated frame followed by a new START in the same chunk */
+  memcpy(chunk, good, 5);
+  memcpy(&chunk[5], good, good_len);
+  zassert_equal(fusain_extract_frame(&extractor, chunk, 5 + good_len, &view,
+                    &consumed),
+      FUSAIN_DECODE_OK, "Should resync on new START");
+
+  /* Truncated frame in carry, new START in the next chunk */
+  memcpy(chunk, good, good_len);
+  zassert_equal(fusain_extract_frame(&extractor, chunk, 5, &view, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Partial frame should be carried");
+  zassert_equal(fusain_extract_frame(&extractor, chunk, good_len, &view,
+                    &consumed),
+      FUSAIN_DECODE_OK, "Should drop carry and resync on new START");
+
+  /* Carried frame completed by a chunk with no END */
+  zassert_equal(fusain_extract_frame(&extractor, chunk, 5, &view, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Partial frame should be carried");
+  zassert_equal(fusain_extract_frame(&extractor, &chunk[5], 3, &view,
+                    &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Carry should grow");
+  zassert_equal(fusain_extract_frame(&extractor, &chunk[8], good_len - 8,
+                    &view, &consumed),
+      FUSAIN_DECODE_OK, "Frame spanning three chunks should extract");
+
+  /* Carry buffer overflow with no END */
+  memset(chunk, 0x41, sizeof(chunk));
+  chunk[0] = FUSAIN_START_BYTE;
+  zassert_equal(fusain_extract_frame(&extractor, chunk, 10, &view, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Partial frame should be carried");
+  zassert_equal(fusain_extract_frame(&extractor, &chunk[10],
+                    sizeof(chunk) - 10, &view, &consumed),
+      FUSAIN_DECODE_BUFFER_OVERFLOW, "Runaway carried frame should overflow");
+  zassert_equal(extractor.carry_length, 0, "Carry should be dropped");
+
+  /* Partial frame too large to carry */
+  zassert_equal(fusain_extract_frame(&extractor, chunk, sizeof(chunk), &view,
+                    &consumed),
+      FUSAIN_DECODE_BUFFER_OVERFLOW, "Runaway partial frame should overflow");
+  zassert_equal(consumed, sizeof(chunk), "Chunk should be consumed");
+}
+
+/* Build a packet from raw CBOR bytes */
+static void make_raw_packet(fusain_packet_t* packet, const uint8_t* cbor,
+    size_t length)
+{
+  memset(packet, 0, sizeof(*packet));
+  memcpy(packet->payload, cbor, length);
+  packet->length = (uint8_t)length;
+}
+
+/* Test single-field peeks on helper-created packets */
+ZTEST(fusain_decoding, test_peek_fields)
+{
+  fusain_packet_t packet;
+  uint64_t u;
+  int64_t i;
+  double d;
+  bool b;
+
+  fusain_create_motor_data(&packet, 0x1234, 2, 123456, -1500, 3000);
+  zassert_equal(fusain_peek_uint(&packet, 0, &u), 0, "Motor index peek");
+  zassert_equal(u, 2, "Motor index should match");
+  zassert_equal(fusain_peek_uint(&packet, 1, &u), 0, "Timestamp peek");
+  zassert_equal(u, 123456, "Timestamp should match");
+  zassert_equal(fusain_peek_int(&packet, 2, &i), 0, "RPM peek");
+  zassert_equal(i, -1500, "RPM should match");
+  zassert_equal(fusain_peek_int(&packet, 3, &i), 0, "Target peek");
+  zassert_equal(i, 3000, "Target should match");
+  zassert_equal(fusain_peek_uint(&packet, 2, &u), -3,
+      "Negative value is not a uint");
+  zassert_equal(fusain_peek_int(&packet, 7, &i), -2, "Absent key");
+
+  fusain_create_temp_data(&packet, 0x1234, 0, 1000, 215.5f);
+  zassert_equal(fusain_peek_float(&packet, 2, &d), 0, "Reading peek");
+  zassert_equal(d, 215.5, "Reading should match");
+  zassert_equal(fusain_peek_float(&packet, 1, &d), -3,
+      "Integer is not a float");
+
+  fusain_create_glow_data(&packet, 0x1234, 0, 1000, true);
+  zassert_equal(fusain_peek_bool(&packet, 2, &b), 0, "Lit peek");
+  zassert_true(b, "Lit should be true");
+  zassert_equal(fusain_peek_bool(&packet, 1, &b), -3,
+      "Integer is not a bool");
+
+  fusain_create_ping_request(&packet, 0x1234);
+  zassert_equal(fusain_peek_uint(&packet, 0, &u), -2,
+      "Nil payload has no fields");
+
+  zassert_equal(fusain_peek_uint(NULL, 0, &u), -1, "NULL packet");
+  zassert_equal(fusain_peek_uint(&packet, 0, NULL), -1, "NULL value");
+  zassert_equal(fusain_peek_int(&packet, 0, NULL), -1, "NULL value");
+  zassert_equal(fusain_peek_float(&packet, 0, NULL), -1, "NULL value");
+  zassert_equal(fusain_peek_bool(&packet, 0, NULL), -1, "NULL value");
+  packet.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_peek_uint(&packet, 0, &u), -1, "Invalid length");
+}
+
+/* Test peeks skip arbitrary CBOR and accept all float widths */
+ZTEST(fusain_decoding, test_peek_raw_cbor)
+{
+  fusain_packet_t packet;
+  uint64_t u;
+  int64_t i;
+  double d;
+  bool b;
+
+  /* Definite map whose earlier entries need every kind of skip */
+  const uint8_t skips[] = {
+    0x82, 0x18, 0x31, 0xA9, /* [0x31, map(9)] */
+    0x61, 'k', 0x01, /* text key */
+    0x01, 0x42, 0xAA, 0xBB, /* bytes */
+    0x02, 0x82, 0x01, 0x9F, 0x02, 0xFF, /* [1, [_ 2]] */
+    0x03, 0xA1, 0x01, 0xF5, /* {1: true} */
+    0x04, 0xC1, 0x1A, 0x00, 0x01, 0x00, 0x00, /* tag(1) uint32 */
+    0x05, 0x5F, 0x41, 0x00, 0xFF, /* indefinite bytes */
+    0x06, 0xF9, 0x3C, 0x00, /* f16 1.0 */
+    0x07, 0xFA, 0xC0, 0x20, 0x00, 0x00, /* f32 -2.5 */
+    0x08, 0x3B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* INT64_MIN */
+  };
+  make_raw_packet(&packet, skips, sizeof(skips));
+  zassert_equal(fusain_peek_int(&packet, 8, &i), 0, "Peek past all skips");
+  zassert_equal(i, INT64_MIN, "Most negative int64");
+  zassert_equal(fusain_peek_float(&packet, 6, &d), 0, "f16 peek");
+  zassert_equal(d, 1.0, "f16 should widen");
+  zassert_equal(fusain_peek_float(&packet, 7, &d), 0, "f32 peek");
+  zassert_equal(d, -2.5, "f32 should widen");
+  zassert_equal(fusain_peek_float(&packet, 5, &d), -3, "Bytes are not a float");
+  zassert_equal(fusain_peek_float(&packet, 3, &d), -3, "Map is not a float");
+  zassert_equal(fusain_peek_bool(&packet, 6, &b), -3, "Float is not a bool");
+  zassert_equal(fusain_peek_int(&packet, 9, &i), -2, "Absent key");
+
+  /* Half precision edge cases: subnormal, zero, infinity, NaN */
+  const uint8_t halves[] = {
+    0x82, 0x18, 0x34, 0xBF,
+    0x00, 0xF9, 0x00, 0x01, /* smallest subnormal 2^-24 */
+    0x01, 0xF9, 0x80, 0x00, /* -0.0 */
+    0x02, 0xF9, 0x7C, 0x00, /* +inf */
+    0x03, 0xF9, 0x7E, 0x00, /* NaN */
+    0x04, 0xF4, /* false */
+    0xFF,
+  };
+  make_raw_packet(&packet, halves, sizeof(halves));
+  zassert_equal(fusain_peek_float(&packet, 0, &d), 0, "Subnormal peek");
+  zassert_equal(d, 1.0 / 16777216.0, "Subnormal should be 2^-24");
+  zassert_equal(fusain_peek_float(&packet, 1, &d), 0, "Zero peek");
+  zassert_equal(d, 0.0, "Negative zero");
+  zassert_equal(fusain_peek_float(&packet, 2, &d), 0, "Infinity peek");
+  zassert_true(d > 1e308, "Infinity");
+  zassert_equal(fusain_peek_float(&packet, 3, &d), 0, "NaN peek");
+  zassert_true(d != d, "NaN");
+  zassert_equal(fusain_peek_bool(&packet, 4, &b), 0, "False peek");
+  zassert_false(b, "Bool should be false");
+  zassert_equal(fusain_peek_float(&packet, 4, &d), -3, "Bool is not a float");
+  zassert_equal(fusain_peek_uint(&packet, 5, &u), -2, "Break ends the map");
+
+  /* Integer range checks */
+  const uint8_t ranges[] = {
+    0x82, 0x18, 0x31, 0xA2,
+    0x00, 0x1B, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 2^63 */
+    0x01, 0x3B, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* -1-2^63 */
+  };
+  make_raw_packet(&packet, ranges, sizeof(ranges));
+  zassert_equal(fusain_peek_uint(&packet, 0, &u), 0, "Large uint peek");
+  zassert_equal(u, 0x8000000000000000ULL, "Large uint should match");
+  zassert_equal(fusain_peek_int(&packet, 0, &i), -3, "Too large for int64");
+  zassert_equal(fusain_peek_int(&packet, 1, &i), -3, "Too small for int64");
+  zassert_equal(fusain_peek_bool(&packet, 0, &b), -3, "Uint is not a bool");
+}
+
+/* Test peeks reject malformed CBOR */
+ZTEST(fusain_decoding, test_peek_malformed)
+{
+  fusain_packet_t packet;
+  uint64_t u;
+  int64_t i;
+
+  static const struct {
+    uint8_t cbor[16];
+    uint8_t length;
+  } cases[] = {
+    { { 0x83, 0x01 }, 2 }, /* Bad message header */
+    { { 0x82, 0x01 }, 2 }, /* Missing map */
+    { { 0x82, 0x01, 0x01 }, 3 }, /* Not a map */
+    { { 0x82, 0x01, 0xBF }, 3 }, /* Indefinite map without break */
+    { { 0x82, 0x01, 0xA1 }, 3 }, /* Missing key */
+    { { 0x82, 0x01, 0xA1, 0x05 }, 4 }, /* Missing value */
+    { { 0x82, 0x01, 0xA1, 0x00 }, 4 }, /* Missing matched value */
+    { { 0x82, 0x01, 0xA1, 0x1C }, 4 }, /* Reserved additional info */
+    { { 0x82, 0x01, 0xA1, 0x19, 0x01 }, 5 }, /* Truncated key argument */
+    { { 0x82, 0x01, 0xA1, 0x1F, 0x00 }, 5 }, /* Indefinite uint key */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x3F }, 5 }, /* Indefinite int value */
+    { { 0x82, 0x01, 0xA1, 0x05, 0xDF, 0x00 }, 6 }, /* Indefinite tag */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x45, 0x00 }, 6 }, /* Short byte string */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x85, 0x00 }, 6 }, /* Short array */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x82, 0x00 }, 6 }, /* Truncated array */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x9F, 0x00 }, 6 }, /* Array without break */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x9F, 0x1C, 0xFF }, 7 }, /* Bad item */
+    { { 0x82, 0x01, 0xA1, 0x05, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81,
+          0x81, 0x81, 0x81, 0x00 },
+        15 }, /* Nested too deep */
+  };
+
+  for (size_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+    make_raw_packet(&packet, cases[n].cbor, cases[n].length);
+    zassert_equal(fusain_peek_uint(&packet, 0, &u), -1,
+        "Case %zu should be malformed", n);
+  }
+
+  /* A matched key with an indefinite-length uint is still a type error */
+  const uint8_t indefinite_value[] = { 0x82, 0x01, 0xA1, 0x00, 0x1F };
+  make_raw_packet(&packet, indefinite_value, sizeof(indefinite_value));
+  zassert_equal(fusain_peek_uint(&packet, 0, &u), -3, "Indefinite uint");
+  zassert_equal(fusain_peek_int(&packet, 0, &i), -3, "Indefinite int");
+}
+
+/* Test fixed-point TEMP_DATA encoding and dual-form decoding */
+ZTEST(fusain_decoding, test_temp_data_fixed_point)
+{
+  fusain_packet_t packet;
+  fusain_temp_data_t data;
+  int32_t centi = 0;
+  double d;
+
+  fusain_create_temp_data_centi(&packet, 0x1234, 2, 70000, 2345);
+  zassert_equal(packet.msg_type, FUSAIN_MSG_TEMP_DATA, "Wrong msg type");
+  zassert_true(packet.length <= FUSAIN_CBOR_SIZE_TEMP_DATA, "Exceeds bound");
+  zassert_equal(fusain_peek_float(&packet, 2, &d), -2, "Float reading sent");
+  zassert_equal(fusain_read_temp_centi(&packet, &centi), 0, "Centi read");
+  zassert_equal(centi, 2345, "Wrong centi");
+  zassert_equal(fusain_decode_temp_data(&packet, &data), 0, "Decode failed");
+  zassert_equal(data.thermometer, 2, "Wrong thermometer");
+  zassert_equal(data.timestamp, 70000, "Wrong timestamp");
+  zassert_true(data.reading > 23.449f && data.reading < 23.451f, "Wrong reading");
+
+  /* Every integer width, both signs */
+  const int32_t values[] = { 0, -1, 23, -24, 255, -256, 65535, -65536,
+    INT32_MAX, INT32_MIN };
+  for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+    fusain_create_temp_data_centi(&packet, 0x1, 0, 300, values[v]);
+    zassert_equal(fusain_read_temp_centi(&packet, &centi), 0, "Centi read");
+    zassert_equal(centi, values[v], "Centi %d should round-trip", values[v]);
+  }
+
+  uint8_t frame[FUSAIN_MAX_PACKET_SIZE * 2];
+  int len = fusain_encode_packet(&packet, frame, sizeof(frame));
+  fusain_decoder_t decoder;
+  fusain_packet_t rx;
+  fusain_decode_result_t result = FUSAIN_DECODE_INCOMPLETE;
+  fusain_reset_decoder(&decoder);
+  for (int b = 0; b < len; b++) {
+    result = fusain_decode_byte(frame[b], &rx, &decoder);
+  }
+  zassert_equal(result, FUSAIN_DECODE_OK, "Frame should decode");
+  zassert_equal(fusain_read_temp_centi(&rx, &centi), 0, "Centi read");
+  zassert_equal(centi, INT32_MIN, "Centi should survive framing");
+
+  /* Float form converts without floating point */
+  fusain_create_temp_data(&packet, 0x1, 0, 100, 23.45f);
+  zassert_equal(fusain_read_temp_centi(&packet, &centi), 0, "Float read");
+  zassert_equal(centi, 2345, "Wrong converted centi");
+  zassert_equal(fusain_decode_temp_data(&packet, &data), 0, "Decode failed");
+  zassert_true(data.reading > 23.449f && data.reading < 23.451f, "Wrong reading");
+
+  const struct {
+    uint8_t cbor[9];
+    size_t length;
+    int ret;
+    int32_t centi;
+  } floats[] = {
+    { { 0xF9, 0x38, 0x00 }, 3, 0, 50 }, /* f16 0.5 */
+    { { 0xF9, 0x80, 0x01 }, 3, 0, 0 }, /* f16 subnormal */
+    { { 0xF9, 0x7C, 0x00 }, 3, -3, 0 }, /* f16 infinity */
+    { { 0xFA, 0xBE, 0x00, 0x00, 0x00 }, 5, 0, -13 }, /* -0.125 rounds away */
+    { { 0xFA, 0x4C, 0x00, 0x00, 0x00 }, 5, -3, 0 }, /* 2^25 * 100 > int32 */
+    { { 0xFA, 0x53, 0x80, 0x00, 0x00 }, 5, -3, 0 }, /* 2^40 */
+    { { 0xFA, 0x7F, 0xC0, 0x00, 0x00 }, 5, -3, 0 }, /* NaN */
+    { { 0xFB, 0xC1, 0x1E, 0x84, 0x80, 0, 0, 0, 0 }, 9, 0, -50000000 },
+    { { 0xFB, 0x41, 0x74, 0x7A, 0xE1, 0x47, 0x85, 0x1E, 0xB8 }, 9, 0, INT32_MAX },
+    { { 0xFB, 0x41, 0x97, 0xD7, 0x84, 0, 0, 0, 0 }, 9, -3, 0 }, /* 1e8 */
+    { { 0xFB, 0x7E, 0x37, 0xE4, 0x3C, 0x88, 0, 0x75, 0x9C }, 9, -3, 0 }, /* 1e300 */
+    { { 0xFB, 0x39, 0xB4, 0x48, 0x4B, 0xFE, 0xEB, 0xC2, 0xA0 }, 9, 0, 0 }, /* 1e-30 */
+    { { 0xF5 }, 1, -3, 0 }, /* Not a float */
+  };
+  for (size_t f = 0; f < sizeof(floats) / sizeof(floats[0]); f++) {
+    uint8_t cbor[24] = { 0x82, 0x18, FUSAIN_MSG_TEMP_DATA, 0xA3, 0x00, 0x00,
+      0x01, 0x00, 0x02 };
+    memcpy(cbor + 9, floats[f].cbor, floats[f].length);
+    make_raw_packet(&packet, cbor, 9 + floats[f].length);
+    packet.msg_type = FUSAIN_MSG_TEMP_DATA;
+    centi = 0;
+    zassert_equal(fusain_read_temp_centi(&packet, &centi), floats[f].ret,
+        "Wrong result for float %zu", f);
+    zassert_equal(centi, floats[f].centi, "Wrong centi for float %zu", f);
+  }
+
+  /* Optional fields are reported in the mask */
+  fusain_temp_data_t full = {
+    .thermometer = 1, .timestamp = 5, .reading = 180.5f,
+    .rpm_control = true, .watched_motor = -3, .target_temp = 200.25f,
+  };
+  fusain_create_temp_data_fields(&packet, 0x1, &full, FUSAIN_TEMP_DATA_OPTIONAL);
+  zassert_equal(fusain_decode_temp_data(&packet, &data),
+      FUSAIN_TEMP_DATA_OPTIONAL, "Wrong present mask");
+  zassert_true(data.rpm_control, "Wrong rpm_control");
+  zassert_equal(data.watched_motor, -3, "Wrong watched_motor");
+  zassert_true(data.target_temp == 200.25f, "Wrong target_temp");
+  fusain_create_temp_data_fields(&packet, 0x1, &full,
+      FUSAIN_TEMP_DATA_WATCHED_MOTOR);
+  zassert_equal(fusain_decode_temp_data(&packet, &data),
+      FUSAIN_TEMP_DATA_WATCHED_MOTOR, "Absent fields should not be reported");
+  zassert_false(data.rpm_control, "Absent rpm_control should be cleared");
+}
+
+/* Test TEMP_DATA decode errors */
+ZTEST(fusain_decoding, test_temp_data_decode_errors)
+{
+  fusain_packet_t packet;
+  fusain_temp_data_t data;
+  int32_t centi;
+
+  zassert_equal(fusain_decode_temp_data(NULL, &data), -1, "NULL packet");
+  fusain_create_temp_data_centi(&packet, 0x1, 0, 0, 100);
+  zassert_equal(fusain_decode_temp_data(&packet, NULL), -1, "NULL output");
+  zassert_equal(fusain_read_temp_centi(&packet, NULL), -1, "NULL centi");
+  packet.msg_type = FUSAIN_MSG_MOTOR_DATA;
+  zassert_equal(fusain_decode_temp_data(&packet, &data), -1, "Wrong type");
+
+  const struct {
+    uint8_t cbor[20];
+    size_t length;
+    int decode;
+    int centi;
+  } cases[] = {
+    /* No timestamp */
+    { { 0x82, 0x18, 0x33, 0xA2, 0x00, 0x00, 0x06, 0x01 }, 8, -2, 0 },
+    /* Thermometer out of int8 range */
+    { { 0x82, 0x18, 0x33, 0xA3, 0x00, 0x18, 0x80, 0x01, 0x00, 0x06, 0x01 },
+        11, -3, 0 },
+    /* Timestamp out of uint32 range */
+    { { 0x82, 0x18, 0x33, 0xA3, 0x00, 0x00, 0x01, 0x1B, 0, 0, 0, 1, 0, 0, 0, 0,
+          0x06, 0x01 },
+        18, -3, 0 },
+    /* No reading in either form */
+    { { 0x82, 0x18, 0x33, 0xA2, 0x00, 0x00, 0x01, 0x00 }, 8, -2, -2 },
+    /* Fixed-point reading is not an integer */
+    { { 0x82, 0x18, 0x33, 0xA3, 0x00, 0x00, 0x01, 0x00, 0x06, 0xF5 }, 10, -3, -3 },
+    /* Fixed-point reading outside int32 */
+    { { 0x82, 0x18, 0x33, 0xA3, 0x00, 0x00, 0x01, 0x00, 0x06, 0x1A, 0x80, 0, 0,
+          0 },
+        14, 0, -3 },
+    /* rpm_control is not a bool */
+    { { 0x82, 0x18, 0x33, 0xA4, 0x00, 0x00, 0x01, 0x00, 0x06, 0x01, 0x03, 0x01 },
+        12, -3, 0 },
+    /* watched_motor outside int32 */
+    { { 0x82, 0x18, 0x33, 0xA4, 0x00, 0x00, 0x01, 0x00, 0x06, 0x01, 0x04, 0x1A,
+          0x80, 0, 0, 0 },
+        16, -3, 0 },
+    /* target_temp is not a float */
+    { { 0x82, 0x18, 0x33, 0xA4, 0x00, 0x00, 0x01, 0x00, 0x06, 0x01, 0x05, 0x01 },
+        12, -3, 0 },
+    /* Malformed map */
+    { { 0x82, 0x18, 0x33, 0xA3, 0x00 }, 5, -1, -1 },
+  };
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    make_raw_packet(&packet, cases[c].cbor, cases[c].length);
+    packet.msg_type = FUSAIN_MSG_TEMP_DATA;
+    zassert_equal(fusain_decode_temp_data(&packet, &data), cases[c].decode,
+        "Wrong decode result for case %zu", c);
+    zassert_equal(fusain_read_temp_centi(&packet, &centi), cases[c].centi,
+        "Wrong centi result for case %zu", c);
+  }
+}
+
+/* Test TELEMETRY_BATCH decode of foreign encodings and errors */
+ZTEST(fusain_decoding, test_telemetry_batch_decode)
+{
+  fusain_packet_t packet;
+  fusain_telemetry_batch_t batch;
+
+  /* Definite containers, f64 and negative values */
+  const uint8_t definite[] = { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x19, 0x01, 0x00,
+    0x01, 0x81, 0x84, 0x18, 0x34, 0x02, 0x0A, 0x9F, 0xFB, 0x40, 0x09, 0x21,
+    0xFB, 0x54, 0x44, 0x2D, 0x18, 0x3A, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF };
+  make_raw_packet(&packet, definite, sizeof(definite));
+  packet.msg_type = FUSAIN_MSG_TELEMETRY_BATCH;
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &batch), 0, "Decode failed");
+  zassert_equal(batch.base_timestamp, 256, "Wrong base");
+  zassert_equal(batch.count, 1, "Wrong count");
+  zassert_equal(batch.records[0].kind, FUSAIN_MSG_TEMP_DATA, "Wrong kind");
+  zassert_equal(batch.records[0].value_count, 2, "Wrong value count");
+  zassert_true(batch.records[0].values[0].is_float, "f64 should be float");
+  zassert_true(batch.records[0].values[0].as.f > 3.1415f
+          && batch.records[0].values[0].as.f < 3.1416f,
+      "Wrong f64 value");
+  zassert_equal(batch.records[0].values[1].as.i, INT32_MIN, "Wrong int value");
+
+  zassert_equal(fusain_decode_telemetry_batch(NULL, &batch), -1, "NULL packet");
+  zassert_equal(fusain_decode_telemetry_batch(&packet, NULL), -1, "NULL batch");
+  packet.msg_type = FUSAIN_MSG_TEMP_DATA;
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &batch), -1, "Wrong type");
+
+  const struct {
+    uint8_t cbor[24];
+    size_t length;
+    int ret;
+  } cases[] = {
+    { { 0x82, 0x18, 0x36, 0xA1, 0x01, 0x80 }, 6, -2 }, /* No base */
+    { { 0x82, 0x18, 0x36, 0xA1, 0x00, 0x1B, 0, 0, 0, 1, 0, 0, 0, 0 }, 14, -3 },
+    { { 0x82, 0x18, 0x36, 0xA1, 0x00, 0x00 }, 6, -2 }, /* No records */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0xA0 }, 8, -3 }, /* Map */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x9F }, 8, -1 }, /* No break */
+    /* Record is not a 4-array */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x83, 0, 0, 0 }, 12, -3 },
+    /* Record truncated */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81 }, 8, -1 },
+    /* Kind out of range */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0x19, 1, 0, 0, 0,
+          0x80 },
+        15, -3 },
+    /* dt truncated */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0x00, 0x00 }, 11, -1 },
+    /* Values is not an array */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0, 0x00 },
+        13, -3 },
+    /* Values truncated */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0 }, 12, -1 },
+    /* Value header truncated */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0, 0x81 },
+        13, -1 },
+    /* Value is a bool */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0, 0x81,
+          0xF5 },
+        14, -3 },
+    /* Value outside int32 */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0, 0x81,
+          0x1A, 0x80, 0, 0, 0 },
+        18, -3 },
+    /* Too many values */
+    { { 0x82, 0x18, 0x36, 0xA2, 0x00, 0x00, 0x01, 0x81, 0x84, 0, 0, 0, 0x87,
+          1, 2, 3, 4, 5, 6, 7 },
+        20, -3 },
+  };
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    make_raw_packet(&packet, cases[c].cbor, cases[c].length);
+    packet.msg_type = FUSAIN_MSG_TELEMETRY_BATCH;
+    zassert_equal(fusain_decode_telemetry_batch(&packet, &batch), cases[c].ret,
+        "Wrong result for case %zu", c);
+  }
+
+  /* More records than the typed batch holds */
+  uint8_t many[8 + 6 * (FUSAIN_BATCH_MAX_RECORDS + 1) + 2] = { 0x82, 0x18,
+    0x36, 0xBF, 0x00, 0x00, 0x01, 0x9F };
+  size_t n = 8;
+  for (int r = 0; r <= FUSAIN_BATCH_MAX_RECORDS; r++) {
+    const uint8_t record[] = { 0x84, 0x18, 0x33, 0x00, 0x00, 0x80 };
+    memcpy(many + n, record, sizeof(record));
+    n += sizeof(record);
+  }
+  many[n++] = 0xFF;
+  many[n++] = 0xFF;
+  make_raw_packet(&packet, many, n);
+  packet.msg_type = FUSAIN_MSG_TELEMETRY_BATCH;
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &batch), -3,
+      "Too many records");
+}
+
+/* Broadcast and group address acceptance */
+ZTEST(fusain_decoding, test_address_filter)
+{
+  fusain_address_filter_t filter;
+  fusain_filter_init(&filter, 0x1234);
+
+  zassert_true(fusain_filter_accepts(&filter, 0x1234), "Own address");
+  zassert_true(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_BROADCAST), "Broadcast");
+  zassert_false(fusain_filter_accepts(&filter, 0x1235), "Other device");
+  zassert_false(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_GROUP(3)),
+      "Group not joined");
+  zassert_false(fusain_filter_accepts(&filter, 0x00000000000000FFULL),
+      "Low byte alone does not make a group address");
+
+  fusain_filter_join(&filter, 3);
+  fusain_filter_join(&filter, 254);
+  zassert_true(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_GROUP(3)), "Group 3");
+  zassert_true(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_GROUP(254)), "Group 254");
+  zassert_false(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_GROUP(35)),
+      "Same bit, other word");
+
+  fusain_filter_leave(&filter, 3);
+  fusain_filter_leave(&filter, 255);
+  zassert_false(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_GROUP(3)), "Left group 3");
+  zassert_true(fusain_filter_accepts(&filter, FUSAIN_ADDRESS_BROADCAST),
+      "Broadcast cannot be left");
+
+  zassert_true(FUSAIN_ADDRESS_IS_MULTICAST(FUSAIN_ADDRESS_GROUP(0)), "Group 0");
+  zassert_true(FUSAIN_ADDRESS_IS_MULTICAST(FUSAIN_ADDRESS_BROADCAST), "Broadcast");
+  zassert_false(FUSAIN_ADDRESS_IS_MULTICAST(FUSAIN_ADDRESS_GROUP_BASE - 1),
+      "Below the reserved range");
+}
+
+/* Decoders with a filter drop frames for other devices at the address */
+ZTEST(fusain_decoding, test_decoder_address_filter)
+{
+  const uint64_t addresses[] = { 0x5678, 0x1234, FUSAIN_ADDRESS_BROADCAST,
+    FUSAIN_ADDRESS_GROUP(7), FUSAIN_ADDRESS_GROUP(8) };
+  const fusain_decode_result_t expected[] = { FUSAIN_DECODE_NOT_ADDRESSED,
+    FUSAIN_DECODE_OK, FUSAIN_DECODE_OK, FUSAIN_DECODE_OK,
+    FUSAIN_DECODE_NOT_ADDRESSED };
+
+  fusain_address_filter_t filter;
+  fusain_filter_init(&filter, 0x1234);
+  fusain_filter_join(&filter, 7);
+
+  for (int cobs = 0; cobs < 2; cobs++) {
+    fusain_decoder_t decoder;
+    fusain_reset_decoder(&decoder);
+    if (cobs) {
+      fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_COBS);
+    }
+    fusain_decoder_set_filter(&decoder, &filter);
+
+    for (size_t i = 0; i < sizeof(addresses) / sizeof(addresses[0]); i++) {
+      fusain_packet_t tx;
+      fusain_packet_t rx;
+      uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+      fusain_create_state_command(&tx, addresses[i], FUSAIN_MODE_EMERGENCY, 0);
+      int len = cobs ? fusain_encode_packet_cobs(&tx, frame, sizeof(frame))
+                     : fusain_encode_packet(&tx, frame, sizeof(frame));
+
+      /* Exactly one final result per frame; dropped frames stop early */
+      int results = 0;
+      fusain_decode_result_t result = FUSAIN_DECODE_INCOMPLETE;
+      for (int b = 0; b < len; b++) {
+        fusain_decode_result_t r = fusain_decode_byte(frame[b], &rx, &decoder);
+        if (r != FUSAIN_DECODE_INCOMPLETE) {
+          result = r;
+          results++;
+        }
+      }
+      zassert_equal(results, 1, "One result per frame (%zu)", i);
+      zassert_equal(result, expected[i], "Address %zu (cobs %d)", i, cobs);
+      if (result == FUSAIN_DECODE_OK) {
+        zassert_equal(rx.address, addresses[i], "Address should match");
+      }
+    }
+
+    /* Error recovery keeps the filter */
+    fusain_packet_t tx;
+    fusain_packet_t rx;
+    uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+    fusain_create_ping_request(&tx, 0x5678);
+    int len = cobs ? fusain_encode_packet_cobs(&tx, frame, sizeof(frame))
+                   : fusain_encode_packet(&tx, frame, sizeof(frame));
+    fusain_decoder_resync(&decoder);
+    fusain_decode_result_t result = FUSAIN_DECODE_INCOMPLETE;
+    for (int b = 0; b < len && result == FUSAIN_DECODE_INCOMPLETE; b++) {
+      result = fusain_decode_byte(frame[b], &rx, &decoder);
+    }
+    zassert_equal(result, FUSAIN_DECODE_NOT_ADDRESSED, "Still filtered (cobs %d)", cobs);
+
+    /* Reset removes it */
+    fusain_reset_decoder(&decoder);
+    len = fusain_encode_packet(&tx, frame, sizeof(frame));
+    result = FUSAIN_DECODE_INCOMPLETE;
+    for (int b = 0; b < len; b++) {
+      result = fusain_decode_byte(frame[b], &rx, &decoder);
+    }
+    zassert_equal(result, FUSAIN_DECODE_OK, "Unfiltered decoder accepts all");
+  }
+}
+
 ZTEST_SUITE(fusain_decoding, NULL, NULL, NULL, NULL, NULL);
@@ -318,5 +318,868 @@ ZTEST(fusain_encoding, test_stuff_byte_escape_boundary)
   zassert_true(len < 0, "Should fail when escape needs 2 bytes but only 1 left");
 }
 
+/* Build the five-frame telemetry burst used by the batch tests */
+static void create_telemetry_burst(fusain_packet_t packets[5])
+{
+  fusain_create_state_data(&packets[0], 0x1234, 0, 0, FUSAIN_STATE_HEATING, 1000);
+  fusain_create_motor_data(&packets[1], 0x1234, 0, 1000, 2500, 2600);
+  fusain_create_temp_data(&packets[2], 0x1234, 0, 1000, 215.5f);
+  fusain_create_pump_data(&packets[3], 0x1234, 0, 1000,
+      FUSAIN_PUMP_EVENT_CYCLE_START, 250);
+  fusain_create_glow_data(&packets[4], 0x1234, 0, 1000, true);
+}
+
+/* Test batch encoding produces the same frames as single encoding */
+ZTEST(fusain_encoding, test_encode_packets_batch)
+{
+  fusain_packet_t packets[5];
+  create_telemetry_burst(packets);
+
+  uint8_t buffer[FUSAIN_MAX_PACKET_SIZE * 10];
+  size_t offsets[5];
+  size_t encoded = 0;
+  int total = fusain_encode_packets(packets, 5, buffer, sizeof(buffer),
+      offsets, &encoded);
+
+  zassert_true(total > 0, "Batch encoding should succeed");
+  zassert_equal(encoded, 5, "All packets should be encoded");
+  zassert_equal(offsets[0], 0, "First frame should start at offset 0");
+
+  size_t expected_offset = 0;
+  for (int i = 0; i < 5; i++) {
+    uint8_t single[FUSAIN_MAX_PACKET_SIZE * 2];
+    int len = fusain_encode_packet(&packets[i], single, sizeof(single));
+    zassert_true(len > 0, "Single encoding should succeed");
+    zassert_equal(offsets[i], expected_offset, "Frame %d offset", i);
+    zassert_mem_equal(&buffer[offsets[i]], single, len,
+        "Frame %d should match single encoding", i);
+    expected_offset += (size_t)len;
+  }
+  zassert_equal((size_t)total, expected_offset, "Total should cover all frames");
+
+  /* The contiguous stream decodes back into five packets */
+  fusain_decoder_t decoder;
+  fusain_reset_decoder(&decoder);
+  fusain_packet_t rx_packet;
+  int decoded = 0;
+  for (int i = 0; i < total; i++) {
+    if (fusain_decode_byte(buffer[i], &rx_packet, &decoder) == FUSAIN_DECODE_OK) {
+      zassert_equal(rx_packet.msg_type, packets[decoded].msg_type,
+          "Decoded frame %d type should match", decoded);
+      decoded++;
+    }
+  }
+  zassert_equal(decoded, 5, "Stream should decode into 5 packets");
+}
+
+/* Test batch encoding reports partial progress when space runs out */
+ZTEST(fusain_encoding, test_encode_packets_partial)
+{
+  fusain_packet_t packets[5];
+  create_telemetry_burst(packets);
+
+  uint8_t single[FUSAIN_MAX_PACKET_SIZE * 2];
+  int len0 = fusain_encode_packet(&packets[0], single, sizeof(single));
+  int len1 = fusain_encode_packet(&packets[1], single, sizeof(single));
+
+  /* Room for the first two frames plus a few bytes, not the third */
+  uint8_t buffer[FUSAIN_MAX_PACKET_SIZE * 10];
+  size_t encoded = 0;
+  int total = fusain_encode_packets(packets, 5, buffer,
+      (size_t)(len0 + len1 + 5), NULL, &encoded);
+
+  zassert_equal(encoded, 2, "Only two frames should fit");
+  zassert_equal(total, len0 + len1, "Only complete frames are counted");
+
+  /* Exactly full buffer: the next frame fails cleanly */
+  total = fusain_encode_packets(packets, 5, buffer, (size_t)(len0 + len1),
+      NULL, &encoded);
+  zassert_equal(encoded, 2, "Exact fit should encode two frames");
+  zassert_equal(total, len0 + len1, "Exact fit total");
+}
+
+/* Test batch encoding argument and packet validation */
+ZTEST(fusain_encoding, test_encode_packets_errors)
+{
+  fusain_packet_t packets[5];
+  create_telemetry_burst(packets);
+  uint8_t buffer[FUSAIN_MAX_PACKET_SIZE * 4];
+  size_t encoded = 99;
+
+  zassert_equal(fusain_encode_packets(NULL, 3, buffer, sizeof(buffer), NULL,
+                    &encoded),
+      -1, "NULL packets should fail");
+  zassert_equal(fusain_encode_packets(packets, 3, NULL, sizeof(buffer), NULL,
+                    &encoded),
+      -1, "NULL buffer should fail");
+  zassert_equal(fusain_encode_packets(packets, 3, buffer, sizeof(buffer), NULL,
+                    NULL),
+      -1, "NULL encoded_count should fail");
+
+  /* Empty batch */
+  zassert_equal(fusain_encode_packets(packets, 0, buffer, sizeof(buffer), NULL,
+                    &encoded),
+      0, "Empty batch writes nothing");
+  zassert_equal(encoded, 0, "Empty batch encodes nothing");
+
+  /* Invalid length in the middle stops with -2 */
+  packets[1].length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_encode_packets(packets, 3, buffer, sizeof(buffer), NULL,
+                    &encoded),
+      -2, "Invalid packet should return -2");
+  zassert_equal(encoded, 1, "Frames before the invalid packet are kept");
+}
+
+/* Flatten scatter-gather segments into a contiguous buffer */
+static size_t flatten_iov(const fusain_span_t* iov, int count, uint8_t* out)
+{
+  size_t offset = 0;
+  for (int i = 0; i < count; i++) {
+    memcpy(out + offset, iov[i].data, iov[i].length);
+    offset += iov[i].length;
+  }
+  return offset;
+}
+
+/* Test scatter-gather encoding matches contiguous encoding */
+ZTEST(fusain_encoding, test_encode_iov_matches_contiguous)
+{
+  fusain_packet_t packets[3];
+  fusain_create_motor_data(&packets[0], 0x1234, 0, 1000, 2500, 2600);
+  fusain_create_device_announce(&packets[1], 0x7E7D7F01, 1, 1, 1, 1);
+  packets[2].address = 0x7F;
+  packets[2].length = 6;
+  memcpy(packets[2].payload, "\x7E\x7D\x41\x42\x7F\x7E", 6);
+
+  for (int p = 0; p < 3; p++) {
+    fusain_span_t iov[FUSAIN_IOV_MAX_SEGMENTS];
+    uint8_t side[FUSAIN_IOV_SIDE_BUFFER_SIZE];
+    size_t total = 0;
+    int count = fusain_encode_packet_iov(&packets[p], iov,
+        FUSAIN_IOV_MAX_SEGMENTS, side, sizeof(side), &total);
+    zassert_true(count > 0, "Packet %d: iov encoding should succeed", p);
+
+    uint8_t expected[FUSAIN_MAX_PACKET_SIZE * 2];
+    int len = fusain_encode_packet(&packets[p], expected, sizeof(expected));
+    uint8_t flat[FUSAIN_MAX_PACKET_SIZE * 2];
+    size_t flat_len = flatten_iov(iov, count, flat);
+
+    zassert_equal(flat_len, (size_t)len, "Packet %d: length should match", p);
+    zassert_equal(total, (size_t)len, "Packet %d: total_length should match", p);
+    zassert_mem_equal(flat, expected, len, "Packet %d: bytes should match", p);
+  }
+}
+
+/* Test escape-free payload is referenced in place */
+ZTEST(fusain_encoding, test_encode_iov_zero_copy)
+{
+  fusain_packet_t packet;
+  fusain_create_ping_response(&packet, 0x1234, 5000);
+
+  fusain_span_t iov[FUSAIN_IOV_MAX_SEGMENTS];
+  uint8_t side[FUSAIN_IOV_SIDE_BUFFER_SIZE];
+  int count = fusain_encode_packet_iov(&packet, iov, FUSAIN_IOV_MAX_SEGMENTS,
+      side, sizeof(side), NULL);
+
+  zassert_equal(count, 3, "Escape-free frame should use 3 segments");
+  zassert_true(iov[1].data == packet.payload, "Payload should not be copied");
+  zassert_equal(iov[1].length, packet.length, "Payload segment covers payload");
+  zassert_equal(iov[0].length + iov[2].length, 13,
+      "Side buffer holds only framing, address and CRC");
+}
+
+/* Test scatter-gather encoding error handling */
+ZTEST(fusain_encoding, test_encode_iov_errors)
+{
+  fusain_packet_t packet = {
+    .length = 3,
+    .address = 0,
+  };
+  memcpy(packet.payload, "AB\x7E", 3);
+  fusain_span_t iov[FUSAIN_IOV_MAX_SEGMENTS];
+  uint8_t side[FUSAIN_IOV_SIDE_BUFFER_SIZE];
+
+  zassert_equal(fusain_encode_packet_iov(NULL, iov, 4, side, sizeof(side), NULL),
+      -1, "NULL packet should fail");
+  zassert_equal(fusain_encode_packet_iov(&packet, NULL, 4, side, sizeof(side), NULL),
+      -1, "NULL iov should fail");
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 4, NULL, sizeof(side), NULL),
+      -1, "NULL side buffer should fail");
+
+  /* Side buffer too small for the header */
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 4, side, 5, NULL), -4,
+      "Small side buffer should fail");
+
+  /* No room for the first segment */
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 0, side, sizeof(side), NULL),
+      -3, "Zero segments should fail");
+
+  /* Room for header only: run before the escape does not fit */
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 1, side, sizeof(side), NULL),
+      -3, "Run before escape should fail");
+
+  /* Room for header and run: escape pair does not fit */
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 2, side, sizeof(side), NULL),
+      -3, "Escape segment should fail");
+
+  /* Trailing run does not fit */
+  memcpy(packet.payload, "ABC", 3);
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 1, side, sizeof(side), NULL),
+      -3, "Trailing run should fail");
+
+  /* Side buffer runs out in the trailer */
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 4, side, 12, NULL), -4,
+      "Side buffer without room for END should fail");
+
+  packet.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_encode_packet_iov(&packet, iov, 4, side, sizeof(side), NULL),
+      -2, "Oversized payload should fail");
+}
+
+/* Re-addressed copies of an encoded frame */
+ZTEST(fusain_encoding, test_retarget_matches_encode)
+{
+  const uint64_t addresses[] = { 0, 0x1234, 0x7E7D7F7E7D7F7E7DULL,
+    0xFFFFFFFFFFFFFFFFULL, 0x0123456789ABCDEFULL };
+  fusain_packet_t templates[3];
+  fusain_create_state_command(&templates[0], 0x7E, FUSAIN_MODE_HEAT, 3);
+  fusain_create_telemetry_config(&templates[1], 0xAA, true, 125);
+  fusain_create_ping_request(&templates[2], 0x1);
+
+  for (int t = 0; t < 3; t++) {
+    uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+    int frame_len = fusain_encode_packet(&templates[t], frame, sizeof(frame));
+    fusain_retarget_t retarget;
+    zassert_equal(fusain_retarget_init(&retarget, frame, frame_len), 0,
+        "Template %d should be accepted", t);
+
+    for (size_t i = 0; i < sizeof(addresses) / sizeof(addresses[0]); i++) {
+      fusain_packet_t packet = templates[t];
+      packet.address = addresses[i];
+      uint8_t expected[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+      uint8_t copy[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+      int expected_len = fusain_encode_packet(&packet, expected, sizeof(expected));
+      int len = fusain_retarget_frame(&retarget, addresses[i], copy, sizeof(copy));
+      zassert_equal(len, expected_len, "Length mismatch (template %d, %zu)", t, i);
+      zassert_mem_equal(copy, expected, len, "Bytes mismatch (template %d, %zu)",
+          t, i);
+      zassert_equal(fusain_retarget_frame(&retarget, addresses[i], copy, len), len,
+          "Exact-size buffer should fit");
+    }
+  }
+}
+
+ZTEST(fusain_encoding, test_retarget_rejects)
+{
+  fusain_packet_t packet;
+  fusain_retarget_t retarget;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t bad[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t copy[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+  /* Payload with an escaped byte so its stuffed length differs */
+  fusain_create_state_command(&packet, 0x1234, FUSAIN_MODE_HEAT, 0x7E);
+  int len = fusain_encode_packet(&packet, frame, sizeof(frame));
+  zassert_true(len > (int)packet.length + 13, "Expected an escape in the payload");
+
+  zassert_equal(fusain_retarget_init(NULL, frame, len), -1, "NULL state");
+  zassert_equal(fusain_retarget_init(&retarget, NULL, len), -1, "NULL frame");
+  zassert_equal(fusain_retarget_init(&retarget, frame, 12), -2, "Too short");
+
+  memcpy(bad, frame, len);
+  bad[0] = 0x00;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2, "No START");
+  memcpy(bad, frame, len);
+  bad[len - 1] = 0x00;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2, "No END");
+  memcpy(bad, frame, len);
+  bad[1] = FUSAIN_LENGTH_ALIAS_FLAG | packet.length;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2, "Short address");
+  memcpy(bad, frame, len);
+  bad[3] = FUSAIN_END_BYTE;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2, "Raw END inside");
+  memcpy(bad, frame, len);
+  bad[1] = packet.length + 3;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2,
+      "LENGTH past the frame");
+  memcpy(bad, frame, len);
+  bad[1] = packet.length - 1;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2,
+      "LENGTH short of the frame");
+  memcpy(bad, frame, len);
+  bad[1] = packet.length + 2;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2,
+      "LENGTH covering the CRC");
+  memcpy(bad, frame, len);
+  bad[len - 2] = FUSAIN_ESC_BYTE;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -2,
+      "Escape before END");
+  memcpy(bad, frame, len);
+  bad[5] ^= 0x01;
+  zassert_equal(fusain_retarget_init(&retarget, bad, len), -3, "CRC mismatch");
+
+  /* Output buffer runs out at each stage */
+  zassert_equal(fusain_retarget_init(&retarget, frame, len), 0, "Init failed");
+  const uint64_t escaped = 0x7E7E7E7E7E7E7E7EULL;
+  int full = fusain_retarget_frame(&retarget, escaped, copy, sizeof(copy));
+  zassert_true(full > len, "Escaped address should grow the frame");
+  zassert_equal(fusain_retarget_frame(NULL, escaped, copy, sizeof(copy)), -1,
+      "NULL state");
+  zassert_equal(fusain_retarget_frame(&retarget, escaped, NULL, sizeof(copy)), -1,
+      "NULL buffer");
+  for (int size = 0; size < full; size++) {
+    zassert_equal(fusain_retarget_frame(&retarget, escaped, copy, size), -1,
+        "%d-byte buffer should fail", size);
+  }
+}
+
+/* Short address alias sessions */
+static fusain_decode_result_t decode_frame(const uint8_t* frame, int length,
+    fusain_decoder_t* decoder, fusain_packet_t* packet)
+{
+  fusain_decode_result_t result = FUSAIN_DECODE_INCOMPLETE;
+  for (int i = 0; i < length; i++) {
+    result = fusain_decode_byte(frame[i], packet, decoder);
+  }
+  return result;
+}
+
+ZTEST(fusain_encoding, test_alias_handshake)
+{
+  const uint64_t appliance_addr = 0x0123456789ABCDEFULL;
+  fusain_alias_t controller = { 0 };
+  fusain_alias_t appliance = { 0 };
+  fusain_decoder_t controller_rx;
+  fusain_decoder_t appliance_rx;
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+  fusain_reset_decoder(&controller_rx);
+  fusain_reset_decoder(&appliance_rx);
+  fusain_decoder_set_alias(&controller_rx, &controller);
+  fusain_decoder_set_alias(&appliance_rx, &appliance);
+
+  /* Controller proposes; it keeps sending full frames */
+  fusain_create_alias_config(&tx, appliance_addr, 0x7E);
+  zassert_true(tx.length <= FUSAIN_CBOR_SIZE_ALIAS_CONFIG, "Exceeds bound");
+  fusain_alias_propose(&controller, appliance_addr, 0x7E);
+  int len = fusain_encode_packet_alias(&tx, &controller, frame, sizeof(frame));
+  zassert_equal(frame[1], tx.length, "Proposed alias must not be used yet");
+  zassert_equal(decode_frame(frame, len, &appliance_rx, &rx), FUSAIN_DECODE_OK,
+      "ALIAS_CONFIG should decode");
+  zassert_equal(fusain_alias_accept(&appliance, &rx), 0, "Accept failed");
+  zassert_equal(appliance.state, FUSAIN_ALIAS_ACTIVE, "Appliance should be active");
+  zassert_equal(appliance.address, appliance_addr, "Wrong session address");
+
+  /* Appliance answers in the short form (alias 0x7E needs escaping) */
+  fusain_create_motor_data(&tx, appliance_addr, 0, 1000, 2500, 3000);
+  int full_len = fusain_encode_packet(&tx, frame, sizeof(frame));
+  len = fusain_encode_packet_alias(&tx, &appliance, frame, sizeof(frame));
+  zassert_equal(len, full_len - 6, "Short frame should drop 7 address bytes "
+                                   "and add one escape");
+  zassert_equal(frame[1], tx.length | FUSAIN_LENGTH_ALIAS_FLAG, "Missing flag");
+  zassert_equal(frame[2], FUSAIN_ESC_BYTE, "Alias should be escaped");
+  zassert_equal(decode_frame(frame, len, &controller_rx, &rx), FUSAIN_DECODE_OK,
+      "Short frame should decode");
+  zassert_equal(rx.address, appliance_addr, "Alias should expand");
+  zassert_equal(rx.length, tx.length, "Wrong length");
+  zassert_mem_equal(rx.payload, tx.payload, tx.length, "Wrong payload");
+  zassert_equal(controller.state, FUSAIN_ALIAS_ACTIVE,
+      "First short frame should confirm the alias");
+
+  /* Controller now sends short frames too, but only to that address */
+  fusain_create_ping_request(&tx, appliance_addr);
+  len = fusain_encode_packet_alias(&tx, &controller, frame, sizeof(frame));
+  zassert_true(frame[1] & FUSAIN_LENGTH_ALIAS_FLAG, "Controller should alias");
+  zassert_equal(decode_frame(frame, len, &appliance_rx, &rx), FUSAIN_DECODE_OK,
+      "Appliance should decode short frame");
+  zassert_equal(rx.address, appliance_addr, "Alias should expand");
+
+  /* The session survives error recovery */
+  frame[len - 3] ^= 0x01;
+  zassert_equal(decode_frame(frame, len, &appliance_rx, &rx), FUSAIN_DECODE_INVALID_CRC,
+      "Corrupt short frame");
+  fusain_decoder_resync(&appliance_rx);
+  frame[len - 3] ^= 0x01;
+  zassert_equal(decode_frame(frame, len, &appliance_rx, &rx), FUSAIN_DECODE_OK,
+      "Short frames still decode after a reset");
+  zassert_equal(rx.address, appliance_addr, "Alias should expand");
+
+  uint8_t plain[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_create_ping_request(&tx, 0x42);
+  len = fusain_encode_packet_alias(&tx, &controller, frame, sizeof(frame));
+  zassert_equal(len, fusain_encode_packet(&tx, plain, sizeof(plain)),
+      "Other addresses use full frames");
+  zassert_mem_equal(frame, plain, len, "Other addresses use full frames");
+  zassert_equal(fusain_encode_packet_alias(&tx, NULL, frame, sizeof(frame)), len,
+      "NULL session uses full frames");
+}
+
+ZTEST(fusain_encoding, test_alias_rejects)
+{
+  fusain_alias_t session;
+  fusain_decoder_t decoder;
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+  fusain_alias_propose(&session, 0x1234, 5);
+  session.state = FUSAIN_ALIAS_ACTIVE;
+  fusain_create_ping_request(&tx, 0x1234);
+  int len = fusain_encode_packet_alias(&tx, &session, frame, sizeof(frame));
+  zassert_true(len > 0, "Encode failed");
+
+  /* Decoders without a session keep rejecting flagged lengths */
+  fusain_reset_decoder(&decoder);
+  zassert_equal(decode_frame(frame, 2, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "No session should reject");
+
+  /* Session dropped */
+  fusain_alias_t other = session;
+  fusain_alias_reset(&other);
+  fusain_decoder_set_alias(&decoder, &other);
+  zassert_equal(decode_frame(frame, 2, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Dropped session should reject");
+
+  /* Alias mismatch */
+  other = session;
+  other.alias = 6;
+  zassert_equal(decode_frame(frame, len, &decoder, &rx),
+      FUSAIN_DECODE_UNKNOWN_ALIAS, "Unknown alias should be rejected");
+
+  /* Oversized flagged length */
+  const uint8_t bad_len[] = { FUSAIN_START_BYTE, 0x80 | 115 };
+  zassert_equal(decode_frame(bad_len, 2, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Flagged length > 114 should be rejected");
+
+  /* Short frames need less buffer, but not less than they use */
+  zassert_equal(fusain_encode_packet_alias(&tx, &session, frame, 6), -1,
+      "Tiny buffer should fail");
+  zassert_equal(fusain_encode_packet_alias(NULL, &session, frame, sizeof(frame)),
+      -1, "NULL packet should fail");
+  session.alias = FUSAIN_ESC_BYTE;
+  fusain_create_alias_config(&tx, 0x1234, 1);
+  tx.length = 0;
+  zassert_equal(fusain_encode_packet_alias(&tx, &session, frame, 7), 7,
+      "Empty short frame with escaped alias fits in 7 bytes");
+
+  /* accept() only takes a valid ALIAS_CONFIG */
+  zassert_equal(fusain_alias_accept(&session, NULL), -1, "NULL packet");
+  fusain_create_ping_request(&tx, 0x1234);
+  zassert_equal(fusain_alias_accept(&session, &tx), -1, "Wrong message type");
+  const uint8_t wide[] = { 0x82, 0x18, FUSAIN_MSG_ALIAS_CONFIG, 0xA1, 0x00, 0x19,
+    0x01, 0x00 };
+  memcpy(tx.payload, wide, sizeof(wide));
+  tx.length = sizeof(wide);
+  tx.msg_type = FUSAIN_MSG_ALIAS_CONFIG;
+  zassert_equal(fusain_alias_accept(&session, &tx), -1, "Alias > 255");
+  tx.length = 5;
+  zassert_equal(fusain_alias_accept(&session, &tx), -1, "Missing alias");
+}
+
+ZTEST(fusain_encoding, test_alias_extract)
+{
+  fusain_alias_t session;
+  fusain_extractor_t extractor;
+  fusain_frame_view_t view;
+  fusain_packet_t tx;
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t chunk[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  size_t consumed;
+
+  fusain_alias_propose(&session, 0x0123456789ABCDEFULL, 9);
+  fusain_create_motor_data(&tx, session.address, 0, 1000, 2500, 3000);
+  session.state = FUSAIN_ALIAS_ACTIVE;
+  int len = fusain_encode_packet_alias(&tx, &session, frame, sizeof(frame));
+  session.state = FUSAIN_ALIAS_PROPOSED;
+  fusain_reset_extractor(&extractor);
+
+  /* Without a session a short frame is rejected, as by the decoder */
+  memcpy(chunk, frame, (size_t)len);
+  zassert_equal(fusain_extract_frame(&extractor, chunk, (size_t)len, &view, &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "No session");
+  zassert_equal(consumed, (size_t)len, "Frame consumed");
+
+  /* With one it is expanded, also when split across chunks */
+  memcpy(chunk, frame, (size_t)len);
+  zassert_equal(fusain_extract_frame_alias(&extractor, &session, chunk, 5, &view, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "First part");
+  zassert_equal(fusain_extract_frame_alias(&extractor, &session, &chunk[5], (size_t)len - 5,
+                    &view, &consumed),
+      FUSAIN_DECODE_OK, "Short frame");
+  zassert_equal(view.address, session.address, "Alias should expand");
+  zassert_equal(view.msg_type, FUSAIN_MSG_MOTOR_DATA, "Type");
+  zassert_equal(view.length, tx.length, "Length");
+  zassert_mem_equal(view.payload, tx.payload, tx.length, "Payload");
+  zassert_equal(session.state, FUSAIN_ALIAS_ACTIVE, "Session confirmed");
+
+  /* Full frames are unaffected */
+  int full_len = fusain_encode_packet(&tx, chunk, sizeof(chunk));
+  zassert_equal(fusain_extract_frame_alias(&extractor, &session, chunk, (size_t)full_len,
+                    &view, &consumed),
+      FUSAIN_DECODE_OK, "Full frame");
+  zassert_equal(view.address, session.address, "Address");
+
+  /* Wrong alias, corrupted frame, dropped session */
+  fusain_alias_t other = session;
+  other.alias = 10;
+  memcpy(chunk, frame, (size_t)len);
+  zassert_equal(fusain_extract_frame_alias(&extractor, &other, chunk, (size_t)len, &view,
+                    &consumed),
+      FUSAIN_DECODE_UNKNOWN_ALIAS, "Unknown alias");
+  memcpy(chunk, frame, (size_t)len);
+  chunk[len - 3] ^= 0x01;
+  zassert_equal(fusain_extract_frame_alias(&extractor, &session, chunk, (size_t)len, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_CRC, "Bad CRC");
+  fusain_alias_reset(&other);
+  memcpy(chunk, frame, (size_t)len);
+  zassert_equal(fusain_extract_frame_alias(&extractor, &other, chunk, (size_t)len, &view,
+                    &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Dropped session");
+}
+
+/* Raw framing for reliable transports */
+ZTEST(fusain_encoding, test_raw_roundtrip)
+{
+  fusain_packet_t tx[3];
+  fusain_packet_t rx;
+  uint8_t stream[3 * FUSAIN_MAX_RAW_PACKET_SIZE];
+
+  for (int with_crc = 0; with_crc < 2; with_crc++) {
+    fusain_create_motor_data(&tx[0], 0x7E7D7F0000000001ULL, 0, 1200, 2500, 2600);
+    fusain_create_ping_request(&tx[1], 0x7E);
+    fusain_create_temp_data(&tx[2], 0xABCD, 0, 1000, 125.5f);
+
+    size_t total = 0;
+    for (int i = 0; i < 3; i++) {
+      int len = fusain_encode_packet_raw(&tx[i], with_crc, &stream[total],
+          sizeof(stream) - total);
+      zassert_equal(len, FUSAIN_RAW_FRAME_SIZE(tx[i].length, with_crc),
+          "Raw frames are never escaped");
+      zassert_equal(stream[total], tx[i].length, "LENGTH first");
+      zassert_mem_equal(&stream[total + 9], tx[i].payload, tx[i].length,
+          "Payload copied verbatim");
+      total += (size_t)len;
+    }
+
+    /* Feed the stream in two reads split inside the second frame */
+    size_t split = FUSAIN_RAW_FRAME_SIZE(tx[0].length, with_crc) + 5;
+    size_t offset = 0;
+    size_t consumed;
+    int decoded = 0;
+    for (size_t end = split; end <= total; end += total - split) {
+      while (fusain_decode_packet_raw(&stream[offset], end - offset, with_crc,
+                 &rx, &consumed)
+          == FUSAIN_DECODE_OK) {
+        zassert_equal(rx.address, tx[decoded].address, "Address mismatch");
+        zassert_equal(rx.msg_type, tx[decoded].msg_type, "Type mismatch");
+        zassert_equal(rx.length, tx[decoded].length, "Length mismatch");
+        zassert_mem_equal(rx.payload, tx[decoded].payload, rx.length,
+            "Payload mismatch");
+        offset += consumed;
+        decoded++;
+      }
+      zassert_equal(consumed, 0, "Partial frame is left for the next read");
+    }
+    zassert_equal(decoded, 3, "All frames should decode");
+    zassert_equal(offset, total, "Whole stream consumed");
+  }
+}
+
+ZTEST(fusain_encoding, test_raw_rejects)
+{
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t frame[FUSAIN_MAX_RAW_PACKET_SIZE];
+  size_t consumed;
+
+  fusain_create_ping_request(&tx, 0x1234);
+  int len = fusain_encode_packet_raw(&tx, true, frame, sizeof(frame));
+  zassert_true(len > 0, "Encode failed");
+
+  /* Encoder arguments */
+  zassert_equal(fusain_encode_packet_raw(NULL, true, frame, sizeof(frame)), -1,
+      "NULL packet should fail");
+  zassert_equal(fusain_encode_packet_raw(&tx, true, NULL, sizeof(frame)), -1,
+      "NULL buffer should fail");
+  zassert_equal(fusain_encode_packet_raw(&tx, true, frame, len - 1), -1,
+      "Short buffer should fail");
+  zassert_equal(fusain_encode_packet_raw(&tx, false, frame, len - 2), len - 2,
+      "No CRC needs 2 bytes less");
+  fusain_packet_t big = tx;
+  big.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_encode_packet_raw(&big, true, frame, sizeof(frame)), -2,
+      "Oversized payload should fail");
+
+  /* Empty read */
+  zassert_equal(fusain_decode_packet_raw(frame, 0, true, &rx, &consumed),
+      FUSAIN_DECODE_INCOMPLETE, "Nothing to decode");
+  zassert_equal(consumed, 0, "Nothing consumed");
+
+  /* Bad CRC drops just that frame */
+  fusain_encode_packet_raw(&tx, true, frame, sizeof(frame));
+  frame[len - 1] ^= 0x01;
+  zassert_equal(fusain_decode_packet_raw(frame, len, true, &rx, &consumed),
+      FUSAIN_DECODE_INVALID_CRC, "Bad CRC");
+  zassert_equal(consumed, (size_t)len, "Bad frame consumed");
+
+  /* Without a CRC, a bad CBOR header is still caught */
+  fusain_encode_packet_raw(&tx, false, frame, sizeof(frame));
+  frame[9] = 0xA0;
+  zassert_equal(fusain_decode_packet_raw(frame, len - 2, false, &rx, &consumed),
+      FUSAIN_DECODE_INVALID_START, "Bad CBOR header");
+  zassert_equal(consumed, (size_t)len - 2, "Bad frame consumed");
+
+  /* Unusable LENGTH (including the alias flag) gives up on the stream */
+  frame[0] = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_decode_packet_raw(frame, 20, false, &rx, &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "Oversized LENGTH");
+  zassert_equal(consumed, 20, "Stream cannot resync");
+  frame[0] = FUSAIN_LENGTH_ALIAS_FLAG | 4;
+  zassert_equal(fusain_decode_packet_raw(frame, 20, false, &rx, &consumed),
+      FUSAIN_DECODE_INVALID_LENGTH, "No aliases on raw links");
+}
+
+/* COBS framing */
+
+/* Reference COBS encoder (byte at a time) to cross-check the library */
+static size_t cobs_reference(const uint8_t* in, size_t length, uint8_t* out)
+{
+  size_t code_at = 0;
+  size_t o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[code_at] = code;
+      code_at = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      code++;
+    }
+  }
+  out[code_at] = code;
+  out[o++] = 0x00;
+  return o;
+}
+
+ZTEST(fusain_encoding, test_cobs_roundtrip)
+{
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t frame[FUSAIN_MAX_COBS_PACKET_SIZE];
+  uint8_t stuffed[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t expected[FUSAIN_MAX_COBS_PACKET_SIZE];
+
+  /* Address and RPM give the raw frame several zero bytes */
+  fusain_create_motor_data(&tx, 0x0000000000010200ULL, 0, 0, 0, 0);
+  int len = fusain_encode_packet_cobs(&tx, frame, sizeof(frame));
+  zassert_equal(len, FUSAIN_COBS_FRAME_SIZE(tx.length), "Fixed 2-byte overhead");
+  zassert_is_null(memchr(frame, 0x00, len - 1), "Only the delimiter is zero");
+  zassert_equal(frame[len - 1], FUSAIN_COBS_DELIMITER, "Delimiter last");
+
+  /* Same frame contents as the stuffed framing (no escapes here) */
+  int stuffed_len = fusain_encode_packet(&tx, stuffed, sizeof(stuffed));
+  zassert_equal(stuffed_len, tx.length + 13, "Expected an escape-free frame");
+  zassert_equal(cobs_reference(&stuffed[1], stuffed_len - 2, expected),
+      (size_t)len, "Reference length");
+  zassert_mem_equal(frame, expected, len, "Should match reference COBS");
+
+  /* Bulk decode */
+  zassert_equal(fusain_decode_cobs_frame(frame, len - 1, &rx), FUSAIN_DECODE_OK,
+      "Bulk decode failed");
+  zassert_equal(rx.address, tx.address, "Address mismatch");
+  zassert_equal(rx.msg_type, FUSAIN_MSG_MOTOR_DATA, "Type mismatch");
+  zassert_equal(rx.length, tx.length, "Length mismatch");
+  zassert_mem_equal(rx.payload, tx.payload, tx.length, "Payload mismatch");
+
+  /* Byte-wise decode, two frames back to back after a leading delimiter */
+  fusain_decoder_t decoder;
+  fusain_reset_decoder(&decoder);
+  fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_COBS);
+  zassert_equal(fusain_decode_byte(0x00, &rx, &decoder),
+      FUSAIN_DECODE_INCOMPLETE, "Empty frame is ignored");
+  for (int round = 0; round < 2; round++) {
+    memset(&rx, 0, sizeof(rx));
+    zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+        "Byte-wise decode failed");
+    zassert_equal(rx.address, tx.address, "Address mismatch");
+    zassert_mem_equal(rx.payload, tx.payload, tx.length, "Payload mismatch");
+  }
+
+  /* Switching back restores the stuffed framing */
+  fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_STUFFED);
+  zassert_equal(decode_frame(stuffed, stuffed_len, &decoder, &rx),
+      FUSAIN_DECODE_OK, "Stuffed decode after switching back");
+}
+
+ZTEST(fusain_encoding, test_cobs_worst_case_overhead)
+{
+  /* Every byte needs escaping in the stuffed framing */
+  fusain_packet_t tx = { .address = 0x7E7E7E7E7E7E7E7EULL };
+  tx.payload[0] = 0x82;
+  tx.payload[1] = 0x18;
+  memset(&tx.payload[2], FUSAIN_START_BYTE, FUSAIN_MAX_PAYLOAD_SIZE - 2);
+  for (int i = 3; i < FUSAIN_MAX_PAYLOAD_SIZE; i += 2) {
+    tx.payload[i] = 0x00; /* Worst case for COBS is still one code byte */
+  }
+  tx.length = FUSAIN_MAX_PAYLOAD_SIZE;
+
+  uint8_t stuffed[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t frame[FUSAIN_MAX_COBS_PACKET_SIZE];
+  int stuffed_len = fusain_encode_packet(&tx, stuffed, sizeof(stuffed));
+  int len = fusain_encode_packet_cobs(&tx, frame, sizeof(frame));
+  zassert_true(stuffed_len > 180, "Stuffed frame should nearly double");
+  zassert_equal(len, FUSAIN_MAX_COBS_PACKET_SIZE, "COBS overhead stays at 2");
+  zassert_true(FUSAIN_MAX_COBS_PACKET_SIZE <= FUSAIN_MAX_PACKET_SIZE,
+      "Worst-case COBS frame fits a packet");
+
+  fusain_packet_t rx;
+  zassert_equal(fusain_decode_cobs_frame(frame, len - 1, &rx), FUSAIN_DECODE_OK,
+      "Decode failed");
+  zassert_equal(rx.address, tx.address, "Address mismatch");
+  zassert_mem_equal(rx.payload, tx.payload, tx.length, "Payload mismatch");
+}
+
+ZTEST(fusain_encoding, test_cobs_rejects)
+{
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  fusain_decoder_t decoder;
+  uint8_t frame[FUSAIN_MAX_COBS_PACKET_SIZE];
+
+  fusain_create_ping_request(&tx, 0x1234);
+  int len = fusain_encode_packet_cobs(&tx, frame, sizeof(frame));
+  zassert_true(len > 0, "Encode failed");
+
+  /* Encoder arguments */
+  zassert_equal(fusain_encode_packet_cobs(NULL, frame, sizeof(frame)), -1,
+      "NULL packet should fail");
+  zassert_equal(fusain_encode_packet_cobs(&tx, NULL, sizeof(frame)), -1,
+      "NULL buffer should fail");
+  zassert_equal(fusain_encode_packet_cobs(&tx, frame, len - 1), -1,
+      "Short buffer should fail");
+  fusain_packet_t big = tx;
+  big.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_encode_packet_cobs(&big, frame, sizeof(frame)), -2,
+      "Oversized payload should fail");
+
+  /* Malformed frames */
+  zassert_equal(fusain_decode_cobs_frame(frame, 0, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Empty frame");
+  const uint8_t overrun[] = { 0x05, 0x01, 0x02 };
+  zassert_equal(fusain_decode_cobs_frame(overrun, sizeof(overrun), &rx),
+      FUSAIN_DECODE_INVALID_START, "Code past end of frame");
+  const uint8_t zero_code[] = { 0x02, 0x01, 0x00, 0x01 };
+  zassert_equal(fusain_decode_cobs_frame(zero_code, sizeof(zero_code), &rx),
+      FUSAIN_DECODE_INVALID_START, "Zero code byte");
+  uint8_t long_frame[300];
+  memset(long_frame, 0x01, sizeof(long_frame));
+  long_frame[0] = 0xFF;
+  zassert_equal(fusain_decode_cobs_frame(long_frame, 255, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Run longer than a packet");
+  zassert_equal(fusain_decode_cobs_frame(long_frame + 1, 150, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Implied zeros past a packet");
+  zassert_equal(fusain_decode_cobs_frame(long_frame + 1, 20, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "LENGTH disagrees with frame size");
+
+  uint8_t corrupt[FUSAIN_MAX_COBS_PACKET_SIZE];
+  memcpy(corrupt, frame, len);
+  corrupt[len - 2] ^= 0x01;
+  zassert_equal(fusain_decode_cobs_frame(corrupt, len - 1, &rx),
+      FUSAIN_DECODE_INVALID_CRC, "Bad CRC");
+
+  /* Byte-wise: overflow drops the frame until the next delimiter */
+  fusain_reset_decoder(&decoder);
+  fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_COBS);
+  zassert_equal(decode_frame(long_frame, 129, &decoder, &rx),
+      FUSAIN_DECODE_BUFFER_OVERFLOW, "Overflow reported");
+  zassert_equal(decode_frame(long_frame, 10, &decoder, &rx),
+      FUSAIN_DECODE_INCOMPLETE, "Rest of the frame dropped");
+  zassert_equal(fusain_decode_byte(0x00, &rx, &decoder),
+      FUSAIN_DECODE_INCOMPLETE, "Dropped frame not decoded");
+  zassert_equal(decode_frame(corrupt, len, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_CRC, "Corrupt frame reported");
+  zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+      "Next frame decodes");
+
+  /* The README's error recovery keeps the framing */
+  zassert_equal(decode_frame(corrupt, len, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_CRC, "Corrupt frame reported");
+  fusain_decoder_resync(&decoder);
+  zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+      "Still COBS after a resync");
+  zassert_equal(decode_frame(long_frame, 10, &decoder, &rx),
+      FUSAIN_DECODE_INCOMPLETE, "Frame cut off");
+  fusain_decoder_resync(&decoder);
+  zassert_equal(decode_frame(long_frame, 10, &decoder, &rx),
+      FUSAIN_DECODE_INCOMPLETE, "Rest of it");
+  zassert_equal(fusain_decode_byte(0x00, &rx, &decoder), FUSAIN_DECODE_INVALID_START,
+      "Cut-off frame rejected");
+  fusain_decoder_resync(&decoder);
+  zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+      "Next frame decodes");
+
+  /* A full reset returns to byte stuffing */
+  fusain_reset_decoder(&decoder);
+  len = fusain_encode_packet(&tx, frame, sizeof(frame));
+  zassert_true(len > 0, "Encode failed");
+  zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+      "Stuffed frame decodes after a reset");
+}
+
+ZTEST(fusain_encoding, test_cobs_alias)
+{
+  fusain_alias_t session;
+  fusain_decoder_t decoder;
+  fusain_packet_t tx;
+  fusain_packet_t rx;
+  uint8_t stuffed[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t frame[FUSAIN_MAX_COBS_PACKET_SIZE];
+
+  /* Short-address frame contents, wrapped with the reference encoder */
+  fusain_alias_propose(&session, 0xABCDEF, 10);
+  session.state = FUSAIN_ALIAS_ACTIVE;
+  fusain_create_ping_request(&tx, 0xABCDEF);
+  int stuffed_len = fusain_encode_packet_alias(&tx, &session, stuffed,
+      sizeof(stuffed));
+  zassert_equal(stuffed_len, tx.length + 6, "Expected an escape-free frame");
+  size_t len = cobs_reference(&stuffed[1], stuffed_len - 2, frame);
+
+  fusain_reset_decoder(&decoder);
+  fusain_decoder_set_framing(&decoder, FUSAIN_FRAMING_COBS);
+  zassert_equal(decode_frame(frame, len, &decoder, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "No session should reject");
+
+  session.state = FUSAIN_ALIAS_PROPOSED;
+  fusain_decoder_set_alias(&decoder, &session);
+  zassert_equal(decode_frame(frame, len, &decoder, &rx), FUSAIN_DECODE_OK,
+      "Short frame should decode");
+  zassert_equal(rx.address, 0xABCDEF, "Alias should expand");
+  zassert_equal(session.state, FUSAIN_ALIAS_ACTIVE, "Session confirmed");
+
+  session.alias = 11;
+  zassert_equal(decode_frame(frame, len, &decoder, &rx),
+      FUSAIN_DECODE_UNKNOWN_ALIAS, "Unknown alias should be rejected");
+
+  /* Bulk decode never has a session */
+  zassert_equal(fusain_decode_cobs_frame(frame, len - 1, &rx),
+      FUSAIN_DECODE_INVALID_LENGTH, "Bulk decode takes full addresses only");
+
+  /* Valid COBS and CRC, but not a CBOR [type, ...] payload */
+  const uint8_t raw[] = { 0x01, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x01, 0x00, 0x00 };
+  uint8_t bad[sizeof(raw)];
+  memcpy(bad, raw, sizeof(raw));
+  uint16_t crc = fusain_crc16(bad, 10);
+  bad[10] = crc >> 8;
+  bad[11] = crc & 0xFF;
+  len = cobs_reference(bad, sizeof(bad), frame);
+  zassert_equal(fusain_decode_cobs_frame(frame, len - 1, &rx),
+      FUSAIN_DECODE_INVALID_START, "Bad CBOR header");
+}
+
 /* Test suite setup */
 ZTEST_SUITE(fusain_encoding, NULL, NULL, NULL, NULL, NULL);
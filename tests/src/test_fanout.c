@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Subscription Fan-out Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+#define HEATER 0x0102030405060708ULL
+#define OTHER_HEATER 0x1112131415161718ULL
+
+static fusain_frame_t fanout_frames[4];
+static fusain_frame_pool_t fanout_pool;
+static fusain_fanout_topic_t fanout_topics[4];
+static fusain_subscription_t fanout_subs[6];
+static fusain_fanout_t fanout;
+
+/* Recorded TX queue: one entry per queued frame */
+static struct {
+  fusain_subscriber_t* subscriber;
+  fusain_frame_t* frame;
+} sent[16];
+static int sent_count;
+
+static int test_send(fusain_subscriber_t* subscriber, fusain_frame_t* frame)
+{
+  if (subscriber->user != NULL) {
+    return -1; /* Queue full */
+  }
+  sent[sent_count].subscriber = subscriber;
+  sent[sent_count].frame = frame;
+  sent_count++;
+  return 0;
+}
+
+/* The TX queues finish sending everything */
+static void drain_sent(void)
+{
+  for (int i = 0; i < sent_count; i++) {
+    fusain_frame_unref(sent[i].frame);
+  }
+  sent_count = 0;
+}
+
+static void fanout_setup(void)
+{
+  fusain_frame_pool_init(&fanout_pool, fanout_frames, 4);
+  zassert_equal(fusain_fanout_init(&fanout, &fanout_pool, fanout_topics, 4, fanout_subs, 6,
+                    test_send),
+      0, "Init");
+  sent_count = 0;
+}
+
+/* Test frame allocation and reference counting */
+ZTEST(fusain_fanout, test_frame_pool)
+{
+  fusain_frame_t* frames[4];
+
+  fusain_frame_pool_init(&fanout_pool, fanout_frames, 4);
+  for (int i = 0; i < 4; i++) {
+    frames[i] = fusain_frame_alloc(&fanout_pool);
+    zassert_not_null(frames[i], "Frame %d", i);
+    zassert_equal(frames[i]->refs, 1, "One owner");
+  }
+  zassert_is_null(fusain_frame_alloc(&fanout_pool), "Pool empty");
+
+  fusain_frame_ref(frames[2]);
+  zassert_false(fusain_frame_unref(frames[2]), "Still shared");
+  zassert_is_null(fusain_frame_alloc(&fanout_pool), "Still in use");
+  zassert_true(fusain_frame_unref(frames[2]), "Last reference");
+  zassert_equal_ptr(fusain_frame_alloc(&fanout_pool), frames[2], "Reused");
+}
+
+/* Test subscribing by message, encode-once delivery and unsubscribing */
+ZTEST(fusain_fanout, test_fanout_publish)
+{
+  fusain_subscriber_t dashboard = { 0 };
+  fusain_subscriber_t logger = { 0 };
+  fusain_packet_t packet;
+
+  zassert_equal(fusain_fanout_init(&fanout, &fanout_pool, fanout_topics, 3, fanout_subs, 6,
+                    test_send),
+      -1, "Not a power of two");
+  zassert_equal(fusain_fanout_init(&fanout, &fanout_pool, fanout_topics, 4, fanout_subs, 6,
+                    NULL),
+      -1, "No send");
+  fanout_setup();
+
+  fusain_create_data_subscription(&packet, 0, HEATER);
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), 0, "Dashboard");
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), 0, "Again: no-op");
+  zassert_equal(fusain_fanout_handle(&fanout, &logger, &packet), 0, "Logger");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &logger, OTHER_HEATER, NULL), 0, "Other heater");
+
+  uint8_t expected[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  int length = fusain_encode_packet(&packet, expected, sizeof(expected));
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 2, "Two subscribers");
+  zassert_equal(sent_count, 2, "Two queued");
+  zassert_equal_ptr(sent[0].frame, sent[1].frame, "One shared frame");
+  zassert_not_equal(sent[0].subscriber, sent[1].subscriber, "Both subscribers");
+  zassert_equal(sent[0].frame->refs, 2, "One reference per queue");
+  zassert_equal(sent[0].frame->length, length, "Length");
+  zassert_mem_equal(sent[0].frame->data, expected, (size_t)length, "Encoded frame");
+  drain_sent();
+  zassert_equal(fanout_frames[0].refs, 0, "Released after sending");
+
+  fusain_create_temp_data(&packet, OTHER_HEATER, 0, 1000, 21.5f);
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 1, "Logger only");
+  zassert_equal_ptr(sent[0].subscriber, &logger, "Logger");
+  drain_sent();
+
+  fusain_create_temp_data(&packet, 0x77, 0, 1000, 21.5f);
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 0, "Nobody subscribed");
+
+  fusain_create_data_unsubscribe(&packet, 0, HEATER);
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), 0, "Unsubscribed");
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), -1, "Not subscribed");
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 1, "Logger left");
+  zassert_equal_ptr(sent[0].subscriber, &logger, "Logger");
+  drain_sent();
+
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), 1, "Not a subscription");
+  fusain_create_state_data(&packet, 0, 0, FUSAIN_ERROR_NONE, FUSAIN_STATE_IDLE, 5);
+  packet.msg_type = FUSAIN_MSG_DATA_SUBSCRIPTION; /* Key 0 is a bool, not an address */
+  zassert_equal(fusain_fanout_handle(&fanout, &dashboard, &packet), -3, "Malformed");
+}
+
+/* Test dropping a subscriber and unlinking from the middle of lists */
+ZTEST(fusain_fanout, test_fanout_drop)
+{
+  fusain_subscriber_t a = { 0 };
+  fusain_subscriber_t b = { 0 };
+  fusain_subscriber_t c = { 0 };
+  fusain_packet_t packet;
+  fanout_setup();
+
+  zassert_equal(fusain_fanout_subscribe(&fanout, &a, HEATER, NULL), 0, "a");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, HEATER, NULL), 0, "b");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &c, HEATER, NULL), 0, "c");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, OTHER_HEATER, NULL), 0, "b other");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, 0x77, NULL), 0, "b third");
+
+  zassert_equal(fusain_fanout_unsubscribe(&fanout, &b, OTHER_HEATER), 0, "Middle of b's list");
+  zassert_equal(fusain_fanout_drop(&fanout, &b), 2, "b's two left");
+
+  /* Release by handle, the same one a repeated subscribe hands back */
+  fusain_subscription_t* handle = NULL;
+  fusain_subscription_t* again = NULL;
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, OTHER_HEATER, &handle), 0, "Handle");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, OTHER_HEATER, &again), 0, "No-op");
+  zassert_equal_ptr(handle, again, "Same subscription");
+  fusain_fanout_release(&fanout, handle);
+  zassert_is_null(b.subscriptions, "Released");
+  zassert_equal(fusain_fanout_unsubscribe(&fanout, &b, OTHER_HEATER), -1, "Gone");
+  zassert_is_null(b.subscriptions, "b empty");
+  zassert_equal(fusain_fanout_drop(&fanout, &b), 0, "Nothing left");
+
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 2, "a and c");
+  zassert_true(sent[0].subscriber != &b && sent[1].subscriber != &b, "Not b");
+  drain_sent();
+
+  /* Released subscriptions are reusable: 6 in the pool, 2 held by a and c */
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, HEATER, NULL), 0, "Reuse");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, OTHER_HEATER, NULL), 0, "Reuse");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &b, 0x77, NULL), 0, "Reuse");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &c, OTHER_HEATER, NULL), 0, "Reuse");
+  zassert_equal(fusain_fanout_subscribe(&fanout, &a, 0x77, NULL), -2, "Out of subscriptions");
+}
+
+/* Test frame exhaustion, refused queues, encoding errors and raw frames */
+ZTEST(fusain_fanout, test_fanout_limits)
+{
+  fusain_subscriber_t ok = { 0 };
+  fusain_subscriber_t full = { .user = &ok };
+  fusain_packet_t packet;
+  fanout_setup();
+
+  for (uint64_t appliance = 0; appliance < 4; appliance++) {
+    zassert_equal(fusain_fanout_subscribe(&fanout, &ok, 100 + appliance, NULL), 0, "Topic");
+  }
+  zassert_equal(fusain_fanout_subscribe(&fanout, &ok, 200, NULL), -2, "Out of appliance slots");
+
+  zassert_equal(fusain_fanout_subscribe(&fanout, &full, 100, NULL), 0, "Full queue");
+  fusain_create_temp_data(&packet, 100, 0, 1000, 21.5f);
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), 1, "Queue full skipped");
+  zassert_equal(sent[0].frame->refs, 1, "Only the queued copy");
+
+  for (int i = 0; i < 3; i++) {
+    zassert_equal(fusain_fanout_publish(&fanout, &packet), 1, "Frame %d", i);
+  }
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), -2, "No free frame");
+  drain_sent();
+
+  packet.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_fanout_publish(&fanout, &packet), -1, "Cannot encode");
+  zassert_not_null(fusain_frame_alloc(&fanout_pool), "Frame returned");
+
+  fusain_frame_t* frame = fusain_frame_alloc(&fanout_pool);
+  zassert_not_null(frame, "Frame");
+  memcpy(frame->data, "\x7E\x01\x7F", 3);
+  frame->length = 3;
+  zassert_equal(fusain_fanout_publish_frame(&fanout, 101, frame), 1, "Raw frame");
+  zassert_equal(sent[0].frame->length, 3, "As given");
+  drain_sent();
+  zassert_equal(frame->refs, 0, "Released");
+
+  frame = fusain_frame_alloc(&fanout_pool);
+  zassert_equal(fusain_fanout_publish_frame(&fanout, 999, frame), 0, "Unknown appliance");
+  zassert_equal(frame->refs, 0, "Caller's reference dropped");
+}
+
+ZTEST_SUITE(fusain_fanout, NULL, NULL, NULL, NULL, NULL);
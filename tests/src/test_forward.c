@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Cut-through Forwarding Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+#define HEATER 0x0102030405060708ULL
+#define STUFFED_HEATER 0x7E7D7F0405060708ULL /* Three escaped address bytes */
+
+static fusain_route_bucket_t forward_buckets[4];
+static fusain_route_t forward_routes;
+static fusain_forwarder_t fwd;
+
+/* Everything written to each egress link */
+static struct {
+  uint8_t data[512];
+  size_t length;
+  int writes;
+} out[3];
+
+static void test_emit(void* user, uint8_t link, const uint8_t* data, size_t length)
+{
+  zassert_equal_ptr(user, &fwd, "User pointer");
+  zassert_true(out[link].length + length <= sizeof(out[link].data), "Egress overflow");
+  memcpy(&out[link].data[out[link].length], data, length);
+  out[link].length += length;
+  out[link].writes++;
+}
+
+static void forward_setup(void)
+{
+  zassert_equal(fusain_route_init(&forward_routes, forward_buckets, NULL, 4), 0, "Routes");
+  zassert_equal(fusain_forward_init(&fwd, &forward_routes, 3, test_emit, &fwd), 0, "Init");
+  memset(out, 0, sizeof(out));
+}
+
+static int frame_of(fusain_packet_t* packet, uint8_t* frame)
+{
+  return fusain_encode_packet(packet, frame, FUSAIN_MAX_STUFFED_PACKET_SIZE);
+}
+
+/* Decode everything a link received; returns the number of good packets */
+static int decode_out(int link, fusain_packet_t* last)
+{
+  fusain_decoder_t decoder;
+  int good = 0;
+
+  fusain_reset_decoder(&decoder);
+  for (size_t i = 0; i < out[link].length; i++) {
+    if (fusain_decode_byte(out[link].data[i], last, &decoder) == FUSAIN_DECODE_OK) {
+      good++;
+    }
+  }
+  return good;
+}
+
+/* Test setup arguments and bad ingress links */
+ZTEST(fusain_forward, test_forward_init)
+{
+  zassert_equal(fusain_route_init(&forward_routes, forward_buckets, NULL, 4), 0, "Routes");
+  zassert_equal(fusain_forward_init(&fwd, NULL, 2, test_emit, NULL), -1, "No routes");
+  zassert_equal(fusain_forward_init(&fwd, &forward_routes, 2, NULL, NULL), -1, "No emit");
+  zassert_equal(fusain_forward_init(&fwd, &forward_routes, 0, test_emit, NULL), -1, "No links");
+  zassert_equal(fusain_forward_init(&fwd, &forward_routes, FUSAIN_FORWARD_MAX_LINKS + 1,
+                    test_emit, NULL),
+      -1, "Too many links");
+  forward_setup();
+  zassert_equal(fusain_forward_feed(&fwd, 3, (const uint8_t*)"\x7E", 1), -1, "No such link");
+  fusain_forward_abort(&fwd, 3);
+}
+
+/* Test flooding telemetry, learning its sender and routing commands back */
+ZTEST(fusain_forward, test_forward_learn)
+{
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  uint32_t route;
+  forward_setup();
+
+  /* Nothing learned yet: a command goes to every other link */
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, 3);
+  int length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 0, frame, (size_t)length), 1, "Flooded");
+  zassert_equal(out[0].length, 0, "Not back to the sender");
+  zassert_mem_equal(out[1].data, frame, (size_t)length, "Bytes unchanged");
+  zassert_mem_equal(out[2].data, frame, (size_t)length, "Bytes unchanged");
+  zassert_equal(fusain_route_lookup(&forward_routes, HEATER, &route), -1, "Commands teach nothing");
+
+  /* Telemetry from link 1 floods too, and teaches where the heater is */
+  memset(out, 0, sizeof(out));
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 1, "Flooded");
+  zassert_equal(out[0].length, (size_t)length, "Controller side");
+  zassert_equal(out[2].length, (size_t)length, "Other segment");
+  zassert_equal(fusain_route_lookup(&forward_routes, HEATER, &route), 0, "Learned");
+  zassert_equal(route, 1, "On link 1");
+
+  /* Now commands for it go to link 1 only */
+  memset(out, 0, sizeof(out));
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, 3);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 0, frame, (size_t)length), 1, "Routed");
+  zassert_equal(out[1].length, (size_t)length, "To the heater");
+  zassert_equal(out[2].length, 0, "Not flooded");
+  zassert_equal(decode_out(1, &packet), 1, "Decodes downstream");
+  zassert_equal(packet.address, HEATER, "Address");
+
+  /* ...and are filtered when they come from the heater's own segment */
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 0, "Filtered");
+  zassert_equal(fwd.dropped, 1, "Dropped");
+
+  /* Multicast always floods */
+  memset(out, 0, sizeof(out));
+  fusain_create_state_command(&packet, FUSAIN_ADDRESS_BROADCAST, FUSAIN_MODE_IDLE, 0);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 1, "Flooded");
+  zassert_equal(out[0].length, (size_t)length, "Everywhere");
+  zassert_equal(out[2].length, (size_t)length, "Everywhere");
+
+  /* The heater moves to link 2 */
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 2, frame, (size_t)length), 1, "Flooded");
+  zassert_equal(fusain_route_lookup(&forward_routes, HEATER, &route), 0, "Known");
+  zassert_equal(route, 2, "Moved");
+  zassert_equal(fwd.forwarded, 5, "Forwarded");
+
+#if FUSAIN_HAS_MSG_ERROR
+  /* Errors carry the sender's address too */
+  fusain_create_error_invalid_cmd(&packet, HEATER, FUSAIN_INVALID_CMD_INVALID_PARAM, 0, 0);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 0, frame, (size_t)length), 1, "Flooded");
+  zassert_equal(fusain_route_lookup(&forward_routes, HEATER, &route), 0, "Known");
+  zassert_equal(route, 0, "Learned from an error");
+#endif
+}
+
+/* Test that bytes go out before the frame has ended, and split input */
+ZTEST(fusain_forward, test_forward_cut_through)
+{
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  forward_setup();
+
+  fusain_create_temp_data(&packet, STUFFED_HEATER, 0, 1000, 21.5f);
+  int length = frame_of(&packet, frame);
+
+  /* START, LENGTH, 8 address bytes (3 escaped) and [type: 0x18 0x34] */
+  size_t head = 1 + 1 + 11 + 3;
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, head - 1), 0, "Partial");
+  zassert_equal(out[0].length, 0, "Not routed yet");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &frame[head - 1], 1), 0, "Type known");
+  zassert_equal(out[0].length, head, "Head out");
+  zassert_mem_equal(out[0].data, frame, head, "Head bytes");
+
+  zassert_equal(fusain_forward_feed(&fwd, 1, &frame[head], (size_t)length - head - 1), 0,
+      "Body");
+  zassert_equal(out[0].length, (size_t)length - 1, "All but END");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &frame[length - 1], 1), 1, "END");
+  zassert_mem_equal(out[0].data, frame, (size_t)length, "Same bytes");
+
+  /* One byte at a time gives the same stream */
+  memset(out, 0, sizeof(out));
+  int completed = 0;
+  for (int i = 0; i < length; i++) {
+    completed += fusain_forward_feed(&fwd, 1, &frame[i], 1);
+  }
+  zassert_equal(completed, 1, "One frame");
+  zassert_equal(out[2].length, (size_t)length, "Length");
+  zassert_mem_equal(out[2].data, frame, (size_t)length, "Same bytes");
+  zassert_equal(decode_out(2, &packet), 1, "Decodes downstream");
+  zassert_equal(packet.address, STUFFED_HEATER, "Address");
+
+  /* Two frames in one buffer, written as one run each */
+  memset(out, 0, sizeof(out));
+  uint8_t two[2 * FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  memcpy(two, frame, (size_t)length);
+  memcpy(&two[length], frame, (size_t)length);
+  zassert_equal(fusain_forward_feed(&fwd, 1, two, 2 * (size_t)length), 2, "Two frames");
+  zassert_equal(out[0].writes, 6, "Head, body and END per frame");
+  zassert_equal(decode_out(0, &packet), 2, "Both decode");
+
+  /* A one-byte message type is routed after one payload byte less */
+  memset(out, 0, sizeof(out));
+  packet.address = HEATER;
+  packet.length = 3;
+  memcpy(packet.payload, "\x82\x05\xA0", 3);
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, 12), 0, "Type known");
+  zassert_equal(out[0].length, 12, "Head out");
+}
+
+/* Test cutting off bad frames downstream */
+ZTEST(fusain_forward, test_forward_abort)
+{
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  uint32_t route;
+  forward_setup();
+
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  int length = frame_of(&packet, frame);
+  frame[length - 3] ^= 0x01; /* CRC */
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 0, "Bad CRC");
+  zassert_equal(out[0].data[out[0].length - 1], FUSAIN_START_BYTE, "Cut off with START");
+  zassert_equal(decode_out(0, &packet), 0, "Nothing decodes downstream");
+  zassert_equal(fusain_route_lookup(&forward_routes, HEATER, &route), -1, "Nothing learned");
+  zassert_equal(fwd.aborted, 1, "Aborted");
+  zassert_equal(fwd.busy, 0, "Links free again");
+
+  /* A wrong byte where END belongs */
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  length = frame_of(&packet, frame);
+  frame[length - 1] = 0x00;
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 0, "No END");
+  zassert_equal(fwd.aborted, 2, "Aborted");
+
+  /* END before the CRC */
+  frame[length - 2] = FUSAIN_END_BYTE;
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length - 1), 0, "Short");
+  zassert_equal(fwd.aborted, 3, "Aborted");
+
+  /* The sender restarts mid-frame: the old frame is cut off, the new one goes through */
+  memset(out, 0, sizeof(out));
+  length = frame_of(&packet, frame);
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, 20), 0, "Half a frame");
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, (size_t)length), 1, "Whole frame");
+  zassert_equal(fwd.aborted, 4, "Aborted");
+  zassert_equal(decode_out(0, &packet), 1, "Only the whole frame decodes");
+
+  /* The link goes down mid-frame */
+  zassert_equal(fusain_forward_feed(&fwd, 1, frame, 20), 0, "Half a frame");
+  fusain_forward_abort(&fwd, 1);
+  zassert_equal(fwd.aborted, 5, "Aborted");
+  zassert_equal(fwd.busy, 0, "Links free again");
+  fusain_forward_abort(&fwd, 1);
+  zassert_equal(fwd.aborted, 5, "Nothing in progress");
+}
+
+/* Test frames that are never routed */
+ZTEST(fusain_forward, test_forward_drop)
+{
+  uint8_t frame[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  forward_setup();
+
+  /* Line noise before any START */
+  zassert_equal(fusain_forward_feed(&fwd, 0, (const uint8_t*)"\x01\x02\x7F", 3), 0, "Noise");
+
+  /* Invalid length, and an aliased frame */
+  zassert_equal(fusain_forward_feed(&fwd, 0, (const uint8_t*)"\x7E\x73", 2), 0, "Too long");
+  fusain_create_ping_request(&packet, HEATER);
+  int length = frame_of(&packet, frame);
+  frame[1] |= FUSAIN_LENGTH_ALIAS_FLAG;
+  zassert_equal(fusain_forward_feed(&fwd, 0, frame, (size_t)length), 0, "Aliased");
+
+  /* Payloads without a [type, ...] header */
+  const uint8_t no_array[] = { 0x7E, 0x02, 1, 2, 3, 4, 5, 6, 7, 8, 0x01, 0x02 };
+  zassert_equal(fusain_forward_feed(&fwd, 0, no_array, sizeof(no_array)), 0, "Not an array");
+  const uint8_t bad_type[] = { 0x7E, 0x02, 1, 2, 3, 4, 5, 6, 7, 8, 0x82, 0x19 };
+  zassert_equal(fusain_forward_feed(&fwd, 0, bad_type, sizeof(bad_type)), 0, "Wide type");
+  const uint8_t short_payload[] = { 0x7E, 0x01, 1, 2, 3, 4, 5, 6, 7, 8, 0x82, 0x00 };
+  zassert_equal(fusain_forward_feed(&fwd, 0, short_payload, sizeof(short_payload)), 0,
+      "No room for a type");
+
+  zassert_equal(fwd.dropped, 5, "Dropped");
+  zassert_equal(fwd.aborted, 0, "Nothing went out");
+  for (int link = 0; link < 3; link++) {
+    zassert_equal(out[link].length, 0, "Silent");
+  }
+}
+
+/* Test two segments bridged to one link talking at the same time */
+ZTEST(fusain_forward, test_forward_collision)
+{
+  uint8_t first[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t second[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  forward_setup();
+
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  int first_length = frame_of(&packet, first);
+  fusain_create_temp_data(&packet, HEATER + 1, 0, 1000, 22.5f);
+  int second_length = frame_of(&packet, second);
+
+  /* Link 1 streams to links 0 and 2; link 2 finds link 0 busy and is held for it */
+  zassert_equal(fusain_forward_feed(&fwd, 1, first, 20), 0, "First under way");
+  zassert_equal(fusain_forward_feed(&fwd, 2, second, (size_t)second_length), 1, "Second done");
+  zassert_equal(fwd.deferred, 1, "Held for link 0");
+  zassert_equal(fwd.collisions, 0, "Nothing skipped");
+  zassert_equal(out[1].length, (size_t)second_length, "Link 1 was free");
+  zassert_equal(out[0].length, 20, "Link 0 not interleaved");
+
+  /* Link 0 frees up and gets the held frame after the first */
+  zassert_equal(fusain_forward_feed(&fwd, 1, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(fwd.busy, 0, "Links free again");
+  zassert_equal(out[0].length, (size_t)(first_length + second_length), "Both on link 0");
+  zassert_mem_equal(&out[0].data[first_length], second, (size_t)second_length, "Same bytes");
+  zassert_equal(decode_out(0, &packet), 2, "Both decode on link 0");
+  zassert_equal(packet.address, HEATER + 1, "Second last");
+  zassert_equal(decode_out(2, &packet), 1, "First on link 2");
+  zassert_equal(packet.address, HEATER, "First");
+  zassert_equal(fwd.forwarded, 2, "Forwarded");
+  zassert_equal(fwd.dropped, 0, "Nothing lost");
+
+  /* Every link link 2 could use is busy: held for both */
+  memset(out, 0, sizeof(out));
+  zassert_equal(fusain_forward_feed(&fwd, 0, first, 20), 0, "First under way");
+  zassert_equal(fusain_forward_feed(&fwd, 1, second, 20), 0, "Second under way");
+  zassert_equal(fwd.deferred, 2, "Link 1 held for link 2");
+  zassert_equal(fusain_forward_feed(&fwd, 2, second, (size_t)second_length), 1, "Held");
+  zassert_equal(fwd.deferred, 4, "Held for links 0 and 1");
+  zassert_equal(fwd.dropped, 0, "Not dropped");
+  zassert_equal(fusain_forward_feed(&fwd, 0, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &second[20], (size_t)second_length - 20), 1,
+      "Done");
+  zassert_equal(fwd.busy, 0, "Links free again");
+  zassert_equal(decode_out(0, &packet), 2, "Link 1's and link 2's frames on link 0");
+  zassert_equal(decode_out(1, &packet), 2, "Link 0's and link 2's frames on link 1");
+  zassert_equal(decode_out(2, &packet), 2, "Link 0's and link 1's frames on link 2");
+}
+
+/* Test frames held while still arriving, and a full hold buffer */
+ZTEST(fusain_forward, test_forward_hold)
+{
+  uint8_t first[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t second[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  uint8_t third[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  fusain_packet_t packet;
+  forward_setup();
+
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  int first_length = frame_of(&packet, first);
+  fusain_create_temp_data(&packet, STUFFED_HEATER, 0, 1000, 22.5f);
+  int second_length = frame_of(&packet, second);
+  fusain_create_temp_data(&packet, HEATER + 2, 0, 1000, 23.5f);
+  int third_length = frame_of(&packet, third);
+
+  /* Link 0 frees up halfway through the held frame: it catches up, then streams */
+  zassert_equal(fusain_forward_feed(&fwd, 1, first, 20), 0, "First under way");
+  zassert_equal(fusain_forward_feed(&fwd, 2, second, 24), 0, "Second held for link 0");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(out[0].length, (size_t)first_length + 24, "Caught up");
+  zassert_equal(fwd.busy, 0x03, "Link 0 now carries the second frame");
+  zassert_equal(fusain_forward_feed(&fwd, 2, &second[24], (size_t)second_length - 24), 1,
+      "Done");
+  zassert_mem_equal(&out[0].data[first_length], second, (size_t)second_length, "Same bytes");
+  zassert_equal(decode_out(0, &packet), 2, "Both decode on link 0");
+  zassert_equal(packet.address, STUFFED_HEATER, "Second last");
+
+  /* A held frame with a bad CRC never reaches the link it waited for */
+  memset(out, 0, sizeof(out));
+  zassert_equal(fusain_forward_feed(&fwd, 1, first, 20), 0, "First under way");
+  second[second_length - 3] ^= 0x01;
+  zassert_equal(fusain_forward_feed(&fwd, 2, second, (size_t)second_length), 0, "Bad CRC");
+  second[second_length - 3] ^= 0x01;
+  zassert_equal(fwd.aborted, 1, "Cut off on link 1");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(out[0].length, (size_t)first_length, "Only the first on link 0");
+
+  /* While a frame waits, the next one from the same link skips the busy link */
+  memset(out, 0, sizeof(out));
+  zassert_equal(fusain_forward_feed(&fwd, 1, first, 20), 0, "First under way");
+  zassert_equal(fusain_forward_feed(&fwd, 2, second, (size_t)second_length), 1, "Held");
+  zassert_equal(fusain_forward_feed(&fwd, 2, third, (size_t)third_length), 1, "Skips link 0");
+  zassert_equal(fwd.collisions, 1, "Counted");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(decode_out(0, &packet), 2, "First and second on link 0");
+  zassert_equal(packet.address, STUFFED_HEATER, "Second last");
+  zassert_equal(decode_out(1, &packet), 2, "Second and third on link 1");
+  zassert_equal(packet.address, HEATER + 2, "Third last");
+
+  /* A held frame whose link goes down before it was routed anywhere */
+  memset(out, 0, sizeof(out));
+  fusain_route_set(&forward_routes, HEATER, 0);
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, 3);
+  int command_length = frame_of(&packet, third);
+  zassert_equal(fusain_forward_feed(&fwd, 1, first, 20), 0, "First under way");
+  zassert_equal(fusain_forward_feed(&fwd, 2, third, 20), 0, "Command held for link 0");
+  fusain_forward_abort(&fwd, 2);
+  zassert_equal(fwd.dropped, 1, "Nothing went out");
+  zassert_equal(fusain_forward_feed(&fwd, 1, &first[20], (size_t)first_length - 20), 1, "Done");
+  zassert_equal(out[0].length, (size_t)first_length, "Only the first on link 0");
+  zassert_true(command_length > 20, "Command longer than the part fed");
+}
+
+ZTEST_SUITE(fusain_forward, NULL, NULL, NULL, NULL, NULL);
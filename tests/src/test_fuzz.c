@@ -298,6 +298,120 @@ ZTEST(fusain_fuzz, test_fuzz_crc)
   }
 }
 
+/* Fuzz batch CRC against the single-span CRC */
+ZTEST(fusain_fuzz, test_fuzz_crc_batch)
+{
+  for (int round = 0; round < CONFIG_FUSAIN_TEST_FUZZ_ROUNDS; round++) {
+    uint8_t data[16][FUSAIN_MAX_PACKET_SIZE];
+    fusain_span_t spans[16];
+    uint16_t crcs[16];
+    size_t count = fuzz_rand() % 17;
+
+    for (size_t s = 0; s < count; s++) {
+      size_t length = fuzz_rand() % (FUSAIN_MAX_PAYLOAD_SIZE + 10);
+      for (size_t i = 0; i < length; i++) {
+        data[s][i] = fuzz_rand_byte();
+      }
+      spans[s].data = data[s];
+      spans[s].length = length;
+    }
+
+    fusain_crc16_batch(spans, count, crcs);
+
+    for (size_t s = 0; s < count; s++) {
+      zassert_equal(crcs[s], fusain_crc16(spans[s].data, spans[s].length),
+          "Round %d: Batch CRC should match single CRC (span %zu)", round, s);
+    }
+  }
+}
+
+/* Fuzz scatter-gather encoding against contiguous encoding */
+ZTEST(fusain_fuzz, test_fuzz_encode_iov)
+{
+  for (int round = 0; round < CONFIG_FUSAIN_TEST_FUZZ_ROUNDS; round++) {
+    fusain_packet_t packet;
+    packet.length = fuzz_rand() % (FUSAIN_MAX_PAYLOAD_SIZE + 1);
+    packet.address = ((uint64_t)fuzz_rand() << 32) | fuzz_rand();
+    for (int i = 0; i < packet.length; i++) {
+      /* Bias towards special bytes so escapes are frequent */
+      packet.payload[i] = (fuzz_rand() % 4 == 0) ? (uint8_t)(0x7D + fuzz_rand() % 3)
+                                                 : fuzz_rand_byte();
+    }
+
+    fusain_span_t iov[FUSAIN_IOV_MAX_SEGMENTS];
+    uint8_t side[FUSAIN_IOV_SIDE_BUFFER_SIZE];
+    size_t total = 0;
+    int count = fusain_encode_packet_iov(&packet, iov, FUSAIN_IOV_MAX_SEGMENTS,
+        side, sizeof(side), &total);
+    zassert_true(count > 0, "Round %d: iov encoding should succeed", round);
+
+    uint8_t expected[FUSAIN_MAX_PACKET_SIZE * 2];
+    int len = fusain_encode_packet(&packet, expected, sizeof(expected));
+    zassert_equal(total, (size_t)len, "Round %d: length should match", round);
+
+    size_t offset = 0;
+    for (int i = 0; i < count; i++) {
+      zassert_mem_equal(iov[i].data, &expected[offset], iov[i].length,
+          "Round %d: segment %d should match", round, i);
+      offset += iov[i].length;
+    }
+  }
+}
+
+/* Fuzz in-place frame extraction against the byte-wise decoder */
+ZTEST(fusain_fuzz, test_fuzz_extract_frames)
+{
+  for (int round = 0; round < CONFIG_FUSAIN_TEST_FUZZ_ROUNDS; round++) {
+    fusain_packet_t tx[4];
+    uint8_t stream[FUSAIN_MAX_STUFFED_PACKET_SIZE * 4];
+    size_t stream_len = 0;
+    for (int p = 0; p < 4; p++) {
+      do { /* Skip packets where CBOR encoding failed */
+        fuzz_create_random_packet(&tx[p]);
+      } while (tx[p].length == 0);
+      int len = fusain_encode_packet(&tx[p], &stream[stream_len],
+          sizeof(stream) - stream_len);
+      zassert_true(len > 0, "Round %d: encoding should succeed", round);
+      stream_len += (size_t)len;
+    }
+
+    /* Feed the stream in random chunk sizes */
+    fusain_extractor_t extractor;
+    fusain_reset_extractor(&extractor);
+    int extracted = 0;
+    size_t offset = 0;
+    while (offset < stream_len) {
+      size_t chunk_len = 1 + fuzz_rand() % 64;
+      if (chunk_len > stream_len - offset) {
+        chunk_len = stream_len - offset;
+      }
+      size_t pos = 0;
+      while (pos < chunk_len) {
+        fusain_frame_view_t view;
+        size_t consumed = 0;
+        fusain_decode_result_t result = fusain_extract_frame(&extractor,
+            &stream[offset + pos], chunk_len - pos, &view, &consumed);
+        pos += consumed;
+        if (result == FUSAIN_DECODE_OK) {
+          zassert_true(extracted < 4, "Round %d: too many frames", round);
+          zassert_equal(view.address, tx[extracted].address,
+              "Round %d: address should match", round);
+          zassert_equal(view.length, tx[extracted].length,
+              "Round %d: length should match", round);
+          zassert_mem_equal(view.payload, tx[extracted].payload, view.length,
+              "Round %d: payload should match", round);
+          extracted++;
+        } else {
+          zassert_equal(result, FUSAIN_DECODE_INCOMPLETE,
+              "Round %d: unexpected result %d", round, result);
+        }
+      }
+      offset += chunk_len;
+    }
+    zassert_equal(extracted, 4, "Round %d: all frames should extract", round);
+  }
+}
+
 /* Fuzz byte stuffing edge cases - tests addresses with special bytes */
 ZTEST(fusain_fuzz, test_fuzz_byte_stuffing)
 {
@@ -9,6 +9,8 @@
  */
 
 #include <fusain/fusain.h>
+#include <fusain/generated/cbor_decode.h>
+#include <fusain/generated/cbor_encode.h>
 #include <string.h>
 #include <zephyr/ztest.h>
 
@@ -421,5 +423,590 @@ ZTEST(fusain_packets, test_create_error_state_reject_extended)
   zassert_true(verify_roundtrip(&packet, "error_state_reject_ext"), "Round-trip should succeed");
 }
 
+/* Check a packet against its worst-case size constants */
+static void check_size_bounds(fusain_packet_t* packet, size_t cbor_size,
+    size_t frame_size, const char* name)
+{
+  zassert_true(packet->length > 0, "%s: encoding should succeed", name);
+  zassert_true(packet->length <= cbor_size, "%s: %u > FUSAIN_CBOR_SIZE (%zu)",
+      name, packet->length, cbor_size);
+
+  /* Every address byte escaped, so only the CBOR payload is left to chance */
+  packet->address = 0x7E7E7E7E7E7E7E7EULL;
+  uint8_t buffer[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  zassert_true(fusain_encode_packet(packet, buffer, frame_size) > 0,
+      "%s: frame should fit in FUSAIN_FRAME_SIZE", name);
+}
+
+/* Test create helpers with extreme values stay within the size constants */
+ZTEST(fusain_packets, test_message_size_bounds)
+{
+  fusain_packet_t packet;
+  const uint64_t addr = 0;
+
+  fusain_cmd_motor_config_t motor_cfg = {
+    .motor = 127,
+    .pwm_period = UINT32_MAX,
+    .pid_kp = 1.1,
+    .pid_ki = -2.2,
+    .pid_kd = 3.3e300,
+    .max_rpm = INT32_MIN,
+    .min_rpm = INT32_MIN,
+    .min_pwm_duty = UINT32_MAX,
+  };
+  fusain_create_motor_config(&packet, addr, &motor_cfg);
+  zassert_equal(packet.length, FUSAIN_CBOR_SIZE_MOTOR_CONFIG,
+      "MOTOR_CONFIG with all fields should hit the bound exactly");
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_MOTOR_CONFIG,
+      FUSAIN_FRAME_SIZE_MOTOR_CONFIG, "motor_config");
+
+  fusain_cmd_pump_config_t pump_cfg = { 127, UINT32_MAX, UINT32_MAX };
+  fusain_create_pump_config(&packet, addr, &pump_cfg);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_PUMP_CONFIG,
+      FUSAIN_FRAME_SIZE_PUMP_CONFIG, "pump_config");
+
+  fusain_cmd_temp_config_t temp_cfg = { 127, 1.1, 2.2, 3.3 };
+  fusain_create_temp_config(&packet, addr, &temp_cfg);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TEMP_CONFIG,
+      FUSAIN_FRAME_SIZE_TEMP_CONFIG, "temp_config");
+
+  fusain_cmd_glow_config_t glow_cfg = { 127, UINT32_MAX };
+  fusain_create_glow_config(&packet, addr, &glow_cfg);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_GLOW_CONFIG,
+      FUSAIN_FRAME_SIZE_GLOW_CONFIG, "glow_config");
+
+  fusain_create_data_subscription(&packet, addr, UINT64_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_DATA_SUBSCRIPTION,
+      FUSAIN_FRAME_SIZE_DATA_SUBSCRIPTION, "data_subscription");
+  fusain_create_data_unsubscribe(&packet, addr, UINT64_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_DATA_UNSUBSCRIBE,
+      FUSAIN_FRAME_SIZE_DATA_UNSUBSCRIBE, "data_unsubscribe");
+  fusain_create_telemetry_config(&packet, addr, true, UINT32_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TELEMETRY_CONFIG,
+      FUSAIN_FRAME_SIZE_TELEMETRY_CONFIG, "telemetry_config");
+  fusain_create_timeout_config(&packet, addr, true, UINT32_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TIMEOUT_CONFIG,
+      FUSAIN_FRAME_SIZE_TIMEOUT_CONFIG, "timeout_config");
+  fusain_create_discovery_request(&packet, addr);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_DISCOVERY_REQUEST,
+      FUSAIN_FRAME_SIZE_DISCOVERY_REQUEST, "discovery_request");
+
+  fusain_create_state_command(&packet, addr, FUSAIN_MODE_EMERGENCY, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_STATE_COMMAND,
+      FUSAIN_FRAME_SIZE_STATE_COMMAND, "state_command");
+  fusain_create_motor_command(&packet, addr, 127, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_MOTOR_COMMAND,
+      FUSAIN_FRAME_SIZE_MOTOR_COMMAND, "motor_command");
+  fusain_create_pump_command(&packet, addr, 127, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_PUMP_COMMAND,
+      FUSAIN_FRAME_SIZE_PUMP_COMMAND, "pump_command");
+  fusain_create_glow_command(&packet, addr, 127, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_GLOW_COMMAND,
+      FUSAIN_FRAME_SIZE_GLOW_COMMAND, "glow_command");
+  fusain_create_temp_command(&packet, addr, 127, FUSAIN_TEMP_CMD_WATCH_MOTOR,
+      127, 0.0f);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TEMP_COMMAND,
+      FUSAIN_FRAME_SIZE_TEMP_COMMAND, "temp_command_watch");
+  fusain_create_temp_command(&packet, addr, 127,
+      FUSAIN_TEMP_CMD_SET_TARGET_TEMP, 127, 1e30f);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TEMP_COMMAND,
+      FUSAIN_FRAME_SIZE_TEMP_COMMAND, "temp_command_target");
+  fusain_create_send_telemetry(&packet, addr, 255, UINT32_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_SEND_TELEMETRY,
+      FUSAIN_FRAME_SIZE_SEND_TELEMETRY, "send_telemetry");
+  fusain_create_ping_request(&packet, addr);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_PING_REQUEST,
+      FUSAIN_FRAME_SIZE_PING_REQUEST, "ping_request");
+
+  fusain_create_state_data(&packet, addr, 1, 255, FUSAIN_STATE_E_STOP,
+      UINT32_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_STATE_DATA,
+      FUSAIN_FRAME_SIZE_STATE_DATA, "state_data");
+  fusain_create_motor_data(&packet, addr, 127, UINT32_MAX, INT32_MIN, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_MOTOR_DATA,
+      FUSAIN_FRAME_SIZE_MOTOR_DATA, "motor_data");
+  fusain_create_pump_data(&packet, addr, 127, UINT32_MAX,
+      FUSAIN_PUMP_EVENT_CYCLE_END, INT32_MIN);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_PUMP_DATA,
+      FUSAIN_FRAME_SIZE_PUMP_DATA, "pump_data");
+  fusain_create_glow_data(&packet, addr, 127, UINT32_MAX, true);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_GLOW_DATA,
+      FUSAIN_FRAME_SIZE_GLOW_DATA, "glow_data");
+  fusain_create_temp_data(&packet, addr, 127, UINT32_MAX, -1e30f);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_TEMP_DATA,
+      FUSAIN_FRAME_SIZE_TEMP_DATA, "temp_data");
+  fusain_create_device_announce(&packet, addr, 255, 255, 255, 255);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_DEVICE_ANNOUNCE,
+      FUSAIN_FRAME_SIZE_DEVICE_ANNOUNCE, "device_announce");
+  fusain_create_ping_response(&packet, addr, UINT32_MAX);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_PING_RESPONSE,
+      FUSAIN_FRAME_SIZE_PING_RESPONSE, "ping_response");
+
+  fusain_create_error_invalid_cmd(&packet, addr,
+      FUSAIN_INVALID_CMD_INVALID_INDEX, INT32_MAX, FUSAIN_CONSTRAINT_VALUE_IN_GAP);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_ERROR_INVALID_CMD,
+      FUSAIN_FRAME_SIZE_ERROR_INVALID_CMD, "error_invalid_cmd");
+  fusain_create_error_state_reject(&packet, addr, FUSAIN_STATE_E_STOP,
+      FUSAIN_REJECTION_TRANSITION_BLOCKED);
+  check_size_bounds(&packet, FUSAIN_CBOR_SIZE_ERROR_STATE_REJECT,
+      FUSAIN_FRAME_SIZE_ERROR_STATE_REJECT, "error_state_reject");
+}
+
+/* Test telemetry bounds are exact with every optional key present */
+ZTEST(fusain_packets, test_message_size_bounds_optional_keys)
+{
+  const size_t header_len = 3; /* [0x82, 0x18, msg_type] */
+  uint8_t buffer[FUSAIN_MAX_PAYLOAD_SIZE];
+  size_t len = 0;
+
+  struct motor_data_payload motor = {
+    .motor_data_payload_motor_index_m = INT8_MIN,
+    .motor_data_payload_timestamp_m = UINT32_MAX,
+    .motor_data_payload_uint2int = INT32_MIN,
+    .motor_data_payload_uint3int = INT32_MIN,
+    .motor_data_payload_uint4int = { INT32_MIN },
+    .motor_data_payload_uint4int_present = true,
+    .motor_data_payload_uint5int = { INT32_MIN },
+    .motor_data_payload_uint5int_present = true,
+    .motor_data_payload_uint6uint = { UINT32_MAX },
+    .motor_data_payload_uint6uint_present = true,
+    .motor_data_payload_uint7uint = { UINT32_MAX },
+    .motor_data_payload_uint7uint_present = true,
+  };
+  zassert_equal(cbor_encode_motor_data_payload(buffer, sizeof(buffer), &motor,
+                    &len),
+      0, "MOTOR_DATA encoding should succeed");
+  zassert_equal(header_len + len, FUSAIN_CBOR_SIZE_MOTOR_DATA,
+      "MOTOR_DATA bound should be exact");
+
+  struct temp_data_payload temp = {
+    .temp_data_payload_thermometer_index_m = INT8_MIN,
+    .temp_data_payload_timestamp_m = UINT32_MAX,
+    .temp_data_payload_uint2float = 1.1,
+    .temp_data_payload_uint3bool = { true },
+    .temp_data_payload_uint3bool_present = true,
+    .temp_data_payload_uint4int = { INT32_MIN },
+    .temp_data_payload_uint4int_present = true,
+    .temp_data_payload_uint5float = { 2.2 },
+    .temp_data_payload_uint5float_present = true,
+  };
+  zassert_equal(cbor_encode_temp_data_payload(buffer, sizeof(buffer), &temp,
+                    &len),
+      0, "TEMP_DATA encoding should succeed");
+  zassert_equal(header_len + len, FUSAIN_CBOR_SIZE_TEMP_DATA,
+      "TEMP_DATA bound should be exact");
+}
+
+/* Delta telemetry encoding */
+ZTEST(fusain_packets, test_create_motor_data_fields)
+{
+  fusain_packet_t packet;
+  fusain_motor_data_t data = {
+    .motor = 1, .timestamp = 100, .rpm = 2500, .target = 3000,
+    .max_rpm = 6000, .min_rpm = -10, .pwm = 500, .pwm_max = 1000,
+  };
+  uint64_t u = 0;
+  int64_t i = 0;
+
+  fusain_create_motor_data_fields(&packet, 0x1234, &data,
+      FUSAIN_MOTOR_DATA_MIN_RPM | FUSAIN_MOTOR_DATA_PWM);
+  zassert_equal(packet.msg_type, FUSAIN_MSG_MOTOR_DATA, "Wrong msg type");
+  zassert_equal(fusain_peek_int(&packet, 2, &i), 0, "rpm missing");
+  zassert_equal(i, 2500, "Wrong rpm");
+  zassert_equal(fusain_peek_int(&packet, 4, &i), -2, "max_rpm sent");
+  zassert_equal(fusain_peek_int(&packet, 5, &i), 0, "min_rpm missing");
+  zassert_equal(i, -10, "Wrong min_rpm");
+  zassert_equal(fusain_peek_uint(&packet, 6, &u), 0, "pwm missing");
+  zassert_equal(u, 500, "Wrong pwm");
+  zassert_equal(fusain_peek_uint(&packet, 7, &u), -2, "pwm_max sent");
+}
+
+ZTEST(fusain_packets, test_motor_data_delta)
+{
+  fusain_packet_t packet;
+  fusain_motor_delta_t delta;
+  fusain_motor_delta_config_t config = {
+    .rpm_deadband = 50, .pwm_deadband = 10, .refresh_ms = 1000,
+  };
+  fusain_motor_data_t data = {
+    .motor = 0, .timestamp = 5000, .rpm = 2500, .target = 3000,
+    .max_rpm = 6000, .min_rpm = 800, .pwm = 500, .pwm_max = 1000,
+  };
+  int64_t i = 0;
+
+  fusain_init_motor_delta(&delta, &config);
+
+  /* First frame is a full refresh */
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_MOTOR_DATA_OPTIONAL, "First frame should be full");
+  uint8_t full_len = packet.length;
+
+  /* Unchanged: only required fields */
+  data.timestamp += 100;
+  data.rpm = 2600;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      0, "Unchanged frame should omit optional fields");
+  zassert_true(packet.length < full_len, "Delta frame should be smaller");
+  zassert_equal(fusain_peek_int(&packet, 2, &i), 0, "rpm missing");
+  zassert_equal(i, 2600, "Wrong rpm");
+  zassert_equal(fusain_peek_int(&packet, 4, &i), -2, "max_rpm sent");
+
+  /* Within deadband */
+  data.timestamp += 100;
+  data.max_rpm = 6050;
+  data.pwm = 490;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      0, "Changes within deadband should be omitted");
+
+  /* Beyond deadband; comparison is against the last sent value */
+  data.timestamp += 100;
+  data.max_rpm = 6051;
+  data.min_rpm = 700;
+  data.pwm = 489;
+  data.pwm_max = 1011;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_MOTOR_DATA_OPTIONAL, "Changes beyond deadband should be sent");
+  zassert_equal(fusain_peek_int(&packet, 4, &i), 0, "max_rpm missing");
+  zassert_equal(i, 6051, "Wrong max_rpm");
+
+  /* Sent values became the new reference */
+  data.timestamp += 100;
+  data.pwm = 495;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      0, "Reference should track last sent value");
+
+  /* Periodic refresh, across timestamp wraparound */
+  data.timestamp = 5000 + 1000;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_MOTOR_DATA_OPTIONAL, "Refresh should send everything");
+  zassert_equal(packet.length, full_len, "Refresh should match full frame");
+
+  data.timestamp = 0xFFFFFF00u;
+  fusain_init_motor_delta(&delta, &config);
+  fusain_create_motor_data_delta(&packet, 0x1, &delta, &data);
+  data.timestamp = 0x100;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      0, "Wrapped timestamp within period should not refresh");
+  data.timestamp = 0x300;
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_MOTOR_DATA_OPTIONAL, "Wrapped timestamp past period should refresh");
+
+  /* refresh_ms = 0 always sends everything */
+  config.refresh_ms = 0;
+  fusain_init_motor_delta(&delta, &config);
+  fusain_create_motor_data_delta(&packet, 0x1, &delta, &data);
+  zassert_equal(fusain_create_motor_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_MOTOR_DATA_OPTIONAL, "refresh_ms 0 should always be full");
+}
+
+ZTEST(fusain_packets, test_temp_data_delta)
+{
+  fusain_packet_t packet;
+  fusain_temp_delta_t delta;
+  fusain_temp_delta_config_t config = {
+    .target_deadband = 0.5f, .refresh_ms = 2000,
+  };
+  fusain_temp_data_t data = {
+    .thermometer = 0, .timestamp = 0, .reading = 150.0f,
+    .rpm_control = true, .watched_motor = 0, .target_temp = 200.0f,
+  };
+  double d = 0.0;
+  bool b = false;
+  int64_t i = 0;
+
+  fusain_init_temp_delta(&delta, &config);
+  zassert_equal(fusain_create_temp_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_TEMP_DATA_OPTIONAL, "First frame should be full");
+  zassert_equal(fusain_peek_bool(&packet, 3, &b), 0, "rpm_control missing");
+  zassert_true(b, "Wrong rpm_control");
+
+  data.timestamp = 500;
+  data.reading = 151.0f;
+  data.target_temp = 200.4f;
+  zassert_equal(fusain_create_temp_data_delta(&packet, 0x1, &delta, &data),
+      0, "Changes within deadband should be omitted");
+  zassert_equal(fusain_peek_float(&packet, 2, &d), 0, "reading missing");
+  zassert_true(d > 150.99 && d < 151.01, "Wrong reading");
+  zassert_equal(fusain_peek_float(&packet, 5, &d), -2, "target_temp sent");
+
+  data.timestamp = 1000;
+  data.target_temp = 199.4f;
+  data.watched_motor = 1;
+  zassert_equal(fusain_create_temp_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_TEMP_DATA_WATCHED_MOTOR | FUSAIN_TEMP_DATA_TARGET_TEMP,
+      "Changed fields should be sent");
+  zassert_equal(fusain_peek_int(&packet, 4, &i), 0, "watched_motor missing");
+  zassert_equal(i, 1, "Wrong watched_motor");
+
+  data.timestamp = 1500;
+  data.rpm_control = false;
+  zassert_equal(fusain_create_temp_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_TEMP_DATA_RPM_CONTROL, "Bool change should be sent");
+
+  data.timestamp = 2000;
+  zassert_equal(fusain_create_temp_data_delta(&packet, 0x1, &delta, &data),
+      FUSAIN_TEMP_DATA_OPTIONAL, "Refresh should send everything");
+}
+
+/* Shortest float encoding */
+static size_t put_float64(uint8_t* out, double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  out[0] = 0xFB;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (uint8_t)(bits >> (56 - 8 * i));
+  }
+  return 9;
+}
+
+ZTEST(fusain_packets, test_compact_floats_config)
+{
+  fusain_cmd_temp_config_t config = {
+    .thermometer = 0,
+    .pid_kp = 0.5,
+    .pid_ki = 1.25,
+    .pid_kd = 20.0,
+  };
+  fusain_packet_t packet;
+  fusain_create_temp_config(&packet, 0xABCD, &config);
+
+  int saved = fusain_compact_floats(&packet);
+  zassert_true(saved >= 0, "Compaction should succeed");
+  zassert_true(packet.length <= FUSAIN_CBOR_SIZE_TEMP_CONFIG,
+      "Compacted payload should respect the size bound");
+  zassert_equal(fusain_compact_floats(&packet), 0,
+      "Compaction should be idempotent");
+
+  double d = 0.0;
+  zassert_equal(fusain_peek_float(&packet, 1, &d), 0, "kp missing");
+  zassert_true(d == 0.5, "Wrong kp");
+  zassert_equal(fusain_peek_float(&packet, 3, &d), 0, "kd missing");
+  zassert_true(d == 20.0, "Wrong kd");
+
+  /* zcbor decoder accepts half precision */
+  struct temp_config_payload decoded;
+  size_t header_len = packet.msg_type <= 0x17 ? 2 : 3;
+  size_t consumed = 0;
+  zassert_equal(cbor_decode_temp_config_payload(packet.payload + header_len,
+                    packet.length - header_len, &decoded, &consumed),
+      0, "Decoder should accept compact floats");
+  zassert_true(decoded.temp_config_payload_uint2float_present, "ki missing");
+  zassert_true(decoded.temp_config_payload_uint2float
+                       .temp_config_payload_uint2float
+          == 1.25,
+      "Wrong ki");
+  zassert_true(verify_roundtrip(&packet, "temp_config"), "Round-trip should succeed");
+
+#ifdef CONFIG_FUSAIN_SHORTEST_FLOAT
+  zassert_equal(saved, 0, "Create helper should already be compact");
+#else
+  zassert_equal(saved, 3 * 6, "Each gain should shrink from 9 to 3 bytes");
+#endif
+}
+
+ZTEST(fusain_packets, test_compact_floats_widths)
+{
+  const struct {
+    double value;
+    uint8_t head;
+    uint32_t bits; /* Expected half/single bits */
+  } cases[] = {
+    { 0.5, 0xF9, 0x3800 },
+    { -0.0, 0xF9, 0x8000 },
+    { 65504.0, 0xF9, 0x7BFF },
+    { 5.9604644775390625e-8, 0xF9, 0x0001 }, /* Smallest half subnormal */
+    { 1.0 / 0.0, 0xF9, 0x7C00 },
+    { 65536.0, 0xFA, 0x47800000 },
+    { 3.1415927410125732, 0xFA, 0x40490FDB },
+    { 1.00146484375, 0xFA, 0x3F803000 }, /* One bit past half precision */
+    { 0.1, 0xFB, 0 },
+    { 1e300, 0xFB, 0 },
+    { 0.0 / 0.0, 0xFB, 0 },
+  };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    fusain_packet_t packet = { .msg_type = FUSAIN_MSG_TEMP_DATA };
+    uint8_t* p = packet.payload;
+    size_t n = 0;
+    p[n++] = 0x82;
+    p[n++] = 0x18;
+    p[n++] = FUSAIN_MSG_TEMP_DATA;
+    p[n++] = 0xBF;
+    p[n++] = 0x02;
+    n += put_float64(p + n, cases[i].value);
+    p[n++] = 0x06;
+    p[n++] = 0x63; /* Text strings are copied verbatim */
+    p[n++] = 0xFB;
+    p[n++] = 0xFB;
+    p[n++] = 0xFB;
+    p[n++] = 0xFF;
+    packet.length = (uint8_t)n;
+
+    int saved = fusain_compact_floats(&packet);
+    size_t width = cases[i].head == 0xF9 ? 2 : cases[i].head == 0xFA ? 4 : 8;
+    zassert_equal(saved, (int)(8 - width), "Wrong savings for case %zu", i);
+    zassert_equal(p[5], cases[i].head, "Wrong width for case %zu", i);
+    if (width < 8) {
+      uint32_t bits = 0;
+      for (size_t b = 0; b < width; b++) {
+        bits = (bits << 8) | p[6 + b];
+      }
+      zassert_equal(bits, cases[i].bits, "Wrong bits for case %zu", i);
+    }
+    zassert_equal(p[6 + width + 2], 0xFB, "String body should be kept");
+    zassert_equal(p[packet.length - 1], 0xFF, "Break should be kept");
+
+    double d = 0.0;
+    double expect = cases[i].value;
+    zassert_equal(fusain_peek_float(&packet, 2, &d), 0, "Peek failed");
+    zassert_true(memcmp(&d, &expect, sizeof(d)) == 0 || (d != d && expect != expect),
+        "Value changed for case %zu", i);
+  }
+}
+
+ZTEST(fusain_packets, test_compact_floats_malformed)
+{
+  zassert_equal(fusain_compact_floats(NULL), -1, "NULL should fail");
+
+  fusain_packet_t packet = { .length = FUSAIN_MAX_PAYLOAD_SIZE + 1 };
+  zassert_equal(fusain_compact_floats(&packet), -1, "Oversize should fail");
+
+  /* Truncated text string: packet must stay untouched */
+  const uint8_t truncated[] = { 0x82, 0x10, 0xA1, 0x00, 0xFB, 0x3F, 0xE0, 0,
+    0, 0, 0, 0, 0, 0x01, 0x65, 'a' };
+  memcpy(packet.payload, truncated, sizeof(truncated));
+  packet.length = sizeof(truncated);
+  zassert_equal(fusain_compact_floats(&packet), -1, "Truncated string should fail");
+  zassert_equal(packet.length, sizeof(truncated), "Length should be unchanged");
+  zassert_mem_equal(packet.payload, truncated, sizeof(truncated),
+      "Payload should be unchanged");
+
+  /* Truncated float head and reserved additional information */
+  const uint8_t bad_head[] = { 0x82, 0x10, 0xFB, 0x3F };
+  memcpy(packet.payload, bad_head, sizeof(bad_head));
+  packet.length = sizeof(bad_head);
+  zassert_equal(fusain_compact_floats(&packet), -1, "Truncated float should fail");
+  packet.payload[2] = 0x1C;
+  zassert_equal(fusain_compact_floats(&packet), -1, "Reserved info should fail");
+}
+
+/* Telemetry batches */
+ZTEST(fusain_packets, test_create_telemetry_batch)
+{
+  fusain_telemetry_batch_t batch = {
+    .base_timestamp = 100000,
+    .count = 3,
+    .records = {
+        { .kind = FUSAIN_MSG_MOTOR_DATA, .index = 0, .dt_ms = 0,
+            .value_count = 2,
+            .values = { { .as.i = 2500 }, { .as.i = -3000 } } },
+        { .kind = FUSAIN_MSG_TEMP_DATA, .index = 1, .dt_ms = 250,
+            .value_count = 2,
+            .values = { { .is_float = true, .as.f = 180.5f },
+                { .is_float = true, .as.f = 23.45f } } },
+        { .kind = FUSAIN_MSG_GLOW_DATA, .index = 0, .dt_ms = 65535 },
+    },
+  };
+  fusain_packet_t packet;
+  zassert_equal(fusain_create_telemetry_batch(&packet, 0x42, &batch), 0,
+      "Create failed");
+  zassert_equal(packet.msg_type, FUSAIN_MSG_TELEMETRY_BATCH, "Wrong msg type");
+  zassert_true(packet.length <= FUSAIN_CBOR_SIZE_TELEMETRY_BATCH, "Exceeds bound");
+  zassert_true(verify_roundtrip(&packet, "telemetry_batch"), "Round-trip failed");
+
+  fusain_telemetry_batch_t decoded;
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &decoded), 0,
+      "Decode failed");
+  zassert_equal(decoded.base_timestamp, 100000, "Wrong base timestamp");
+  zassert_equal(decoded.count, 3, "Wrong record count");
+  for (uint8_t r = 0; r < batch.count; r++) {
+    const fusain_batch_record_t* want = &batch.records[r];
+    const fusain_batch_record_t* got = &decoded.records[r];
+    zassert_equal(got->kind, want->kind, "Wrong kind in record %u", r);
+    zassert_equal(got->index, want->index, "Wrong index in record %u", r);
+    zassert_equal(got->dt_ms, want->dt_ms, "Wrong dt in record %u", r);
+    zassert_equal(got->value_count, want->value_count, "Wrong count in record %u", r);
+    for (uint8_t v = 0; v < want->value_count; v++) {
+      zassert_equal(got->values[v].is_float, want->values[v].is_float,
+          "Wrong value type");
+      zassert_mem_equal(&got->values[v].as, &want->values[v].as,
+          sizeof(got->values[v].as), "Wrong value");
+    }
+  }
+
+  /* Too many values is rejected and leaves no packet */
+  batch.records[2].value_count = FUSAIN_BATCH_MAX_VALUES + 1;
+  zassert_equal(fusain_create_telemetry_batch(&packet, 0x42, &batch), -3,
+      "Oversized record should fail");
+  zassert_equal(packet.length, 0, "Failed create should clear the packet");
+}
+
+ZTEST(fusain_packets, test_telemetry_batch_builder)
+{
+  fusain_packet_t packet;
+  fusain_batch_builder_t builder;
+  fusain_motor_data_t motor = { .motor = 0, .rpm = 2500, .target = 3000 };
+  fusain_temp_data_t temp = { .thermometer = 0, .reading = 150.25f };
+  size_t single_bytes = 0;
+  uint32_t base = 0xFFFFFF00u; /* Offsets wrap with the timestamp */
+
+  fusain_batch_begin(&builder, &packet, 0x42, base);
+  int added = 0;
+  for (;;) {
+    int ret;
+    fusain_packet_t single;
+    if (added % 2 == 0) {
+      motor.timestamp = base + (uint32_t)added * 100;
+      ret = fusain_batch_add_motor(&builder, &motor);
+      fusain_create_motor_data(&single, 0x42, 0, motor.timestamp, 2500, 3000);
+    } else {
+      temp.timestamp = base + (uint32_t)added * 100;
+      ret = fusain_batch_add_temp(&builder, &temp);
+      fusain_create_temp_data(&single, 0x42, 0, temp.timestamp, 150.25f);
+    }
+    if (ret == -1) {
+      break;
+    }
+    zassert_equal(ret, 0, "Add failed");
+    single_bytes += 13 + single.length;
+    added++;
+  }
+  zassert_true(added >= 8, "Batch should hold many readings, got %d", added);
+  zassert_equal(fusain_batch_finish(&builder), added, "Wrong finish count");
+  zassert_equal(fusain_batch_finish(&builder), added, "Finish is idempotent");
+  zassert_true(packet.length <= FUSAIN_MAX_PAYLOAD_SIZE, "Overfilled payload");
+  zassert_true((size_t)(13 + packet.length) * 2 < single_bytes,
+      "Batch should be under half the size of single frames");
+  zassert_equal(fusain_batch_add_motor(&builder, &motor), -1,
+      "Finished batch should not accept records");
+
+  fusain_telemetry_batch_t decoded;
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &decoded), 0,
+      "Decode failed");
+  zassert_equal(decoded.count, added, "Wrong decoded count");
+  zassert_equal(decoded.records[1].kind, FUSAIN_MSG_TEMP_DATA, "Wrong kind");
+  zassert_equal(decoded.records[1].dt_ms, 100, "Wrong dt");
+  zassert_true(decoded.records[1].values[0].as.f == 150.25f, "Wrong reading");
+
+  /* Offsets past 16 bits need a new batch */
+  fusain_batch_begin(&builder, &packet, 0x42, 1000);
+  motor.timestamp = 1000 + 65536;
+  zassert_equal(fusain_batch_add_motor(&builder, &motor), -3, "dt overflow");
+  temp.timestamp = 999;
+  zassert_equal(fusain_batch_add_temp(&builder, &temp), -3, "Negative dt");
+
+  /* Record limit applies even when records are tiny */
+  fusain_batch_record_t empty = { .kind = FUSAIN_MSG_GLOW_DATA };
+  for (int r = 0; r < FUSAIN_BATCH_MAX_RECORDS; r++) {
+    zassert_equal(fusain_batch_add(&builder, &empty), 0, "Add failed");
+  }
+  zassert_equal(fusain_batch_add(&builder, &empty), -1, "Record limit");
+  fusain_batch_finish(&builder);
+  zassert_equal(fusain_decode_telemetry_batch(&packet, &decoded), 0,
+      "Decode failed");
+  zassert_equal(decoded.count, FUSAIN_BATCH_MAX_RECORDS, "Wrong count");
+}
+
 /* Test suite setup */
 ZTEST_SUITE(fusain_packets, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Polling Scheduler Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+static void poll_setup(fusain_poll_scheduler_t* scheduler, uint8_t max_in_flight)
+{
+  fusain_poll_config_t config = {
+    .baud_rate = 115200,
+    .max_in_flight = max_in_flight,
+    .guard_us = 100,
+    .initial_turnaround_us = 2000,
+    .min_timeout_us = 1000,
+    .max_timeout_us = 50000,
+  };
+  fusain_poll_init(scheduler, &config);
+}
+
+/* Build the telemetry an appliance would answer with */
+static void poll_reply(fusain_packet_t* packet, uint64_t address)
+{
+  fusain_create_state_data(packet, address, 0, 0, FUSAIN_STATE_IDLE, 1000);
+}
+
+/* Test target registration limits */
+ZTEST(fusain_poll, test_poll_add_remove)
+{
+  fusain_poll_scheduler_t scheduler;
+  poll_setup(&scheduler, 1);
+
+  zassert_equal(fusain_poll_add(&scheduler, 0x100, 0, 0, 0), -1, "Zero period rejected");
+  zassert_equal(fusain_poll_add(&scheduler, FUSAIN_ADDRESS_BROADCAST, 0, 1000, 0), -1,
+      "Broadcast rejected");
+  zassert_equal(fusain_poll_add(&scheduler, FUSAIN_ADDRESS_GROUP(3), 0, 1000, 0), -1,
+      "Group rejected");
+
+  for (int i = 0; i < FUSAIN_POLL_MAX_TARGETS; i++) {
+    zassert_equal(fusain_poll_add(&scheduler, 0x100 + i, 0, 1000, 0), i, "Index returned");
+  }
+  zassert_equal(fusain_poll_add(&scheduler, 0x100, 0, 1000, 0), -1, "Duplicate rejected");
+  zassert_equal(fusain_poll_add(&scheduler, 0x999, 0, 1000, 0), -2, "Table full");
+
+  zassert_equal(fusain_poll_remove(&scheduler, 0x999), -1, "Unknown address");
+  zassert_equal(fusain_poll_remove(&scheduler, 0x100), 0, "Removed");
+  zassert_equal(scheduler.target_count, FUSAIN_POLL_MAX_TARGETS - 1, "One fewer target");
+  zassert_equal(scheduler.heap_size, FUSAIN_POLL_MAX_TARGETS - 1, "Heap shrank");
+  zassert_equal(fusain_poll_add(&scheduler, 0x999, 0, 1000, 0),
+      FUSAIN_POLL_MAX_TARGETS - 1, "Room again");
+
+  /* Heap and target table stay consistent after the swap-remove */
+  for (uint8_t i = 0; i < scheduler.heap_size; i++) {
+    zassert_equal(scheduler.targets[scheduler.heap[i]].heap_slot, i, "Heap slot %u", i);
+  }
+}
+
+/* Test earliest-deadline-first selection and poll rates */
+ZTEST(fusain_poll, test_poll_edf)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_packet_t packet;
+  fusain_packet_t reply;
+  uint64_t wake;
+  uint32_t counts[3] = { 0 };
+  const uint64_t addresses[3] = { 0x10, 0x20, 0x30 };
+
+  poll_setup(&scheduler, 1);
+  fusain_poll_add(&scheduler, addresses[0], 0, 100000, 0);
+  fusain_poll_add(&scheduler, addresses[1], 1, 200000, 0);
+  fusain_poll_add(&scheduler, addresses[2], 2, 400000, 0);
+
+  /* Nothing happens before the first deadline */
+  fusain_poll_add(&scheduler, 0x40, 0, 1000000, 5000);
+  zassert_equal(fusain_poll_remove(&scheduler, 0x40), 0, "Removed");
+
+  uint64_t now = 0;
+  while (now < 2000000) {
+    if (fusain_poll_next(&scheduler, now, &packet, &wake)) {
+      zassert_equal(packet.msg_type, FUSAIN_MSG_SEND_TELEMETRY, "Poll type");
+      int index = -1;
+      for (int i = 0; i < 3; i++) {
+        if (packet.address == addresses[i]) {
+          index = i;
+        }
+      }
+      zassert_true(index >= 0, "Known target");
+      counts[index]++;
+
+      /* Answer 5 ms after the request */
+      poll_reply(&reply, packet.address);
+      now += 5000;
+      zassert_equal(fusain_poll_response(&scheduler, &reply, now), 0, "Matched");
+      continue;
+    }
+    zassert_true(wake > now && wake != UINT64_MAX, "Wake in the future");
+    now = wake;
+  }
+
+  zassert_equal(counts[0], 20, "10 Hz target: %u", counts[0]);
+  zassert_equal(counts[1], 10, "5 Hz target: %u", counts[1]);
+  zassert_equal(counts[2], 5, "2.5 Hz target: %u", counts[2]);
+  zassert_equal(scheduler.targets[0].polls, scheduler.targets[0].responses, "All answered");
+}
+
+/* Test latency learning, timeouts and unexpected responses */
+ZTEST(fusain_poll, test_poll_latency)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_packet_t packet;
+  fusain_packet_t reply;
+  uint64_t wake;
+
+  poll_setup(&scheduler, 1);
+  fusain_poll_add(&scheduler, 0x55, 0, 20000, 0);
+  poll_reply(&reply, 0x55);
+  zassert_equal(fusain_poll_response(&scheduler, &reply, 0), -1, "Nothing outstanding");
+
+  uint64_t now = 0;
+  for (int i = 0; i < 20; i++) {
+    zassert_equal(fusain_poll_next(&scheduler, now, &packet, &wake), 1, "Poll %d", i);
+    uint64_t sent = scheduler.flights[0].sent_us;
+
+    /* Appliance answers 3 ms after the request ends */
+    uint64_t done = sent + 3000 + (uint64_t)(reply.length + 13) * 10 * 1000000 / 115200;
+    zassert_equal(fusain_poll_response(&scheduler, &reply, done), 0, "Matched");
+    now += 20000;
+  }
+
+  const fusain_poll_target_t* target = &scheduler.targets[0];
+  zassert_true(target->turnaround_us >= 2990 && target->turnaround_us <= 3010,
+      "Turnaround learned: %u", target->turnaround_us);
+  zassert_true(target->turnaround_var_us < 100, "Variance settled: %u",
+      target->turnaround_var_us);
+
+  /* A silent appliance times out and is polled again on schedule */
+  zassert_equal(fusain_poll_next(&scheduler, now, &packet, &wake), 1, "Poll sent");
+  uint64_t timeout = scheduler.flights[0].timeout_us;
+  zassert_equal(timeout - scheduler.flights[0].sent_us,
+      target->turnaround_us + target->response_air_us + 4 * target->turnaround_var_us,
+      "Timeout tracks latency");
+  zassert_equal(wake, timeout, "Wake for the timeout");
+
+  zassert_equal(fusain_poll_next(&scheduler, timeout - 1, &packet, &wake), 0, "Still waiting");
+  zassert_equal(fusain_poll_next(&scheduler, timeout, &packet, &wake), 0, "Not due yet");
+  zassert_equal(target->timeouts, 1, "Timeout counted");
+  zassert_equal(scheduler.in_flight, 0, "Flight released");
+  zassert_equal(wake, now + 20000, "Next deadline");
+  zassert_equal(fusain_poll_response(&scheduler, &reply, timeout + 10), -1, "Late reply");
+
+  /* Each timeout widens the next one */
+  uint32_t var = target->turnaround_var_us;
+  zassert_equal(fusain_poll_next(&scheduler, now + 20000, &packet, &wake), 1, "Poll sent");
+  zassert_equal(fusain_poll_next(&scheduler, wake, &packet, &wake), 0, "Expired");
+  zassert_equal(target->turnaround_var_us, var * 2 + 1, "Deviation doubled");
+}
+
+/* Test pipelining into the turnaround gap of a slow appliance */
+ZTEST(fusain_poll, test_poll_pipeline)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_packet_t packet;
+  fusain_packet_t reply;
+  uint64_t wake;
+
+  for (uint8_t depth = 1; depth <= 2; depth++) {
+    poll_setup(&scheduler, depth);
+    fusain_poll_add(&scheduler, 0xA, 0, 100000, 0);
+    fusain_poll_add(&scheduler, 0xB, 0, 100000, 0);
+
+    /* As if learned: A answers after 20 ms, B after 1 ms */
+    scheduler.targets[0].turnaround_us = 20000;
+    scheduler.targets[0].turnaround_var_us = 500;
+    scheduler.targets[1].turnaround_us = 1000;
+    scheduler.targets[1].turnaround_var_us = 100;
+
+    zassert_equal(fusain_poll_next(&scheduler, 0, &packet, &wake), 1, "First poll");
+    uint64_t address = packet.address;
+    uint64_t tx_end = scheduler.flights[0].sent_us;
+    zassert_equal(wake, depth == 1 ? scheduler.flights[0].timeout_us : tx_end + 100,
+        "Wake %u", depth);
+
+    int second = fusain_poll_next(&scheduler, tx_end + 100, &packet, &wake);
+    if (depth == 1) {
+      zassert_equal(second, 0, "Waits for the response");
+      continue;
+    }
+
+    /* The slow appliance was polled first (same deadline, lower index) and
+     * the fast one fits in its turnaround gap */
+    zassert_equal(address, 0xA, "Slow appliance first");
+    zassert_equal(second, 1, "Pipelined");
+    zassert_equal(packet.address, 0xB, "Fast appliance second");
+    zassert_equal(scheduler.in_flight, 2, "Two outstanding");
+    zassert_true(scheduler.flights[1].rx_end_us + 100 <= scheduler.flights[0].rx_start_us,
+        "Windows disjoint");
+
+    /* Both responses arrive in order */
+    poll_reply(&reply, 0xB);
+    zassert_equal(fusain_poll_response(&scheduler, &reply, scheduler.flights[1].rx_end_us), 0,
+        "Fast reply");
+    poll_reply(&reply, 0xA);
+    zassert_equal(fusain_poll_response(&scheduler, &reply, scheduler.flights[0].rx_end_us), 0,
+        "Slow reply");
+    zassert_equal(scheduler.in_flight, 0, "Idle");
+  }
+}
+
+/* Test that overlapping predicted windows hold a request back */
+ZTEST(fusain_poll, test_poll_window_conflict)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_packet_t packet;
+  uint64_t wake;
+
+  poll_setup(&scheduler, 4);
+  fusain_poll_add(&scheduler, 0xA, 0, 100000, 0);
+  fusain_poll_add(&scheduler, 0xB, 0, 100000, 0);
+
+  zassert_equal(fusain_poll_next(&scheduler, 0, &packet, &wake), 1, "First poll");
+  uint64_t blocked = scheduler.flights[0].rx_end_us + 100;
+  zassert_equal(fusain_poll_next(&scheduler, wake, &packet, &wake), 0, "Would collide");
+  zassert_equal(wake, blocked, "Wake once the window passes");
+
+  /* Removing the outstanding target frees the bus */
+  zassert_equal(fusain_poll_remove(&scheduler, 0xA), 0, "Removed");
+  zassert_equal(scheduler.in_flight, 0, "Flight dropped");
+  zassert_equal(fusain_poll_next(&scheduler, scheduler.tx_free_us, &packet, &wake), 1,
+      "Second poll");
+  zassert_equal(packet.address, 0xB, "Remaining target");
+
+  /* Swap-remove repoints the outstanding poll of the moved target */
+  zassert_equal(fusain_poll_remove(&scheduler, 0xB), 0, "Removed B");
+  fusain_poll_add(&scheduler, 0xC, 0, 100000, 500000);
+  fusain_poll_add(&scheduler, 0xE, 0, 100000, 200000);
+  zassert_equal(fusain_poll_next(&scheduler, 200000, &packet, &wake), 1, "Poll E");
+  zassert_equal(packet.address, 0xE, "Earliest deadline");
+  zassert_equal(fusain_poll_remove(&scheduler, 0xC), 0, "Removed C");
+  zassert_equal(scheduler.targets[0].address, 0xE, "Moved into the hole");
+  zassert_equal(scheduler.flights[0].target, 0, "Flight repointed");
+  fusain_packet_t reply;
+  poll_reply(&reply, 0xE);
+  zassert_equal(fusain_poll_response(&scheduler, &reply, scheduler.flights[0].rx_end_us), 0,
+      "Reply matched");
+  zassert_equal(fusain_poll_remove(&scheduler, 0xE), 0, "Removed E");
+  zassert_equal(scheduler.target_count, 0, "Empty");
+  zassert_equal(fusain_poll_next(&scheduler, 300000, &packet, &wake), 0, "Nothing to poll");
+  zassert_equal(wake, UINT64_MAX, "Nothing scheduled");
+}
+
+/* Test configuration clamping and catch-up after falling behind */
+ZTEST(fusain_poll, test_poll_limits)
+{
+  fusain_poll_scheduler_t scheduler;
+  fusain_packet_t packet;
+  fusain_packet_t reply;
+  uint64_t wake;
+  fusain_poll_config_t config = {
+    .baud_rate = 0,
+    .max_in_flight = 0,
+    .min_timeout_us = 3000,
+    .max_timeout_us = 1000,
+  };
+
+  fusain_poll_init(&scheduler, &config);
+  zassert_equal(scheduler.config.max_in_flight, 1, "At least one in flight");
+  zassert_equal(scheduler.config.max_timeout_us, 3000, "Bounds ordered");
+  config.max_in_flight = 200;
+  fusain_poll_init(&scheduler, &config);
+  zassert_equal(scheduler.config.max_in_flight, FUSAIN_POLL_MAX_IN_FLIGHT, "Capped");
+
+  /* Unknown airtime: the timeout is held at its minimum */
+  fusain_poll_add(&scheduler, 0x1, 0, 1000, 0);
+  zassert_equal(fusain_poll_next(&scheduler, 0, &packet, &wake), 1, "Polled");
+  zassert_equal(scheduler.flights[0].timeout_us, 3000, "Minimum timeout");
+
+  /* A very late reply is clamped before it skews the estimate */
+  poll_reply(&reply, 0x1);
+  zassert_equal(fusain_poll_response(&scheduler, &reply, 1000000), 0, "Matched");
+  zassert_equal(scheduler.targets[0].turnaround_us, 3000, "Sample clamped");
+
+  /* Missed periods are not made up in a burst */
+  zassert_equal(fusain_poll_next(&scheduler, 1000000, &packet, &wake), 1, "Polled");
+  zassert_equal(scheduler.targets[0].deadline_us, 1000000, "Deadline floored");
+  zassert_equal(scheduler.flights[0].timeout_us, 1003000, "Maximum timeout");
+
+  /* Deadlines come out in order whatever order they went in */
+  poll_setup(&scheduler, 1);
+  const uint64_t deadlines[] = { 50, 10, 40, 30, 20, 60, 0 };
+  for (size_t i = 0; i < sizeof(deadlines) / sizeof(deadlines[0]); i++) {
+    fusain_poll_add(&scheduler, 0x100 + i, 0, 1000000, deadlines[i] * 1000);
+  }
+  uint64_t last = 0;
+  for (size_t i = 0; i < sizeof(deadlines) / sizeof(deadlines[0]); i++) {
+    zassert_equal(fusain_poll_next(&scheduler, 100000 + i * 100000, &packet, &wake), 1,
+        "Polled");
+    uint64_t deadline = deadlines[packet.address - 0x100];
+    zassert_true(deadline >= last, "EDF order at %u", (unsigned)i);
+    last = deadline;
+    poll_reply(&reply, packet.address);
+    fusain_poll_response(&scheduler, &reply, 100000 + i * 100000 + 50000);
+  }
+}
+
+ZTEST_SUITE(fusain_poll, NULL, NULL, NULL, NULL, NULL);
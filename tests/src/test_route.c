@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Routing Table Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+static fusain_route_bucket_t route_buckets[256];
+static fusain_route_bucket_t route_spare[256];
+
+/* Test setup arguments and an empty table */
+ZTEST(fusain_route, test_route_init)
+{
+  fusain_route_t table;
+  uint32_t route;
+
+  zassert_equal(sizeof(fusain_route_bucket_t), 64, "One cache line per bucket");
+  zassert_equal(fusain_route_init(&table, route_buckets, NULL, 6), -1, "Not a power of two");
+  zassert_equal(fusain_route_init(&table, route_buckets, NULL, 0), -1, "Empty");
+  zassert_equal(fusain_route_init(&table, NULL, NULL, 4), -1, "No storage");
+  zassert_equal(fusain_route_init(&table, route_buckets, NULL, 4), 0, "Init");
+  zassert_equal(fusain_route_lookup(&table, 0x1234, &route), -1, "Empty table");
+  zassert_equal(fusain_route_remove(&table, 0x1234), -1, "Nothing to remove");
+  zassert_is_null(fusain_route_compact(&table), "No spare");
+}
+
+/* Test add, change, remove and re-add of one address */
+ZTEST(fusain_route, test_route_set_remove)
+{
+  fusain_route_t table;
+  uint32_t route;
+  zassert_equal(fusain_route_init(&table, route_buckets, NULL, 4), 0, "Init");
+
+  zassert_equal(fusain_route_set(&table, 0x0102030405060708ULL, 7), 1, "Added");
+  zassert_equal(fusain_route_set(&table, FUSAIN_ADDRESS_BROADCAST, 9), 1, "Multicast too");
+  zassert_equal(fusain_route_lookup(&table, 0x0102030405060708ULL, &route), 0, "Found");
+  zassert_equal(route, 7, "Route");
+  zassert_equal(fusain_route_set(&table, 0x0102030405060708ULL, 8), 0, "Changed");
+  zassert_equal(fusain_route_lookup(&table, 0x0102030405060708ULL, &route), 0, "Found");
+  zassert_equal(route, 8, "New route");
+  zassert_equal(table.count, 2, "Two entries");
+
+  zassert_equal(fusain_route_remove(&table, 0x0102030405060708ULL), 0, "Removed");
+  zassert_equal(fusain_route_remove(&table, 0x0102030405060708ULL), -1, "Already removed");
+  zassert_equal(fusain_route_lookup(&table, 0x0102030405060708ULL, &route), -1, "Gone");
+  zassert_equal(table.removed, 1, "Slot held back");
+
+  zassert_equal(fusain_route_set(&table, 0x0102030405060708ULL, 3), 1, "Re-added");
+  zassert_equal(table.removed, 0, "Own slot reused");
+  zassert_equal(fusain_route_lookup(&table, 0x0102030405060708ULL, &route), 0, "Found");
+  zassert_equal(route, 3, "Route");
+  zassert_equal(fusain_route_lookup(&table, FUSAIN_ADDRESS_BROADCAST, &route), 0, "Found");
+  zassert_equal(route, 9, "Untouched");
+}
+
+/* Test the fill limit and reclaiming removed slots by compaction */
+ZTEST(fusain_route, test_route_compact)
+{
+  fusain_route_t table;
+  uint32_t route;
+  zassert_equal(fusain_route_init(&table, route_buckets, route_spare, 4), 0, "Init");
+
+  /* 4 buckets of 4 slots: 14 fit under the 7/8 limit */
+  for (uint64_t a = 0; a < 14; a++) {
+    zassert_equal(fusain_route_set(&table, 100 + a, (uint32_t)a), 1, "Add %u", (unsigned)a);
+  }
+  zassert_equal(fusain_route_set(&table, 200, 0), -2, "Full");
+  for (uint64_t a = 0; a < 14; a++) {
+    zassert_equal(fusain_route_lookup(&table, 100 + a, &route), 0, "Find %u", (unsigned)a);
+    zassert_equal(route, (uint32_t)a, "Route %u", (unsigned)a);
+  }
+  zassert_equal(fusain_route_lookup(&table, 200, &route), -1, "Not added");
+
+  /* Compact a full table there and back: entries spill into later buckets */
+  fusain_route_recycle(&table, fusain_route_compact(&table));
+  fusain_route_recycle(&table, fusain_route_compact(&table));
+  zassert_equal_ptr(table.buckets, route_buckets, "Back in the first array");
+  for (uint64_t a = 0; a < 14; a++) {
+    zassert_equal(fusain_route_lookup(&table, 100 + a, &route), 0, "Find %u", (unsigned)a);
+  }
+
+  for (uint64_t a = 0; a < 14; a += 2) {
+    zassert_equal(fusain_route_remove(&table, 100 + a), 0, "Remove %u", (unsigned)a);
+  }
+  zassert_equal(fusain_route_set(&table, 200, 0), -2, "Removed slots still held");
+
+  fusain_route_bucket_t* retired = fusain_route_compact(&table);
+  zassert_equal_ptr(retired, route_buckets, "Old array retired");
+  zassert_equal_ptr(table.buckets, route_spare, "Spare published");
+  zassert_equal(table.removed, 0, "Reclaimed");
+  zassert_equal(table.count, 7, "Live entries kept");
+  for (uint64_t a = 0; a < 14; a++) {
+    int expected = (a % 2) ? 0 : -1;
+    zassert_equal(fusain_route_lookup(&table, 100 + a, &route), expected, "Find %u", (unsigned)a);
+    if (expected == 0) {
+      zassert_equal(route, (uint32_t)a, "Route %u", (unsigned)a);
+    }
+  }
+  zassert_equal(fusain_route_set(&table, 200, 42), 1, "Room again");
+
+  zassert_is_null(fusain_route_compact(&table), "Retired array still in grace");
+  fusain_route_recycle(&table, retired);
+  zassert_equal_ptr(fusain_route_compact(&table), route_spare, "Compacts back");
+  zassert_equal(fusain_route_lookup(&table, 200, &route), 0, "Found");
+  zassert_equal(route, 42, "Route");
+}
+
+/* Test random adds and removes against a reference array */
+ZTEST(fusain_route, test_route_random)
+{
+  enum { KEYS = 600 };
+  static uint32_t expected[KEYS];
+  static bool live[KEYS];
+  fusain_route_t table;
+  uint32_t seed = 12345;
+  uint32_t route;
+
+  memset(live, 0, sizeof(live));
+  zassert_equal(fusain_route_init(&table, route_buckets, route_spare, 256), 0, "Init");
+
+  for (int step = 0; step < 20000; step++) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t key = (seed >> 8) % KEYS;
+    uint64_t address = 0xA5A5000000000000ULL + (uint64_t)key * 0x10001ULL;
+    if ((seed >> 28) < 11) {
+      zassert_equal(fusain_route_set(&table, address, step), live[key] ? 0 : 1, "Set");
+      expected[key] = (uint32_t)step;
+      live[key] = true;
+    } else {
+      zassert_equal(fusain_route_remove(&table, address), live[key] ? 0 : -1, "Remove");
+      live[key] = false;
+    }
+    if (step % 5000 == 4999) {
+      fusain_route_recycle(&table, fusain_route_compact(&table));
+      zassert_equal(table.removed, 0, "Reclaimed");
+    }
+  }
+
+  uint32_t count = 0;
+  for (uint32_t key = 0; key < KEYS; key++) {
+    uint64_t address = 0xA5A5000000000000ULL + (uint64_t)key * 0x10001ULL;
+    int ret = fusain_route_lookup(&table, address, &route);
+    zassert_equal(ret, live[key] ? 0 : -1, "Lookup %u", key);
+    if (live[key]) {
+      zassert_equal(route, expected[key], "Route %u", key);
+      count++;
+    }
+  }
+  zassert_equal(table.count, count, "Count");
+}
+
+ZTEST_SUITE(fusain_route, NULL, NULL, NULL, NULL, NULL);
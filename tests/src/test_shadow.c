@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Device Shadow Tests
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+#define HEATER 0x0102030405060708ULL
+
+static fusain_shadow_device_t shadow_table[16];
+
+static void shadow_setup(fusain_shadow_t* shadow)
+{
+  zassert_equal(fusain_shadow_init(shadow, shadow_table, 16), 0, "Init");
+}
+
+/* Test setup and lookups of unknown data */
+ZTEST(fusain_shadow, test_shadow_init)
+{
+  fusain_shadow_t shadow;
+  fusain_state_data_t state;
+
+  zassert_equal(fusain_shadow_init(&shadow, shadow_table, 12), -1, "Not a power of two");
+  zassert_equal(fusain_shadow_init(&shadow, shadow_table, 0), -1, "Empty");
+  zassert_equal(fusain_shadow_init(&shadow, NULL, 16), -1, "No storage");
+  shadow_setup(&shadow);
+
+  zassert_equal(fusain_shadow_read_state(&shadow, HEATER, &state), -1, "Unknown device");
+
+  fusain_packet_t packet;
+  fusain_create_ping_response(&packet, HEATER, 1000);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 1, "Not shadowed");
+  zassert_equal(shadow.count, 0, "No device created");
+}
+
+/* Test every single-reading message type */
+ZTEST(fusain_shadow, test_shadow_messages)
+{
+  fusain_shadow_t shadow;
+  fusain_packet_t packet;
+  shadow_setup(&shadow);
+
+  fusain_create_state_data(&packet, HEATER, 1, FUSAIN_ERROR_OVERHEAT, FUSAIN_STATE_ERROR, 500);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 10), 0, "State");
+  fusain_create_device_announce(&packet, HEATER, 1, 2, 1, 1);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 11), 0, "Announce");
+  fusain_create_pump_data(&packet, HEATER, 0, 600, FUSAIN_PUMP_EVENT_PULSE_END, 250);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 12), 0, "Pump");
+  fusain_create_glow_data(&packet, HEATER, 0, 700, true);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 13), 0, "Glow");
+  fusain_create_temp_data(&packet, HEATER, 1, 800, 21.5f);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 14), 0, "Temp");
+  zassert_equal(shadow.count, 1, "One device");
+
+  fusain_state_data_t state;
+  zassert_equal(fusain_shadow_read_state(&shadow, HEATER, &state), 0, "Read state");
+  zassert_true(state.error, "Error flag");
+  zassert_equal(state.code, FUSAIN_ERROR_OVERHEAT, "Code");
+  zassert_equal(state.state, FUSAIN_STATE_ERROR, "State");
+  zassert_equal(state.timestamp, 500, "Timestamp");
+
+  fusain_device_caps_t caps;
+  zassert_equal(fusain_shadow_read_caps(&shadow, HEATER, &caps), 0, "Read caps");
+  zassert_equal(caps.motor_count, 1, "Motors");
+  zassert_equal(caps.thermometer_count, 2, "Thermometers");
+  zassert_equal(caps.pump_count, 1, "Pumps");
+  zassert_equal(caps.glow_count, 1, "Glow plugs");
+
+  fusain_pump_data_t pump;
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 0, &pump), 0, "Read pump");
+  zassert_equal(pump.event, FUSAIN_PUMP_EVENT_PULSE_END, "Event");
+  zassert_equal(pump.rate, 250, "Rate");
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 1, &pump), -2, "Pump 1 silent");
+
+  fusain_glow_data_t glow;
+  zassert_equal(fusain_shadow_read_glow(&shadow, HEATER, 0, &glow), 0, "Read glow");
+  zassert_true(glow.lit, "Lit");
+  zassert_equal(glow.timestamp, 700, "Glow timestamp");
+
+  fusain_temp_data_t temp;
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 0, &temp), -2, "Thermometer 0 silent");
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 1, &temp), 0, "Read temp");
+  zassert_equal(temp.thermometer, 1, "Index");
+  zassert_true(temp.reading == 21.5f, "Reading");
+
+  fusain_motor_data_t motor;
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 0, &motor), -2, "Motor silent");
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, FUSAIN_SHADOW_MAX_PERIPHERALS,
+                    &motor),
+      -2, "Beyond the table");
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER + 1, FUSAIN_SHADOW_MAX_PERIPHERALS,
+                    &motor),
+      -1, "Unknown device");
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, FUSAIN_SHADOW_MAX_PERIPHERALS, &pump),
+      -2, "Beyond the table");
+  zassert_equal(fusain_shadow_read_pump(&shadow, 1, FUSAIN_SHADOW_MAX_PERIPHERALS, &pump),
+      -1, "Unknown device");
+  zassert_equal(fusain_shadow_read_glow(&shadow, HEATER, FUSAIN_SHADOW_MAX_PERIPHERALS, &glow),
+      -2, "Beyond the table");
+  zassert_equal(fusain_shadow_read_glow(&shadow, 1, FUSAIN_SHADOW_MAX_PERIPHERALS, &glow),
+      -1, "Unknown device");
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, FUSAIN_SHADOW_MAX_PERIPHERALS, &temp),
+      -2, "Beyond the table");
+  zassert_equal(fusain_shadow_read_temp(&shadow, 1, FUSAIN_SHADOW_MAX_PERIPHERALS, &temp),
+      -1, "Unknown device");
+
+  fusain_shadow_record_t record;
+  zassert_equal(fusain_shadow_snapshot(&shadow, HEATER, &record), 0, "Snapshot");
+  zassert_equal(record.updated_ms, 14, "Update time");
+  zassert_equal(record.temp_mask, 0x02, "Thermometer 1 reported");
+
+  const fusain_shadow_device_t* entry = NULL;
+  for (size_t i = 0; i < sizeof(shadow_table) / sizeof(shadow_table[0]); i++) {
+    if (shadow_table[i].in_use && shadow_table[i].address == HEATER) {
+      entry = &shadow_table[i];
+    }
+  }
+  zassert_not_null(entry, "Table entry");
+  zassert_equal(entry->seq, 10, "Two steps per update");
+  zassert_mem_equal(&entry->copies[0], &entry->copies[1], sizeof(fusain_shadow_record_t),
+      "Both copies in step when idle");
+  zassert_equal(fusain_shadow_snapshot(&shadow, 1, &record), -1, "Unknown device");
+}
+
+/* Test that optional fields left out keep their last value */
+ZTEST(fusain_shadow, test_shadow_optional_fields)
+{
+  fusain_shadow_t shadow;
+  fusain_packet_t packet;
+  fusain_motor_data_t motor = {
+    .motor = 1, .timestamp = 100, .rpm = 2000, .target = 2100,
+    .max_rpm = 5000, .min_rpm = 800, .pwm = 40, .pwm_max = 100,
+  };
+  shadow_setup(&shadow);
+
+  fusain_create_motor_data_fields(&packet, HEATER, &motor, FUSAIN_MOTOR_DATA_OPTIONAL);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Full motor");
+  fusain_create_motor_data(&packet, HEATER, 1, 200, 2050, 2100);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Delta motor");
+
+  fusain_motor_data_t read;
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 1, &read), 0, "Read");
+  zassert_equal(read.rpm, 2050, "New rpm");
+  zassert_equal(read.timestamp, 200, "New timestamp");
+  zassert_equal(read.max_rpm, 5000, "Kept max");
+  zassert_equal(read.min_rpm, 800, "Kept min");
+  zassert_equal(read.pwm, 40, "Kept pwm");
+  zassert_equal(read.pwm_max, 100, "Kept pwm max");
+
+  fusain_temp_data_t temp = {
+    .thermometer = 0, .timestamp = 10, .reading = 80.0f,
+    .rpm_control = true, .watched_motor = 1, .target_temp = 90.0f,
+  };
+  fusain_create_temp_data_fields(&packet, HEATER, &temp,
+      FUSAIN_TEMP_DATA_RPM_CONTROL | FUSAIN_TEMP_DATA_WATCHED_MOTOR
+          | FUSAIN_TEMP_DATA_TARGET_TEMP);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Full temp");
+  fusain_create_temp_data(&packet, HEATER, 0, 20, 81.0f);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Delta temp");
+
+  fusain_temp_data_t read_temp;
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 0, &read_temp), 0, "Read");
+  zassert_true(read_temp.reading == 81.0f, "New reading");
+  zassert_true(read_temp.rpm_control, "Kept rpm control");
+  zassert_equal(read_temp.watched_motor, 1, "Kept watched motor");
+  zassert_true(read_temp.target_temp == 90.0f, "Kept target");
+
+  /* PUMP_DATA without a rate (key 3) keeps the last one */
+  fusain_create_pump_data(&packet, HEATER, 2, 10, FUSAIN_PUMP_EVENT_CYCLE_START, 300);
+  fusain_shadow_update(&shadow, &packet, 0);
+  static const uint8_t no_rate[] = { 0x82, 0x18, 0x32, 0xA3, 0x00, 0x02, 0x01, 0x14, 0x02,
+    FUSAIN_PUMP_EVENT_CYCLE_END };
+  memcpy(packet.payload, no_rate, sizeof(no_rate));
+  packet.length = sizeof(no_rate);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Pump event");
+
+  fusain_pump_data_t pump;
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 2, &pump), 0, "Read");
+  zassert_equal(pump.event, FUSAIN_PUMP_EVENT_CYCLE_END, "New event");
+  zassert_equal(pump.timestamp, 20, "New timestamp");
+  zassert_equal(pump.rate, 300, "Kept rate");
+}
+
+/* Test malformed payloads, out-of-range indices and a full table */
+ZTEST(fusain_shadow, test_shadow_rejects)
+{
+  fusain_shadow_t shadow;
+  fusain_packet_t packet;
+  static const uint8_t types[] = { FUSAIN_MSG_STATE_DATA, FUSAIN_MSG_MOTOR_DATA,
+    FUSAIN_MSG_PUMP_DATA, FUSAIN_MSG_GLOW_DATA, FUSAIN_MSG_TEMP_DATA,
+    FUSAIN_MSG_DEVICE_ANNOUNCE, FUSAIN_MSG_TELEMETRY_BATCH };
+  shadow_setup(&shadow);
+
+  /* A PING_RESPONSE payload under each shadowed type: key 0 out of range,
+   * then key 0 valid and key 1 missing */
+  for (size_t i = 0; i < sizeof(types); i++) {
+    fusain_create_ping_response(&packet, HEATER, 1000);
+    packet.msg_type = types[i];
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Malformed 0x%02x", types[i]);
+    fusain_create_ping_response(&packet, HEATER, 0);
+    packet.msg_type = types[i];
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Missing 0x%02x", types[i]);
+  }
+
+  /* Wrong value types in optional keys */
+  static const uint8_t bad_motor[] = { 0x82, 0x18, 0x31, 0xA5, 0x00, 0x00, 0x01, 0x00, 0x02,
+    0x00, 0x03, 0x00, 0x04, 0xF5 };
+  static const uint8_t bad_pwm[] = { 0x82, 0x18, 0x31, 0xA5, 0x00, 0x00, 0x01, 0x00, 0x02,
+    0x00, 0x03, 0x00, 0x06, 0x20 };
+  static const uint8_t bad_rate[] = { 0x82, 0x18, 0x32, 0xA4, 0x00, 0x00, 0x01, 0x00, 0x02,
+    0x00, 0x03, 0xF4 };
+  static const uint8_t bad_glow[] = { 0x82, 0x18, 0x33, 0xA3, 0x00, 0x00, 0x01, 0x00, 0x02,
+    0x00 };
+  const struct {
+    uint8_t type;
+    const uint8_t* payload;
+    size_t length;
+  } bad[] = {
+    { FUSAIN_MSG_MOTOR_DATA, bad_motor, sizeof(bad_motor) },
+    { FUSAIN_MSG_MOTOR_DATA, bad_pwm, sizeof(bad_pwm) },
+    { FUSAIN_MSG_PUMP_DATA, bad_rate, sizeof(bad_rate) },
+    { FUSAIN_MSG_GLOW_DATA, bad_glow, sizeof(bad_glow) },
+  };
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    packet.msg_type = bad[i].type;
+    memcpy(packet.payload, bad[i].payload, bad[i].length);
+    packet.length = (uint8_t)bad[i].length;
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Bad field %u", (unsigned)i);
+  }
+
+  /* Indices past the per-kind limit */
+  const uint8_t high = FUSAIN_SHADOW_MAX_PERIPHERALS;
+  fusain_create_motor_data(&packet, HEATER, high, 0, 0, 0);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -3, "Motor");
+  fusain_create_pump_data(&packet, HEATER, high, 0, FUSAIN_PUMP_EVENT_ERROR, 0);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -3, "Pump");
+  fusain_create_glow_data(&packet, HEATER, high, 0, false);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -3, "Glow");
+  fusain_create_temp_data(&packet, HEATER, high, 0, 0.0f);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -3, "Temp");
+  zassert_equal(shadow.count, 0, "Nothing stored");
+
+  /* Fill the table, then every kind reports it full */
+  for (uint64_t i = 0; i < 16; i++) {
+    fusain_create_glow_data(&packet, 0x100 + i, 0, 0, false);
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Device %u", (unsigned)i);
+  }
+  fusain_create_glow_data(&packet, 0x100, 1, 0, true);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "Known device still updates");
+
+  fusain_batch_builder_t builder;
+  fusain_packet_t batch;
+  fusain_batch_begin(&builder, &batch, 0x999, 0);
+  fusain_batch_finish(&builder);
+  fusain_packet_t full[7];
+  fusain_create_state_data(&full[0], 0x999, 0, 0, FUSAIN_STATE_IDLE, 0);
+  fusain_create_device_announce(&full[1], 0x999, 1, 1, 1, 1);
+  fusain_create_motor_data(&full[2], 0x999, 0, 0, 0, 0);
+  fusain_create_pump_data(&full[3], 0x999, 0, 0, FUSAIN_PUMP_EVENT_ERROR, 0);
+  fusain_create_glow_data(&full[4], 0x999, 0, 0, false);
+  fusain_create_temp_data(&full[5], 0x999, 0, 0, 0.0f);
+  full[6] = batch;
+  for (size_t i = 0; i < 7; i++) {
+    zassert_equal(fusain_shadow_update(&shadow, &full[i], 0), -2, "Full 0x%02x",
+        full[i].msg_type);
+  }
+  fusain_state_data_t state;
+  zassert_equal(fusain_shadow_read_state(&shadow, 0x999, &state), -1, "Not found in a full table");
+}
+
+/* Test TELEMETRY_BATCH records */
+ZTEST(fusain_shadow, test_shadow_batch)
+{
+  fusain_shadow_t shadow;
+  fusain_packet_t packet;
+  fusain_batch_builder_t builder;
+  shadow_setup(&shadow);
+
+  fusain_motor_data_t motor = { .motor = 0, .timestamp = 1010, .rpm = 1500, .target = 1600 };
+  fusain_temp_data_t temp = { .thermometer = 1, .timestamp = 1020, .reading = 55.25f };
+  fusain_batch_record_t pump = { .kind = FUSAIN_MSG_PUMP_DATA, .index = 0, .dt_ms = 30,
+    .value_count = 2, .values = { { .as.i = FUSAIN_PUMP_EVENT_PULSE_END }, { .as.i = 125 } } };
+  fusain_batch_record_t glow = { .kind = FUSAIN_MSG_GLOW_DATA, .index = 0, .dt_ms = 40,
+    .value_count = 1, .values = { { .as.i = 1 } } };
+  fusain_batch_record_t state = { .kind = FUSAIN_MSG_STATE_DATA, .index = 0, .dt_ms = 50,
+    .value_count = 1, .values = { { .as.i = FUSAIN_STATE_HEATING } } };
+  fusain_batch_record_t full_motor = { .kind = FUSAIN_MSG_MOTOR_DATA, .index = 1, .dt_ms = 60,
+    .value_count = 6, .values = { { .as.i = 1 }, { .is_float = true, .as.f = 2.0f },
+                          { .as.i = 3 }, { .as.i = 4 }, { .as.i = 5 }, { .as.i = 6 } } };
+  fusain_batch_record_t full_temp = { .kind = FUSAIN_MSG_TEMP_DATA, .index = 2, .dt_ms = 70,
+    .value_count = 4, .values = { { .as.i = 30 }, { .as.i = 1 }, { .as.i = 1 },
+                          { .is_float = true, .as.f = 45.5f } } };
+
+  fusain_batch_begin(&builder, &packet, HEATER, 1000);
+  zassert_equal(fusain_batch_add_motor(&builder, &motor), 0, "Motor");
+  zassert_equal(fusain_batch_add_temp(&builder, &temp), 0, "Temp");
+  zassert_equal(fusain_batch_add(&builder, &pump), 0, "Pump");
+  zassert_equal(fusain_batch_add(&builder, &glow), 0, "Glow");
+  zassert_equal(fusain_batch_add(&builder, &state), 0, "State (not shadowed)");
+  zassert_equal(fusain_batch_add(&builder, &full_motor), 0, "All motor values");
+  zassert_equal(fusain_batch_add(&builder, &full_temp), 0, "All temp values");
+  fusain_batch_finish(&builder);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 99), 0, "Batch applied");
+
+  fusain_motor_data_t read_motor;
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 0, &read_motor), 0, "Motor");
+  zassert_equal(read_motor.rpm, 1500, "rpm");
+  zassert_equal(read_motor.target, 1600, "target");
+  zassert_equal(read_motor.timestamp, 1010, "Base plus offset");
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 1, &read_motor), 0, "Motor 1");
+  zassert_equal(read_motor.target, 2, "Float value as int");
+  zassert_equal(read_motor.pwm_max, 6, "Last value");
+
+  fusain_temp_data_t read_temp;
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 1, &read_temp), 0, "Temp");
+  zassert_true(read_temp.reading == 55.25f, "Reading");
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 2, &read_temp), 0, "Temp 2");
+  zassert_true(read_temp.reading == 30.0f, "Int reading as float");
+  zassert_true(read_temp.rpm_control, "rpm control");
+  zassert_true(read_temp.target_temp == 45.5f, "Target");
+
+  fusain_pump_data_t read_pump;
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 0, &read_pump), 0, "Pump");
+  zassert_equal(read_pump.rate, 125, "Rate");
+  fusain_glow_data_t read_glow;
+  zassert_equal(fusain_shadow_read_glow(&shadow, HEATER, 0, &read_glow), 0, "Glow");
+  zassert_true(read_glow.lit, "Lit");
+  fusain_state_data_t read_state;
+  zassert_equal(fusain_shadow_read_state(&shadow, HEATER, &read_state), -2, "State ignored");
+
+  /* A bad record rejects the whole batch */
+  fusain_batch_record_t short_motor = { .kind = FUSAIN_MSG_MOTOR_DATA, .index = 0,
+    .value_count = 1, .values = { { .as.i = 9 } } };
+  fusain_batch_record_t high_glow = glow;
+  high_glow.index = FUSAIN_SHADOW_MAX_PERIPHERALS;
+  fusain_batch_begin(&builder, &packet, HEATER, 2000);
+  fusain_batch_add(&builder, &pump);
+  fusain_batch_add(&builder, &short_motor);
+  fusain_batch_finish(&builder);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Too few values");
+  fusain_batch_begin(&builder, &packet, HEATER, 2000);
+  fusain_batch_add(&builder, &pump);
+  fusain_batch_add(&builder, &high_glow);
+  fusain_batch_finish(&builder);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -3, "Index too high");
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 0, &read_pump), 0, "Pump");
+  zassert_equal(read_pump.timestamp, 1030, "Unchanged");
+
+  /* Values that do not fit their integer field are malformed */
+  const fusain_batch_value_t bad_values[] = {
+    { .is_float = true, .as.f = NAN },
+    { .is_float = true, .as.f = INFINITY },
+    { .is_float = true, .as.f = -INFINITY },
+    { .is_float = true, .as.f = 2147483648.0f },
+  };
+  for (size_t i = 0; i < sizeof(bad_values) / sizeof(bad_values[0]); i++) {
+    fusain_batch_record_t bad_motor = full_motor;
+    bad_motor.values[i % 2] = bad_values[i];
+    fusain_batch_record_t bad_glow = glow;
+    bad_glow.values[0] = bad_values[i];
+    fusain_batch_begin(&builder, &packet, HEATER, 2000);
+    fusain_batch_add(&builder, &bad_motor);
+    fusain_batch_finish(&builder);
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Motor value %zu", i);
+    fusain_batch_begin(&builder, &packet, HEATER, 2000);
+    fusain_batch_add(&builder, &bad_glow);
+    fusain_batch_finish(&builder);
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Glow value %zu", i);
+  }
+  fusain_batch_record_t bad_pwm = full_motor;
+  bad_pwm.values[4].as.i = -1;
+  fusain_batch_record_t bad_event = pump;
+  bad_event.values[0].as.i = 256;
+  fusain_batch_record_t float_event = pump;
+  float_event.values[0] = (fusain_batch_value_t) { .is_float = true, .as.f = -1.0f };
+  const fusain_batch_record_t* bad_records[] = { &bad_pwm, &bad_event, &float_event };
+  for (size_t i = 0; i < sizeof(bad_records) / sizeof(bad_records[0]); i++) {
+    fusain_batch_begin(&builder, &packet, HEATER, 2000);
+    fusain_batch_add(&builder, bad_records[i]);
+    fusain_batch_finish(&builder);
+    zassert_equal(fusain_shadow_update(&shadow, &packet, 0), -1, "Out of range %zu", i);
+  }
+
+  /* In range, including truncation toward zero and float-only fields */
+  float_event.values[0].as.f = 255.9f;
+  fusain_batch_record_t nan_temp = full_temp;
+  nan_temp.values[0] = bad_values[0];
+  fusain_batch_begin(&builder, &packet, HEATER, 2000);
+  fusain_batch_add(&builder, &float_event);
+  fusain_batch_add(&builder, &nan_temp);
+  fusain_batch_finish(&builder);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 0), 0, "In range");
+  zassert_equal(fusain_shadow_read_pump(&shadow, HEATER, 0, &read_pump), 0, "Pump");
+  zassert_equal(read_pump.event, 255, "Truncated");
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 2, &read_temp), 0, "Temp");
+  zassert_true(isnan(read_temp.reading), "Readings are stored as sent");
+}
+
+/* Backing store, 8-byte aligned; the header is reached through the union */
+static union {
+  fusain_shadow_image_t header;
+  uint64_t words[(sizeof(fusain_shadow_image_t) + 16 * sizeof(fusain_shadow_device_t))
+          / sizeof(uint64_t)
+      + 1];
+} shadow_image;
+
+static fusain_shadow_device_t* image_entry(fusain_shadow_t* shadow, uint64_t address)
+{
+  for (uint32_t i = 0; i <= shadow->mask; i++) {
+    if (shadow->devices[i].in_use && shadow->devices[i].address == address) {
+      return &shadow->devices[i];
+    }
+  }
+  return NULL;
+}
+
+/* Test restoring a persistent image, including after interrupted writes */
+ZTEST(fusain_shadow, test_shadow_persist)
+{
+  fusain_shadow_t shadow;
+  fusain_packet_t packet;
+  fusain_state_data_t state;
+  fusain_motor_data_t motor;
+  fusain_shadow_record_t record;
+  uint64_t restored[4];
+  size_t size = sizeof(shadow_image);
+
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 12), -1, "Not a power of two");
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, fusain_shadow_image_size(16) - 1, 16),
+      -1, "Too small");
+  zassert_equal(fusain_shadow_attach(&shadow, (uint8_t*)&shadow_image + 1, size - 1, 8), -1,
+      "Misaligned");
+
+  memset(&shadow_image, 0xA5, sizeof(shadow_image));
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 0, "Formatted");
+  zassert_true(shadow.persistent, "Persistent");
+  fusain_create_motor_data(&packet, HEATER, 0, 100, 2500, 2600);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 5), 0, "Motor");
+  fusain_create_state_data(&packet, 2, 0, FUSAIN_ERROR_NONE, FUSAIN_STATE_HEATING, 200);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 6), 0, "State");
+  zassert_equal(fusain_shadow_restored(&shadow, restored, 4), 0, "Nothing restored");
+
+  /* Restart */
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 2, "Both restored");
+  zassert_equal(shadow.count, 2, "Count");
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 0, &motor), 0, "Motor");
+  zassert_equal(motor.rpm, 2500, "rpm");
+  zassert_equal(fusain_shadow_snapshot(&shadow, HEATER, &record), 0, "Snapshot");
+  zassert_true(record.present & FUSAIN_SHADOW_RESTORED, "Flagged");
+  zassert_equal(record.updated_ms, 5, "Previous update time");
+  zassert_equal(fusain_shadow_restored(&shadow, restored, 4), 2, "Both to revalidate");
+
+  fusain_create_motor_data(&packet, HEATER, 0, 110, 2550, 2600);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 7), 0, "Motor");
+  zassert_equal(fusain_shadow_restored(&shadow, restored, 1), 1, "One left");
+  zassert_equal(restored[0], 2, "Device 2");
+  zassert_equal(fusain_shadow_restored(&shadow, NULL, 0), 1, "Count only");
+
+  /* Stopped mid-update: the sequence still names the old copy */
+  fusain_shadow_device_t* entry = image_entry(&shadow, 2);
+  entry->seq = 1;
+  entry->copies[0].state.state = FUSAIN_STATE_IDLE;
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 2, "Restored");
+  zassert_equal(fusain_shadow_read_state(&shadow, 2, &state), 0, "State");
+  zassert_equal(state.state, FUSAIN_STATE_HEATING, "Old copy");
+  zassert_equal(entry->seq, 0, "Sequence reset");
+
+  /* Damaged current copy: fall back to the other one */
+  entry->copies[0].state.state = FUSAIN_STATE_IDLE;
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 2, "Restored");
+  zassert_equal(fusain_shadow_read_state(&shadow, 2, &state), 0, "State");
+  zassert_equal(state.state, FUSAIN_STATE_HEATING, "Other copy");
+  entry->seq = 1;
+  entry->copies[1].state.state = FUSAIN_STATE_IDLE;
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 2, "Restored");
+  zassert_equal(fusain_shadow_read_state(&shadow, 2, &state), 0, "State");
+  zassert_equal(state.state, FUSAIN_STATE_HEATING, "Other copy");
+
+  /* Both damaged: the device stays known without readings */
+  entry->copies[0].state.state = FUSAIN_STATE_IDLE;
+  entry->copies[1].state.state = FUSAIN_STATE_IDLE;
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 16), 1, "Heater only");
+  zassert_equal(fusain_shadow_read_state(&shadow, 2, &state), -2, "Readings lost");
+  zassert_equal(fusain_shadow_restored(&shadow, restored, 4), 2, "Still listed");
+
+  /* Foreign header or other capacity: formatted */
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 8), 0, "Other capacity");
+  zassert_equal(fusain_shadow_read_motor(&shadow, HEATER, 0, &motor), -1, "Empty");
+  shadow_image.header.version++;
+  zassert_equal(fusain_shadow_attach(&shadow, &shadow_image, size, 8), 0, "Other version");
+}
+
+#ifndef CONFIG_FUSAIN
+/* Test a shadow file surviving close and reopen */
+ZTEST(fusain_shadow, test_shadow_file)
+{
+  const char* path = "fusain_shadow_test.bin";
+  fusain_shadow_t shadow;
+  fusain_shadow_file_t file;
+  fusain_packet_t packet;
+  fusain_temp_data_t temp;
+
+  remove(path);
+  zassert_equal(fusain_shadow_open(&shadow, &file, path, 12), -1, "Not a power of two");
+  zassert_equal(fusain_shadow_open(&shadow, &file, "no/such/dir/shadow.bin", 16), -2,
+      "Cannot create");
+
+  zassert_equal(fusain_shadow_open(&shadow, &file, path, 16), 0, "Created");
+  fusain_create_temp_data(&packet, HEATER, 0, 300, 64.5f);
+  zassert_equal(fusain_shadow_update(&shadow, &packet, 1), 0, "Temp");
+  zassert_equal(fusain_shadow_sync(&file, false), 0, "Scheduled");
+  zassert_equal(fusain_shadow_sync(&file, true), 0, "Written");
+  fusain_shadow_close(&file);
+  zassert_is_null(file.image, "Closed");
+
+  zassert_equal(fusain_shadow_open(&shadow, &file, path, 16), 1, "Reopened");
+  zassert_equal(fusain_shadow_read_temp(&shadow, HEATER, 0, &temp), 0, "Temp");
+  zassert_true(temp.reading == 64.5f, "Reading");
+  fusain_shadow_close(&file);
+
+  zassert_equal(fusain_shadow_open(&shadow, &file, path, 32), 0, "Resized and formatted");
+  fusain_shadow_close(&file);
+  remove(path);
+}
+#endif
+
+ZTEST_SUITE(fusain_shadow, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Timer Wheel Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+typedef struct {
+  fusain_timer_t timer;
+  fusain_wheel_t* wheel;
+  uint32_t fired_at;
+  uint32_t fire_count;
+  uint32_t period; // Restart from the callback when nonzero
+  fusain_timer_t* cancel; // Cancel this timer from the callback
+} test_device_t;
+
+static void on_expire(fusain_timer_t* timer, void* user)
+{
+  test_device_t* device = user;
+
+  zassert_equal(timer, &device->timer, "Own timer");
+  zassert_false(fusain_timer_pending(timer), "Not pending in callback");
+  device->fired_at = device->wheel->tick;
+  device->fire_count++;
+  if (device->period > 0) {
+    fusain_timer_start(device->wheel, timer, device->period, 0);
+  }
+  if (device->cancel != NULL) {
+    fusain_timer_cancel(device->wheel, device->cancel);
+  }
+}
+
+static void device_init(test_device_t* device, fusain_wheel_t* wheel)
+{
+  memset(device, 0, sizeof(*device));
+  device->wheel = wheel;
+  fusain_timer_init(&device->timer, on_expire, device);
+}
+
+/* Test that every level fires on the exact tick */
+ZTEST(fusain_timer, test_wheel_levels)
+{
+  static const uint32_t delays[] = { 0, 1, 2, 63, 64, 65, 4095, 4096, 4097, 262143,
+    262144, 300000, 16777215, 16777216, 17000000 };
+  enum { COUNT = sizeof(delays) / sizeof(delays[0]) };
+  static fusain_wheel_t wheel;
+  static test_device_t devices[COUNT];
+
+  fusain_wheel_init(&wheel, 1000, 1);
+  for (size_t i = 0; i < COUNT; i++) {
+    device_init(&devices[i], &wheel);
+    fusain_timer_start(&wheel, &devices[i].timer, delays[i], 0);
+  }
+  zassert_equal(wheel.pending, COUNT, "All pending");
+
+  /* Advance in uneven steps */
+  uint32_t now = 1000;
+  uint32_t step = 1;
+  while (wheel.pending > 0) {
+    now += step;
+    fusain_wheel_advance(&wheel, now);
+    step = step * 3 % 1009 + 1;
+  }
+
+  for (size_t i = 0; i < COUNT; i++) {
+    uint32_t expected = 1000 + (delays[i] == 0 ? 1 : delays[i]);
+    zassert_equal(devices[i].fire_count, 1, "Fired once (%u)", delays[i]);
+    zassert_equal(devices[i].fired_at, expected, "Delay %u fired at %u", delays[i],
+        devices[i].fired_at);
+  }
+}
+
+/* Test the tick counter wrapping around 2^32 */
+ZTEST(fusain_timer, test_wheel_wrap)
+{
+  fusain_wheel_t wheel;
+  test_device_t devices[3];
+  const uint32_t start = UINT32_MAX - 100;
+
+  fusain_wheel_init(&wheel, start, 1);
+  for (int i = 0; i < 3; i++) {
+    device_init(&devices[i], &wheel);
+  }
+  fusain_timer_start(&wheel, &devices[0].timer, 50, 0);
+  fusain_timer_start(&wheel, &devices[1].timer, 101, 0);
+  fusain_timer_start(&wheel, &devices[2].timer, 6000, 0);
+
+  zassert_equal(fusain_wheel_advance(&wheel, 4900), 2, "Two fired");
+  zassert_equal(devices[0].fired_at, start + 50, "Before wrap");
+  zassert_equal(devices[1].fired_at, 0, "At wrap");
+  zassert_equal(fusain_wheel_advance(&wheel, 4899), 0, "Going back does nothing");
+  zassert_equal(fusain_wheel_advance(&wheel, 4900), 0, "Same tick does nothing");
+  zassert_equal(fusain_wheel_advance(&wheel, start + 5999), 0, "Not yet");
+  zassert_equal(fusain_wheel_advance(&wheel, start + 6000), 1, "Third fired");
+  zassert_equal(devices[2].fired_at, start + 6000, "After wrap");
+}
+
+/* Test cancel, restart and callbacks that touch timers */
+ZTEST(fusain_timer, test_timer_cancel_restart)
+{
+  fusain_wheel_t wheel;
+  test_device_t a;
+  test_device_t b;
+  test_device_t c;
+
+  fusain_wheel_init(&wheel, 0, 0);
+  device_init(&a, &wheel);
+  device_init(&b, &wheel);
+  device_init(&c, &wheel);
+
+  zassert_equal(fusain_timer_cancel(&wheel, &a.timer), -1, "Not started");
+  fusain_timer_start(&wheel, &a.timer, 10, 0);
+  fusain_timer_start(&wheel, &b.timer, 10, 0);
+  zassert_true(fusain_timer_pending(&a.timer), "Pending");
+  zassert_equal(fusain_timer_cancel(&wheel, &a.timer), 0, "Cancelled");
+  zassert_equal(fusain_timer_cancel(&wheel, &a.timer), -1, "Already cancelled");
+  zassert_equal(wheel.pending, 1, "One left");
+
+  /* Restarting a pending timer moves it */
+  fusain_timer_start(&wheel, &b.timer, 20, 0);
+  zassert_equal(wheel.pending, 1, "Still one");
+  zassert_equal(fusain_wheel_advance(&wheel, 19), 0, "Moved past 10");
+  zassert_equal(fusain_wheel_advance(&wheel, 20), 1, "Fired at 20");
+
+  /* A heartbeat restarts itself and cancels a peer in the same slot */
+  b.period = 100;
+  fusain_timer_start(&wheel, &b.timer, 100, 0);
+  fusain_timer_start(&wheel, &c.timer, 100, 0);
+  b.cancel = &c.timer;
+  fusain_timer_start(&wheel, &a.timer, 100, 0);
+  a.cancel = &c.timer;
+  zassert_equal(fusain_wheel_advance(&wheel, 120), 2, "Only one of the peers survives");
+  zassert_equal(c.fire_count + a.fire_count + b.fire_count, 3, "Counts");
+  b.cancel = NULL;
+  zassert_equal(fusain_wheel_advance(&wheel, 1020), 9, "Heartbeat every 100");
+  zassert_equal(b.fire_count, 11, "Eleven beats");
+  zassert_equal(b.fired_at, 1020, "On schedule");
+  zassert_true(fusain_timer_pending(&b.timer), "Still beating");
+
+  /* Delay 0 from a callback runs on the next tick */
+  b.period = 0;
+  fusain_timer_cancel(&wheel, &b.timer);
+  fusain_timer_start(&wheel, &b.timer, 0, 0);
+  zassert_equal(fusain_wheel_advance(&wheel, 1021), 1, "Next tick");
+
+  /* Very long delays are clamped and stay pending */
+  fusain_timer_start(&wheel, &a.timer, UINT32_MAX, 0);
+  zassert_equal(a.timer.expires, 1021 + 0x7FFFFFFFU, "Clamped");
+  zassert_equal(fusain_wheel_advance(&wheel, 1021 + 20000000), 0, "Far off");
+  zassert_true(fusain_timer_pending(&a.timer), "Parked");
+}
+
+/* Test that jitter spreads heartbeats started together */
+ZTEST(fusain_timer, test_timer_jitter)
+{
+  static fusain_wheel_t wheel;
+  static test_device_t devices[500];
+  uint32_t per_tick[51] = { 0 };
+
+  fusain_wheel_init(&wheel, 0, 12345);
+  for (int i = 0; i < 500; i++) {
+    device_init(&devices[i], &wheel);
+    fusain_timer_start(&wheel, &devices[i].timer, 1000, 50);
+  }
+  zassert_equal(fusain_wheel_advance(&wheel, 999), 0, "Nothing early");
+  zassert_equal(fusain_wheel_advance(&wheel, 1050), 500, "All within the jitter");
+
+  uint32_t busiest = 0;
+  for (int i = 0; i < 500; i++) {
+    per_tick[devices[i].fired_at - 1000]++;
+  }
+  for (int i = 0; i <= 50; i++) {
+    busiest = per_tick[i] > busiest ? per_tick[i] : busiest;
+  }
+  zassert_true(busiest < 30, "Spread out (busiest tick %u)", busiest);
+
+  /* Full-range jitter is accepted */
+  fusain_timer_start(&wheel, &devices[0].timer, 0, UINT32_MAX);
+  zassert_true(fusain_timer_pending(&devices[0].timer), "Started");
+}
+
+/* Test the sleep hint */
+ZTEST(fusain_timer, test_wheel_next)
+{
+  fusain_wheel_t wheel;
+  test_device_t device;
+
+  fusain_wheel_init(&wheel, 0, 1);
+  device_init(&device, &wheel);
+  zassert_equal(fusain_wheel_next(&wheel), UINT32_MAX, "Idle");
+  zassert_equal(fusain_wheel_advance(&wheel, 1000000), 0, "Idle skip");
+  zassert_equal(wheel.tick, 1000000, "Skipped ahead");
+
+  fusain_timer_start(&wheel, &device.timer, 5, 0);
+  zassert_equal(fusain_wheel_next(&wheel), 5, "Level 0");
+
+  /* 1000000 = 15625 * 64, so the next wrap is 64 ticks away */
+  fusain_timer_start(&wheel, &device.timer, 5000, 0);
+  uint32_t wakes = 0;
+  while (fusain_timer_pending(&device.timer)) {
+    uint32_t next = fusain_wheel_next(&wheel);
+    zassert_true(next <= 64, "Wake at the latest on the wrap");
+    fusain_wheel_advance(&wheel, wheel.tick + next);
+    wakes++;
+  }
+  zassert_equal(device.fired_at, 1005000, "Fired on time");
+  zassert_true(wakes < 100, "Few wakes (%u)", wakes);
+}
+
+ZTEST_SUITE(fusain_timer, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2025 Kaz Walker, Thermoquad
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fusain Protocol Library - Priority TX Scheduler Tests
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include <fusain/fusain.h>
+
+#define HEATER 0x0102030405060708ULL
+
+static fusain_tx_slot_t tx_slots[8];
+static fusain_tx_scheduler_t sched;
+
+/* Pull everything and decode it; returns the number of packets */
+static int tx_drain(fusain_packet_t* packets, int max, size_t chunk, uint64_t now_us)
+{
+  fusain_decoder_t decoder;
+  uint8_t buffer[16];
+  int count = 0;
+  size_t n;
+
+  fusain_reset_decoder(&decoder);
+  while ((n = fusain_tx_pull(&sched, buffer, chunk, now_us)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (count < max
+          && fusain_decode_byte(buffer[i], &packets[count], &decoder) == FUSAIN_DECODE_OK) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/* Test the class of each message family */
+ZTEST(fusain_tx, test_tx_class)
+{
+  fusain_packet_t packet;
+
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_EMERGENCY, 0);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_SAFETY, "Emergency stop");
+  fusain_create_timeout_config(&packet, HEATER, true, 5000);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_SAFETY, "Timeout config");
+  fusain_create_error_state_reject(&packet, HEATER, FUSAIN_STATE_IDLE, 1);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_SAFETY, "Error");
+
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, 3);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_CONTROL, "State command");
+  fusain_create_motor_command(&packet, HEATER, 0, 3000);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_CONTROL, "Motor command");
+  fusain_create_telemetry_config(&packet, HEATER, true, 250);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_CONFIG, "Config");
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 21.5f);
+  zassert_equal(fusain_tx_class_of(&packet), FUSAIN_TX_TELEMETRY, "Telemetry");
+}
+
+/* Test that an emergency stop goes out right after the frame in progress */
+ZTEST(fusain_tx, test_tx_preempt)
+{
+  fusain_packet_t packet;
+  fusain_packet_t received[8];
+  uint8_t buffer[8];
+
+  zassert_equal(fusain_tx_init(&sched, NULL, 8, NULL), -1, "No slots");
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, NULL), 0, "Strict");
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), 0), 0, "Nothing queued");
+
+  for (uint32_t i = 0; i < 4; i++) {
+    fusain_create_temp_data(&packet, HEATER, (uint8_t)i, i, 21.5f);
+    zassert_equal(fusain_tx_enqueue(&sched, &packet, 100), FUSAIN_TX_TELEMETRY, "Queued");
+  }
+  fusain_create_telemetry_config(&packet, HEATER, true, 250);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 100), FUSAIN_TX_CONFIG, "Queued");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 4, "Depth");
+
+  /* The config frame goes first; the first telemetry frame is under way */
+  uint8_t first[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+  int config_length = fusain_encode_packet(&packet, first, sizeof(first));
+  zassert_equal(fusain_tx_pull(&sched, first, (size_t)config_length + 4, 150),
+      (size_t)config_length + 4, "Stops where asked");
+
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_EMERGENCY, 0);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 200), FUSAIN_TX_SAFETY, "E-stop");
+
+  /* The rest of the frame in progress can't be decoded alone: 5 packets follow */
+  int count = tx_drain(received, 8, 16, 300);
+  zassert_equal(count, 4, "E-stop and three telemetry frames");
+  zassert_equal(received[0].msg_type, FUSAIN_MSG_STATE_COMMAND, "E-stop first");
+  for (int i = 1; i < 4; i++) {
+    zassert_equal(received[i].msg_type, FUSAIN_MSG_TEMP_DATA, "Then telemetry");
+  }
+
+  fusain_tx_stats_t* safety = &sched.stats[FUSAIN_TX_SAFETY];
+  zassert_equal(safety->sent, 1, "Sent");
+  zassert_equal(safety->latency_max_us, 100, "Waited for one frame");
+  fusain_tx_stats_t* telemetry = &sched.stats[FUSAIN_TX_TELEMETRY];
+  zassert_equal(telemetry->sent, 4, "Sent");
+  zassert_equal(telemetry->max_depth, 4, "Max depth");
+  zassert_equal(telemetry->depth, 0, "Empty");
+  zassert_equal(telemetry->latency_total_us, 50 + 3 * 200, "Latency");
+  zassert_equal(telemetry->latency_max_us, 200, "Latency");
+}
+
+/* Test deficit round robin sharing bytes by weight */
+ZTEST(fusain_tx, test_tx_weighted)
+{
+  const uint16_t zero[FUSAIN_TX_CLASSES] = { 0, 64, 0, 64 };
+  const uint16_t weights[FUSAIN_TX_CLASSES] = { 0, 64, 64, 32 };
+  fusain_packet_t packet;
+  fusain_packet_t received[8];
+
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, zero), -1, "Zero weight");
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, weights), 0, "Weighted");
+
+  /* Three of each; control would starve the others under strict priority */
+  for (int i = 0; i < 3; i++) {
+    fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, i);
+    fusain_tx_enqueue(&sched, &packet, 0);
+    fusain_create_temp_data(&packet, HEATER, (uint8_t)i, (uint32_t)i, 21.5f);
+    fusain_tx_enqueue(&sched, &packet, 0);
+  }
+  fusain_create_telemetry_config(&packet, HEATER, true, 250);
+  fusain_tx_enqueue(&sched, &packet, 0);
+
+  zassert_equal(tx_drain(received, 8, 16, 0), 7, "All sent");
+  /* Commands are 22 bytes and TEMP_DATA 32: a round is two commands and one TEMP_DATA */
+  const uint8_t expected[7] = {
+    FUSAIN_MSG_STATE_COMMAND, FUSAIN_MSG_STATE_COMMAND, FUSAIN_MSG_TELEMETRY_CONFIG,
+    FUSAIN_MSG_TEMP_DATA, FUSAIN_MSG_STATE_COMMAND, FUSAIN_MSG_TEMP_DATA,
+    FUSAIN_MSG_TEMP_DATA,
+  };
+  for (int i = 0; i < 7; i++) {
+    zassert_equal(received[i].msg_type, expected[i], "Order at %d", i);
+  }
+
+  /* Safety still pre-empts every weighted class */
+  fusain_create_temp_data(&packet, HEATER, 0, 9, 21.5f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  fusain_create_error_state_reject(&packet, HEATER, FUSAIN_STATE_IDLE, 1);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  zassert_equal(tx_drain(received, 8, 16, 0), 2, "Both sent");
+  zassert_equal(received[0].msg_type, FUSAIN_MSG_ERROR_STATE_REJECT, "Error first");
+}
+
+/* Test evicting lower classes when every slot is in use */
+ZTEST(fusain_tx, test_tx_evict)
+{
+  fusain_packet_t packet;
+  fusain_packet_t received[4];
+
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 2, NULL), 0, "Two slots");
+  fusain_create_temp_data(&packet, HEATER, 1, 1, 21.5f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  fusain_create_temp_data(&packet, HEATER, 2, 2, 21.5f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+
+  fusain_create_temp_data(&packet, HEATER, 3, 3, 21.5f);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 0), -2, "Nothing lower to evict");
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_EMERGENCY, 0);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 0), FUSAIN_TX_SAFETY, "Evicts");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].dropped, 2, "Refused and evicted");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 1, "One left");
+
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_EMERGENCY, 0);
+  packet.length = FUSAIN_MAX_PAYLOAD_SIZE + 1;
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 0), -1, "Cannot encode");
+
+  zassert_equal(tx_drain(received, 4, 16, 0), 2, "E-stop and newest telemetry");
+  zassert_equal(received[0].msg_type, FUSAIN_MSG_STATE_COMMAND, "E-stop");
+  uint64_t timestamp;
+  zassert_equal(fusain_peek_uint(&received[1], 1, &timestamp), 0, "Timestamp");
+  zassert_equal(timestamp, 2, "Oldest was evicted");
+}
+
+/* Test replacing queued latest-value telemetry with newer values */
+ZTEST(fusain_tx, test_tx_coalesce)
+{
+  fusain_packet_t packet;
+  fusain_packet_t received[8];
+  uint64_t timestamp;
+  uint8_t buffer[4];
+
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, NULL), 0, "Init");
+  fusain_create_temp_data(&packet, HEATER, 0, 1, 20.0f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  fusain_create_temp_data(&packet, HEATER, 1, 2, 20.0f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  fusain_create_motor_data(&packet, HEATER, 0, 3, 3000, 3200);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  fusain_create_temp_data(&packet, HEATER + 1, 0, 4, 20.0f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 4, "Distinct keys");
+
+  /* Newer values take the place of the queued ones */
+  fusain_create_temp_data(&packet, HEATER, 0, 5, 21.0f);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 10), FUSAIN_TX_TELEMETRY, "Coalesced");
+  fusain_create_motor_data(&packet, HEATER, 0, 6, 3100, 3200);
+  zassert_equal(fusain_tx_enqueue(&sched, &packet, 10), FUSAIN_TX_TELEMETRY, "Coalesced");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 4, "Bounded");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].coalesced, 2, "Counted");
+
+  /* Pump events are each kept */
+  fusain_create_pump_data(&packet, HEATER, 0, 7, FUSAIN_PUMP_EVENT_CYCLE_START, 0);
+  fusain_tx_enqueue(&sched, &packet, 10);
+  fusain_create_pump_data(&packet, HEATER, 0, 8, FUSAIN_PUMP_EVENT_PULSE_END, 0);
+  fusain_tx_enqueue(&sched, &packet, 10);
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 6, "Events queued");
+
+  /* A frame already under way is not touched */
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), 20), 4, "Started");
+  fusain_create_temp_data(&packet, HEATER, 0, 9, 22.0f);
+  fusain_tx_enqueue(&sched, &packet, 20);
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 6, "Queued anew");
+
+  zassert_equal(tx_drain(received, 8, 16, 30), 6, "Rest of the queue");
+  const uint32_t expected[6] = { 2, 6, 4, 7, 8, 9 };
+  for (int i = 0; i < 6; i++) {
+    zassert_equal(fusain_peek_uint(&received[i], 1, &timestamp), 0, "Timestamp");
+    zassert_equal(timestamp, expected[i], "Frame %d", i);
+  }
+
+  /* STATE_DATA has no peripheral index */
+  fusain_create_state_data(&packet, HEATER, 0, 0, FUSAIN_STATE_IDLE, 1);
+  fusain_tx_enqueue(&sched, &packet, 40);
+  fusain_create_state_data(&packet, HEATER, 0, 0, FUSAIN_STATE_HEATING, 2);
+  fusain_tx_enqueue(&sched, &packet, 40);
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 1, "Coalesced");
+  zassert_equal(tx_drain(received, 8, 16, 50), 1, "Latest state");
+  zassert_equal(fusain_peek_uint(&received[0], 3, &timestamp), 0, "Timestamp");
+  zassert_equal(timestamp, 2, "Newest");
+
+  /* Without a readable index a frame is queued as it is */
+  fusain_create_temp_data(&packet, HEATER, 0, 1, 20.0f);
+  packet.payload[3] = 0x40; /* Index is now a byte string */
+  fusain_tx_enqueue(&sched, &packet, 60);
+  fusain_tx_enqueue(&sched, &packet, 60);
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].depth, 2, "Not coalesced");
+}
+
+/* Test the telemetry token bucket */
+ZTEST(fusain_tx, test_tx_rate)
+{
+  const uint16_t weights[FUSAIN_TX_CLASSES] = { 0, 64, 64, 64 };
+  fusain_packet_t packet;
+  uint8_t buffer[FUSAIN_MAX_STUFFED_PACKET_SIZE];
+
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, NULL), 0, "Init");
+  zassert_equal(fusain_tx_wake(&sched, 0), UINT64_MAX, "Nothing queued");
+  fusain_tx_set_rate(&sched, FUSAIN_TX_UART_RATE(10000), 0, 0); /* 1000 bytes/s */
+
+  /* The bucket holds 251 bytes to start: as many whole frames as fit */
+  size_t lengths[8];
+  size_t burst = 0;
+  size_t frames = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    fusain_create_temp_data(&packet, HEATER, i, 1000, 20.0f);
+    lengths[i] = (size_t)fusain_encode_packet(&packet, buffer, sizeof(buffer));
+    fusain_tx_enqueue(&sched, &packet, 0);
+    if (frames == i && burst + lengths[i] <= FUSAIN_MAX_STUFFED_PACKET_SIZE) {
+      burst += lengths[i];
+      frames++;
+    }
+  }
+  size_t pulled = 0;
+  size_t n;
+  while ((n = fusain_tx_pull(&sched, buffer, sizeof(buffer), 0)) > 0) {
+    pulled += n;
+  }
+  zassert_equal(pulled, burst, "Burst");
+  uint64_t missing = lengths[frames] - (FUSAIN_MAX_STUFFED_PACKET_SIZE - burst);
+  zassert_equal(fusain_tx_wake(&sched, 0), missing * 1000, "At 1000 bytes/s");
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), missing * 1000 - 1), 0,
+      "Not yet");
+  uint64_t due = missing * 1000;
+
+  /* Other classes are not held back */
+  fusain_create_state_command(&packet, HEATER, FUSAIN_MODE_HEAT, 3);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  zassert_equal(fusain_tx_wake(&sched, due - 1), due - 1, "Command ready");
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), due - 1), 22, "Command only");
+
+  zassert_equal(fusain_tx_pull(&sched, buffer, 8, due), 8, "Telemetry again");
+  zassert_equal(fusain_tx_wake(&sched, due), due, "Frame under way");
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), due), lengths[frames] - 8,
+      "Rest of it");
+  while (fusain_tx_pull(&sched, buffer, sizeof(buffer), UINT32_MAX) > 0) {
+  }
+  zassert_equal(fusain_tx_wake(&sched, UINT32_MAX), UINT64_MAX, "All sent");
+
+  /* A long idle spell only fills the bucket */
+  for (uint8_t i = 0; i < 8; i++) {
+    fusain_create_temp_data(&packet, HEATER, i, 1000, 20.0f);
+    fusain_tx_enqueue(&sched, &packet, 0);
+  }
+  pulled = 0;
+  while ((n = fusain_tx_pull(&sched, buffer, sizeof(buffer), 10000000000ULL)) > 0) {
+    pulled += n;
+  }
+  zassert_equal(pulled, burst, "Burst");
+
+  /* Weighted service skips telemetry while it waits for tokens */
+  zassert_equal(fusain_tx_init(&sched, tx_slots, 8, weights), 0, "Weighted");
+  fusain_tx_set_rate(&sched, 1000, 64, 0);
+  for (uint8_t i = 0; i < 8; i++) {
+    fusain_create_temp_data(&packet, HEATER, i, 1000, 20.0f);
+    fusain_tx_enqueue(&sched, &packet, 0);
+  }
+  fusain_create_telemetry_config(&packet, HEATER, true, 250);
+  fusain_tx_enqueue(&sched, &packet, 0); /* Evicts the oldest frame, index 0 */
+  pulled = 0;
+  while ((n = fusain_tx_pull(&sched, buffer, sizeof(buffer), 0)) > 0) {
+    pulled += n;
+  }
+  zassert_equal(sched.stats[FUSAIN_TX_CONFIG].sent, 1, "Config sent");
+  zassert_equal(sched.stats[FUSAIN_TX_TELEMETRY].sent, frames, "A burst of telemetry");
+
+  fusain_create_temp_data(&packet, HEATER, 0, 1000, 20.0f);
+  fusain_tx_enqueue(&sched, &packet, 0);
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), 0), 0, "Out of tokens");
+  fusain_tx_set_rate(&sched, 0, 0, 0);
+  zassert_equal(fusain_tx_pull(&sched, buffer, sizeof(buffer), 0), lengths[0], "Unlimited");
+}
+
+ZTEST_SUITE(fusain_tx, NULL, NULL, NULL, NULL, NULL);
@@ -113,6 +113,9 @@ static inline void __ztest_set_entry(
 #define zassert_not_null(ptr, fmt, ...) \
   zassert_true((ptr) != NULL, fmt, ##__VA_ARGS__)
 
+#define zassert_equal_ptr(a, b, fmt, ...) \
+  zassert_true((const void*)(a) == (const void*)(b), fmt, ##__VA_ARGS__)
+
 #define zassert_mem_equal(buf1, buf2, len, fmt, ...)                  \
   do {                                                                \
     if (memcmp((buf1), (buf2), (len)) != 0) {                         \